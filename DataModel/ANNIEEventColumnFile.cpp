@@ -0,0 +1,467 @@
+#include "ANNIEEventColumnFile.h"
+
+#include <iostream>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+void ANNIEEventColumn::Encode(std::string& Entry, const HitMap& Value){
+  size_t NumHits = 0;
+  for (HitMap::const_iterator it = Value.begin(); it != Value.end(); ++it) NumHits += it->second.size();
+  //The hit count leads the entry, so an empty map is still told apart from a missing one
+  uint64_t Count = NumHits;
+  Entry.resize(sizeof(Count) + NumHits*sizeof(ColumnHit));
+  char* p = &Entry[0];
+  std::memcpy(p, &Count, sizeof(Count));
+  p += sizeof(Count);
+  for (HitMap::const_iterator it = Value.begin(); it != Value.end(); ++it){
+    for (size_t i=0; i<it->second.size(); i++){
+      const Hit& ahit = it->second.at(i);
+      ColumnHit chit;
+      chit.ChannelKey = it->first;
+      chit.TubeId = ahit.GetTubeId();
+      chit.Time = ahit.GetTime();
+      chit.Charge = ahit.GetCharge();
+      std::memcpy(p, &chit, sizeof(chit));
+      p += sizeof(chit);
+    }
+  }
+}
+
+void ANNIEEventColumn::Decode(const char* Entry, uint64_t Size, HitMap& Value){
+  Value.clear();
+  //Hits are stored grouped by channel key, so each channel's vector is filled in one go
+  std::vector<Hit>* ChannelHits = nullptr;
+  unsigned long ChannelKey = 0;
+  for (uint64_t Pos = sizeof(uint64_t); Pos + sizeof(ColumnHit) <= Size; Pos += sizeof(ColumnHit)){
+    ColumnHit chit;
+    std::memcpy(&chit, Entry + Pos, sizeof(chit));
+    if(ChannelHits == nullptr || chit.ChannelKey != ChannelKey){
+      ChannelKey = chit.ChannelKey;
+      ChannelHits = &Value[ChannelKey];
+    }
+    ChannelHits->push_back(Hit(chit.TubeId, chit.Time, chit.Charge));
+  }
+}
+
+
+void ANNIEEventColumn::Encode(std::string& Entry, const MCHitMap& Value){
+  //As a HitMap entry, with each record followed by a uint32 parent count and the parent indices
+  uint64_t Count = 0;
+  size_t EntrySize = sizeof(Count);
+  for (MCHitMap::const_iterator it = Value.begin(); it != Value.end(); ++it){
+    Count += it->second.size();
+    for (size_t i=0; i<it->second.size(); i++){
+      EntrySize += sizeof(ColumnHit) + sizeof(uint32_t) + it->second.at(i).GetParents()->size()*sizeof(int32_t);
+    }
+  }
+  Entry.resize(EntrySize);
+  char* p = &Entry[0];
+  std::memcpy(p, &Count, sizeof(Count));
+  p += sizeof(Count);
+  for (MCHitMap::const_iterator it = Value.begin(); it != Value.end(); ++it){
+    for (size_t i=0; i<it->second.size(); i++){
+      const MCHit& ahit = it->second.at(i);
+      ColumnHit chit;
+      chit.ChannelKey = it->first;
+      chit.TubeId = ahit.GetTubeId();
+      chit.Time = ahit.GetTime();
+      chit.Charge = ahit.GetCharge();
+      std::memcpy(p, &chit, sizeof(chit));
+      p += sizeof(chit);
+      const std::vector<int>* Parents = ahit.GetParents();
+      uint32_t NumParents = Parents->size();
+      std::memcpy(p, &NumParents, sizeof(NumParents));
+      p += sizeof(NumParents);
+      for (uint32_t j=0; j<NumParents; j++){
+        int32_t Parent = Parents->at(j);
+        std::memcpy(p, &Parent, sizeof(Parent));
+        p += sizeof(Parent);
+      }
+    }
+  }
+}
+
+void ANNIEEventColumn::Decode(const char* Entry, uint64_t Size, MCHitMap& Value){
+  Value.clear();
+  std::vector<MCHit>* ChannelHits = nullptr;
+  unsigned long ChannelKey = 0;
+  uint64_t Pos = sizeof(uint64_t);
+  while(Pos + sizeof(ColumnHit) + sizeof(uint32_t) <= Size){
+    ColumnHit chit;
+    uint32_t NumParents;
+    std::memcpy(&chit, Entry + Pos, sizeof(chit));
+    Pos += sizeof(chit);
+    std::memcpy(&NumParents, Entry + Pos, sizeof(NumParents));
+    Pos += sizeof(NumParents);
+    if(Pos + NumParents*sizeof(int32_t) > Size) break;
+    std::vector<int> Parents(NumParents);
+    for (uint32_t j=0; j<NumParents; j++){
+      int32_t Parent;
+      std::memcpy(&Parent, Entry + Pos, sizeof(Parent));
+      Pos += sizeof(Parent);
+      Parents[j] = Parent;
+    }
+    if(ChannelHits == nullptr || chit.ChannelKey != ChannelKey){
+      ChannelKey = chit.ChannelKey;
+      ChannelHits = &Value[ChannelKey];
+    }
+    ChannelHits->push_back(MCHit(chit.TubeId, chit.Time, chit.Charge, std::move(Parents)));
+  }
+}
+
+
+ANNIEEventColumnWriter::~ANNIEEventColumnWriter(){
+  this->Close();
+}
+
+bool ANNIEEventColumnWriter::Open(const std::string& Filename){
+  this->Close();
+  Columns.clear();
+  ColumnIndex.clear();
+  NumEvents = 0;
+  ChunkFirstEvent = 0;
+  WriteFailed = false;
+  OutFile = std::fopen(Filename.c_str(), "wb");
+  if(OutFile == nullptr){
+    std::cout << "ANNIEEventColumnWriter: ERROR could not open " << Filename << " for writing" << std::endl;
+    return false;
+  }
+  const uint32_t Reserved = 0;
+  bool Success = (std::fwrite(ANNIEEventColumn::MAGIC, 1, sizeof(ANNIEEventColumn::MAGIC), OutFile) == sizeof(ANNIEEventColumn::MAGIC));
+  Success &= (std::fwrite(&ANNIEEventColumn::VERSION, sizeof(ANNIEEventColumn::VERSION), 1, OutFile) == 1);
+  Success &= (std::fwrite(&Reserved, sizeof(Reserved), 1, OutFile) == 1);
+  Success &= (std::fflush(OutFile) == 0);
+  if(!Success){
+    std::cout << "ANNIEEventColumnWriter: ERROR failed writing " << Filename << std::endl;
+    std::fclose(OutFile);
+    OutFile = nullptr;
+    return false;
+  }
+  CurrentFilename = Filename;
+  return true;
+}
+
+bool ANNIEEventColumnWriter::AddEntry(const std::string& Name, const std::string& Type, const std::string& Data){
+  if(!this->IsOpen()){
+    std::cout << "ANNIEEventColumnWriter: ERROR no file open.  " << Name << " not written" << std::endl;
+    return false;
+  }
+  std::map<std::string, size_t>::iterator it = ColumnIndex.find(Name);
+  if(it == ColumnIndex.end()){
+    Column NewColumn;
+    NewColumn.Name = Name;
+    NewColumn.Type = Type;
+    NewColumn.SpillFilename = CurrentFilename + ".col." + std::to_string(Columns.size()) + ".tmp";
+    NewColumn.Spill = std::fopen(NewColumn.SpillFilename.c_str(), "wb");
+    if(NewColumn.Spill == nullptr){
+      std::cout << "ANNIEEventColumnWriter: ERROR could not open " << NewColumn.SpillFilename << " for writing" << std::endl;
+      return false;
+    }
+    it = ColumnIndex.emplace(Name, Columns.size()).first;
+    Columns.push_back(NewColumn);
+  }
+  Column& TheColumn = Columns.at(it->second);
+  if(TheColumn.Type != Type){
+    std::cout << "ANNIEEventColumnWriter: ERROR " << Name << " has type " << Type <<
+        " but its column holds " << TheColumn.Type << ".  Entry not written" << std::endl;
+    return false;
+  }
+  //Events of this chunk before this one that didn't set the member get empty entries
+  uint64_t ChunkEvents = NumEvents - ChunkFirstEvent;
+  while(TheColumn.Offsets.size() < ChunkEvents) TheColumn.Offsets.push_back(TheColumn.Size);
+  if(TheColumn.Offsets.size() > ChunkEvents){
+    std::cout << "ANNIEEventColumnWriter: WARNING " << Name << " was already set for this event.  Entry not written" << std::endl;
+    return false;
+  }
+  TheColumn.Offsets.push_back(TheColumn.Size);
+  if(!Data.empty() && std::fwrite(Data.data(), 1, Data.size(), TheColumn.Spill) != Data.size()){
+    std::cout << "ANNIEEventColumnWriter: ERROR failed writing " << Name << " to " << TheColumn.SpillFilename << std::endl;
+    return false;
+  }
+  TheColumn.Size += Data.size();
+  return true;
+}
+
+bool ANNIEEventColumnWriter::WriteEvent(){
+  if(!this->IsOpen()){
+    std::cout << "ANNIEEventColumnWriter: ERROR no file open.  Event not written" << std::endl;
+    return false;
+  }
+  NumEvents+=1;
+  if(NumEvents - ChunkFirstEvent >= uint64_t(EventsPerChunk)) return this->WriteChunk();
+  return true;
+}
+
+bool ANNIEEventColumnWriter::WriteChunk(){
+  uint64_t ChunkEvents = NumEvents - ChunkFirstEvent;
+  for (size_t i=0; i<Columns.size(); i++){
+    Column& TheColumn = Columns.at(i);
+    while(TheColumn.Offsets.size() < ChunkEvents+1) TheColumn.Offsets.push_back(TheColumn.Size);
+  }
+
+  std::string Header;
+  uint64_t ChunkSize = 0;  //Filled in once the layout is known
+  uint32_t NumColumns = Columns.size();
+  uint32_t Reserved = 0;
+  Header.append(reinterpret_cast<const char*>(&ChunkSize), sizeof(ChunkSize));
+  Header.append(reinterpret_cast<const char*>(&NumColumns), sizeof(NumColumns));
+  Header.append(reinterpret_cast<const char*>(&Reserved), sizeof(Reserved));
+  Header.append(reinterpret_cast<const char*>(&ChunkEvents), sizeof(ChunkEvents));
+  uint64_t HeaderSize = Header.size();
+  for (size_t i=0; i<Columns.size(); i++){
+    HeaderSize += 2*sizeof(uint32_t) + Columns.at(i).Name.size() + Columns.at(i).Type.size() + 3*sizeof(uint64_t);
+  }
+  //Each column's index and data start on an 8-byte boundary
+  uint64_t Position = (HeaderSize + 7) & ~uint64_t(7);
+  std::vector<uint64_t> ColumnStarts;
+  for (size_t i=0; i<Columns.size(); i++){
+    Column& TheColumn = Columns.at(i);
+    uint64_t IndexOffset = Position;
+    uint64_t DataOffset = IndexOffset + TheColumn.Offsets.size()*sizeof(uint64_t);
+    uint32_t NameLength = TheColumn.Name.size();
+    uint32_t TypeLength = TheColumn.Type.size();
+    Header.append(reinterpret_cast<const char*>(&NameLength), sizeof(NameLength));
+    Header.append(TheColumn.Name);
+    Header.append(reinterpret_cast<const char*>(&TypeLength), sizeof(TypeLength));
+    Header.append(TheColumn.Type);
+    Header.append(reinterpret_cast<const char*>(&IndexOffset), sizeof(IndexOffset));
+    Header.append(reinterpret_cast<const char*>(&DataOffset), sizeof(DataOffset));
+    Header.append(reinterpret_cast<const char*>(&TheColumn.Size), sizeof(TheColumn.Size));
+    ColumnStarts.push_back(IndexOffset);
+    Position = (DataOffset + TheColumn.Size + 7) & ~uint64_t(7);
+  }
+  ChunkSize = Position;
+  std::memcpy(&Header[0], &ChunkSize, sizeof(ChunkSize));
+
+  bool Success = !WriteFailed;
+  if(Success){
+    const char Padding[8] = {0};
+    std::vector<char> Buffer(1<<20);
+    uint64_t Written = 0;
+    Success = (std::fwrite(Header.data(), 1, Header.size(), OutFile) == Header.size());
+    Written += Header.size();
+    for (size_t i=0; i<Columns.size() && Success; i++){
+      Column& TheColumn = Columns.at(i);
+      Success = (std::fwrite(Padding, 1, ColumnStarts.at(i)-Written, OutFile) == ColumnStarts.at(i)-Written);
+      Written = ColumnStarts.at(i);
+      Success &= (std::fwrite(TheColumn.Offsets.data(), sizeof(uint64_t), TheColumn.Offsets.size(), OutFile) == TheColumn.Offsets.size());
+      Written += TheColumn.Offsets.size()*sizeof(uint64_t);
+      //Copy the column's data back from its spill file
+      std::FILE* Spill = (std::fflush(TheColumn.Spill) == 0) ? std::fopen(TheColumn.SpillFilename.c_str(), "rb") : nullptr;
+      if(Spill == nullptr){
+        std::cout << "ANNIEEventColumnWriter: ERROR could not reopen " << TheColumn.SpillFilename << std::endl;
+        Success = false;
+        break;
+      }
+      uint64_t Remaining = TheColumn.Size;
+      while(Remaining > 0 && Success){
+        size_t Chunk = std::min<uint64_t>(Remaining, Buffer.size());
+        Success = (std::fread(Buffer.data(), 1, Chunk, Spill) == Chunk) &&
+            (std::fwrite(Buffer.data(), 1, Chunk, OutFile) == Chunk);
+        Remaining -= Chunk;
+      }
+      std::fclose(Spill);
+      Written += TheColumn.Size;
+    }
+    if(Success && Written != Position) Success = (std::fwrite(Padding, 1, Position-Written, OutFile) == Position-Written);
+    Success &= (std::fflush(OutFile) == 0);
+    if(!Success){
+      std::cout << "ANNIEEventColumnWriter: ERROR failed writing events " << ChunkFirstEvent << " to " << NumEvents-1 <<
+          " to " << CurrentFilename << ".  Later events will not be written" << std::endl;
+      WriteFailed = true;
+    }
+  } else {
+    std::cout << "ANNIEEventColumnWriter: ERROR dropping events " << ChunkFirstEvent << " to " << NumEvents-1 <<
+        " after an earlier write to " << CurrentFilename << " failed" << std::endl;
+  }
+
+  //Start the next chunk with empty spill files
+  for (size_t i=0; i<Columns.size(); i++){
+    Column& TheColumn = Columns.at(i);
+    TheColumn.Offsets.clear();
+    TheColumn.Size = 0;
+    TheColumn.Spill = std::freopen(TheColumn.SpillFilename.c_str(), "wb", TheColumn.Spill);
+    if(TheColumn.Spill == nullptr){
+      std::cout << "ANNIEEventColumnWriter: ERROR could not reopen " << TheColumn.SpillFilename << " for writing" << std::endl;
+      WriteFailed = true;
+    }
+  }
+  ChunkFirstEvent = NumEvents;
+  return Success;
+}
+
+bool ANNIEEventColumnWriter::Close(){
+  if(!this->IsOpen()) return true;
+  //Members set after the last WriteEvent belong to an unfinished event and are dropped
+  uint64_t ChunkEvents = NumEvents - ChunkFirstEvent;
+  for (size_t i=0; i<Columns.size(); i++){
+    Column& TheColumn = Columns.at(i);
+    if(TheColumn.Offsets.size() > ChunkEvents){
+      TheColumn.Size = TheColumn.Offsets.at(ChunkEvents);
+      TheColumn.Offsets.resize(ChunkEvents);
+    }
+  }
+  bool Success = (ChunkEvents > 0) ? this->WriteChunk() : !WriteFailed;
+  Success &= (std::fclose(OutFile) == 0);
+  OutFile = nullptr;
+  if(!Success) std::cout << "ANNIEEventColumnWriter: ERROR " << CurrentFilename << " is incomplete" << std::endl;
+
+  this->RemoveSpillFiles();
+  Columns.clear();
+  ColumnIndex.clear();
+  CurrentFilename.clear();
+  return Success;
+}
+
+void ANNIEEventColumnWriter::RemoveSpillFiles(){
+  for (size_t i=0; i<Columns.size(); i++){
+    if(Columns.at(i).Spill != nullptr) std::fclose(Columns.at(i).Spill);
+    Columns.at(i).Spill = nullptr;
+    std::remove(Columns.at(i).SpillFilename.c_str());
+  }
+}
+
+
+ANNIEEventColumnReader::~ANNIEEventColumnReader(){
+  this->Close();
+}
+
+bool ANNIEEventColumnReader::Open(const std::string& Filename){
+  this->Close();
+  int fd = open(Filename.c_str(), O_RDONLY);
+  if(fd < 0){
+    std::cout << "ANNIEEventColumnReader: ERROR could not open " << Filename << std::endl;
+    return false;
+  }
+  struct stat FileStat;
+  if(fstat(fd, &FileStat) != 0 || FileStat.st_size == 0){
+    std::cout << "ANNIEEventColumnReader: ERROR " << Filename << " is empty" << std::endl;
+    close(fd);
+    return false;
+  }
+  void* Mapped = mmap(nullptr, FileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(Mapped == MAP_FAILED){
+    std::cout << "ANNIEEventColumnReader: ERROR could not map " << Filename << std::endl;
+    return false;
+  }
+  Mapping = static_cast<const char*>(Mapped);
+  MappingSize = FileStat.st_size;
+
+  //Reads a value from the header, checking it lies inside Limit
+  uint64_t Pos = 0;
+  uint64_t Limit = MappingSize;
+  bool Good = true;
+  auto Read = [&](void* Value, uint64_t Size){
+    if(!Good || Pos + Size > Limit){ Good = false; return; }
+    std::memcpy(Value, Mapping + Pos, Size);
+    Pos += Size;
+  };
+  auto ReadString = [&](std::string& Value){
+    uint32_t Length = 0;
+    Read(&Length, sizeof(Length));
+    if(!Good || Pos + Length > Limit){ Good = false; return; }
+    Value.assign(Mapping + Pos, Length);
+    Pos += Length;
+  };
+
+  char Magic[sizeof(ANNIEEventColumn::MAGIC)];
+  uint32_t Version = 0;
+  uint32_t Reserved = 0;
+  Read(Magic, sizeof(Magic));
+  Read(&Version, sizeof(Version));
+  Read(&Reserved, sizeof(Reserved));
+  if(!Good || !std::equal(Magic, Magic+sizeof(Magic), ANNIEEventColumn::MAGIC) ||
+          Version != ANNIEEventColumn::VERSION){
+    std::cout << "ANNIEEventColumnReader: ERROR " << Filename << " is not an ANNIEEvent column file" << std::endl;
+    this->Close();
+    return false;
+  }
+
+  //Chunks follow each other to the end of the file.  One that does not fit was cut short.
+  while(Pos < MappingSize){
+    uint64_t ChunkStart = Pos;
+    uint64_t ChunkSize = 0;
+    uint32_t NumColumns = 0;
+    Chunk TheChunk;
+    Limit = MappingSize;
+    Read(&ChunkSize, sizeof(ChunkSize));
+    if(Good && ChunkStart + ChunkSize <= MappingSize) Limit = ChunkStart + ChunkSize;
+    else Good = false;
+    Read(&NumColumns, sizeof(NumColumns));
+    Read(&Reserved, sizeof(Reserved));
+    Read(&TheChunk.NumEvents, sizeof(TheChunk.NumEvents));
+    for (uint32_t i=0; i<NumColumns && Good; i++){
+      Column TheColumn;
+      ChunkColumn TheChunkColumn;
+      uint64_t IndexOffset = 0, DataOffset = 0;
+      ReadString(TheColumn.Name);
+      ReadString(TheColumn.Type);
+      Read(&IndexOffset, sizeof(IndexOffset));
+      Read(&DataOffset, sizeof(DataOffset));
+      Read(&TheChunkColumn.Size, sizeof(TheChunkColumn.Size));
+      if(!Good || IndexOffset + (TheChunk.NumEvents+1)*sizeof(uint64_t) > ChunkSize || DataOffset + TheChunkColumn.Size > ChunkSize){
+        Good = false;
+        break;
+      }
+      TheChunkColumn.Index = Mapping + ChunkStart + IndexOffset;
+      TheChunkColumn.Data = Mapping + ChunkStart + DataOffset;
+      std::map<std::string, size_t>::iterator it = ColumnIndex.find(TheColumn.Name);
+      if(it == ColumnIndex.end()){
+        it = ColumnIndex.emplace(TheColumn.Name, Columns.size()).first;
+        Columns.push_back(TheColumn);
+      } else if(Columns.at(it->second).Type != TheColumn.Type){
+        Good = false;
+        break;
+      }
+      if(TheChunk.Columns.size() <= it->second) TheChunk.Columns.resize(it->second+1);
+      TheChunk.Columns.at(it->second) = TheChunkColumn;
+    }
+    if(!Good){
+      std::cout << "ANNIEEventColumnReader: WARNING " << Filename << " ends in an incomplete or corrupt chunk." <<
+          "  Reading its first " << NumEvents << " events" << std::endl;
+      break;
+    }
+    ChunkFirstEvents.push_back(NumEvents);
+    NumEvents += TheChunk.NumEvents;
+    Chunks.push_back(TheChunk);
+    Pos = ChunkStart + ChunkSize;
+  }
+  return true;
+}
+
+void ANNIEEventColumnReader::Close(){
+  if(Mapping != nullptr) munmap(const_cast<char*>(Mapping), MappingSize);
+  Mapping = nullptr;
+  MappingSize = 0;
+  NumEvents = 0;
+  Columns.clear();
+  ColumnIndex.clear();
+  Chunks.clear();
+  ChunkFirstEvents.clear();
+}
+
+int ANNIEEventColumnReader::FindColumn(const std::string& Name) const{
+  std::map<std::string, size_t>::const_iterator it = ColumnIndex.find(Name);
+  if(it == ColumnIndex.end()) return -1;
+  return it->second;
+}
+
+bool ANNIEEventColumnReader::GetEntry(size_t Column, uint64_t Event, const char*& Data, uint64_t& Size) const{
+  if(Column >= Columns.size() || Event >= NumEvents) return false;
+  size_t ChunkNum = std::upper_bound(ChunkFirstEvents.begin(), ChunkFirstEvents.end(), Event) - ChunkFirstEvents.begin() - 1;
+  const Chunk& TheChunk = Chunks[ChunkNum];
+  if(Column >= TheChunk.Columns.size() || TheChunk.Columns[Column].Index == nullptr) return false;
+  const ChunkColumn& TheColumn = TheChunk.Columns[Column];
+  uint64_t ChunkEvent = Event - ChunkFirstEvents[ChunkNum];
+  uint64_t Start, End;
+  std::memcpy(&Start, TheColumn.Index + ChunkEvent*sizeof(uint64_t), sizeof(Start));
+  std::memcpy(&End, TheColumn.Index + (ChunkEvent+1)*sizeof(uint64_t), sizeof(End));
+  if(End <= Start || End > TheColumn.Size) return false;
+  Data = TheColumn.Data + Start;
+  Size = End - Start;
+  return true;
+}
@@ -0,0 +1,236 @@
+#ifndef ANNIEEVENTCOLUMNFILE_H
+#define ANNIEEVENTCOLUMNFILE_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <cstring>
+#include <typeinfo>
+#include <type_traits>
+#include <stdint.h>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+
+#include "Hit.h"
+#include "TimeClass.h"
+#include "Waveform.h"
+
+/**
+ * Columnar ANNIEEvent files.  Every ANNIEEvent key is stored as its own column: the
+ * key's entries for all events one after another, plus an index of where each event's
+ * entry starts.  A reader memory-maps the file and only touches the columns (and
+ * events) it is asked for, so reading a few keys, or jumping to event N, costs a
+ * fraction of reading whole BoostStore entries.
+ *
+ * Events are written in chunks of consecutive events, each laid out as a complete column
+ * file of its own.  A chunk is appended and flushed as soon as it is full, so a file left
+ * behind by a crash still holds every complete chunk.
+ *
+ * File layout (integers in host byte order, chunks and columns 8-byte aligned):
+ *   "ANNIECOL", uint32 version, uint32 reserved, then the chunks:
+ *   chunk header: uint64 chunk size, uint32 number of columns, uint32 reserved,
+ *     uint64 number of events
+ *   per column: uint32 name length, name, uint32 type length, type, uint64 index offset,
+ *     uint64 data offset, uint64 data size (offsets from the start of the chunk)
+ *   per column: index of (number of events + 1) uint64 offsets into the column's data,
+ *     then the data.  An event without the key has an empty entry.
+ *
+ * Entries are boost binary archives, except hit maps (std::map<unsigned long,
+ * std::vector<Hit>>, e.g. Hits and TDCData), which are stored as a uint64 hit count
+ * followed by fixed-width ColumnHit records, read without going through boost.  MCHit
+ * maps add each hit's parent indices after its record.  Maps of other Hit subclasses
+ * have no column encoding and are rejected at compile time.
+ */
+
+namespace ANNIEEventColumn {
+  const char MAGIC[8] = {'A','N','N','I','E','C','O','L'};
+  const uint32_t VERSION = 2;
+  const unsigned int ARCHIVE_FLAGS = boost::archive::no_header;
+
+  typedef std::map<unsigned long, std::vector<Hit>> HitMap;
+  typedef std::map<unsigned long, std::vector<MCHit>> MCHitMap;
+  typedef std::map<unsigned long, std::vector<Waveform<uint16_t>>> WaveformMap;
+  typedef std::map<std::string, int> StringIntMap;
+
+  //Fixed-width entry of a hit map column
+  struct ColumnHit {
+    uint64_t ChannelKey;
+    int64_t TubeId;
+    double Time;
+    double Charge;
+  };
+
+  //Type names stored with each column, so readers can tell how to load it
+  template<class T> struct Type { static std::string Name(){ return typeid(T).name(); } };
+  #define ANNIEEVENTCOLUMN_TYPE(T, NAME) template<> struct Type<T> { static std::string Name(){ return NAME; } };
+  ANNIEEVENTCOLUMN_TYPE(int, "int")
+  ANNIEEVENTCOLUMN_TYPE(uint32_t, "uint32")
+  ANNIEEVENTCOLUMN_TYPE(uint64_t, "uint64")
+  ANNIEEVENTCOLUMN_TYPE(double, "double")
+  ANNIEEVENTCOLUMN_TYPE(bool, "bool")
+  ANNIEEVENTCOLUMN_TYPE(std::string, "string")
+  ANNIEEVENTCOLUMN_TYPE(TimeClass, "TimeClass")
+  ANNIEEVENTCOLUMN_TYPE(HitMap, "HitMap")
+  ANNIEEVENTCOLUMN_TYPE(MCHitMap, "MCHitMap")
+  ANNIEEVENTCOLUMN_TYPE(std::vector<Hit>, "HitVector")
+  ANNIEEVENTCOLUMN_TYPE(StringIntMap, "StringIntMap")
+  ANNIEEVENTCOLUMN_TYPE(WaveformMap, "WaveformMapUInt16")
+  #undef ANNIEEVENTCOLUMN_TYPE
+
+  //Maps of Hit subclasses other than MCHit.  They have no column type, so would be stored
+  //under a compiler-specific type name that no reader loads
+  template<class T> struct IsSlicedHitMap : std::false_type {};
+  template<class K, class H> struct IsSlicedHitMap<std::map<K, std::vector<H>>> :
+    std::integral_constant<bool, std::is_base_of<Hit, H>::value && !std::is_same<H, Hit>::value &&
+        !std::is_same<H, MCHit>::value> {};
+
+  //Serialises a value as a column entry
+  template<class T> void Encode(std::string& Entry, const T& Value){
+    static_assert(!IsSlicedHitMap<T>::value, "ANNIEEventColumn: this hit map type has no column encoding");
+    boost::iostreams::back_insert_device<std::string> inserter(Entry);
+    boost::iostreams::stream<boost::iostreams::back_insert_device<std::string> > s(inserter);
+    {
+      boost::archive::binary_oarchive oa(s, ARCHIVE_FLAGS);
+      oa << Value;
+    }
+    s.flush();
+  }
+  void Encode(std::string& Entry, const HitMap& Value);
+  void Encode(std::string& Entry, const MCHitMap& Value);
+
+  //Restores a value from a column entry
+  template<class T> void Decode(const char* Entry, uint64_t Size, T& Value){
+    boost::iostreams::basic_array_source<char> device(Entry, Size);
+    boost::iostreams::stream<boost::iostreams::basic_array_source<char> > s(device);
+    boost::archive::binary_iarchive ia(s, ARCHIVE_FLAGS);
+    ia >> Value;
+  }
+  void Decode(const char* Entry, uint64_t Size, HitMap& Value);
+  void Decode(const char* Entry, uint64_t Size, MCHitMap& Value);
+}
+
+/**
+ * \class ANNIEEventColumnWriter
+ *
+ * Writes a columnar ANNIEEvent file.  Each column's entries are spilled to a temporary
+ * file next to the output while events are added, and every EventsPerChunk events the
+ * chunk is appended to the output and flushed.  Close() writes the last, partial chunk.
+ */
+class ANNIEEventColumnWriter {
+
+ public:
+
+  ~ANNIEEventColumnWriter();
+
+  bool Open(const std::string& Filename);  ///< Starts a new file, closing any open one
+  bool Close();  ///< Writes the last chunk, then removes the temporary files
+  void SetEventsPerChunk(int Events) {EventsPerChunk = (Events > 0) ? Events : 1;}
+  bool IsOpen() const {return !CurrentFilename.empty();}
+  const std::string& GetFilename() const {return CurrentFilename;}
+  uint64_t GetNumEvents() const {return NumEvents;}
+
+  template<class T> bool SetEventMember(const std::string& Name, const T& Value){
+    Entry.clear();
+    ANNIEEventColumn::Encode(Entry, Value);
+    return this->AddEntry(Name, ANNIEEventColumn::Type<T>::Name(), Entry);
+  }
+  bool WriteEvent();  ///< Ends the current event, writing out the chunk once it is full
+
+ private:
+
+  struct Column {
+    std::string Name;
+    std::string Type;
+    std::string SpillFilename;
+    std::FILE* Spill = nullptr;
+    uint64_t Size = 0;  //Bytes spilled for the current chunk
+    std::vector<uint64_t> Offsets;  //Start of each of the current chunk's entries
+  };
+
+  bool AddEntry(const std::string& Name, const std::string& Type, const std::string& Data);
+  bool WriteChunk();
+  void RemoveSpillFiles();
+
+  std::string CurrentFilename;
+  std::FILE* OutFile = nullptr;
+  bool WriteFailed = false;  //Once a chunk is only partly written, later chunks are dropped
+  std::vector<Column> Columns;
+  std::map<std::string, size_t> ColumnIndex;  //Key: column name.  Value: index in Columns
+  uint64_t NumEvents = 0;
+  uint64_t ChunkFirstEvent = 0;  //First event of the chunk being collected
+  int EventsPerChunk = 100;
+  std::string Entry;  //Reused buffer for serialising entries
+
+};
+
+/**
+ * \class ANNIEEventColumnReader
+ *
+ * Memory-maps a columnar ANNIEEvent file.  Entries are only read (and deserialised)
+ * when they are asked for, and any event can be read directly.  A file whose last chunk
+ * was cut short (the writer crashed) is read up to the end of its last complete chunk.
+ */
+class ANNIEEventColumnReader {
+
+ public:
+
+  ~ANNIEEventColumnReader();
+
+  bool Open(const std::string& Filename);
+  void Close();
+  uint64_t GetNumEvents() const {return NumEvents;}
+  size_t GetNumColumns() const {return Columns.size();}
+  const std::string& GetColumnName(size_t Column) const {return Columns.at(Column).Name;}
+  const std::string& GetColumnType(size_t Column) const {return Columns.at(Column).Type;}
+  int FindColumn(const std::string& Name) const;  ///< Index of the named column, or -1
+
+  bool GetEntry(size_t Column, uint64_t Event, const char*& Data, uint64_t& Size) const;  ///< False if the event has no entry in the column
+  template<class T> bool Get(size_t Column, uint64_t Event, T& Value) const{
+    const char* Data;
+    uint64_t Size;
+    if(!this->GetEntry(Column, Event, Data, Size)) return false;
+    ANNIEEventColumn::Decode(Data, Size, Value);
+    return true;
+  }
+  template<class T> bool Get(const std::string& Name, uint64_t Event, T& Value) const{
+    int Column = this->FindColumn(Name);
+    if(Column < 0) return false;
+    return this->Get(Column, Event, Value);
+  }
+
+ private:
+
+  struct Column {
+    std::string Name;
+    std::string Type;
+  };
+  //A column's entries within one chunk
+  struct ChunkColumn {
+    const char* Index = nullptr;  //(chunk events + 1) uint64 offsets into Data.  nullptr if the chunk lacks the column
+    const char* Data = nullptr;
+    uint64_t Size = 0;
+  };
+  struct Chunk {
+    uint64_t NumEvents;
+    std::vector<ChunkColumn> Columns;  //Indexed like Columns; columns first written in later chunks are missing
+  };
+
+  const char* Mapping = nullptr;
+  size_t MappingSize = 0;
+  uint64_t NumEvents = 0;
+  std::vector<Column> Columns;
+  std::map<std::string, size_t> ColumnIndex;
+  std::vector<Chunk> Chunks;
+  std::vector<uint64_t> ChunkFirstEvents;
+
+};
+
+#endif
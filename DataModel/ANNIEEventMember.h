@@ -0,0 +1,58 @@
+#ifndef ANNIEEVENTMEMBER_H
+#define ANNIEEVENTMEMBER_H
+
+#include <string>
+#include <utility>
+#include <type_traits>
+
+#include "BoostStore.h"
+
+/**
+ * Shared access to large ANNIEEvent members (waveform and pulse maps).
+ *
+ * Getting a member by value deserialises a full copy of it for every tool that reads
+ * it, and setting one by value serialises another.  Members published with Publish()
+ * are instead held by the store through a pointer, and every tool reading them with
+ * Get() is handed that same object.  A member read with Get() that was set by value
+ * (e.g. loaded from a file) is deserialised once, on the first Get(), and shared from
+ * then on.  A later by-value Set() does not replace that shared copy, and the store
+ * gives no way to tell that it is stale, so Publish() is the only way these members are
+ * written: every tool that writes one, and every tool that reads one, goes through here.
+ *
+ * Persist is given at every Publish().  Members loaded or built from raw data are
+ * persisted, so they are saved with the event; intermediate products (calibrated
+ * waveforms, pulses) are only persisted when the producing tool is configured to,
+ * as persisting serialises a full copy of the member on every event.
+ *
+ * Lifetime: the store owns the object.  It stays valid until the member is published
+ * again or the store's Delete() is called at the end of the event, so tools must not
+ * delete it or hold on to it across events.  Readers get a const pointer; a tool that
+ * changes a member publishes a new one under its own name.
+ */
+
+namespace ANNIEEventMember {
+
+  //Moves Value into a new object owned by Store.  Persist: whether it is saved with the event.
+  template<class T> typename std::decay<T>::type* Publish(BoostStore* Store, const std::string& Name, T&& Value, bool Persist){
+    typedef typename std::decay<T>::type Member;
+    Member* Shared = new Member(std::forward<T>(Value));
+    Store->Set(Name, Shared, Persist);
+    return Shared;
+  }
+
+  //The shared member, or nullptr if the store does not have it
+  template<class T> const T* Get(BoostStore* Store, const std::string& Name){
+    T* Shared = nullptr;
+    if(!Store->Get(Name, Shared)) return nullptr;
+    return Shared;
+  }
+
+  //The shared member, or Empty if the store does not have it.  Empty must outlive the reference returned.
+  template<class T> const T& Get(BoostStore* Store, const std::string& Name, const T& Empty){
+    const T* Shared = Get<T>(Store, Name);
+    return Shared ? *Shared : Empty;
+  }
+
+}
+
+#endif
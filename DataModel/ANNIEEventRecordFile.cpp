@@ -0,0 +1,233 @@
+#include "ANNIEEventRecordFile.h"
+
+#include <algorithm>
+#include <iostream>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+#include <boost/iostreams/copy.hpp>
+
+ANNIEEventRecordWriter::ANNIEEventRecordWriter(){}
+
+ANNIEEventRecordWriter::~ANNIEEventRecordWriter(){
+  this->Close();
+}
+
+bool ANNIEEventRecordWriter::Open(const std::string& Filename){
+  this->Close();
+  //Records are appended to an existing file, like BoostStore::Save does
+  std::ifstream Existing(Filename.c_str(), std::ios::in | std::ios::binary | std::ios::ate);
+  bool HasHeader = Existing.is_open() && Existing.tellg() > 0;
+  Existing.close();
+  OutFile.open(Filename.c_str(), std::ios::out | std::ios::binary | std::ios::app);
+  if(!OutFile.is_open()){
+    std::cout << "ANNIEEventRecordWriter: ERROR could not open " << Filename << " for writing" << std::endl;
+    return false;
+  }
+  CurrentFilename = Filename;
+  if(!HasHeader){
+    OutFile.write(ANNIEEventRecord::MAGIC, sizeof(ANNIEEventRecord::MAGIC));
+    OutFile.write(reinterpret_cast<const char*>(&ANNIEEventRecord::VERSION), sizeof(ANNIEEventRecord::VERSION));
+  }
+  RunPayload.clear();
+  EventPayload.clear();
+  NumRunMembers = 0;
+  NumEventMembers = 0;
+  NumEventsWritten = 0;
+  return true;
+}
+
+bool ANNIEEventRecordWriter::Close(){
+  if(!OutFile.is_open()) return true;
+  bool Flushed = this->Flush();
+  OutFile.close();
+  CurrentFilename.clear();
+  return Flushed;
+}
+
+void ANNIEEventRecordWriter::AppendRecord(uint8_t RecordType, const std::string& Payload, uint32_t NumMembers){
+  Uncompressed.clear();
+  Uncompressed.append(reinterpret_cast<const char*>(&NumMembers), sizeof(NumMembers));
+  Uncompressed.append(Payload);
+
+  //Reserve the record's length prefix and type, then compress the payload in after them
+  size_t RecordStart = Batch.size();
+  uint32_t RecordLength = 0;
+  Batch.append(reinterpret_cast<const char*>(&RecordLength), sizeof(RecordLength));
+  Batch.append(reinterpret_cast<const char*>(&RecordType), sizeof(RecordType));
+  {
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::zlib_compressor(boost::iostreams::zlib_params(CompressionLevel)));
+    out.push(boost::iostreams::back_inserter(Batch));
+    out.write(Uncompressed.data(), Uncompressed.size());
+  }
+  RecordLength = Batch.size() - RecordStart - sizeof(RecordLength) - sizeof(RecordType);
+  Batch.replace(RecordStart, sizeof(RecordLength), reinterpret_cast<const char*>(&RecordLength), sizeof(RecordLength));
+  return;
+}
+
+bool ANNIEEventRecordWriter::WriteEvent(){
+  if(!OutFile.is_open()){
+    std::cout << "ANNIEEventRecordWriter: ERROR no file open.  Event not written" << std::endl;
+    return false;
+  }
+  if(NumRunMembers > 0){
+    this->AppendRecord(ANNIEEventRecord::RUN_RECORD, RunPayload, NumRunMembers);
+    RunPayload.clear();
+    NumRunMembers = 0;
+  }
+  this->AppendRecord(ANNIEEventRecord::EVENT_RECORD, EventPayload, NumEventMembers);
+  EventPayload.clear();
+  NumEventMembers = 0;
+  NumEventsWritten+=1;
+  EventsInBatch+=1;
+  if(EventsInBatch >= EventsPerFlush) return this->Flush();
+  return true;
+}
+
+bool ANNIEEventRecordWriter::Flush(){
+  if(!OutFile.is_open()) return false;
+  if(!Batch.empty()) OutFile.write(Batch.data(), Batch.size());
+  OutFile.flush();
+  Batch.clear();
+  EventsInBatch = 0;
+  return OutFile.good();
+}
+
+
+bool ANNIEEventRecordReader::Open(const std::string& Filename){
+  this->Close();
+  InFile.open(Filename.c_str(), std::ios::in | std::ios::binary);
+  if(!InFile.is_open()){
+    std::cout << "ANNIEEventRecordReader: ERROR could not open " << Filename << std::endl;
+    return false;
+  }
+  char Magic[sizeof(ANNIEEventRecord::MAGIC)];
+  uint32_t Version = 0;
+  InFile.read(Magic, sizeof(Magic));
+  InFile.read(reinterpret_cast<char*>(&Version), sizeof(Version));
+  if(!InFile.good() || !std::equal(Magic, Magic+sizeof(Magic), ANNIEEventRecord::MAGIC) ||
+          Version != ANNIEEventRecord::VERSION){
+    std::cout << "ANNIEEventRecordReader: ERROR " << Filename << " is not a version "
+              << ANNIEEventRecord::VERSION << " ANNIEEvent record file" << std::endl;
+    InFile.close();
+    return false;
+  }
+  CurrentFilename = Filename;
+
+  //Index the records, skipping over their payloads
+  InFile.seekg(0, std::ios::end);
+  std::streamoff FileSize = InFile.tellg();
+  std::streamoff Offset = sizeof(Magic) + sizeof(Version);
+  std::streamoff RunOffset = -1;
+  const std::streamoff HeaderSize = sizeof(uint32_t) + sizeof(uint8_t);
+  while(Offset + HeaderSize <= FileSize){
+    uint32_t RecordLength = 0;
+    uint8_t RecordType = 0;
+    InFile.seekg(Offset);
+    InFile.read(reinterpret_cast<char*>(&RecordLength), sizeof(RecordLength));
+    InFile.read(reinterpret_cast<char*>(&RecordType), sizeof(RecordType));
+    if(!InFile.good() || Offset + HeaderSize + RecordLength > FileSize) break;
+    if(RecordType == ANNIEEventRecord::RUN_RECORD) RunOffset = Offset;
+    else if(RecordType == ANNIEEventRecord::EVENT_RECORD){
+      EventOffsets.push_back(Offset);
+      EventRunOffsets.push_back(RunOffset);
+    }
+    Offset += HeaderSize + RecordLength;
+  }
+  if(Offset != FileSize){
+    std::cout << "ANNIEEventRecordReader: WARNING " << Filename << " ends in an incomplete record,"
+              << " which is skipped" << std::endl;
+  }
+  InFile.clear();
+  return true;
+}
+
+bool ANNIEEventRecordReader::Close(){
+  if(InFile.is_open()) InFile.close();
+  CurrentFilename.clear();
+  EventOffsets.clear();
+  EventRunOffsets.clear();
+  LoadedRunOffset = -1;
+  NextEvent = 0;
+  EventMembers.clear();
+  RunConstants.clear();
+  return true;
+}
+
+bool ANNIEEventRecordReader::ReadRecord(std::streamoff Offset){
+  uint32_t RecordLength = 0;
+  uint8_t RecordType = 0;
+  InFile.clear();
+  InFile.seekg(Offset);
+  InFile.read(reinterpret_cast<char*>(&RecordLength), sizeof(RecordLength));
+  InFile.read(reinterpret_cast<char*>(&RecordType), sizeof(RecordType));
+  if(!InFile.good()) return false;
+  Compressed.resize(RecordLength);
+  InFile.read(&Compressed[0], RecordLength);
+  if(!InFile.good()) return false;
+  Payload.clear();
+  try {
+    boost::iostreams::filtering_istream in;
+    in.push(boost::iostreams::zlib_decompressor());
+    in.push(boost::iostreams::array_source(Compressed.data(), Compressed.size()));
+    boost::iostreams::copy(in, boost::iostreams::back_inserter(Payload));
+  } catch (const std::exception& e) {
+    std::cout << "ANNIEEventRecordReader: ERROR could not decompress the record at byte " << Offset
+              << " of " << CurrentFilename << ": " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ANNIEEventRecordReader::UnpackMembers(std::map<std::string, ANNIEEventRecord::Member>& Members){
+  //Every length is checked against what is left of the payload before it is used
+  const char* p = Payload.data();
+  const char* End = p + Payload.size();
+  auto ReadLength = [&](uint32_t& Length){
+    if(End - p < (std::ptrdiff_t)sizeof(Length)) return false;
+    std::copy(p, p+sizeof(Length), reinterpret_cast<char*>(&Length));
+    p += sizeof(Length);
+    return true;
+  };
+  auto ReadString = [&](std::string& Value){
+    uint32_t Length;
+    if(!ReadLength(Length) || (uint64_t)(End - p) < Length) return false;
+    Value.assign(p, Length);
+    p += Length;
+    return true;
+  };
+
+  uint32_t NumMembers;
+  bool Good = ReadLength(NumMembers);
+  for (uint32_t i=0; Good && i<NumMembers; i++){
+    std::string Name;
+    ANNIEEventRecord::Member Read;
+    Good = ReadString(Name) && ReadString(Read.Type) && ReadString(Read.Data);
+    if(Good) Members[Name] = std::move(Read);
+  }
+  if(!Good){
+    std::cout << "ANNIEEventRecordReader: ERROR corrupt record in " << CurrentFilename << std::endl;
+  }
+  return Good;
+}
+
+bool ANNIEEventRecordReader::ReadEvent(uint64_t Event){
+  if(Event >= EventOffsets.size()) return false;
+  std::streamoff RunOffset = EventRunOffsets.at(Event);
+  if(RunOffset != LoadedRunOffset){
+    RunConstants.clear();
+    LoadedRunOffset = -1;
+    if(RunOffset >= 0){
+      if(!this->ReadRecord(RunOffset) || !this->UnpackMembers(RunConstants)) return false;
+      LoadedRunOffset = RunOffset;
+    }
+  }
+  EventMembers.clear();
+  if(!this->ReadRecord(EventOffsets.at(Event)) || !this->UnpackMembers(EventMembers)) return false;
+  NextEvent = Event + 1;
+  return true;
+}
+
+bool ANNIEEventRecordReader::ReadNextEvent(){
+  return this->ReadEvent(NextEvent);
+}
@@ -0,0 +1,177 @@
+#ifndef ANNIEEVENTRECORDFILE_H
+#define ANNIEEVENTRECORDFILE_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include <fstream>
+#include <stdint.h>
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/iostreams/stream.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#include <boost/iostreams/device/array.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+
+#include "ANNIEEventColumnFile.h"
+
+/**
+ * \class ANNIEEventRecordWriter
+ *
+ * Append-only ANNIEEvent output.  Each event is written as a single length-prefixed,
+ * zlib-compressed record holding its members, each serialised with a boost binary
+ * archive.  Run-level constants (run number, run type, start time...) are written
+ * once per file in a run record ahead of the first event, instead of with every
+ * event.  Records are collected in memory and written out every EventsPerFlush events.
+ *
+ * File layout:  "ANNIEREC", uint32 version, then records of
+ *   uint32 compressed payload length, uint8 record type, compressed payload
+ * Uncompressed payload: uint32 number of members, then per member
+ *   uint32 name length, name, uint32 type length, type name (as in ANNIEEventColumn::Type),
+ *   uint32 data length, binary archive of the member
+ * Integers are in host byte order.
+ */
+
+namespace ANNIEEventRecord {
+  const char MAGIC[8] = {'A','N','N','I','E','R','E','C'};
+  const uint32_t VERSION = 2;
+  const uint8_t RUN_RECORD = 1;
+  const uint8_t EVENT_RECORD = 2;
+  const unsigned int ARCHIVE_FLAGS = boost::archive::no_header;
+
+  //A member of a record as read back: its type name and serialised value
+  struct Member {
+    std::string Type;
+    std::string Data;
+  };
+
+  //Appends a length-prefixed string to a record payload
+  inline void AppendString(std::string& Payload, const std::string& Value){
+    uint32_t Length = Value.size();
+    Payload.append(reinterpret_cast<const char*>(&Length), sizeof(Length));
+    Payload.append(Value);
+  }
+
+  //Appends a member (name, type name, serialised value) to an uncompressed record payload
+  template<class T> void AppendMember(std::string& Payload, const std::string& Name, const T& Value){
+    AppendString(Payload, Name);
+    AppendString(Payload, ANNIEEventColumn::Type<T>::Name());
+    size_t LengthPos = Payload.size();
+    uint32_t DataLength = 0;
+    Payload.append(reinterpret_cast<const char*>(&DataLength), sizeof(DataLength));
+    {
+      boost::iostreams::back_insert_device<std::string> inserter(Payload);
+      boost::iostreams::stream<boost::iostreams::back_insert_device<std::string> > s(inserter);
+      {
+        boost::archive::binary_oarchive oa(s, ARCHIVE_FLAGS);
+        oa << Value;
+      }
+      s.flush();
+    }
+    DataLength = Payload.size() - LengthPos - sizeof(DataLength);
+    Payload.replace(LengthPos, sizeof(DataLength), reinterpret_cast<const char*>(&DataLength), sizeof(DataLength));
+  }
+}
+
+class ANNIEEventRecordWriter {
+
+ public:
+
+  ANNIEEventRecordWriter();
+  ~ANNIEEventRecordWriter();
+
+  bool Open(const std::string& Filename);  ///< Opens a file for appending, closing any open one.  Run constants must be set again.
+  bool Close();  ///< Flushes and closes the file
+  bool IsOpen() const {return OutFile.is_open();}
+  const std::string& GetFilename() const {return CurrentFilename;}
+  void SetEventsPerFlush(int Events) {EventsPerFlush = (Events > 0) ? Events : 1;}
+  void SetCompressionLevel(int Level) {CompressionLevel = Level;}
+  unsigned long GetNumEventsWritten() const {return NumEventsWritten;}
+
+  template<class T> void SetRunConstant(const std::string& Name, const T& Value){
+    ANNIEEventRecord::AppendMember(RunPayload, Name, Value);
+    NumRunMembers+=1;
+  }
+  template<class T> void SetEventMember(const std::string& Name, const T& Value){
+    ANNIEEventRecord::AppendMember(EventPayload, Name, Value);
+    NumEventMembers+=1;
+  }
+  bool WriteEvent();  ///< Writes the members set since the last event as one record (preceded by any new run constants)
+  bool Flush();  ///< Writes the batched records to the file
+
+ private:
+
+  void AppendRecord(uint8_t RecordType, const std::string& Payload, uint32_t NumMembers);
+
+  std::ofstream OutFile;
+  std::string CurrentFilename;
+  std::string RunPayload;
+  std::string EventPayload;
+  uint32_t NumRunMembers = 0;
+  uint32_t NumEventMembers = 0;
+  std::string Batch;  //Compressed records waiting to be written
+  std::string Uncompressed;  //Reused buffer for a record's uncompressed payload
+  int EventsInBatch = 0;
+  int EventsPerFlush = 100;
+  int CompressionLevel = 1;
+  unsigned long NumEventsWritten = 0;
+
+};
+
+/**
+ * \class ANNIEEventRecordReader
+ *
+ * Reads files written by ANNIEEventRecordWriter one event at a time.  Run constants
+ * from the file's run records are available alongside each event's members.  Open()
+ * indexes the records, so events can be read in any order; a record cut short at the
+ * end of the file (e.g. by a crash before the last flush completed) is left out.
+ */
+class ANNIEEventRecordReader {
+
+ public:
+
+  bool Open(const std::string& Filename);
+  bool Close();
+  uint64_t GetNumEvents() const {return EventOffsets.size();}
+  bool ReadEvent(uint64_t Event);  ///< Loads an event's members, and the run constants in force for it
+  bool ReadNextEvent();  ///< Loads the event after the last one read.  Returns false at the end of the file.
+
+  bool Has(const std::string& Name) const {return EventMembers.count(Name) || RunConstants.count(Name);}
+  const std::map<std::string, ANNIEEventRecord::Member>& GetEventMembers() const {return EventMembers;}
+  const std::map<std::string, ANNIEEventRecord::Member>& GetRunConstants() const {return RunConstants;}
+  template<class T> bool Get(const std::string& Name, T& Value) const{
+    std::map<std::string, ANNIEEventRecord::Member>::const_iterator it = EventMembers.find(Name);
+    if(it == EventMembers.end()){
+      it = RunConstants.find(Name);
+      if(it == RunConstants.end()) return false;
+    }
+    const std::string& Data = it->second.Data;
+    boost::iostreams::basic_array_source<char> device(Data.data(), Data.size());
+    boost::iostreams::stream<boost::iostreams::basic_array_source<char> > s(device);
+    boost::archive::binary_iarchive ia(s, ANNIEEventRecord::ARCHIVE_FLAGS);
+    ia >> Value;
+    return true;
+  }
+
+ private:
+
+  bool ReadRecord(std::streamoff Offset);
+  bool UnpackMembers(std::map<std::string, ANNIEEventRecord::Member>& Members);
+
+  std::ifstream InFile;
+  std::string CurrentFilename;
+  std::string Compressed;
+  std::string Payload;
+  std::vector<std::streamoff> EventOffsets;  //File offset of each event record
+  std::vector<std::streamoff> EventRunOffsets;  //File offset of the run record before each event (-1: none)
+  std::streamoff LoadedRunOffset = -1;
+  uint64_t NextEvent = 0;
+  std::map<std::string, ANNIEEventRecord::Member> EventMembers;
+  std::map<std::string, ANNIEEventRecord::Member> RunConstants;
+
+};
+
+#endif
@@ -14,6 +14,10 @@ template <typename T> class CalibratedADCWaveform : public Waveform<T> {
       double baseline, double sigma_bl)
       : Waveform<T>(tc, samples), fBaseline(baseline),
       fSigmaBaseline(sigma_bl) {}
+    CalibratedADCWaveform(const double& tc, std::vector<T>&& samples,
+      double baseline, double sigma_bl)
+      : Waveform<T>(tc, std::move(samples)), fBaseline(baseline),
+      fSigmaBaseline(sigma_bl) {}
 
     inline double GetBaseline() const { return fBaseline; }
     inline double GetSigmaBaseline() const { return fSigmaBaseline; }
@@ -4,6 +4,7 @@
 //#include <stdint.h>
 #include <iostream>
 #include <vector>
+#include <map>
 //#include <array>
 #include <stdlib.h>
 #include "zmq.hpp"
@@ -42,5 +43,17 @@ class CardData : public SerialisableObject{
   
 };
 
+//Packed {CardID, ChannelID} key for tank PMT waveforms.  The ChannelID is the 8-bit
+//ID from a frame header and CardID = CrateNum*1000 + SlotNum.
+typedef uint32_t CardChannelKey;
+
+inline CardChannelKey MakeCardChannelKey(int CardID, int ChannelID){
+  return ((uint32_t)CardID << 8) | ((uint32_t)ChannelID & 0xff);
+}
+inline int CardChannelKeyToCardID(CardChannelKey key){ return (int)(key >> 8); }
+inline int CardChannelKeyToChannelID(CardChannelKey key){ return (int)(key & 0xff); }
+
+//Waveforms of one trigger. Key: {CardID,ChannelID}. Value: finished waveform
+typedef std::map<CardChannelKey, std::vector<uint16_t>> TankWaveMap;
 
 #endif
@@ -0,0 +1,46 @@
+#include "CrateSpaceTable.h"
+
+#include <algorithm>
+
+void CrateSpaceTable::AddCrateMap(const std::map<std::vector<int>,int>& CrateMap, ChannelType Type){
+  for(const std::pair<const std::vector<int>,int>& apair : CrateMap){
+    if(apair.first.size() < 3 || apair.first.at(0) < 0 || apair.first.at(1) < 0 || apair.first.at(2) < 0) continue;
+    Entry& anentry = this->Add(apair.first.at(0), apair.first.at(1), apair.first.at(2));
+    anentry.ChannelKey = apair.second;
+    anentry.Type = Type;
+  }
+}
+
+void CrateSpaceTable::SetLoopback(int Crate, int Slot, int Channel, LoopbackRole Role){
+  if(Crate < 0 || Slot < 0 || Channel < 0) return;
+  Entry& anentry = this->Add(Crate, Slot, Channel);
+  anentry.Type = Loopback;
+  anentry.Role = Role;
+}
+
+size_t CrateSpaceTable::Size(ChannelType Type) const {
+  return std::count_if(Entries.begin(), Entries.end(), [Type](const Entry& anentry){ return anentry.Type == Type; });
+}
+
+CrateSpaceTable::Entry& CrateSpaceTable::Add(int Crate, int Slot, int Channel){
+  //Grow the table to hold the new entry, keeping the existing ones
+  if(Crate >= NumCrates || Slot >= NumSlots || Channel >= NumChannels){
+    int NewNumCrates = std::max(NumCrates, Crate+1);
+    int NewNumSlots = std::max(NumSlots, Slot+1);
+    int NewNumChannels = std::max(NumChannels, Channel+1);
+    std::vector<Entry> NewEntries(NewNumCrates*NewNumSlots*NewNumChannels);
+    for(int i_crate = 0; i_crate < NumCrates; i_crate++){
+      for(int i_slot = 0; i_slot < NumSlots; i_slot++){
+        for(int i_channel = 0; i_channel < NumChannels; i_channel++){
+          NewEntries[(i_crate*NewNumSlots + i_slot)*NewNumChannels + i_channel] =
+              Entries[(i_crate*NumSlots + i_slot)*NumChannels + i_channel];
+        }
+      }
+    }
+    Entries.swap(NewEntries);
+    NumCrates = NewNumCrates;
+    NumSlots = NewNumSlots;
+    NumChannels = NewNumChannels;
+  }
+  return Entries[(Crate*NumSlots + Slot)*NumChannels + Channel];
+}
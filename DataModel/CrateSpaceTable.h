@@ -0,0 +1,75 @@
+#ifndef CRATESPACETABLE_H
+#define CRATESPACETABLE_H
+
+#include <map>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/vector.hpp>
+
+/**
+ * \class CrateSpaceTable
+ *
+ * Dense lookup of the electronics space {crate, slot, channel} of a tank PMT,
+ * auxiliary or MRD channel.  One array index gives the channel key, the kind of
+ * channel and, for the MRD trigger loopbacks, which loopback it is.  Built once by
+ * LoadGeometry from the same crate map files as the *CrateSpaceToChannelNumMap maps,
+ * and shared through the CStore as "CrateSpaceTable".  Lookups outside the loaded
+ * crates, slots and channels give an entry of type None.
+ */
+
+class CrateSpaceTable {
+
+ public:
+
+  enum ChannelType : uint8_t { None = 0, TankPMT, Aux, MRD, Loopback };
+  enum LoopbackRole : uint8_t { NoLoopback = 0, BeamLoopback, CosmicLoopback };
+
+  struct Entry {
+    int ChannelKey = -1;
+    ChannelType Type = None;
+    LoopbackRole Role = NoLoopback;
+
+    template <class Archive> void serialize(Archive& ar, const unsigned int version){
+      ar & ChannelKey;
+      ar & Type;
+      ar & Role;
+    }
+  };
+
+  //Adds every {crate, slot, channel} -> channel key entry of a crate map
+  void AddCrateMap(const std::map<std::vector<int>,int>& CrateMap, ChannelType Type);
+  //Marks an electronics channel as an MRD trigger loopback
+  void SetLoopback(int Crate, int Slot, int Channel, LoopbackRole Role);
+
+  const Entry& Get(int Crate, int Slot, int Channel) const {
+    if(Crate < 0 || Slot < 0 || Channel < 0 || Crate >= NumCrates || Slot >= NumSlots || Channel >= NumChannels) return EmptyEntry;
+    return Entries[(Crate*NumSlots + Slot)*NumChannels + Channel];
+  }
+
+  size_t Size(ChannelType Type) const;
+
+ private:
+
+  friend class boost::serialization::access;
+
+  //only needed to put a CrateSpaceTable pointer in a BoostStore; the CStore keeps it unserialised
+  template <class Archive> void serialize(Archive& ar, const unsigned int version){
+    ar & NumCrates;
+    ar & NumSlots;
+    ar & NumChannels;
+    ar & Entries;
+  }
+
+  Entry& Add(int Crate, int Slot, int Channel);
+
+  int NumCrates = 0;
+  int NumSlots = 0;
+  int NumChannels = 0;
+  std::vector<Entry> Entries;  //Indexed by (Crate*NumSlots + Slot)*NumChannels + Channel
+  Entry EmptyEntry;
+
+};
+
+#endif
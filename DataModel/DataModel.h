@@ -34,6 +34,7 @@
 #include "RecoVertex.h"
 #include "RecoRing.h"
 #include "MRDOut.h"
+#include "MrdTrack.h"
 #include "Channel.h"
 #include "LAPPDPulse.h"
 #include "CardData.h"
@@ -24,7 +24,24 @@ void FoMCalculator::LoadVertexGeometry(VertexGeometry* vtxgeo) {
 }
 
 
-void FoMCalculator::TimePropertiesLnL(double vtxTime, double& vtxFOM)
+void FoMCalculator::TimePropertiesLnL(double vtxTime, double& vtxFOM, double* dFoMdTime)
+{
+  if( dFoMdTime==0 ){
+    this->TimeLnL(vtxTime, vtxFOM, 0);
+    return;
+  }
+
+  // delta = residual - vtxTime, so d(fom)/d(vtxTime) = -sum of d(fom)/d(delta)
+  fDFoMdDelta.resize(this->fVtxGeo->GetNDigits());
+  this->TimeLnL(vtxTime, vtxFOM, fDFoMdDelta.data());
+  *dFoMdTime = 0.0;
+  for( int idigit=0; idigit<this->fVtxGeo->GetNDigits(); idigit++ ){
+    *dFoMdTime -= fDFoMdDelta[idigit];
+  }
+  return;
+}
+
+void FoMCalculator::TimeLnL(double vtxTime, double& vtxFOM, double* dFoMdDelta)
 { 
   // internal variables
   // ==================
@@ -70,6 +87,8 @@ void FoMCalculator::TimePropertiesLnL(double vtxTime, double& vtxFOM)
       P = (1.0-Pnoise)*Preal + Pnoise; 
       chi2 += -2.0*log(P);
       ndof += 1.0; 
+      // d(chi2)/d(delta), scaled to d(fom)/d(delta) below
+      if( dFoMdDelta ) dFoMdDelta[idigit] = 2.0*(1.0-Pnoise)*Preal*delta/(P*sigma*sigma);
   }	
 
   // calculate figure of merit
@@ -77,6 +96,12 @@ void FoMCalculator::TimePropertiesLnL(double vtxTime, double& vtxFOM)
     fom = fBaseFOM - 5.0*chi2/ndof;
   }  
 
+  if( dFoMdDelta ){
+    for( int idigit=0; idigit<this->fVtxGeo->GetNDigits(); idigit++ ){
+      dFoMdDelta[idigit] *= -5.0/ndof;
+    }
+  }
+
   // return figure of merit
   // ======================
   vtxFOM = fom;
@@ -87,6 +112,11 @@ void FoMCalculator::TimePropertiesLnL(double vtxTime, double& vtxFOM)
 
 
 void FoMCalculator::ConePropertiesFoM(double coneEdge, double& coneFOM)
+{
+  this->ConeFoM(coneEdge, coneFOM, 0);
+}
+
+void FoMCalculator::ConeFoM(double coneEdge, double& coneFOM, double* dFoMdAngle)
 {  
   // calculate figure of merit
   // =========================
@@ -96,19 +126,26 @@ void FoMCalculator::ConePropertiesFoM(double coneEdge, double& coneFOM)
   double digitCharge = 0.0;
   double coneCharge = 0.0;
   double allCharge = 0.0;
+  double u = 0.0;
 
   double fom = -9999.;
 
   for( int idigit=0; idigit<this->fVtxGeo->GetNDigits(); idigit++ ){ 	
+    if( dFoMdAngle ) dFoMdAngle[idigit] = 0.0;
     if( this->fVtxGeo->IsFiltered(idigit) && this->fVtxGeo->GetDigitType(idigit) == RecoDigit::PMT8inch){
       deltaAngle = this->fVtxGeo->GetAngle(idigit) - coneEdge;
       digitCharge = this->fVtxGeo->GetDigitQ(idigit);
 
+      // d(coneCharge)/d(deltaAngle), scaled to d(fom)/d(angle) below
       if( deltaAngle<=0.0 ){
         coneCharge += digitCharge*( 0.75 + 0.25/( 1.0 + (deltaAngle*deltaAngle)/(coneEdgeLow*coneEdgeLow) ) );
+        u = 1.0 + (deltaAngle*deltaAngle)/(coneEdgeLow*coneEdgeLow);
+        if( dFoMdAngle ) dFoMdAngle[idigit] = -digitCharge*0.25*(2.0*deltaAngle/(coneEdgeLow*coneEdgeLow))/(u*u);
       }
       else{
         coneCharge += digitCharge*( 0.00 + 1.00/( 1.0 + (deltaAngle*deltaAngle)/(coneEdgeHigh*coneEdgeHigh) ) );
+        u = 1.0 + (deltaAngle*deltaAngle)/(coneEdgeHigh*coneEdgeHigh);
+        if( dFoMdAngle ) dFoMdAngle[idigit] = -digitCharge*(2.0*deltaAngle/(coneEdgeHigh*coneEdgeHigh))/(u*u);
       }
 
       allCharge += digitCharge;
@@ -119,13 +156,96 @@ void FoMCalculator::ConePropertiesFoM(double coneEdge, double& coneFOM)
     fom = fBaseFOM*coneCharge/allCharge;
   }
 
+  if( dFoMdAngle ){
+    for( int idigit=0; idigit<this->fVtxGeo->GetNDigits(); idigit++ ){
+      dFoMdAngle[idigit] = ( allCharge>0.0 ) ? fBaseFOM*dFoMdAngle[idigit]/allCharge : 0.0;
+    }
+  }
+
   // return figure of merit
   // ======================
   coneFOM = fom;
   return;
 }
 
+void FoMCalculator::AddDigitGradients(double vtxX, double vtxY, double vtxZ,
+                                      double dirX, double dirY, double dirZ,
+                                      bool extended, double timeWeight, double coneWeight, double* grad)
+{
+  // Chain rule from the per-digit d(fom)/d(delta) and d(fom)/d(angle) left in
+  // fDFoMdDelta and fDFoMdAngle to the vertex and direction, following
+  // VertexGeometry::CalcResiduals: with r = digit - vertex, ds = |r|,
+  // p = r/ds and cos(zenith) = p.dir,
+  //   d(ds)/d(vtx) = -p
+  //   d(cos(zenith))/d(vtx) = -(dir - cos(zenith) p)/ds,  d(cos(zenith))/d(dir) = p
+  double degToRad = TMath::Pi()/180.0;
+  double theta = Parameters::CherenkovAngle()*degToRad;
+  double sintheta = sin(theta);
+  double fC = Parameters::SpeedOfLight();
+  double fCn = fC/Parameters::Index0();
+  bool hasDirection = ( dirX*dirX + dirY*dirY + dirZ*dirZ>0.0 );
+
+  double dDist[6];   // d(ds)/d(vtxX,vtxY,vtxZ,dirX,dirY,dirZ)
+  double dZenith[6]; // d(zenith)/d(...), radians
+  double dDelta[6];  // d(residual)/d(...)
+
+  for( int idigit=0; idigit<this->fVtxGeo->GetNDigits(); idigit++ ){
+    double timeTerm = ( timeWeight!=0.0 ) ? timeWeight*fDFoMdDelta[idigit] : 0.0;
+    double coneTerm = ( coneWeight!=0.0 ) ? coneWeight*fDFoMdAngle[idigit] : 0.0;
+    if( timeTerm==0.0 && coneTerm==0.0 ) continue;
+
+    double dx = this->fVtxGeo->GetDigitX(idigit)-vtxX;
+    double dy = this->fVtxGeo->GetDigitY(idigit)-vtxY;
+    double dz = this->fVtxGeo->GetDigitZ(idigit)-vtxZ;
+    double ds = sqrt(dx*dx+dy*dy+dz*dz);
+    double px = dx/ds;
+    double py = dy/ds;
+    double pz = dz/ds;
+
+    dDist[0] = -px; dDist[1] = -py; dDist[2] = -pz;
+    dDist[3] = 0.0; dDist[4] = 0.0; dDist[5] = 0.0;
+
+    double phi = 0.0;
+    for( int k=0; k<6; k++ ) dZenith[k] = 0.0;
+    if( hasDirection ){
+      double cosphi = px*dirX+py*dirY+pz*dirZ;
+      double sinphi = sqrt(1.0-cosphi*cosphi);
+      phi = acos(cosphi);
+      if( sinphi>0.0 ){
+        dZenith[0] = (dirX-cosphi*px)/(ds*sinphi);
+        dZenith[1] = (dirY-cosphi*py)/(ds*sinphi);
+        dZenith[2] = (dirZ-cosphi*pz)/(ds*sinphi);
+        dZenith[3] = -px/sinphi;
+        dZenith[4] = -py/sinphi;
+        dZenith[5] = -pz/sinphi;
+      }
+    }
 
+    if( extended && phi<theta ){
+      // residual = dt - Ltrack/c - Lphoton/(c/n)
+      // Ltrack = ds*sin(theta-phi)/sin(theta), Lphoton = ds*sin(phi)/sin(theta)
+      double sinTrack = sin(theta-phi)/sintheta;
+      double cosTrack = cos(theta-phi)/sintheta;
+      double sinPhoton = sin(phi)/sintheta;
+      double cosPhoton = cos(phi)/sintheta;
+      for( int k=0; k<6; k++ ){
+        double dLtrack = dDist[k]*sinTrack - ds*cosTrack*dZenith[k];
+        double dLphoton = dDist[k]*sinPhoton + ds*cosPhoton*dZenith[k];
+        dDelta[k] = -dLtrack/fC - dLphoton/fCn;
+      }
+    }
+    else{
+      // residual = dt - ds/(c/n)
+      for( int k=0; k<6; k++ ) dDelta[k] = -dDist[k]/fCn;
+    }
+
+    for( int k=0; k<6; k++ ){
+      grad[k] += timeTerm*dDelta[k] + coneTerm*dZenith[k]/degToRad;
+    }
+    grad[kGradTime] -= timeTerm; // delta = residual - vtxTime
+  }
+  return;
+}
 
 
 //Given the position of the point vertex (x, y, z) and n digits, calculate the mean expected vertex time
@@ -216,7 +336,7 @@ double FoMCalculator::FindSimpleTimeProperties(double myConeEdge) {
   return meanTime; //return expected vertex time
 }
 
-void FoMCalculator::PointPositionChi2(double vtxX, double vtxY, double vtxZ, double vtxTime, double& fom)
+void FoMCalculator::PointPositionChi2(double vtxX, double vtxY, double vtxZ, double vtxTime, double& fom, double* grad)
 {  
   // figure of merit
   // ===============
@@ -228,13 +348,25 @@ void FoMCalculator::PointPositionChi2(double vtxX, double vtxY, double vtxZ, dou
 
   // calculate figure of merit
   // =========================
-  this->TimePropertiesLnL(vtxTime, vtxFOM);
+  if( grad ) fDFoMdDelta.resize(this->fVtxGeo->GetNDigits());
+  this->TimeLnL(vtxTime, vtxFOM, grad ? fDFoMdDelta.data() : 0);
 
   // calculate overall figure of merit
   // =================================
   fom = vtxFOM;
+
+  // calculate gradient
+  // ==================
+  if( grad ){
+    for( int k=0; k<kNGrad; k++ ) grad[k] = 0.0;
+    this->AddDigitGradients(vtxX, vtxY, vtxZ, 0.0, 0.0, 0.0, false, 1.0, 0.0, grad);
+  }
+
   // truncate
-  if( fom<-9999. ) fom = -9999.;
+  if( fom<-9999. ){
+    fom = -9999.;
+    if( grad ) for( int k=0; k<kNGrad; k++ ) grad[k] = 0.0;
+  }
 
   return;
 }
@@ -245,7 +377,7 @@ void FoMCalculator::PointPositionChi2(double vtxX, double vtxY, double vtxZ, dou
 
 void FoMCalculator::PointDirectionChi2(double vtxX, double vtxY, 
 	                                       double vtxZ, double dirX, double dirY, double dirZ, 
-	                                       double coneAngle, double& fom)
+	                                       double coneAngle, double& fom, double* grad)
 {  
   // figure of merit
   // ===============
@@ -258,21 +390,32 @@ void FoMCalculator::PointDirectionChi2(double vtxX, double vtxY,
 
   // calculate figure of merit
   // =========================
-  this->ConePropertiesFoM(coneAngle, coneFOM);
+  if( grad ) fDFoMdAngle.resize(this->fVtxGeo->GetNDigits());
+  this->ConeFoM(coneAngle, coneFOM, grad ? fDFoMdAngle.data() : 0);
 
   // calculate overall figure of merit
   // =================================
   fom = coneFOM;
 
+  // calculate gradient
+  // ==================
+  if( grad ){
+    for( int k=0; k<kNGrad; k++ ) grad[k] = 0.0;
+    this->AddDigitGradients(vtxX, vtxY, vtxZ, dirX, dirY, dirZ, false, 0.0, 1.0, grad);
+  }
+
   // truncate
-  if( fom<-9999. ) fom = -9999.;
+  if( fom<-9999. ){
+    fom = -9999.;
+    if( grad ) for( int k=0; k<kNGrad; k++ ) grad[k] = 0.0;
+  }
 
   return;
 }
 
 void FoMCalculator::PointVertexChi2(double vtxX, double vtxY, double vtxZ, 
 	                                    double dirX, double dirY, double dirZ,
-	                                    double coneAngle, double vtxTime, double& fom)
+	                                    double coneAngle, double vtxTime, double& fom, double* grad)
 {  
   // figure of merit
   // ===============
@@ -287,8 +430,12 @@ void FoMCalculator::PointVertexChi2(double vtxX, double vtxY, double vtxZ,
   double timeFOM = -9999.;
   double coneFOM = -9999.;
   
-  this->ConePropertiesFoM(coneAngle,coneFOM);
-  this->TimePropertiesLnL(vtxTime, timeFOM);
+  if( grad ){
+    fDFoMdDelta.resize(this->fVtxGeo->GetNDigits());
+    fDFoMdAngle.resize(this->fVtxGeo->GetNDigits());
+  }
+  this->ConeFoM(coneAngle, coneFOM, grad ? fDFoMdAngle.data() : 0);
+  this->TimeLnL(vtxTime, timeFOM, grad ? fDFoMdDelta.data() : 0);
   
   double fTimeFitWeight = this->fTimeFitWeight;
   double fConeFitWeight = this->fConeFitWeight;
@@ -297,13 +444,26 @@ void FoMCalculator::PointVertexChi2(double vtxX, double vtxY, double vtxZ,
   // calculate overall figure of merit
   // =================================
   fom = vtxFOM;
+
+  // calculate gradient
+  // ==================
+  if( grad ){
+    for( int k=0; k<kNGrad; k++ ) grad[k] = 0.0;
+    this->AddDigitGradients(vtxX, vtxY, vtxZ, dirX, dirY, dirZ, false,
+                            fTimeFitWeight/(fTimeFitWeight+fConeFitWeight),
+                            fConeFitWeight/(fTimeFitWeight+fConeFitWeight), grad);
+  }
+
   // truncate
-  if( fom<-9999. ) fom = -9999.;
+  if( fom<-9999. ){
+    fom = -9999.;
+    if( grad ) for( int k=0; k<kNGrad; k++ ) grad[k] = 0.0;
+  }
 
   return;
 }
 
-void FoMCalculator::ExtendedVertexChi2(double vtxX, double vtxY, double vtxZ, double dirX, double dirY, double dirZ, double coneAngle, double vtxTime, double& fom)
+void FoMCalculator::ExtendedVertexChi2(double vtxX, double vtxY, double vtxZ, double dirX, double dirY, double dirZ, double coneAngle, double vtxTime, double& fom, double* grad)
 {  
   // figure of merit
   // ===============
@@ -318,8 +478,12 @@ void FoMCalculator::ExtendedVertexChi2(double vtxX, double vtxY, double vtxZ, do
   // calculate figure of merit
   // =========================
 
-  this->ConePropertiesFoM(coneAngle,coneFOM);
-  this->TimePropertiesLnL(vtxTime, timeFOM);
+  if( grad ){
+    fDFoMdDelta.resize(this->fVtxGeo->GetNDigits());
+    fDFoMdAngle.resize(this->fVtxGeo->GetNDigits());
+  }
+  this->ConeFoM(coneAngle, coneFOM, grad ? fDFoMdAngle.data() : 0);
+  this->TimeLnL(vtxTime, timeFOM, grad ? fDFoMdDelta.data() : 0);
   
   double fTimeFitWeight = this->fTimeFitWeight;
   double fConeFitWeight = this->fConeFitWeight;
@@ -329,8 +493,20 @@ void FoMCalculator::ExtendedVertexChi2(double vtxX, double vtxY, double vtxZ, do
   // =================================
   fom = vtxFOM;
 
+  // calculate gradient
+  // ==================
+  if( grad ){
+    for( int k=0; k<kNGrad; k++ ) grad[k] = 0.0;
+    this->AddDigitGradients(vtxX, vtxY, vtxZ, dirX, dirY, dirZ, true,
+                            fTimeFitWeight/(fTimeFitWeight+fConeFitWeight),
+                            fConeFitWeight/(fTimeFitWeight+fConeFitWeight), grad);
+  }
+
   // truncate
-  if( fom<-9999. ) fom = -9999.;
+  if( fom<-9999. ){
+    fom = -9999.;
+    if( grad ) for( int k=0; k<kNGrad; k++ ) grad[k] = 0.0;
+  }
 
   return;
 }
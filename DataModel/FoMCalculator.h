@@ -39,6 +39,11 @@ public:
   //bool fIntegralsDone;
   
   VertexGeometry* fVtxGeo;
+
+  // Gradients of the figures of merit: grad must hold kNGrad values, which
+  // are set to the derivatives of fom with respect to these, in this order.
+  // Angles are taken as in VertexGeometry (degrees), positions in cm, times in ns.
+  enum { kGradX=0, kGradY, kGradZ, kGradDirX, kGradDirY, kGradDirZ, kGradTime, kNGrad };
   
  	
   FoMCalculator();
@@ -48,21 +53,37 @@ public:
   void SetMeanTimeCalculatorType(int type) {fMeanTimeCalculatorType = type;}
   void LoadVertexGeometry(VertexGeometry* vtxgeo);
   double FindSimpleTimeProperties(double myConeEdge);
-  void TimePropertiesLnL(double vtxTime, double& vtxFom);
+  // dFoMdTime, if given, is set to d(fom)/d(vtxTime) with the residuals held fixed
+  void TimePropertiesLnL(double vtxTime, double& vtxFom, double* dFoMdTime = 0);
   void ConePropertiesFoM(double coneEdge, double& chi2);
-  void PointPositionChi2(double vtxX, double vtxY, double vtxZ, double vtxTime, double& fom);
-  void PointDirectionChi2(double vtxX, double vtxY, double vtxZ, double dirX, double dirY, double dirZ, double coneAngle, double& fom);
+  // The Chi2 functions set grad (if given) as described above kNGrad
+  void PointPositionChi2(double vtxX, double vtxY, double vtxZ, double vtxTime, double& fom, double* grad = 0);
+  void PointDirectionChi2(double vtxX, double vtxY, double vtxZ, double dirX, double dirY, double dirZ, double coneAngle, double& fom, double* grad = 0);
   void PointVertexChi2(double vtxX, double vtxY, double vtxZ,
 	                                    double dirX, double dirY, double dirZ, 
-	                                    double coneAngle, double vtxTime, double& fom);
+	                                    double coneAngle, double vtxTime, double& fom, double* grad = 0);
   void ExtendedVertexChi2(double vtxX, double vtxY, double vtxZ, 
 	                                    double dirX, double dirY, double dirZ, 
-	                                    double coneAngle, double vtxTime, double& fom);
+	                                    double coneAngle, double vtxTime, double& fom, double* grad = 0);
 //  void ConePropertiesLnL(double coneParam0, double coneParam1, double coneParam2, double& coneAngle, double& coneFOM);
 //  void CorrectedVertexChi2(double vtxX, double vtxY, double vtxZ, 
 //	                                    double dirX, double dirY, double dirZ, 
 //                                      double& vtxAngle, double& vtxTime, double& fom);
-  
+
+private:
+  // The figures of merit, also setting the derivative of fom with respect to
+  // each digit's time residual (dFoMdDelta) or zenith angle (dFoMdAngle) if given
+  void TimeLnL(double vtxTime, double& vtxFom, double* dFoMdDelta);
+  void ConeFoM(double coneEdge, double& coneFom, double* dFoMdAngle);
+
+  // Adds timeWeight*d(time fom) + coneWeight*d(cone fom) to grad, from the
+  // per-digit derivatives in fDFoMdDelta and fDFoMdAngle
+  void AddDigitGradients(double vtxX, double vtxY, double vtxZ,
+                         double dirX, double dirY, double dirZ,
+                         bool extended, double timeWeight, double coneWeight, double* grad);
+
+  std::vector<double> fDFoMdDelta;
+  std::vector<double> fDFoMdAngle;
   
 };
 
@@ -13,10 +13,22 @@ bool MRDOut::Send(zmq::socket_t *socket){
   zmq::message_t ms1(&OutN,sizeof OutN, datacleanup);
   zmq::message_t ms2(&Trigger,sizeof Trigger, datacleanup);
   zmq::message_t ms3(&TimeStamp,sizeof TimeStamp, datacleanup);
-  zmq::message_t ms4(&Value[0],sizeof(unsigned int) * Value.size(), datacleanup);
-  zmq::message_t ms5(&Slot[0],sizeof(unsigned int) * Slot.size(), datacleanup);
-  zmq::message_t ms6(&Channel[0],sizeof(unsigned int) * Channel.size(), datacleanup);
-  zmq::message_t ms7(&Crate[0],sizeof(unsigned int) * Crate.size(), datacleanup);
+  //The wire format keeps one array per hit field, so the packed hits are
+  //unpacked into the (copied) message buffers
+  zmq::message_t ms4(sizeof(unsigned int) * Hits.size());
+  zmq::message_t ms5(sizeof(unsigned int) * Hits.size());
+  zmq::message_t ms6(sizeof(unsigned int) * Hits.size());
+  zmq::message_t ms7(sizeof(unsigned int) * Hits.size());
+  unsigned int* Value = static_cast<unsigned int*>(ms4.data());
+  unsigned int* Slot = static_cast<unsigned int*>(ms5.data());
+  unsigned int* Channel = static_cast<unsigned int*>(ms6.data());
+  unsigned int* Crate = static_cast<unsigned int*>(ms7.data());
+  for(size_t i=0; i<Hits.size(); i++){
+    Value[i] = Hits[i].Value();
+    Slot[i] = Hits[i].Slot();
+    Channel[i] = Hits[i].Channel();
+    Crate[i] = Hits[i].Crate();
+  }
   //  zmq::message_t ms8(&buffersize,sizeof buffersize, datacleanup);
 
   socket->send(ms1,ZMQ_SNDMORE);
@@ -35,6 +47,7 @@ bool MRDOut::Send(zmq::socket_t *socket){
 bool MRDOut::Receive(zmq::socket_t *socket){
 
   zmq::message_t message;
+  std::vector<unsigned int> Value, Slot, Channel, Crate;
   //  std::cout<<"d1"<<std::endl;
   if(socket->recv(&message)){
     // std::cout<<"d2"<<std::endl;
@@ -74,6 +87,13 @@ bool MRDOut::Receive(zmq::socket_t *socket){
                 Crate.resize(message.size() / sizeof(unsigned int));
                 memcpy(&Crate[0], message.data(),message.size());
 
+                //The card type is not sent
+                Hits.clear();
+                Hits.reserve(Value.size());
+                for(size_t i=0; i<Value.size(); i++){
+                  Hits.emplace_back(Crate.at(i),Slot.at(i),Channel.at(i),Value[i],MRDHit::Unknown);
+                }
+
               }
               else return false;
             }
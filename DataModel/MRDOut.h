@@ -1,9 +1,54 @@
 #ifndef MRDOUT_H
 #define MRDOUT_H
 
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+#include <stdint.h>
 #include <SerialisableObject.h>
+#include <boost/serialization/level.hpp>
+#include <boost/serialization/tracking.hpp>
+#include <boost/serialization/version.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/utility.hpp>
+#include <boost/serialization/map.hpp>
 #include <zmq.hpp>
 
+//One MRD readout hit, bit-packed into a single 64-bit word:
+//bits 0-31 value, 32-39 channel, 40-47 slot, 48-55 crate, 56-63 card type
+struct MRDHit {
+
+  enum CardType : uint8_t {Unknown=0, TDC, ADC};
+
+  uint64_t Word = 0;
+
+  MRDHit(){}
+  MRDHit(unsigned int crate, unsigned int slot, unsigned int channel, unsigned int value, CardType type=TDC) :
+    Word( (uint64_t(type)<<56) | (uint64_t(crate & 0xFF)<<48) | (uint64_t(slot & 0xFF)<<40) |
+          (uint64_t(channel & 0xFF)<<32) | uint64_t(value) ) {}
+
+  unsigned int Value() const {return (unsigned int)(Word & 0xFFFFFFFF);}
+  unsigned int Channel() const {return (unsigned int)((Word>>32) & 0xFF);}
+  unsigned int Slot() const {return (unsigned int)((Word>>40) & 0xFF);}
+  unsigned int Crate() const {return (unsigned int)((Word>>48) & 0xFF);}
+  CardType Type() const {return CardType(Word>>56);}
+
+  static CardType TypeFromString(const std::string& type){
+    if(type=="TDC") return TDC;
+    if(type=="ADC") return ADC;
+    return Unknown;
+  }
+
+  template <class Archive> void serialize(Archive& ar, const unsigned int version){
+    ar & Word;
+  }
+
+};
+//Hits are stored back to back as bare words, without per-object class information
+BOOST_CLASS_IMPLEMENTATION(MRDHit, boost::serialization::object_serializable)
+BOOST_CLASS_TRACKING(MRDHit, boost::serialization::track_never)
+
 class MRDOut  : public SerialisableObject{
 
   friend class boost::serialization::access;
@@ -13,8 +58,7 @@ class MRDOut  : public SerialisableObject{
   MRDOut();
 
   unsigned int OutN, Trigger;
-  std::vector<unsigned int> Value, Slot, Channel, Crate;
-  std::vector<std::string> Type;
+  std::vector<MRDHit> Hits;
   //ULong64_t
   long TimeStamp;
 
@@ -25,19 +69,62 @@ class MRDOut  : public SerialisableObject{
 
  private:
 
-  template <class Archive> void serialize(Archive& ar, const unsigned int version){
+  template <class Archive> void save(Archive& ar, const unsigned int version) const{
 
     ar & OutN;
     ar & Trigger;
-    ar & Value;
-    ar & Slot;
-    ar & Channel;
-    ar & Crate;
-    ar & Type;
+    ar & Hits;
     ar & TimeStamp;
 
   }
 
+  template <class Archive> void load(Archive& ar, const unsigned int version){
+
+    ar & OutN;
+    ar & Trigger;
+    if(version>0) ar & Hits;
+    else{
+      //Version 0 files store each hit field in its own vector
+      std::vector<unsigned int> Value, Slot, Channel, Crate;
+      std::vector<std::string> Type;
+      ar & Value;
+      ar & Slot;
+      ar & Channel;
+      ar & Crate;
+      ar & Type;
+      Hits.clear();
+      Hits.reserve(Value.size());
+      for(size_t i=0; i<Value.size(); i++){
+        MRDHit::CardType type = (i<Type.size()) ? MRDHit::TypeFromString(Type[i]) : MRDHit::Unknown;
+        Hits.emplace_back(Crate.at(i),Slot.at(i),Channel.at(i),Value[i],type);
+      }
+    }
+    ar & TimeStamp;
+
+  }
+
+  BOOST_SERIALIZATION_SPLIT_MEMBER()
+
 };
+BOOST_CLASS_VERSION(MRDOut, 1)
+
+//One decoded MRD trigger, as passed from the MRDDataDecoder to the ANNIEEventBuilder
+struct MRDTriggerRecord {
+  std::vector<std::pair<unsigned long, int> > Hits;  //{channel key, TDC value} of each hit
+  std::string TriggerType = "No Loopback";  //"Beam", "Cosmic" or "No Loopback"
+  int BeamLoopbackTDC = -1;
+  int CosmicLoopbackTDC = -1;
+
+  //only needed to put an MRDEventMap pointer in a BoostStore; the CStore keeps it unserialised
+  template <class Archive> void serialize(Archive& ar, const unsigned int version){
+    ar & Hits;
+    ar & TriggerType;
+    ar & BeamLoopbackTDC;
+    ar & CosmicLoopbackTDC;
+  }
+};
+
+//Decoded MRD triggers not yet built into ANNIEEvents. Key: MRD timestamp (ms since 1970/1/1)
+typedef std::map<uint64_t, MRDTriggerRecord> MRDEventMap;
 
 #endif
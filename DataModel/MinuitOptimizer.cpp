@@ -18,9 +18,37 @@
 #include <cassert>
 using namespace std;
 
+// TMinuit only takes a plain function as FCN, so the FCNs below get the
+// optimizer being fitted from fgMinuitOptimizer. It is set by a
+// CurrentOptimizer for the length of each fit, so that it is always the
+// optimizer that is fitting rather than the last one constructed.
 static MinuitOptimizer* fgMinuitOptimizer = 0;
-static FoMCalculator* fgFoMCalculator = 0;
-static void vertex_time_lnl(int&, double*, double& f, double* par, int)
+
+namespace {
+  class CurrentOptimizer {
+  public:
+    CurrentOptimizer(MinuitOptimizer* optimizer) : fPrevious(fgMinuitOptimizer) { fgMinuitOptimizer = optimizer; }
+    ~CurrentOptimizer() { fgMinuitOptimizer = fPrevious; }
+  private:
+    MinuitOptimizer* fPrevious;
+  };
+
+  // Derivatives of fom with respect to the direction angles (dirTheta, dirPhi),
+  // from those with respect to the direction components in grad
+  void DirectionAngleGradient(const double* grad, double dirTheta, double dirPhi,
+                              double& dFoMdTheta, double& dFoMdPhi)
+  {
+    double gX = grad[FoMCalculator::kGradDirX];
+    double gY = grad[FoMCalculator::kGradDirY];
+    double gZ = grad[FoMCalculator::kGradDirZ];
+    dFoMdTheta = cos(dirTheta)*(gX*cos(dirPhi)+gY*sin(dirPhi)) - gZ*sin(dirTheta);
+    dFoMdPhi = sin(dirTheta)*(gY*cos(dirPhi)-gX*sin(dirPhi));
+  }
+}
+
+// With SET GRA (see SetUseAnalyticGradient), Minuit calls the FCNs with
+// iflag==2 when it wants the gradient of f in gin as well
+static void vertex_time_lnl(int&, double* gin, double& f, double* par, int iflag)
 {  
 
   bool printDebugMessages = 0;
@@ -28,7 +56,12 @@ static void vertex_time_lnl(int&, double*, double& f, double* par, int)
   double vtxTime = par[0]; // nanoseconds
   double fom = -9999.;
   fgMinuitOptimizer->time_fit_itr();  
-  fgFoMCalculator->TimePropertiesLnL(vtxTime, fom);
+  if( iflag==2 && fgMinuitOptimizer->fUseAnalyticGradient ){
+    double dFoMdTime = 0.0;
+    fgMinuitOptimizer->fFoMCalculator->TimePropertiesLnL(vtxTime, fom, &dFoMdTime);
+    gin[0] = -dFoMdTime;
+  }
+  else fgMinuitOptimizer->fFoMCalculator->TimePropertiesLnL(vtxTime, fom);
   f = -fom; // note: need to maximize this fom
   if( printDebugMessages ){
     std::cout << "  [vertex_time_lnl] [" << fgMinuitOptimizer->time_fit_iterations() << "] vtime=" << vtxTime << " fom=" << fom << std::endl;
@@ -36,7 +69,7 @@ static void vertex_time_lnl(int&, double*, double& f, double* par, int)
   return;
 }
 
-static void point_position_chi2(int&, double*, double& f, double* par, int)
+static void point_position_chi2(int&, double* gin, double& f, double* par, int iflag)
 {
   bool printDebugMessages = 0;
 
@@ -47,7 +80,15 @@ static void point_position_chi2(int&, double*, double& f, double* par, int)
 
   double fom = -9999.;
   fgMinuitOptimizer->point_position_itr();
-  fgFoMCalculator->PointPositionChi2(vtxX,vtxY,vtxZ,vtxTime,fom);
+  if( iflag==2 && fgMinuitOptimizer->fUseAnalyticGradient ){
+    double grad[FoMCalculator::kNGrad];
+    fgMinuitOptimizer->fFoMCalculator->PointPositionChi2(vtxX,vtxY,vtxZ,vtxTime,fom,grad);
+    gin[0] = -grad[FoMCalculator::kGradX];
+    gin[1] = -grad[FoMCalculator::kGradY];
+    gin[2] = -grad[FoMCalculator::kGradZ];
+    gin[3] = -grad[FoMCalculator::kGradTime];
+  }
+  else fgMinuitOptimizer->fFoMCalculator->PointPositionChi2(vtxX,vtxY,vtxZ,vtxTime,fom);
 
 
   f = -fom; // note: need to maximize this fom
@@ -59,7 +100,7 @@ static void point_position_chi2(int&, double*, double& f, double* par, int)
   return;
 }
 
-static void point_direction_chi2(int&, double*, double& f, double* par, int)
+static void point_direction_chi2(int&, double* gin, double& f, double* par, int iflag)
 {
   bool printDebugMessages = 0;
   
@@ -83,7 +124,16 @@ static void point_direction_chi2(int&, double*, double& f, double* par, int)
   double coneAngle = fgMinuitOptimizer->fConeAngle; //Cherenkov cone angle
 
   fgMinuitOptimizer->point_direction_itr();
-  fgFoMCalculator->PointDirectionChi2(vtxX,vtxY,vtxZ,
+  if( iflag==2 && fgMinuitOptimizer->fUseAnalyticGradient ){
+    double grad[FoMCalculator::kNGrad];
+    fgMinuitOptimizer->fFoMCalculator->PointDirectionChi2(vtxX,vtxY,vtxZ,
+                                       dirX,dirY,dirZ,
+                                       coneAngle, fom, grad);
+    DirectionAngleGradient(grad, dirTheta, dirPhi, gin[0], gin[1]);
+    gin[0] = -gin[0];
+    gin[1] = -gin[1];
+  }
+  else fgMinuitOptimizer->fFoMCalculator->PointDirectionChi2(vtxX,vtxY,vtxZ,
                                      dirX,dirY,dirZ,
                                      coneAngle, fom);
   f = -fom; // note: need to maximize this fom
@@ -97,7 +147,7 @@ static void point_direction_chi2(int&, double*, double& f, double* par, int)
   return; 
 }
 
-static void point_vertex_chi2(int&, double*, double& f, double* par, int)
+static void point_vertex_chi2(int&, double* gin, double& f, double* par, int iflag)
 {
   bool printDebugMessages = 0;
   
@@ -117,7 +167,18 @@ static void point_vertex_chi2(int&, double*, double& f, double* par, int)
   double coneAngle = fgMinuitOptimizer->fConeAngle; //Cherenkov cone angle
 
   fgMinuitOptimizer->point_vertex_itr();
-  fgFoMCalculator->PointVertexChi2(vtxX,vtxY,vtxZ,dirX,dirY,dirZ,coneAngle, vtxTime,fom);
+  if( iflag==2 && fgMinuitOptimizer->fUseAnalyticGradient ){
+    double grad[FoMCalculator::kNGrad];
+    fgMinuitOptimizer->fFoMCalculator->PointVertexChi2(vtxX,vtxY,vtxZ,dirX,dirY,dirZ,coneAngle, vtxTime,fom,grad);
+    gin[0] = -grad[FoMCalculator::kGradX];
+    gin[1] = -grad[FoMCalculator::kGradY];
+    gin[2] = -grad[FoMCalculator::kGradZ];
+    DirectionAngleGradient(grad, dirTheta, dirPhi, gin[3], gin[4]);
+    gin[3] = -gin[3];
+    gin[4] = -gin[4];
+    gin[5] = -grad[FoMCalculator::kGradTime];
+  }
+  else fgMinuitOptimizer->fFoMCalculator->PointVertexChi2(vtxX,vtxY,vtxZ,dirX,dirY,dirZ,coneAngle, vtxTime,fom);
   f = -fom; // note: need to maximize this fom
 
   if( printDebugMessages ){
@@ -128,7 +189,7 @@ static void point_vertex_chi2(int&, double*, double& f, double* par, int)
   return;
 }
 
-static void extended_vertex_chi2(int&, double*, double& f, double* par, int)
+static void extended_vertex_chi2(int&, double* gin, double& f, double* par, int iflag)
 {
   bool printDebugMessages = 0;
   
@@ -150,7 +211,20 @@ static void extended_vertex_chi2(int&, double*, double& f, double* par, int)
 
   fgMinuitOptimizer->extended_vertex_itr();
   
-  fgFoMCalculator->ExtendedVertexChi2(vtxX,vtxY,vtxZ,
+  if( iflag==2 && fgMinuitOptimizer->fUseAnalyticGradient ){
+    double grad[FoMCalculator::kNGrad];
+    fgMinuitOptimizer->fFoMCalculator->ExtendedVertexChi2(vtxX,vtxY,vtxZ,
+                                       dirX,dirY,dirZ, 
+                                       coneAngle, vtxTime,fom,grad);
+    gin[0] = -grad[FoMCalculator::kGradX];
+    gin[1] = -grad[FoMCalculator::kGradY];
+    gin[2] = -grad[FoMCalculator::kGradZ];
+    DirectionAngleGradient(grad, dirTheta, dirPhi, gin[3], gin[4]);
+    gin[3] = -gin[3];
+    gin[4] = -gin[4];
+    gin[5] = -grad[FoMCalculator::kGradTime];
+  }
+  else fgMinuitOptimizer->fFoMCalculator->ExtendedVertexChi2(vtxX,vtxY,vtxZ,
                                      dirX,dirY,dirZ, 
                                      coneAngle, vtxTime,fom);
 
@@ -167,8 +241,7 @@ static void extended_vertex_chi2(int&, double*, double& f, double* par, int)
 
 //Constructor
 MinuitOptimizer::MinuitOptimizer() {
-  fgMinuitOptimizer = this;
-  fgFoMCalculator = new FoMCalculator();
+  fFoMCalculator = new FoMCalculator();
   fSeedVtx = 0;
   fFittedVtx = new RecoVertex();
   fVtxX = -9999.;
@@ -188,6 +261,7 @@ MinuitOptimizer::MinuitOptimizer() {
   fPass = 0;
   fItr = 0;
   fPrintLevel = -1;
+  fUseAnalyticGradient = false;
 
   fFixTimeParam0 = 0.20;  // scattering parameter (not currently used)
   
@@ -247,7 +321,7 @@ MinuitOptimizer::MinuitOptimizer() {
 //Destructor
 MinuitOptimizer::~MinuitOptimizer() {
 	fSeedVtx = 0;
-    delete fgFoMCalculator; fgFoMCalculator = 0;
+	delete fFoMCalculator; fFoMCalculator = 0;
 	delete fMinuitTimeFit; fMinuitTimeFit = 0;
 	delete fMinuitPointPosition; fMinuitPointPosition = 0;
 	delete fMinuitPointDirection; fMinuitPointDirection = 0;
@@ -259,13 +333,21 @@ MinuitOptimizer::~MinuitOptimizer() {
 }
 	
 
+void MinuitOptimizer::SetMinuitGradient(TMinuit* minuit) {
+  // the same TMinuit is reused for every fit, so set this either way
+  int err = 0;
+  double arglist[1] = {1}; // 1: don't check the gradient against Minuit's own
+  if( fUseAnalyticGradient ) minuit->mnexcm("SET GRA",arglist,1,err);
+  else minuit->mnexcm("SET NOG",arglist,0,err);
+}
+
 void MinuitOptimizer::SetFitterTimeRange(double tmin, double tmax) {
   fTmin = tmin;
   fTmax = tmax;
 }
 
 void MinuitOptimizer::LoadVertexGeometry(VertexGeometry* vtxgeo) {
-  fgFoMCalculator->fVtxGeo = vtxgeo;	
+  fFoMCalculator->fVtxGeo = vtxgeo;	
 }
 
 void MinuitOptimizer::SetNumberOfIterations(int iterations) {
@@ -281,15 +363,15 @@ void MinuitOptimizer::SetNumberOfIterations(int iterations) {
 }
 
 void MinuitOptimizer::SetTimeFitWeight(double tweight) {
-  fgFoMCalculator->SetTimeFitWeight(tweight);	
+  fFoMCalculator->SetTimeFitWeight(tweight);	
 }
 
 void MinuitOptimizer::SetConeFitWeight(double cweight) {
-  fgFoMCalculator->SetConeFitWeight(cweight);	
+  fFoMCalculator->SetConeFitWeight(cweight);	
 }
 
 void MinuitOptimizer::SetMeanTimeCalculatorType(int type) {
-  fgFoMCalculator->SetMeanTimeCalculatorType(type);	
+  fFoMCalculator->SetMeanTimeCalculatorType(type);	
 }
 
 //Load vertex
@@ -320,12 +402,13 @@ void MinuitOptimizer::LoadVertex(double vtxX, double vtxY, double vtxZ, double v
 
 
 void MinuitOptimizer::FitPointTimeWithMinuit() {
-  fgFoMCalculator->fVtxGeo->CalcPointResiduals(fVtxX, fVtxY, fVtxZ, 0.0, 0.0, 0.0, 0.0);
+  CurrentOptimizer current(this);
+  fFoMCalculator->fVtxGeo->CalcPointResiduals(fVtxX, fVtxY, fVtxZ, 0.0, 0.0, 0.0, 0.0);
 
   // calculate mean and rms
   // ====================== 
   double meanvtxTime = 0.0;
-  meanvtxTime = fgFoMCalculator->FindSimpleTimeProperties(fConeAngle);  //returns weighted average of the expected vertex time
+  meanvtxTime = fFoMCalculator->FindSimpleTimeProperties(fConeAngle);  //returns weighted average of the expected vertex time
   // reset counter
   // =============
   time_fit_reset_itr();
@@ -350,6 +433,7 @@ void MinuitOptimizer::FitPointTimeWithMinuit() {
   fMinuitTimeFit->SetFCN(vertex_time_lnl);
   //end
   fMinuitTimeFit->mnexcm("SET STR",arglist,1,err);
+  this->SetMinuitGradient(fMinuitTimeFit);
   fMinuitTimeFit->mnparm(0,"vtxTime",seedTime,1.0,fTmin,fTmax,err);
   
   flag = fMinuitTimeFit->Migrad();
@@ -359,7 +443,7 @@ void MinuitOptimizer::FitPointTimeWithMinuit() {
   // fitting done; calculate best-fit figure of merit
   // =========================
   double fom = -9999.;
-  fgFoMCalculator->TimePropertiesLnL(fitTime, fom);
+  fFoMCalculator->TimePropertiesLnL(fitTime, fom);
   
   fVtxTime = fitTime;
   fVtxFOM = fom;
@@ -371,6 +455,7 @@ void MinuitOptimizer::FitPointTimeWithMinuit() {
 
 //Fit point position in 3D
 void MinuitOptimizer::FitPointPositionWithMinuit() {
+  CurrentOptimizer current(this);
 	// seed vertex
   // ===========
   bool foundSeed = fSeedVtx->FoundVertex();
@@ -428,6 +513,7 @@ void MinuitOptimizer::FitPointPositionWithMinuit() {
   fMinuitPointPosition->mncler();
   fMinuitPointPosition->SetFCN(point_position_chi2);
   fMinuitPointPosition->mnexcm("SET STR",arglist,1,err);
+  this->SetMinuitGradient(fMinuitPointPosition);
   fMinuitPointPosition->mnparm(0,"x",seedX,1.0,fXmin,fXmax,err);
   fMinuitPointPosition->mnparm(1,"y",seedY,1.0,fYmin,fYmax,err);
   fMinuitPointPosition->mnparm(2,"z",seedZ,5.0,fZmin,fZmax,err);
@@ -454,7 +540,7 @@ void MinuitOptimizer::FitPointPositionWithMinuit() {
   if( flag==0 ) fPass = 1; // anything else: abnormal termination 
 
   fItr = point_position_iterations();
-  fgFoMCalculator->PointPositionChi2(fVtxX,fVtxY,fVtxZ,fVtxTime,fVtxFOM);
+  fFoMCalculator->PointPositionChi2(fVtxX,fVtxY,fVtxZ,fVtxTime,fVtxFOM);
   
   // set vertex and direction
   // ========================
@@ -483,6 +569,7 @@ void MinuitOptimizer::FitPointPositionWithMinuit() {
 }
 
 void MinuitOptimizer::FitPointDirectionWithMinuit() {
+  CurrentOptimizer current(this);
   // initialization
   // ==============
   bool foundSeed = ( fSeedVtx->FoundVertex() && fSeedVtx->FoundDirection() );
@@ -549,6 +636,7 @@ void MinuitOptimizer::FitPointDirectionWithMinuit() {
   fMinuitPointDirection->mncler();
   fMinuitPointDirection->SetFCN(point_direction_chi2);
   fMinuitPointDirection->mnexcm("SET STR",arglist,1,err);
+  this->SetMinuitGradient(fMinuitPointDirection);
   fMinuitPointDirection->mnparm(0,"theta",seedTheta,0.125*TMath::Pi(),0.0,TMath::Pi(),err);
   fMinuitPointDirection->mnparm(1,"phi",seedPhi,0.25*TMath::Pi(),-1.0*TMath::Pi(),+3.0*TMath::Pi(),err);
 
@@ -573,7 +661,7 @@ void MinuitOptimizer::FitPointDirectionWithMinuit() {
   
   // calculate vertex
   // ================
-  fgFoMCalculator->PointDirectionChi2(fVtxX,fVtxY,fVtxZ,fDirX,fDirY,fDirZ,fConeAngle,fVtxFOM);
+  fFoMCalculator->PointDirectionChi2(fVtxX,fVtxY,fVtxZ,fDirX,fDirY,fDirZ,fConeAngle,fVtxFOM);
 
   // set vertex and direction
   // ========================
@@ -603,6 +691,7 @@ void MinuitOptimizer::FitPointDirectionWithMinuit() {
 }
 
 void MinuitOptimizer::FitPointVertexWithMinuit() {
+  CurrentOptimizer current(this);
   
   // seed vertex
   // ===========  
@@ -686,6 +775,7 @@ void MinuitOptimizer::FitPointVertexWithMinuit() {
   fMinuitPointVertex->mncler();
   fMinuitPointVertex->SetFCN(point_vertex_chi2);
   fMinuitPointVertex->mnexcm("SET STR",arglist,1,err);
+  this->SetMinuitGradient(fMinuitPointVertex);
 //  fMinuitPointVertex->mnparm(0,"x",seedX,1.0,-152,152,err); 
 //  fMinuitPointVertex->mnparm(1,"y",seedY,1.0,-212.46,183.54,err);
 //  fMinuitPointVertex->mnparm(2,"z",seedZ,1.0,15,319,err);
@@ -726,7 +816,7 @@ void MinuitOptimizer::FitPointVertexWithMinuit() {
   
   // fitting complete; calculate vertex FOM
   // ================
-  fgFoMCalculator->PointVertexChi2(fVtxX,fVtxY,fVtxZ,fDirX,fDirY,fDirZ,fConeAngle, fVtxTime,fVtxFOM); 
+  fFoMCalculator->PointVertexChi2(fVtxX,fVtxY,fVtxZ,fDirX,fDirY,fDirZ,fConeAngle, fVtxTime,fVtxFOM); 
   
   // set vertex and direction
   // ========================
@@ -756,6 +846,7 @@ void MinuitOptimizer::FitPointVertexWithMinuit() {
 }
 
 void MinuitOptimizer::FitExtendedVertexWithMinuit() {
+  CurrentOptimizer current(this);
   // seed vertex
   // ===========
   bool foundSeed = ( fSeedVtx->FoundVertex() 
@@ -837,6 +928,7 @@ void MinuitOptimizer::FitExtendedVertexWithMinuit() {
   fMinuitExtendedVertex->SetFCN(extended_vertex_chi2);
   fMinuitExtendedVertex->mnset();
   fMinuitExtendedVertex->mnexcm("SET STR",arglist,1,err);
+  this->SetMinuitGradient(fMinuitExtendedVertex);
   fMinuitExtendedVertex->mnparm(0,"x",seedX,1.0,fXmin,fXmax,err);
   fMinuitExtendedVertex->mnparm(1,"y",seedY,1.0,fYmin,fYmax,err);
   fMinuitExtendedVertex->mnparm(2,"z",seedZ,5.0,fZmin,fZmax,err);
@@ -880,7 +972,7 @@ void MinuitOptimizer::FitExtendedVertexWithMinuit() {
   
   // fit complete; calculate fit results
   // ================
-  fgFoMCalculator->ExtendedVertexChi2(fVtxX,fVtxY,fVtxZ,
+  fFoMCalculator->ExtendedVertexChi2(fVtxX,fVtxY,fVtxZ,
                            fDirX,fDirY,fDirZ, 
                            fConeAngle, fVtxTime,fVtxFOM);
                            
@@ -934,7 +1026,7 @@ void MinuitOptimizer::FitExtendedVertexWithMinuit() {
 //  if(TMath::Sqrt(vtxX*vtxX + vtxY*vtxY + vtxZ*vtxZ)>152 || vtxY>198 || vtxY<-198) {fom = 9999;}
 //  fgMinuitOptimizer->corrected_vertex_itr();
 //  
-//  fgFoMCalculator->CorrectedVertexChi2(vtxX,vtxY,vtxZ,
+//  fgMinuitOptimizer->fFoMCalculator->CorrectedVertexChi2(vtxX,vtxY,vtxZ,
 //                                     dirX,dirY,dirZ,
 //                                     vangle,vtime,fom);
 //
@@ -967,7 +1059,7 @@ void MinuitOptimizer::FitExtendedVertexWithMinuit() {
 //  double fom = 0.0;
 //
 //  fgMinuitOptimizer->cone_fit_itr();
-//  fgFoMCalculator->ConePropertiesLnL(vtxParam0,vtxParam1,vtxParam2,vangle,fom);
+//  fgMinuitOptimizer->fFoMCalculator->ConePropertiesLnL(vtxParam0,vtxParam1,vtxParam2,vangle,fom);
 //
 //  f = -fom; // note: need to maximize this fom
 //
@@ -1081,7 +1173,7 @@ void MinuitOptimizer::FitExtendedVertexWithMinuit() {
 //  	
 //  // calculate vertex
 //  // ================
-//  fgFoMCalculator->CorrectedVertexChi2(fVtxX,fVtxY,fVtxZ,
+//  fFoMCalculator->CorrectedVertexChi2(fVtxX,fVtxY,fVtxZ,
 //                           fDirX,fDirY,fDirZ, 
 //                           fConeAngle,fVtxTime,fVtxFOM); //fit vertex time here
 //                           
@@ -1113,7 +1205,7 @@ void MinuitOptimizer::FitExtendedVertexWithMinuit() {
 //  double ConeParam0 = this->fFixConeParam0;
 //  double ConeParam1 = this->fFixConeParam1;
 //  double ConeParam2 = this->fFixConeParam2;
-//  fgFoMCalculator->ConePropertiesLnL(ConeParam0,ConeParam1,ConeParam2,coneAngle,coneFOM);  
+//  fFoMCalculator->ConePropertiesLnL(ConeParam0,ConeParam1,ConeParam2,coneAngle,coneFOM);  
 //  return;
 //}
 //
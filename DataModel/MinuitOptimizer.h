@@ -40,6 +40,7 @@ public:
   double fFoundVertex;
   
   int fPrintLevel;
+  bool fUseAnalyticGradient; // give Minuit the FoMCalculator gradients rather than finite differences
   int fPass = 0;
   int fItr = 0;
   
@@ -68,6 +69,9 @@ public:
   TMinuit* fMinuitExtendedVertex; 
 
   TMinuit* fMinuitTimeFit;
+
+  // each optimizer has its own FoM calculator, so deleting one does not pull it from under another
+  FoMCalculator* fFoMCalculator;
   
  	
  	MinuitOptimizer();
@@ -78,6 +82,11 @@ public:
   void SetConeFitWeight(double cweight);
   void SetMeanTimeCalculatorType(int type);
   void SetNumberOfIterations(int iterations);
+  // Give Minuit the FoMCalculator's analytic FOM gradient (SET GRA) instead of
+  // letting it estimate the gradient by finite differences, which costs extra FOM
+  // evaluations per step.  Set by the UseAnalyticGradient option of the Vtx* tools.
+  void SetUseAnalyticGradient(bool use) {fUseAnalyticGradient = use;}
+  void SetMinuitGradient(TMinuit* minuit);
   void SetConeAngle(double cangle){ fConeAngle=cangle;}
   void LoadVertexGeometry(VertexGeometry* vtxgeo);
   void LoadVertex(RecoVertex* vtx);
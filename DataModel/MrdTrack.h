@@ -0,0 +1,110 @@
+/* vim:set noexpandtab tabstop=4 wrap */
+#ifndef MRDTRACKCLASS_H
+#define MRDTRACKCLASS_H
+
+#include<SerialisableObject.h>
+#include <iostream>
+#include <vector>
+
+#include "Position.h"
+
+// A reconstructed MRD track, as published in the "MRDTracks" vector of the MRDTracks store
+// by FindMrdTracks (with short tracks appended by TrackCombiner).
+// Positions and lengths are in [m], times in [ns], energies in [MeV].
+class MrdTrack : public SerialisableObject{
+
+	friend class boost::serialization::access;
+
+	public:
+	MrdTrack(){serialise=true;}
+
+	int MrdTrackID=-1;
+	int MrdSubEventID=-1;
+	int TrackIndex=-1;               // index of the track within its sub-event
+	bool InterceptsTank=false;
+	double StartTime=0.;
+	Position StartVertex;
+	Position StopVertex;
+	double TrackAngle=0.;            // [rad]
+	double TrackAngleError=0.;
+	std::vector<int> LayersHit;
+	double TrackLength=0.;
+	bool IsMrdPenetrating=false;
+	bool IsMrdStopped=false;
+	bool IsMrdSideExit=false;
+	double EnergyLoss=0.;
+	double EnergyLossError=0.;
+	double PenetrationDepth=0.;
+	double HtrackFitChi2=0.;
+	double HtrackFitCov=0.;
+	double VtrackFitChi2=0.;
+	double VtrackFitCov=0.;
+	std::vector<int> PMTsHit;
+	// straight line fits in the two views: origin at global z=0 [cm], and gradient
+	double HtrackOrigin=0.;
+	double HtrackOriginError=0.;
+	double HtrackGradient=0.;        // dx/dz
+	double HtrackGradientError=0.;
+	double VtrackOrigin=0.;
+	double VtrackOriginError=0.;
+	double VtrackGradient=0.;        // dy/dz
+	double VtrackGradientError=0.;
+	// back projections
+	Position TankExitPoint;
+	Position MrdEntryPoint;
+
+	bool Print(){
+		std::cout<<"MrdTrackID : "<<MrdTrackID<<", MrdSubEventID : "<<MrdSubEventID
+				 <<", TrackIndex : "<<TrackIndex<<std::endl
+				 <<"StartTime : "<<StartTime<<", StartVertex : "<<StartVertex.AsString()
+				 <<", StopVertex : "<<StopVertex.AsString()<<std::endl
+				 <<"TrackAngle : "<<TrackAngle<<" +- "<<TrackAngleError
+				 <<", TrackLength : "<<TrackLength<<", PenetrationDepth : "<<PenetrationDepth<<std::endl
+				 <<"EnergyLoss : "<<EnergyLoss<<" +- "<<EnergyLossError
+				 <<", NumLayersHit : "<<LayersHit.size()<<", NumPMTsHit : "<<PMTsHit.size()<<std::endl
+				 <<"InterceptsTank : "<<InterceptsTank<<", IsMrdPenetrating : "<<IsMrdPenetrating
+				 <<", IsMrdStopped : "<<IsMrdStopped<<", IsMrdSideExit : "<<IsMrdSideExit<<std::endl
+				 <<"TankExitPoint : "<<TankExitPoint.AsString()
+				 <<", MrdEntryPoint : "<<MrdEntryPoint.AsString()<<std::endl;
+		return true;
+	}
+
+	template<class Archive> void serialize(Archive & ar, const unsigned int version){
+		if(serialise){
+			ar & MrdTrackID;
+			ar & MrdSubEventID;
+			ar & TrackIndex;
+			ar & InterceptsTank;
+			ar & StartTime;
+			ar & StartVertex;
+			ar & StopVertex;
+			ar & TrackAngle;
+			ar & TrackAngleError;
+			ar & LayersHit;
+			ar & TrackLength;
+			ar & IsMrdPenetrating;
+			ar & IsMrdStopped;
+			ar & IsMrdSideExit;
+			ar & EnergyLoss;
+			ar & EnergyLossError;
+			ar & PenetrationDepth;
+			ar & HtrackFitChi2;
+			ar & HtrackFitCov;
+			ar & VtrackFitChi2;
+			ar & VtrackFitCov;
+			ar & PMTsHit;
+			ar & HtrackOrigin;
+			ar & HtrackOriginError;
+			ar & HtrackGradient;
+			ar & HtrackGradientError;
+			ar & VtrackOrigin;
+			ar & VtrackOriginError;
+			ar & VtrackGradient;
+			ar & VtrackGradientError;
+			ar & TankExitPoint;
+			ar & MrdEntryPoint;
+		}
+	}
+};
+
+#endif
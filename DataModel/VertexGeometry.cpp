@@ -36,6 +36,8 @@ VertexGeometry::VertexGeometry()
   fTotalFilteredQ = 0.0;
   fMinTime = 0.0;
   fMaxTime = 0.0;  
+  fPointResidualMean = 0.0;
+  fExtendedResidualMean = 0.0;
   fVtxX1 = 0.0;
   fVtxY1 = 0.0;
   fVtxZ1 = 0.0;
@@ -227,6 +229,9 @@ void VertexGeometry::LoadDigits(std::vector<RecoDigit>* vDigitList)
   fMinTime = -999999.9;
   fMaxTime = -999999.9;
 
+  fPointResidualMean = 0.0;
+  fExtendedResidualMean = 0.0;
+
   double Swx = 0.0;
   double Sw = 0.0;
 
@@ -256,7 +261,9 @@ void VertexGeometry::LoadDigits(std::vector<RecoDigit>* vDigitList)
     fDistScatter[idigit] = 0.0;
 
     fDeltaTime[idigit] = 0.0;
-    fDeltaSigma[idigit] = 0.0;
+    // time resolution only depends on the digit type, so it is set once here
+    // rather than for every residual calculation
+    fDeltaSigma[idigit] = Parameters::TimeResolution(fDigitType[idigit]); //add by JW
     
     fDeltaAngle[idigit] = 0.0;
     fDeltaPoint[idigit] = 0.0;
@@ -425,11 +432,61 @@ void VertexGeometry::CalcResiduals(RecoVertex* myVertex)
 
 void VertexGeometry::CalcPointResiduals(double vtxX, double vtxY, double vtxZ, double vtxTime, double dirX, double dirY, double dirZ)
 {
-  this->CalcResiduals( vtxX, vtxY, vtxZ, vtxTime,
-                       dirX, dirY, dirZ );
+  // only the point residuals and the zenith angle are calculated here,
+  // the other per-digit quantities are left as they were.
+  // the geometry loop has no branches or calls other than sqrt,
+  // so that the compiler can vectorise it.
+
+  // light speed in water
+  // ====================
+  double fC = Parameters::SpeedOfLight();
+  double fN = Parameters::Index0(); //...chrom1.34, 1.333;
+  double fCn = fC/fN;
+
+  // loop over digits
+  // ================
+  for( int idigit=0; idigit<fNDigits; idigit++ ){
+    double dx = fDigitX[idigit]-vtxX;
+    double dy = fDigitY[idigit]-vtxY;
+    double dz = fDigitZ[idigit]-vtxZ;
+    double ds = sqrt(dx*dx+dy*dy+dz*dz);
+    double dt = fDigitT[idigit] - vtxTime;
+    double residual = dt - ds/fCn;
+
+    fDistPoint[idigit] = ds;
+    fDeltaTime[idigit] = dt;
+    fDeltaPoint[idigit] = ds/fCn;
+    fPointPath[idigit] = fN*ds;
+    fPointResidual[idigit] = residual;
+    fDelta[idigit] = residual;
+  }
 
+  // the sum is kept out of the loop above, which would not be vectorised otherwise
+  double Sx = 0.0;
   for( int idigit=0; idigit<fNDigits; idigit++ ){
-    fDelta[idigit] = fPointResidual[idigit];
+    Sx += fPointResidual[idigit];
+  }
+
+  if( fNDigits>0 ){
+    fPointResidualMean = Sx/fNDigits;
+  }
+
+  // zenith angle, if direction is known
+  // ===================================
+  if( dirX*dirX + dirY*dirY + dirZ*dirZ>0.0 ){
+    double degToRad = TMath::Pi()/180.0;
+    for( int idigit=0; idigit<fNDigits; idigit++ ){
+      double ds = fDistPoint[idigit];
+      double cosphi = ((fDigitX[idigit]-vtxX)/ds)*dirX
+                    + ((fDigitY[idigit]-vtxY)/ds)*dirY
+                    + ((fDigitZ[idigit]-vtxZ)/ds)*dirZ;
+      fZenith[idigit] = acos(cosphi)/degToRad; // degrees
+    }
+  }
+  else{
+    for( int idigit=0; idigit<fNDigits; idigit++ ){
+      fZenith[idigit] = 0.0;
+    }
   }
 
   return;
@@ -437,101 +494,80 @@ void VertexGeometry::CalcPointResiduals(double vtxX, double vtxY, double vtxZ, d
 
 void VertexGeometry::CalcExtendedResiduals(double vtxX, double vtxY, double vtxZ, double vtxTime, double dirX, double dirY, double dirZ )
 {
+  // CalcResiduals sets the extended residual as the default delta
   this->CalcResiduals( vtxX, vtxY, vtxZ, vtxTime,
                        dirX, dirY, dirZ );
 
-  for( int idigit=0; idigit<fNDigits; idigit++ ){
-    fDelta[idigit] = fExtendedResidual[idigit];
-  }
-
   //std::cout << fDelta[46] << std::endl;
   return;
 }
 
 void VertexGeometry::CalcResiduals(double vtxX, double vtxY, double vtxZ, double vtxTime, double dirX, double dirY, double dirZ )
 {
-  // reset arrays
-  // ============
-  for( int idigit=0; idigit<fNDigits; idigit++ ){
-    fConeAngle[idigit] = 0.0;
-    fZenith[idigit] = 0.0;
-    fAzimuth[idigit] = 0.0;
-    fSolidAngle[idigit] = 0.0;
-    fDistPoint[idigit] = 0.0;
-    fDistTrack[idigit] = 0.0;
-    fDistPhoton[idigit] = 0.0;  
-    fDistScatter[idigit] = 0.0; 
-    fDeltaTime[idigit] = 0.0; 
-    fDeltaSigma[idigit] = 0.0;
-    fDeltaAngle[idigit] = 0.0;
-    fDeltaPoint[idigit] = 0.0;
-    fDeltaTrack[idigit] = 0.0;
-    fDeltaPhoton[idigit] = 0.0;
-    fDeltaScatter[idigit] = 0.0;
-    fPointPath[idigit] = 0.0;
-    fExtendedPath[idigit] = 0.0;
-    fPointResidual[idigit] = 0.0;
-    fExtendedResidual[idigit] = 0.0;
-    fDelta[idigit] = 0.0;
-    fPointResidualMean = 0.0;
-    fExtendedResidualMean = 0.0;
-  }
   // cone angle
   // ==========
+  double degToRad = TMath::Pi()/180.0;
   double thetadeg = Parameters::CherenkovAngle(); // degrees
-  double theta = thetadeg*(TMath::Pi()/180.0); // degrees->radians
+  double theta = thetadeg*degToRad; // degrees->radians
+  double sintheta = sin(theta);
   //theta = acos(30.0/(29.0*1.38));
   //bool truehits = (Interface::Instance())->IsTrueHits(); 
 
+  // light speed in water
+  // ====================
+  double fC = Parameters::SpeedOfLight();
+  double fVmu = fC;
+  //double fN = Parameters::RefractiveIndex(Lphoton);
+  //chrom.....
+  double fN = Parameters::Index0(); //...chrom1.34, 1.333;
+  double fCn = fC/fN;
+
+  // track direction
+  // ===============
+  bool hasDirection = ( dirX*dirX + dirY*dirY + dirZ*dirZ>0.0 );
+  bool hasTransverse = ( dirX*dirX + dirY*dirY>0.0 );
+  double dirXY = hasTransverse ? sqrt(dirX*dirX+dirY*dirY) : 0.0;
+
   // loop over digits
   // ================
+  double SxPoint = 0.0;
+  double SxExtended = 0.0;
+
   for( int idigit=0; idigit<fNDigits; idigit++ ){
     double dx = fDigitX[idigit]-vtxX;
     double dy = fDigitY[idigit]-vtxY;
     double dz = fDigitZ[idigit]-vtxZ;
     double ds = sqrt(dx*dx+dy*dy+dz*dz);
 
-    //  std::cout<< "tttt "<< dx << " " << dy <<" " << dz << " " << ds << std::endl;
-
     double px = dx/ds;
     double py = dy/ds;
     double pz = dz/ds;
 
-    double cosphi = 1.0;
     double sinphi = 1.0;
     double phi = 0.0; 
     double phideg = 0.0;
-
-    double ax = 0.0;
-    double ay = 0.0;
-    double az = 0.0;
     double azideg = 0.0;
-    
 
     // calculate angles if direction is known
-    if( dirX*dirX + dirY*dirY + dirZ*dirZ>0.0 ){
+    if( hasDirection ){
 
       // zenith angle
-      cosphi = px*dirX+py*dirY+pz*dirZ;
+      double cosphi = px*dirX+py*dirY+pz*dirZ;
       phi = acos(cosphi); // radians
-      phideg = phi/(TMath::Pi()/180.0); // radians->degrees
+      phideg = phi/degToRad; // radians->degrees
       sinphi = sqrt(1.0-cosphi*cosphi);
       sinphi += 0.24*exp(-sinphi/0.24);
       sinphi /= 0.684;  // sin(phideg)/sin(thetadeg)
 
       // azimuthal angle
-      if( dirX*dirX+dirY*dirY>0.0 ){
-        ax = (px*dirZ-pz*dirX) - (py*dirX-px*dirY)*(1.0-dirZ)*dirY/sqrt(dirX*dirX+dirY*dirY);
-        ay = (py*dirZ-pz*dirY) - (px*dirY-py*dirX)*(1.0-dirZ)*dirX/sqrt(dirX*dirX+dirY*dirY);
-        az = pz*dirZ + py*dirY + px*dirX;
-      }
-      else{
-        ax = px;
-        ay = py;
-        az = pz;
+      double ax = px;
+      double ay = py;
+      if( hasTransverse ){
+        ax = (px*dirZ-pz*dirX) - (py*dirX-px*dirY)*(1.0-dirZ)*dirY/dirXY;
+        ay = (py*dirZ-pz*dirY) - (px*dirY-py*dirX)*(1.0-dirZ)*dirX/dirXY;
       }
 
-      azideg = atan2(ay,ax)/(TMath::Pi()/180.0); // radians->degrees
+      azideg = atan2(ay,ax)/degToRad; // radians->degrees
     }
 
     double Lpoint = ds;
@@ -540,8 +576,8 @@ void VertexGeometry::CalcResiduals(double vtxX, double vtxY, double vtxZ, double
     double Lscatter = 0.0;
  
     if( phi<theta ){
-      Ltrack = Lpoint*sin(theta-phi)/sin(theta);
-      Lphoton = Lpoint*sin(phi)/sin(theta);
+      Ltrack = Lpoint*sin(theta-phi)/sintheta;
+      Lphoton = Lpoint*sin(phi)/sintheta;
       Lscatter = 0.0;
     }
     
@@ -551,17 +587,8 @@ void VertexGeometry::CalcResiduals(double vtxX, double vtxY, double vtxZ, double
       Lscatter = Lpoint*(phi-theta);
     }
 
-    double fC = Parameters::SpeedOfLight();
-    double fVmu = fC;
-    //double fN = Parameters::RefractiveIndex(Lphoton);
-    //chrom.....
-    double fN = Parameters::Index0(); //...chrom1.34, 1.333;	
-
     double dt = fDigitT[idigit] - vtxTime; 
-    double qpes = fDigitQ[idigit];
-//    double tres = Parameters::TimeResolution(qpes);
-    double tres = Parameters::TimeResolution(fDigitType[idigit]); //add by JW
-//    double tres = Parameters::TimeResolution(fDigitType[idigit], qpes); //add by JW
+
     fConeAngle[idigit] = thetadeg; // degrees
     fZenith[idigit] = phideg;      // degrees
     fAzimuth[idigit] = azideg;     // degrees
@@ -573,34 +600,29 @@ void VertexGeometry::CalcResiduals(double vtxX, double vtxY, double vtxZ, double
     fDistScatter[idigit] = Lscatter;
 
     fDeltaTime[idigit] = dt;
-    fDeltaSigma[idigit] = tres;
-    
-    //    std::cout<<"REWRWEREWR "<<Lpoint<<" "<<fC<< " "<<fN<<" "<<(fC/fN)<<std::endl;
-
-
 
     fDeltaAngle[idigit] = phideg-thetadeg; // degrees
-    fDeltaPoint[idigit] = Lpoint/(fC/fN);
+    fDeltaPoint[idigit] = Lpoint/fCn;
     fDeltaTrack[idigit] = Ltrack/fVmu;
-    fDeltaPhoton[idigit] = Lphoton/(fC/fN);
-    fDeltaScatter[idigit] = Lscatter/(fC/fN);
+    fDeltaPhoton[idigit] = Lphoton/fCn;
+    fDeltaScatter[idigit] = Lscatter/fCn;
  
     fPointPath[idigit] = fN*Lpoint;
     fExtendedPath[idigit] = Ltrack + fN*Lphoton;
 
-    fPointResidual[idigit] = dt - Lpoint/(fC/fN);
-    fExtendedResidual[idigit] = dt - Ltrack/fVmu - Lphoton/(fC/fN);
+    fPointResidual[idigit] = dt - Lpoint/fCn;
+    fExtendedResidual[idigit] = dt - Ltrack/fVmu - Lphoton/fCn;
 
     fDelta[idigit] = fExtendedResidual[idigit]; // default.
+
+    SxPoint += fPointResidual[idigit];
+    SxExtended += fExtendedResidual[idigit];
   }
   
-  for( int idigit=0; idigit<fNDigits; idigit++ ){
-    fPointResidualMean += fPointResidual[idigit];
-    fExtendedResidualMean += fExtendedResidual[idigit];
+  if( fNDigits>0 ){
+    fPointResidualMean = SxPoint/fNDigits;
+    fExtendedResidualMean = SxExtended/fNDigits;
   }
-  
-  fPointResidualMean = fPointResidualMean/fNDigits;
-  fExtendedResidualMean = fExtendedResidualMean/fNDigits;
  //std::cout << "[CalcResiduals] (vtxX,vtxY,vtxZ,vtxTime) = (" << vtxX <<","<<vtxY<<","<<vtxZ<<","<<vtxTime<<"), (dirX,dirY,dirZ) = (" << dirX <<","<<dirY<<","<<dirZ << ")" << std::endl;
 
   return;
@@ -24,6 +24,10 @@ class VertexGeometry {
   void CalcResiduals(double vx, double vy, double vz, double vtxTime,
 		      double px, double py, double pz);
 
+  // CalcPointResiduals only fills the point residuals (distance, delta time,
+  // point path and residual) and the zenith angle, which is all the point
+  // figures of merit need. The other quantities need CalcResiduals or
+  // CalcExtendedResiduals.
   void CalcPointResiduals(double vx, double vy, double vz, double vtxTime,
 		           double px, double py, double pz);
   void CalcExtendedResiduals(double vx, double vy, double vz, double vtxTime,
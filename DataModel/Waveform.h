@@ -14,7 +14,7 @@ class Waveform : public SerialisableObject{
 
 	public:
   Waveform() : fStartTime(), fSamples(std::vector<T>{}) {serialise=true;}
-  Waveform(double tsin, std::vector<T> samplesin) : fStartTime(tsin), fSamples(samplesin){serialise=true;}
+  Waveform(double tsin, std::vector<T> samplesin) : fStartTime(tsin), fSamples(std::move(samplesin)){serialise=true;}
 
 	inline double GetStartTime() const {return fStartTime;}
 	inline std::vector<T>* GetSamples() {return &fSamples;}
@@ -33,18 +33,16 @@ bool ADCCalibrator::Execute() {
   }
 
   // Load the map containing the ADC raw waveform data
-  std::map<unsigned long, std::vector<Waveform<unsigned short> > >
-    raw_waveform_map;
-
-  bool got_raw_data = annie_event->Get("RawADCData", raw_waveform_map);
+  const auto* raw_waveform_map = ANNIEEventMember::Get<std::map<unsigned long,
+    std::vector<Waveform<unsigned short> > > >(annie_event, "RawADCData");
 
   // Check for problems
-  if ( !got_raw_data ) {
+  if ( !raw_waveform_map ) {
     Log("Error: The ADCCalibrator tool could not find the RawADCData entry", 0,
       verbosity);
     return false;
   }
-  else if ( raw_waveform_map.empty() ) {
+  else if ( raw_waveform_map->empty() ) {
     Log("Error: The ADCCalibrator tool found an empty RawADCData entry", 0,
       verbosity);
     return false;
@@ -54,7 +52,7 @@ bool ADCCalibrator::Execute() {
   std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > >
     calibrated_waveform_map;
 
-  for (const auto& temp_pair : raw_waveform_map) {
+  for (const auto& temp_pair : *raw_waveform_map) {
     const auto& channel_key = temp_pair.first;
     const auto& raw_waveforms = temp_pair.second;
 
@@ -65,7 +63,12 @@ bool ADCCalibrator::Execute() {
       raw_waveforms);
   }
 
-  annie_event->Set("CalibratedADCData", calibrated_waveform_map);
+  // The calibrated waveforms are only saved with the ANNIEEvent if asked for
+  bool persist_output = false;
+  m_variables.Get("PersistOutput", persist_output);
+
+  ANNIEEventMember::Publish(annie_event, "CalibratedADCData",
+    std::move(calibrated_waveform_map), persist_output);
 
   return true;
 }
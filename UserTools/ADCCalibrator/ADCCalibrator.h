@@ -7,6 +7,7 @@
 #pragma once
 
 // ToolAnalysis includes
+#include "ANNIEEventMember.h"
 #include "CalibratedADCWaveform.h"
 #include "Tool.h"
 #include "Waveform.h"
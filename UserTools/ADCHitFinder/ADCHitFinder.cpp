@@ -40,37 +40,33 @@ bool ADCHitFinder::Execute() {
     }
 
     // Load the map containing the ADC raw waveform data
-    std::map<unsigned long, std::vector<Waveform<unsigned short> > >
-      raw_waveform_map;
-
-    bool got_raw_data = annie_event->Get("RawADCData", raw_waveform_map);
+    const auto* raw_waveform_map = ANNIEEventMember::Get<std::map<unsigned long,
+      std::vector<Waveform<unsigned short> > > >(annie_event, "RawADCData");
 
     // Check for problems
-    if ( !got_raw_data ) {
+    if ( !raw_waveform_map ) {
       Log("Error: The ADCHitFinder tool could not find the RawADCData entry", 0,
         verbosity);
       return false;
     }
-    else if ( raw_waveform_map.empty() ) {
+    else if ( raw_waveform_map->empty() ) {
       Log("Error: The ADCHitFinder tool found an empty RawADCData entry", 0,
         verbosity);
       return false;
     }
 
     // Load the map containing the ADC calibrated waveform data
-    std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > >
-      calibrated_waveform_map;
-
-    bool got_calibrated_data = annie_event->Get("CalibratedADCData",
-      calibrated_waveform_map);
+    const auto* calibrated_waveform_map = ANNIEEventMember::Get<std::map<
+      unsigned long, std::vector<CalibratedADCWaveform<double> > > >(
+      annie_event, "CalibratedADCData");
 
     // Check for problems
-    if ( !got_calibrated_data ) {
+    if ( !calibrated_waveform_map ) {
       Log("Error: The ADCHitFinder tool could not find the CalibratedADCData"
         " entry", 0, verbosity);
       return false;
     }
-    else if ( calibrated_waveform_map.empty() ) {
+    else if ( calibrated_waveform_map->empty() ) {
       Log("Error: The ADCHitFinder tool found an empty CalibratedADCData entry",
         0, verbosity);
       return false;
@@ -86,11 +82,11 @@ bool ADCHitFinder::Execute() {
     // Build the map of pulses
     std::map<unsigned long, std::vector< std::vector<ADCPulse> > > pulse_map;
 
-    for (const auto& temp_pair : raw_waveform_map) {
+    for (const auto& temp_pair : *raw_waveform_map) {
       const auto& channel_key = temp_pair.first;
       const auto& raw_waveforms = temp_pair.second;
 
-      const auto& calibrated_waveforms = calibrated_waveform_map.at(channel_key);
+      const auto& calibrated_waveforms = calibrated_waveform_map->at(channel_key);
 
       // Ensure that the number of minibuffers is the same between the
       // sets of raw and calibrated waveforms for the current channel
@@ -134,7 +130,12 @@ bool ADCHitFinder::Execute() {
       pulse_map[channel_key] = pulse_vec;
     }
 
-    annie_event->Set("RecoADCHits", pulse_map);
+    // The pulses are only saved with the ANNIEEvent if asked for
+    bool persist_output = false;
+    m_variables.Get("PersistOutput", persist_output);
+
+    ANNIEEventMember::Publish(annie_event, "RecoADCHits", std::move(pulse_map),
+      persist_output);
 
     return true;
   }
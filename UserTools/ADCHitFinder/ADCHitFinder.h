@@ -5,6 +5,7 @@
 
 // ToolAnalysis includes
 #include "ADCPulse.h"
+#include "ANNIEEventMember.h"
 #include "CalibratedADCWaveform.h"
 #include "Tool.h"
 #include "Waveform.h"
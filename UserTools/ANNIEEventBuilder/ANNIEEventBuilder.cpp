@@ -18,10 +18,14 @@ bool ANNIEEventBuilder::Initialise(std::string configfile, DataModel &data){
   OrphanWarningValue = 20;
   MRDPMTTimeDiffTolerance = 10;   //ms
   DriftWarningValue = 5;           //ms
+  DriftTrackingEvents = 50;
   NumWavesInCompleteSet = 140;
   OrphanOldTankTimestamps = true;
   OldTimestampThreshold = 30; //seconds
   ExecutesPerBuild = 50;
+  OutputFormat = "BoostStore";
+  RecordEventsPerFlush = 100;
+  ColumnEventsPerChunk = 100;
 
   /////////////////////////////////////////////////////////////////
   //FIXME: Need rough scan and tolerances in variable settings
@@ -34,6 +38,23 @@ bool ANNIEEventBuilder::Initialise(std::string configfile, DataModel &data){
   m_variables.Get("OrphanOldTankTimestamps",OrphanOldTankTimestamps);
   m_variables.Get("OldTimestampThreshold",OldTimestampThreshold);
   m_variables.Get("ExecutesPerBuild",ExecutesPerBuild);
+  m_variables.Get("DriftTrackingEvents",DriftTrackingEvents);
+  if(DriftTrackingEvents < 1) DriftTrackingEvents = 1;
+  m_variables.Get("OutputFormat",OutputFormat);
+  m_variables.Get("RecordEventsPerFlush",RecordEventsPerFlush);
+  m_variables.Get("ColumnEventsPerChunk",ColumnEventsPerChunk);
+
+  if(OutputFormat == "RecordFile"){
+    UseRecordFile = true;
+    RecordWriter.SetEventsPerFlush(RecordEventsPerFlush);
+  } else if(OutputFormat == "ColumnFile"){
+    UseColumnFile = true;
+    ColumnWriter.SetEventsPerChunk(ColumnEventsPerChunk);
+  } else if(OutputFormat != "BoostStore"){
+    std::cout << "BuildANNIEEvent ERROR: OutputFormat not recognized! " <<
+        "Please select BoostStore, RecordFile or ColumnFile" << std::endl;
+    return false;
+  }
 
   if(BuildType == "TankAndMRD"){
     std::cout << "BuildANNIEEvent Building Tank and MRD-merged ANNIE events. " <<
@@ -49,13 +70,16 @@ bool ANNIEEventBuilder::Initialise(std::string configfile, DataModel &data){
     return false;
   }
 
-  m_data->CStore.Get("TankPMTCrateSpaceToChannelNumMap",TankPMTCrateSpaceToChannelNumMap);
-  m_data->CStore.Get("AuxCrateSpaceToChannelNumMap",AuxCrateSpaceToChannelNumMap);
-  m_data->CStore.Get("MRDCrateSpaceToChannelNumMap",MRDCrateSpaceToChannelNumMap);
+  bool got_table = m_data->CStore.Get("CrateSpaceTable",CrateSpace);
+  if(!got_table || CrateSpace==nullptr){
+    std::cout << "BuildANNIEEvent ERROR: No CrateSpaceTable in the CStore. " <<
+        "Is LoadGeometry run first?" << std::endl;
+    return false;
+  }
 
   if(BuildType == "Tank" || BuildType == "TankAndMRD"){
-    int NumTankPMTChannels = TankPMTCrateSpaceToChannelNumMap.size();
-    int NumAuxChannels = AuxCrateSpaceToChannelNumMap.size();
+    int NumTankPMTChannels = CrateSpace->Size(CrateSpaceTable::TankPMT);
+    int NumAuxChannels = CrateSpace->Size(CrateSpaceTable::Aux);
     if(verbosity>4) std::cout << "TOTAL TANK + AUX CHANNELS: " << NumTankPMTChannels + NumAuxChannels << std::endl;
     if(verbosity>4) std::cout << "CURRENT SET THRESHOLD FOR BUILDING PMT EVENTS: " << NumWavesInCompleteSet << std::endl;
   }
@@ -125,10 +149,10 @@ bool ANNIEEventBuilder::Execute(){
     
     //Assume a whole processed file will have all it's PMT data finished
     std::vector<uint64_t> PMTEventsToDelete;
-    for(std::pair<uint64_t,std::map<std::vector<int>, std::vector<uint16_t>>> apair : *InProgressTankEvents){
+    for(std::pair<const uint64_t,TankWaveMap>& apair : *InProgressTankEvents){
       uint64_t PMTCounterTime = apair.first;
       if(verbosity>4) std::cout << "Finished waveset has clock counter: " << PMTCounterTime << std::endl;
-      std::map<std::vector<int>, std::vector<uint16_t>> aWaveMap = apair.second;
+      TankWaveMap& aWaveMap = apair.second;
       if(verbosity>4) std::cout << "Number of waves for this counter: " << aWaveMap.size() << std::endl;
       //For this counter, need to have the number of TankPMT channels plus number of aux channels
       if(aWaveMap.size() >= (NumWavesInCompleteSet)){
@@ -147,39 +171,24 @@ bool ANNIEEventBuilder::Execute(){
 
   } else if (BuildType == "MRD"){
     m_data->CStore.Get("NewMRDDataAvailable",IsNewMRDData);
-    std::vector<unsigned long> MRDEventsToDelete;
     if(!IsNewMRDData){
       Log("ANNIEEventBuilder:: No new MRD Data.  Not building ANNIEEvent: ",v_message, verbosity);
       return true;
     }
-    m_data->CStore.Get("MRDEvents",MRDEvents);
-    m_data->CStore.Get("MRDEventTriggerTypes",TriggerTypeMap);
-    m_data->CStore.Get("MRDBeamLoopback",MRDBeamLoopbackMap);
-    m_data->CStore.Get("MRDCosmicLoopback",MRDCosmicLoopbackMap);
+    bool got_mrdevents = m_data->CStore.Get("MRDEvents",MRDEvents);
+    if(!got_mrdevents){
+      Log("ANNIEEventBuilder Tool: Error! No MRDEvents pointer in CStore!",v_error, verbosity);
+      return false;
+    }
     
    //Loop through MRDEvents and process each into ANNIEEvent.
-    for(std::pair<unsigned long,std::vector<std::pair<unsigned long,int>>> apair : MRDEvents){
-      unsigned long MRDTimeStamp = apair.first;
-      std::vector<std::pair<unsigned long,int>> MRDHits = apair.second;
-      std::string MRDTriggerType = TriggerTypeMap[MRDTimeStamp];
-      int beam_tdc = MRDBeamLoopbackMap[MRDTimeStamp];
-      int cosmic_tdc = MRDCosmicLoopbackMap[MRDTimeStamp];
+    for(const std::pair<const uint64_t,MRDTriggerRecord>& apair : *MRDEvents){
       this->BuildANNIEEventRunInfo(RunNumber,SubRunNumber,RunType,StarTime);
-      this->BuildANNIEEventMRD(MRDHits, MRDTimeStamp, MRDTriggerType, beam_tdc, cosmic_tdc);
+      this->BuildANNIEEventMRD(apair.second, apair.first);
       this->SaveEntryToFile(RunNumber,SubRunNumber);
-      //Erase this entry from the InProgressTankEventsMap
-      MRDEventsToDelete.push_back(MRDTimeStamp);
     }
-    for (unsigned int i=0; i< MRDEventsToDelete.size(); i++){
-      MRDEvents.erase(MRDEventsToDelete.at(i));
-      TriggerTypeMap.erase(MRDEventsToDelete.at(i));
-      MRDBeamLoopbackMap.erase(MRDEventsToDelete.at(i));
-      MRDCosmicLoopbackMap.erase(MRDEventsToDelete.at(i));
-    }
-    m_data->CStore.Set("MRDEvents",MRDEvents);
-    m_data->CStore.Set("MRDEventTriggerTypes",TriggerTypeMap);
-    m_data->CStore.Set("MRDBeamLoopback",MRDBeamLoopbackMap);
-    m_data->CStore.Set("MRDCosmicLoopback",MRDCosmicLoopbackMap);
+    //All of them are built
+    MRDEvents->clear();
   }
 
   else if (BuildType == "TankAndMRD"){
@@ -196,29 +205,23 @@ bool ANNIEEventBuilder::Execute(){
     m_data->CStore.Get("NewTankPMTDataAvailable",IsNewTankData);
     if(IsNewTankData){
       if(verbosity>3) std::cout << "ANNIEEventBuilder Tool: Processing new tank data " << std::endl;
-      for(std::pair<uint64_t,std::map<std::vector<int>, std::vector<uint16_t>>> apair : *InProgressTankEvents){
+      for(std::pair<const uint64_t,TankWaveMap>& apair : *InProgressTankEvents){
         uint64_t PMTCounterTimeNs = apair.first;
-        std::map<std::vector<int>, std::vector<uint16_t>> aWaveMap = apair.second;
+        TankWaveMap& aWaveMap = apair.second;
         if(verbosity>4) std::cout << "Number of waves for this counter: " << aWaveMap.size() << std::endl;
         
-        //Push back any new timestamps, then remove duplicates in the end
-        //FIXME: Should be able to speed this up with sets rather than vectors?
-        UnpairedTankTimestamps.push_back(PMTCounterTimeNs);
+        //The set ignores timestamps already seen
+        UnpairedTankTimestamps.insert(PMTCounterTimeNs);
         if(PMTCounterTimeNs>NewestTimestamp){
           NewestTimestamp = PMTCounterTimeNs;
           if(verbosity>3)std::cout << "TANKTIMESTAMP," << PMTCounterTimeNs << std::endl;
         }
-        //if(std::find(UnpairedTankTimestamps.begin(),UnpairedTankTimestamps.end(), PMTCounterTimeNs) == 
-         //            UnpairedTankTimestamps.end()){
-         // UnpairedTankTimestamps.push_back(PMTCounterTimeNs);  //Units in ns
-        //}
         //If this trigger has all of it's waveforms, add it to the finished
         //Events and delete it from the in-progress events
-        int NumTankPMTChannels = TankPMTCrateSpaceToChannelNumMap.size();
-        int NumAuxChannels = AuxCrateSpaceToChannelNumMap.size();
         if(aWaveMap.size() >= (NumWavesInCompleteSet)){
-          FinishedTankEvents.emplace(PMTCounterTimeNs,aWaveMap);
-          FinishedTankTimestamps.push_back(PMTCounterTimeNs);
+          //The in-progress entry is erased below, so its waves can be moved
+          FinishedTankEvents.emplace(PMTCounterTimeNs,std::move(aWaveMap));
+          FinishedTankTimestamps.insert(PMTCounterTimeNs);
           //Put PMT timestamp into the timestamp set for this run.
           if(verbosity>4) std::cout << "Finished waveset has clock counter: " << PMTCounterTimeNs << std::endl;
           InProgressEventsToDelete.push_back(PMTCounterTimeNs);
@@ -230,30 +233,22 @@ bool ANNIEEventBuilder::Execute(){
           InProgressEventsToDelete.push_back(PMTCounterTimeNs);
         }
       }
-      RemoveDuplicates(UnpairedTankTimestamps);
     }
     
     //Look through our MRD data for any new timestamps
-    m_data->CStore.Get("MRDEventTriggerTypes",TriggerTypeMap);
     m_data->CStore.Get("NewMRDDataAvailable",IsNewMRDData);
-    m_data->CStore.Get("MRDEvents",MRDEvents);
-    m_data->CStore.Get("MRDBeamLoopback",MRDBeamLoopbackMap);
-    m_data->CStore.Get("MRDCosmicLoopback",MRDCosmicLoopbackMap);
+    bool got_mrdevents = m_data->CStore.Get("MRDEvents",MRDEvents);
+    if(!got_mrdevents){
+      Log("ANNIEEventBuilder Tool: Error! No MRDEvents pointer in CStore!",v_error, verbosity);
+      return false;
+    }
     if(IsNewMRDData){
-      for(std::pair<unsigned long,std::vector<std::pair<unsigned long,int>>> apair : MRDEvents){
-        unsigned long MRDTimeStamp = apair.first;
-        std::vector<std::pair<unsigned long,int>> MRDHits = apair.second;
-        //See if this MRD timestamp has been encountered before; if not,
-        //add it to our MRD timestamp record
-        //FIXME: should be able to speed up using sets?
-        UnpairedMRDTimestamps.push_back(MRDTimeStamp);
-        //if(std::find(UnpairedMRDTimestamps.begin(),UnpairedMRDTimestamps.end(), MRDTimeStamp) == 
-        //             UnpairedMRDTimestamps.end()){
-        //  UnpairedMRDTimestamps.push_back(MRDTimeStamp);
-        //}
-        if(verbosity>3)std::cout << "MRDTIMESTAMPTRIGTYPE," << MRDTimeStamp << "," << TriggerTypeMap.at(MRDTimeStamp) << std::endl;
+      for(const std::pair<const uint64_t,MRDTriggerRecord>& apair : *MRDEvents){
+        uint64_t MRDTimeStamp = apair.first;
+        //Add it to our MRD timestamp record; the set ignores timestamps already seen
+        UnpairedMRDTimestamps.insert(MRDTimeStamp);
+        if(verbosity>3)std::cout << "MRDTIMESTAMPTRIGTYPE," << MRDTimeStamp << "," << apair.second.TriggerType << std::endl;
       }
-      RemoveDuplicates(UnpairedMRDTimestamps);
     }
     //Since timestamp pairing has been done for finished Tank Events,
     //Erase the finished Tank Events from the InProgressTankEventsMap
@@ -277,33 +272,23 @@ bool ANNIEEventBuilder::Execute(){
       std::vector<uint64_t> BuiltTankTimes;
       for(std::pair<uint64_t,uint64_t> cpair : UnbuiltTankMRDPairs){
         uint64_t TankCounterTime = cpair.first;
-        if(std::find(FinishedTankTimestamps.begin(),FinishedTankTimestamps.end(), TankCounterTime) == 
-                     FinishedTankTimestamps.end()){
-          continue;
-        }
+        if(FinishedTankTimestamps.count(TankCounterTime) == 0) continue;
         if(verbosity>4) std::cout << "TANK EVENT WITH TIMESTAMP " << TankCounterTime << "HAS REQUIRED MINIMUM NUMBER OF WAVES TO BUILD" << std::endl;
-        std::map<std::vector<int>, std::vector<uint16_t>> aWaveMap = FinishedTankEvents.at(TankCounterTime);
+        TankWaveMap& aWaveMap = FinishedTankEvents.at(TankCounterTime);
         uint64_t MRDTimeStamp = cpair.second;
         if(verbosity>4) std::cout << "MRD TIMESTAMP: " << MRDTimeStamp << std::endl;
-        std::vector<std::pair<unsigned long,int>> MRDHits = MRDEvents.at(MRDTimeStamp);
-        std::string MRDTriggerType = TriggerTypeMap[MRDTimeStamp];
-        int beam_tdc = MRDBeamLoopbackMap[MRDTimeStamp];
-        int cosmic_tdc = MRDCosmicLoopbackMap[MRDTimeStamp];
+        const MRDTriggerRecord& MRDEvent = MRDEvents->at(MRDTimeStamp);
         if(verbosity>4) std::cout << "BUILDING AN ANNIE EVENT" << std::endl;
         this->BuildANNIEEventRunInfo(CurrentRunNum, CurrentSubRunNum, CurrentRunType,CurrentStarTime);
         this->BuildANNIEEventTank(TankCounterTime, aWaveMap);
-        this->BuildANNIEEventMRD(MRDHits, MRDTimeStamp, MRDTriggerType, beam_tdc, cosmic_tdc);
+        this->BuildANNIEEventMRD(MRDEvent, MRDTimeStamp);
         this->SaveEntryToFile(CurrentRunNum,CurrentSubRunNum);
         if(verbosity>4) std::cout << "BUILT AN ANNIE EVENT SUCCESSFULLY" << std::endl;
         //Erase this entry from maps/vectors used when pairing completed events 
         BuiltTankTimes.push_back(TankCounterTime);
         FinishedTankEvents.erase(TankCounterTime);
-        MRDEvents.erase(MRDTimeStamp);
-        TriggerTypeMap.erase(MRDTimeStamp);
-        MRDBeamLoopbackMap.erase(MRDTimeStamp);
-        MRDCosmicLoopbackMap.erase(MRDTimeStamp);
-        FinishedTankTimestamps.erase(std::remove(FinishedTankTimestamps.begin(),FinishedTankTimestamps.end(),TankCounterTime), 
-                   FinishedTankTimestamps.end());
+        MRDEvents->erase(MRDTimeStamp);
+        FinishedTankTimestamps.erase(TankCounterTime);
       }
       for(int i=0; i<BuiltTankTimes.size(); i++){
         UnbuiltTankMRDPairs.erase(BuiltTankTimes.at(i));
@@ -312,17 +297,6 @@ bool ANNIEEventBuilder::Execute(){
   
   }
   
-  //m_data->CStore.Set("InProgressTankEvents",InProgressTankEvents);
-  m_data->CStore.Set("MRDEvents",MRDEvents);
-  m_data->CStore.Set("MRDEventTriggerTypes",TriggerTypeMap);
-  m_data->CStore.Set("MRDBeamLoopback",MRDBeamLoopbackMap);
-  m_data->CStore.Set("MRDCosmicLoopback",MRDCosmicLoopbackMap);
-  //InProgressTankEvents.clear();
-  MRDEvents.clear();
-  TriggerTypeMap.clear();
-  MRDBeamLoopbackMap.clear();
-  MRDCosmicLoopbackMap.clear();
-
   ExecuteCount = 0;
   return true;
 }
@@ -334,6 +308,8 @@ bool ANNIEEventBuilder::Finalise(){
   ANNIEEvent->Close();
   ANNIEEvent->Delete();
   delete ANNIEEvent;
+  RecordWriter.Close();
+  ColumnWriter.Close();
   if(verbosity>2) std::cout << "PMT/MRD Orphan number at finalise: " << OrphanTankTimestamps.size() <<
           "," << OrphanMRDTimestamps.size() << std::endl;
   //Save the current subrun and delete ANNIEEvent
@@ -354,135 +330,160 @@ void ANNIEEventBuilder::PauseDecodingOnAheadStream(){
 }
 
 void ANNIEEventBuilder::RemoveCosmics(){
-  std::vector<uint64_t> MRDStampsToDelete;
-  for (int i=0;i<(UnpairedMRDTimestamps.size()); i++) {
-    std::string MRDTriggerType = TriggerTypeMap[UnpairedMRDTimestamps.at(i)];
+  std::set<uint64_t>::iterator it = UnpairedMRDTimestamps.begin();
+  while (it != UnpairedMRDTimestamps.end()) {
+    uint64_t MRDTimeStamp = *it;
+    MRDEventMap::const_iterator MRDEvent = MRDEvents->find(MRDTimeStamp);
+    std::string MRDTriggerType = (MRDEvent != MRDEvents->end()) ? MRDEvent->second.TriggerType : "";
     if(verbosity>4) std::cout << "THIS MRD TRIGGER TYPE IS: " << MRDTriggerType << std::endl;
-    if(MRDTriggerType == "Cosmic"){
-      MRDStampsToDelete.push_back(UnpairedMRDTimestamps.at(i));
-      if(verbosity>3){
-        std::cout << "NO BEAM COSMIC COSMIC IS: " << UnpairedMRDTimestamps.at(i) << std::endl;
-        std::cout << "DELETING FROM TIMESTAMPS TO PAIR/BUILD" << std::endl;
-      }
+    if(MRDTriggerType != "Cosmic"){
+      ++it;
+      continue;
     }
-  }
-  for (int j=0; j<MRDStampsToDelete.size(); j++){
-    UnpairedMRDTimestamps.erase(std::remove(UnpairedMRDTimestamps.begin(),UnpairedMRDTimestamps.end(),MRDStampsToDelete.at(j)), 
-               UnpairedMRDTimestamps.end());
-    MRDEvents.erase(MRDStampsToDelete.at(j));
-    TriggerTypeMap.erase(MRDStampsToDelete.at(j));
-    MRDBeamLoopbackMap.erase(MRDStampsToDelete.at(j));
-    MRDCosmicLoopbackMap.erase(MRDStampsToDelete.at(j));
+    if(verbosity>3){
+      std::cout << "NO BEAM COSMIC COSMIC IS: " << MRDTimeStamp << std::endl;
+      std::cout << "DELETING FROM TIMESTAMPS TO PAIR/BUILD" << std::endl;
+    }
+    it = UnpairedMRDTimestamps.erase(it);
+    MRDEvents->erase(MRDTimeStamp);
   }
   return;
 }
 
 
-void ANNIEEventBuilder::CalculateSlidWindows(std::vector<uint64_t> FirstTimestampSet,
-        std::vector<uint64_t> SecondTimestampSet, int shift, double& tmean, double& tvar)
+void ANNIEEventBuilder::CalculateSlidWindows(const std::vector<uint64_t>& FirstTimestampSet,
+        const std::vector<uint64_t>& SecondTimestampSet, int shift, double& tmean, double& tvar)
 {
-  //Build offsets vectors used to sync streams
-  //std::vector<uint64_t> PMTOffsets;
-  //std::vector<uint64_t> MRDOffsets;
-  //for (int j=1; j<EventsPerPairing*2; j++){
-  //  PMTOffsets.push_back((FirstTimestampSet.at(j)/1E6) - (FirstTimestampSet.at(j-1)/1E6));
-  //  MRDOffsets.push_back(SecondTimestampSet.at(j)- SecondTimestampSet.at(j-1));
-  //}
- 
   //TO-DO: We should look at the overall mean of the unshifted differnces.
   //Depending on the sign, choose whether to slide the MRD or PMT dataset
-  //slide earliest times in MRD offset off the left
-  std::vector<uint64_t> MRDTS_copy = SecondTimestampSet;
-  std::vector<uint64_t> PMTTS_copy = FirstTimestampSet;
-  //std::vector<uint64_t> SlidMRDOffsets = MRDOffsets;
-  //std::vector<uint64_t> SlidPMTOffsets = PMTOffsets;
-  //std::cout << "SLIDING OFFSETS" << std::endl;
-  //SlidMRDOffsets.erase(SlidMRDOffsets.begin(),SlidMRDOffsets.begin()+shift);
-  //SlidPMTOffsets.erase(SlidPMTOffsets.end()-shift,SlidPMTOffsets.end());
-  MRDTS_copy.erase(MRDTS_copy.begin(),MRDTS_copy.begin()+shift);
-  PMTTS_copy.erase(PMTTS_copy.end()-shift,PMTTS_copy.end());
+  //Slide earliest times in the second set off the left by indexing it with the shift
   std::vector<double> TSDifferences;
-  //std::vector<double> OffsetDifferences;
+  TSDifferences.reserve(EventsPerPairing*2);
   for (int k=0; k<EventsPerPairing*2; k++){
-    if(verbosity>4){ 
-      std::cout << "PMT-MRD TIMESTAMP: " << static_cast<double>(PMTTS_copy.at(k)) - 
-              static_cast<double>(MRDTS_copy.at(k))  << std::endl;
-      //std::cout << "OFFSET DIFF: " << static_cast<double>(SlidPMTOffsets.at(k)) - 
-      //        static_cast<double>(SlidMRDOffsets.at(k))  << std::endl;
-    }
-    //OffsetDifferences.push_back(static_cast<double>(SlidPMTOffsets.at(k)) - static_cast<double>(SlidMRDOffsets.at(k)));
-    TSDifferences.push_back(static_cast<double>(PMTTS_copy.at(k)) - static_cast<double>(MRDTS_copy.at(k)));
+    double TSDifference = static_cast<double>(FirstTimestampSet.at(k)) - static_cast<double>(SecondTimestampSet.at(k+shift));
+    if(verbosity>4) std::cout << "PMT-MRD TIMESTAMP: " << TSDifference << std::endl;
+    TSDifferences.push_back(TSDifference);
   }
   double mean,var;
-  //double omean,ovar;
   ComputeMeanAndVariance(TSDifferences,mean,var);
   tmean = mean;
   tvar = var;
-  //ComputeMeanAndVariance(OffsetDifferences,omean,ovar);
   if(verbosity>4){
     std::cout << "SHIFTING MRD ARRAY BACK BY " << shift << " INDICES..." << std::endl;
     std::cout << "MEAN TS SHIFT: " << mean << std::endl;
     std::cout << "VARIANCE TS SHIFT: " << var << std::endl;
-    //std::cout << "MEAN OF OFFSETS: " << omean << std::endl;
-    //std::cout << "VARIANCE OF OFFSETS: " << ovar << std::endl;
   }
   return;
 }
 
+double ANNIEEventBuilder::TankTimestampToMRDTime(uint64_t TankTimestamp)
+{
+  //PMT counter times are in ns; MRD timestamps are in ms and offset by 6 hours
+  return (static_cast<double>(TankTimestamp/1E6) - 21600000.0);
+}
+
+void ANNIEEventBuilder::ResyncStreams(double TSDiff, double DriftEstimate, std::set<uint64_t>::iterator& TankIt,
+        std::set<uint64_t>::iterator& MRDIt, int& NumOrphans)
+{
+  //The fronts of the two streams don't pair.  The stream whose front is earlier has
+  //extra events (or the other stream lost some).  Binary search the later front's
+  //partner in the earlier stream; if it's there, everything in the earlier stream
+  //before it is orphaned in one go.  Otherwise the later front itself has no partner.
+  if(TSDiff > 0){
+    //MRD front is earlier.  Look for the tank front's MRD partner.
+    double MRDTarget = TankTimestampToMRDTime(*TankIt) - DriftEstimate;
+    double LowestMRDTime = std::max(0.0, MRDTarget - MRDPMTTimeDiffTolerance);
+    std::set<uint64_t>::iterator Partner = UnpairedMRDTimestamps.lower_bound(static_cast<uint64_t>(std::ceil(LowestMRDTime)));
+    if(Partner == UnpairedMRDTimestamps.end()){
+      //Partner may not be decoded yet; only the MRD front is known to be out of step
+      if(verbosity>3) std::cout << "MOVING MRD TIMESTAMP TO ORPHANAGE" << std::endl;
+      OrphanMRDTimestamps.push_back(*MRDIt);
+      NumOrphans+=1;
+      MRDIt = UnpairedMRDTimestamps.erase(MRDIt);
+      return;
+    }
+    if(std::abs(static_cast<double>(*Partner) - MRDTarget) > MRDPMTTimeDiffTolerance){
+      if(verbosity>3) std::cout << "MOVING TANK TIMESTAMP TO ORPHANAGE" << std::endl;
+      OrphanTankTimestamps.push_back(*TankIt);
+      NumOrphans+=1;
+      TankIt = UnpairedTankTimestamps.erase(TankIt);
+      return;
+    }
+    if(verbosity>3) std::cout << "MOVING " << std::distance(MRDIt,Partner) << " MRD TIMESTAMPS TO ORPHANAGE" << std::endl;
+    for (std::set<uint64_t>::iterator it = MRDIt; it != Partner; ++it) OrphanMRDTimestamps.push_back(*it);
+    NumOrphans += std::distance(MRDIt,Partner);
+    MRDIt = UnpairedMRDTimestamps.erase(MRDIt,Partner);
+    return;
+  } else {
+    //Tank front is earlier.  Look for the MRD front's tank partner.
+    double TankTarget = (static_cast<double>(*MRDIt) + DriftEstimate + 21600000.0)*1E6;
+    double LowestTankTime = std::max(0.0, TankTarget - MRDPMTTimeDiffTolerance*1E6);
+    std::set<uint64_t>::iterator Partner = UnpairedTankTimestamps.lower_bound(static_cast<uint64_t>(std::ceil(LowestTankTime)));
+    if(Partner == UnpairedTankTimestamps.end()){
+      if(verbosity>3) std::cout << "MOVING TANK TIMESTAMP TO ORPHANAGE" << std::endl;
+      OrphanTankTimestamps.push_back(*TankIt);
+      NumOrphans+=1;
+      TankIt = UnpairedTankTimestamps.erase(TankIt);
+      return;
+    }
+    if(std::abs(static_cast<double>(*Partner) - TankTarget) > MRDPMTTimeDiffTolerance*1E6){
+      if(verbosity>3) std::cout << "MOVING MRD TIMESTAMP TO ORPHANAGE" << std::endl;
+      OrphanMRDTimestamps.push_back(*MRDIt);
+      NumOrphans+=1;
+      MRDIt = UnpairedMRDTimestamps.erase(MRDIt);
+      return;
+    }
+    if(verbosity>3) std::cout << "MOVING " << std::distance(TankIt,Partner) << " TANK TIMESTAMPS TO ORPHANAGE" << std::endl;
+    for (std::set<uint64_t>::iterator it = TankIt; it != Partner; ++it) OrphanTankTimestamps.push_back(*it);
+    NumOrphans += std::distance(TankIt,Partner);
+    TankIt = UnpairedTankTimestamps.erase(TankIt,Partner);
+  }
+  return;
+}
 
 void ANNIEEventBuilder::PairTankPMTAndMRDTriggers(){
-  //FIXME: I'm noticing a ~ms drift in the main sync pattern per 1000 events.  Let's have
-  //A variable updated with the mean from all paired events in the previous iteration.  Add
-  //This correction to the difference check, then update it with this built set's mean for
-  //the next iteration of the method.`
+  //Both unpaired timestamp sets are sorted, so pairing is a single merge from the
+  //front of the two streams.  The PMT-MRD time difference drifts by ~ms per 1000 events,
+  //so the tolerance window is centred on a running drift estimate that follows the
+  //pairs as they are made.  CurrentDriftMean carries it over to the next pairing.
   if(verbosity>4) std::cout << "ANNIEEventBuilder Tool: Beginning to pair events" << std::endl;
-  //Organize Unpaired timestamps chronologically
-  //std::sort(UnpairedMRDTimestamps.begin(),UnpairedMRDTimestamps.end());
-  //std::sort(UnpairedTankTimestamps.begin(),UnpairedTankTimestamps.end());
   
-  std::vector<uint64_t> TankStampsToDelete;
-  std::vector<uint64_t> MRDStampsToDelete;
-  int NumPairsToMake = EventsPerPairing;
   std::vector<double> ThisPairingTSDiffs;
+  ThisPairingTSDiffs.reserve(EventsPerPairing);
+  double DriftEstimate = CurrentDriftMean;
 
   int NumOrphans = 0;
+  int NumPairsMade = 0;
   if(verbosity>4) std::cout << "MEAN OF PMT-MRD TIME DIFFERENCE LAST LOOP: " << CurrentDriftMean << std::endl;
-  for (int i=0;i<(NumPairsToMake); i++) {
-    double TSDiff = (static_cast<double>(UnpairedTankTimestamps.at(i)/1E6) - 21600000.0) - static_cast<double>(UnpairedMRDTimestamps.at(i));
+  std::set<uint64_t>::iterator TankIt = UnpairedTankTimestamps.begin();
+  std::set<uint64_t>::iterator MRDIt = UnpairedMRDTimestamps.begin();
+  while (NumPairsMade < EventsPerPairing && TankIt != UnpairedTankTimestamps.end() &&
+          MRDIt != UnpairedMRDTimestamps.end()) {
+    double TSDiff = TankTimestampToMRDTime(*TankIt) - static_cast<double>(*MRDIt);
     if(verbosity>4){
-      std::cout << "PAIRED TANK TIMESTAMP: " << UnpairedTankTimestamps.at(i) << std::endl;
-      std::cout << "PAIRED MRD TIMESTAMP: " << UnpairedMRDTimestamps.at(i) << std::endl;
-      std::cout << "DIFFERENCE BETWEEN PMT AND MRD TIMESTAMP (ms): " << 
-      (((UnpairedTankTimestamps.at(i)/1E6) - 21600000) - UnpairedMRDTimestamps.at(i)) << std::endl;
+      std::cout << "PAIRED TANK TIMESTAMP: " << *TankIt << std::endl;
+      std::cout << "PAIRED MRD TIMESTAMP: " << *MRDIt << std::endl;
+      std::cout << "DIFFERENCE BETWEEN PMT AND MRD TIMESTAMP (ms): " << TSDiff << std::endl;
     }
-    if(std::abs(TSDiff-CurrentDriftMean) > MRDPMTTimeDiffTolerance){
+    if(std::abs(TSDiff-DriftEstimate) > MRDPMTTimeDiffTolerance){
       if(verbosity>3) std::cout << "DEVIATION OF " << MRDPMTTimeDiffTolerance << " ms DETECTED IN STREAMS!" << std::endl;
-      if(TSDiff > 0) {
-        if(verbosity>3) std::cout << "MOVING MRD TIMESTAMP TO ORPHANAGE" << std::endl;
-        OrphanMRDTimestamps.push_back(UnpairedMRDTimestamps.at(i));
-        NumOrphans +=1;
-        UnpairedMRDTimestamps.erase(std::remove(UnpairedMRDTimestamps.begin(),UnpairedMRDTimestamps.end(),UnpairedMRDTimestamps.at(i)), 
-             UnpairedMRDTimestamps.end());
-      } else {
-        if(verbosity>3) std::cout << "MOVING TANK TIMESTAMP TO ORPHANAGE" << std::endl;
-        OrphanTankTimestamps.push_back(UnpairedTankTimestamps.at(i));
-        NumOrphans +=1;
-        UnpairedTankTimestamps.erase(std::remove(UnpairedTankTimestamps.begin(),UnpairedTankTimestamps.end(),UnpairedTankTimestamps.at(i)), 
-             UnpairedTankTimestamps.end());
-      }
-      i-=1;
-      NumPairsToMake-=1;
-    } else {
-      ThisPairingTSDiffs.push_back(TSDiff);
+      this->ResyncStreams(TSDiff-DriftEstimate, DriftEstimate, TankIt, MRDIt, NumOrphans);
+      continue;
     }
+    UnbuiltTankMRDPairs.emplace(*TankIt,*MRDIt);
+    ThisPairingTSDiffs.push_back(TSDiff);
+    DriftEstimate += (TSDiff-DriftEstimate)/DriftTrackingEvents;
+    TankIt = UnpairedTankTimestamps.erase(TankIt);
+    MRDIt = UnpairedMRDTimestamps.erase(MRDIt);
+    NumPairsMade+=1;
   }
+  if(verbosity>4) std::cout << "PAIRED " << NumPairsMade << " EVENTS, " << NumOrphans << " ORPHANS" << std::endl;
 
   //With the last set of pairs calculate what the mean drift is
   //TODO: Error handling for high drift and high orphan rates?
   //TODO: Try to pair up orphans at some point?
   double ThisPairingMean, ThisPairingVariance;
   if(ThisPairingTSDiffs.size()>2){
-    ComputeMeanAndVariance(ThisPairingTSDiffs,CurrentDriftMean,CurrentDriftVariance);
     ComputeMeanAndVariance(ThisPairingTSDiffs,ThisPairingMean,ThisPairingVariance);
     if(std::abs(CurrentDriftMean-ThisPairingMean)>DriftWarningValue){
       std::cout << "ANNIEEventBuilder tool: WARNING! Shift in drift greater than " << DriftWarningValue << " since last pairings." << std::endl;
@@ -490,35 +491,17 @@ void ANNIEEventBuilder::PairTankPMTAndMRDTriggers(){
     if(NumOrphans > OrphanWarningValue){
       std::cout << "ANNIEEventBuilder tool: WARNING! High orphan rate detected.  More than " << OrphanWarningValue << " this pairing sequence." << std::endl;
     }
-    CurrentDriftMean = ThisPairingMean;
+    CurrentDriftMean = DriftEstimate;
     CurrentDriftVariance = ThisPairingVariance;
   }
-  if(verbosity>4) std::cout << "DOING OUR PAIR UP: " << std::endl;
-  for (int i=0;i<(NumPairsToMake); i++) {
-    UnbuiltTankMRDPairs.emplace(UnpairedTankTimestamps.at(i),UnpairedMRDTimestamps.at(i));
-    TankStampsToDelete.push_back(UnpairedTankTimestamps.at(i));
-    MRDStampsToDelete.push_back(UnpairedMRDTimestamps.at(i));
-  }
-
-  if(verbosity>4) std::cout << "DELETE PAIRED TIMESTAMPS FROM THE UNPAIRED VECTORS: " << std::endl;
-  //Delete all paired timestamps still in the unpaired unbuilt timestamps vectors 
-  for (int i=0; i<(NumPairsToMake); i++){
-    uint64_t BuiltTankTime = TankStampsToDelete.at(i);
-    uint64_t BuiltMRDTime = MRDStampsToDelete.at(i);
-    UnpairedTankTimestamps.erase(std::remove(UnpairedTankTimestamps.begin(),UnpairedTankTimestamps.end(),BuiltTankTime), 
-               UnpairedTankTimestamps.end());
-    UnpairedMRDTimestamps.erase(std::remove(UnpairedMRDTimestamps.begin(),UnpairedMRDTimestamps.end(),BuiltMRDTime), 
-               UnpairedMRDTimestamps.end());
-  }
-  if(verbosity>4) std::cout << "FINISHED ERASING PAIRED TIMESTAMPS FROM FINISHED VECTORS" << std::endl;
 
   return;
 }
 
 
-void ANNIEEventBuilder::BuildANNIEEventMRD(std::vector<std::pair<unsigned long,int>> MRDHits, 
-        unsigned long MRDTimeStamp, std::string MRDTriggerType, int beam_tdc, int cosmic_tdc)
+void ANNIEEventBuilder::BuildANNIEEventMRD(const MRDTriggerRecord& MRDEvent, uint64_t MRDTimeStamp)
 {
+  const std::vector<std::pair<unsigned long,int>>& MRDHits = MRDEvent.Hits;
   std::cout << "Building an ANNIE Event (MRD), ANNIEEventNum = "<<ANNIEEventNum << std::endl;
 
   TDCData = new std::map<unsigned long, std::vector<Hit>>;
@@ -540,16 +523,21 @@ void ANNIEEventBuilder::BuildANNIEEventMRD(std::vector<std::pair<unsigned long,i
   }
 
   std::map<std::string, int> mrd_loopback_tdc;
-  mrd_loopback_tdc.emplace("BeamLoopbackTDC",beam_tdc);
-  mrd_loopback_tdc.emplace("CosmicLoopbackTDC",cosmic_tdc);
+  mrd_loopback_tdc.emplace("BeamLoopbackTDC",MRDEvent.BeamLoopbackTDC);
+  mrd_loopback_tdc.emplace("CosmicLoopbackTDC",MRDEvent.CosmicLoopbackTDC);
 
   Log("ANNIEEventBuilder: TDCData size: "+std::to_string(TDCData->size()),v_debug,verbosity);
 
-  ANNIEEvent->Set("TDCData",TDCData,true);
+  if(UseRecordFile || UseColumnFile){
+    this->SetEventMember("TDCData",*TDCData);
+    delete TDCData; TDCData = nullptr;
+  } else {
+    ANNIEEvent->Set("TDCData",TDCData,true);
+  }
   TimeClass timeclass_timestamp((uint64_t)MRDTimeStamp*1000);  //in microseconds
-  ANNIEEvent->Set("EventTime",timeclass_timestamp); //not sure if EventTime is also in UTC or defined differently
-  ANNIEEvent->Set("MRDTriggerType",MRDTriggerType);
-  ANNIEEvent->Set("MRDLoopbackTDC",mrd_loopback_tdc);
+  this->SetEventMember("EventTime",timeclass_timestamp); //not sure if EventTime is also in UTC or defined differently
+  this->SetEventMember("MRDTriggerType",MRDEvent.TriggerType);
+  this->SetEventMember("MRDLoopbackTDC",mrd_loopback_tdc);
   return;
 }
 
@@ -557,47 +545,59 @@ void ANNIEEventBuilder::BuildANNIEEventRunInfo(int RunNumber, int SubRunNumber,
         int RunType, uint64_t StartTime)
 {
   if(verbosity>v_message)std::cout << "Building an ANNIE Event Run Info" << std::endl;
-  ANNIEEvent->Set("EventNumber",ANNIEEventNum);
-  ANNIEEvent->Set("RunNumber",RunNumber);
-  ANNIEEvent->Set("SubrunNumber",SubRunNumber);
-  ANNIEEvent->Set("RunType",RunType);
-  ANNIEEvent->Set("RunStartTime",StartTime);
+  if(UseRecordFile){
+    //Run information is only written once, at the start of each record file
+    if(!RecordWriter.IsOpen()){
+      RecordWriter.Open(this->GetOutputFilename(RunNumber,SubRunNumber));
+      RecordWriter.SetRunConstant("RunNumber",RunNumber);
+      RecordWriter.SetRunConstant("SubrunNumber",SubRunNumber);
+      RecordWriter.SetRunConstant("RunType",RunType);
+      RecordWriter.SetRunConstant("RunStartTime",StartTime);
+    }
+    RecordWriter.SetEventMember("EventNumber",ANNIEEventNum);
+    return;
+  }
+  if(UseColumnFile && !ColumnWriter.IsOpen()){
+    ColumnWriter.Open(this->GetOutputFilename(RunNumber,SubRunNumber));
+  }
+  this->SetEventMember("EventNumber",ANNIEEventNum);
+  this->SetEventMember("RunNumber",RunNumber);
+  this->SetEventMember("SubrunNumber",SubRunNumber);
+  this->SetEventMember("RunType",RunType);
+  this->SetEventMember("RunStartTime",StartTime);
   //TODO: Things missing from ANNIEEvent that should be in before this tool finishes:
   //  - BeamStatus?  
   return;
 }
 
 void ANNIEEventBuilder::BuildANNIEEventTank(uint64_t ClockTime, 
-        std::map<std::vector<int>, std::vector<uint16_t>> WaveMap)
+        TankWaveMap& WaveMap)
 {
   if(verbosity>v_message)std::cout << "Building an ANNIE Event" << std::endl;
 
   ///////////////LOAD RAW PMT DATA INTO ANNIEEVENT///////////////
   std::map<unsigned long, std::vector<Waveform<uint16_t>> > RawADCData;
   std::map<unsigned long, std::vector<Waveform<uint16_t>> > RawADCAuxData;
-  for(std::pair<std::vector<int>, std::vector<uint16_t>> apair : WaveMap){
-    int CardID = apair.first.at(0);
-    int ChannelID = apair.first.at(1);
+  for(std::pair<const CardChannelKey, std::vector<uint16_t>>& apair : WaveMap){
+    int CardID = CardChannelKeyToCardID(apair.first);
+    int ChannelID = CardChannelKeyToChannelID(apair.first);
     int CrateNum=-1;
     int SlotNum=-1;
     if(verbosity>v_debug) std::cout << "Converting card ID " << CardID << ", channel ID " <<
           ChannelID << " to electronics space" << std::endl;
     this->CardIDToElectronicsSpace(CardID, CrateNum, SlotNum);
-    std::vector<uint16_t> TheWaveform = apair.second;
     //FIXME: We're feeding Waveform class expects a double, not a uint64_t (?)
-    Waveform<uint16_t> TheWave(ClockTime, TheWaveform);
     //Placing waveform in a vector in case we want a hefty-mode minibuffer storage eventually
-    std::vector<Waveform<uint16_t>> WaveVec{TheWave};
+    std::vector<Waveform<uint16_t>> WaveVec;
+    WaveVec.emplace_back(ClockTime, std::move(apair.second));
     
-    std::vector<int> CrateSpace{CrateNum,SlotNum,ChannelID};
-    unsigned long ChannelKey;
-    if(TankPMTCrateSpaceToChannelNumMap.count(CrateSpace)>0){
-      ChannelKey = TankPMTCrateSpaceToChannelNumMap.at(CrateSpace);
-      RawADCData.emplace(ChannelKey,WaveVec);
+    const CrateSpaceTable::Entry& entry = CrateSpace->Get(CrateNum,SlotNum,ChannelID);
+    unsigned long ChannelKey = entry.ChannelKey;
+    if(entry.Type == CrateSpaceTable::TankPMT){
+      RawADCData.emplace(ChannelKey,std::move(WaveVec));
     }
-    else if (AuxCrateSpaceToChannelNumMap.count(CrateSpace)>0){
-      ChannelKey = AuxCrateSpaceToChannelNumMap.at(CrateSpace);
-      RawADCAuxData.emplace(ChannelKey,WaveVec);
+    else if (entry.Type == CrateSpaceTable::Aux){
+      RawADCAuxData.emplace(ChannelKey,std::move(WaveVec));
     } else{
       Log("ANNIEEventBuilder:: Cannot find channel key for crate space entry: ",v_error, verbosity);
       Log("ANNIEEventBuilder::CrateNum "+to_string(CrateNum),v_error, verbosity);
@@ -611,9 +611,9 @@ void ANNIEEventBuilder::BuildANNIEEventTank(uint64_t ClockTime,
     std::cout << "No Raw ADC Data in entry.  Not putting to ANNIEEvent." << std::endl;
   }
   std::cout << "Setting ANNIE Event information" << std::endl;
-  ANNIEEvent->Set("RawADCData",RawADCData);
-  ANNIEEvent->Set("RawADCAuxData",RawADCAuxData);
-  ANNIEEvent->Set("EventTimeTank",ClockTime);
+  this->PublishEventMember("RawADCData",std::move(RawADCData));
+  this->PublishEventMember("RawADCAuxData",std::move(RawADCAuxData));
+  this->SetEventMember("EventTimeTank",ClockTime);
   if(verbosity>v_debug) std::cout << "ANNIEEventBuilder: ANNIE Event "+
       to_string(ANNIEEventNum)+" built." << std::endl;
   return;
@@ -623,8 +623,19 @@ void ANNIEEventBuilder::BuildANNIEEventTank(uint64_t ClockTime,
 void ANNIEEventBuilder::SaveEntryToFile(int RunNum, int SubRunNum)
 {
   /*if(verbosity>4)*/ std::cout << "ANNIEEvent: Saving ANNIEEvent entry"+to_string(ANNIEEventNum) << std::endl;
-  std::string Filename = SavePath + ProcessedFilesBasename + "R" + to_string(RunNum) + 
-      "S" + to_string(SubRunNum);
+  if(UseRecordFile){
+    //Appends the event's record; the file is written in batches of RecordEventsPerFlush events
+    RecordWriter.WriteEvent();
+    ANNIEEventNum+=1;
+    return;
+  }
+  if(UseColumnFile){
+    //Column files are appended to and flushed in chunks of ColumnEventsPerChunk events
+    ColumnWriter.WriteEvent();
+    ANNIEEventNum+=1;
+    return;
+  }
+  std::string Filename = this->GetOutputFilename(RunNum,SubRunNum);
   ANNIEEvent->Save(Filename);
   //std::cout <<"ANNIEEvent saved, now delete"<<std::endl;
   ANNIEEvent->Delete();		//Delete() will delete the last entry in the store from memory and enable us to set a new pointer (won't erase the entry from saved file)
@@ -633,6 +644,15 @@ void ANNIEEventBuilder::SaveEntryToFile(int RunNum, int SubRunNum)
   return;
 }
 
+std::string ANNIEEventBuilder::GetOutputFilename(int RunNum, int SubRunNum)
+{
+  std::string Filename = SavePath + ProcessedFilesBasename + "R" + to_string(RunNum) + 
+      "S" + to_string(SubRunNum);
+  if(UseRecordFile) Filename += ".rec";
+  else if(UseColumnFile) Filename += ".col";
+  return Filename;
+}
+
 void ANNIEEventBuilder::CardIDToElectronicsSpace(int CardID, 
         int &CrateNum, int &SlotNum)
 {
@@ -652,6 +672,8 @@ void ANNIEEventBuilder::OpenNewANNIEEvent(int RunNum, int SubRunNum,uint64_t Sta
   ANNIEEvent->Close();
   ANNIEEvent->Delete();
   delete ANNIEEvent; ANNIEEvent = new BoostStore(false,2);
+  RecordWriter.Close();
+  ColumnWriter.Close();
   CurrentRunNum = RunNum;
   CurrentSubRunNum = SubRunNum;
   CurrentRunType = RunT;
@@ -10,7 +10,12 @@
 #include "TimeClass.h"
 #include "TriggerClass.h"
 #include "Waveform.h"
+#include "CardData.h"
+#include "CrateSpaceTable.h"
 #include "ANNIEalgorithms.h"
+#include "ANNIEEventRecordFile.h"
+#include "ANNIEEventColumnFile.h"
+#include "ANNIEEventMember.h"
 /**
  * \class ANNIEEventBuilder
  *
@@ -33,13 +38,16 @@ class ANNIEEventBuilder: public Tool {
   void PairTankPMTAndMRDTriggers();  // Put together timestamps of finished decoding Tank Triggers and MRD Triggers 
   void RemoveCosmics();             // Removes events from MRD stream labeled as a cosmic trigger only
   void BuildANNIEEventRunInfo(int RunNum, int SubRunNum, int RunType, uint64_t RunStartTime);  //Loads run level information, as well as the entry number
-  void BuildANNIEEventTank(uint64_t CounterTime, std::map<std::vector<int>, std::vector<uint16_t>> WaveMap);
-  void BuildANNIEEventMRD(std::vector<std::pair<unsigned long,int>> MRDHits, 
-        unsigned long MRDTimeStamp, std::string MRDTriggerType, int beam_tdc, int cosmic_tdc);
-  void CalculateSlidWindows(std::vector<uint64_t> FirstTimestampSet,
-        std::vector<uint64_t> SecondTimestampSet, int shift, double& tmean, double& tvar);
+  void BuildANNIEEventTank(uint64_t CounterTime, TankWaveMap& WaveMap);  //Waveforms are moved out of WaveMap
+  void BuildANNIEEventMRD(const MRDTriggerRecord& MRDEvent, uint64_t MRDTimeStamp);
+  void CalculateSlidWindows(const std::vector<uint64_t>& FirstTimestampSet,
+        const std::vector<uint64_t>& SecondTimestampSet, int shift, double& tmean, double& tvar);
+  double TankTimestampToMRDTime(uint64_t TankTimestamp);  //Converts a PMT counter time (ns) to the MRD timestamp scale (ms)
+  void ResyncStreams(double TSDiff, double DriftEstimate, std::set<uint64_t>::iterator& TankIt,
+        std::set<uint64_t>::iterator& MRDIt, int& NumOrphans);  //Orphans timestamps to bring the front of both streams back in step
   void CardIDToElectronicsSpace(int CardID, int &CrateNum, int &SlotNum);
   void SaveEntryToFile(int RunNum, int SubRunNum);
+  std::string GetOutputFilename(int RunNum, int SubRunNum);
   void OpenNewANNIEEvent(int RunNum, int SubRunNum,uint64_t StarT, int RunT);
 
   
@@ -54,30 +62,40 @@ class ANNIEEventBuilder: public Tool {
     v.erase(itr, v.end());
   }
 
+  //Adds a member to the event being built, in whichever output format is in use
+  template<typename T> void SetEventMember(const std::string& Name, const T& Value){
+    if(UseRecordFile) RecordWriter.SetEventMember(Name,Value);
+    else if(UseColumnFile) ColumnWriter.SetEventMember(Name,Value);
+    else ANNIEEvent->Set(Name,Value);
+  }
+
+  //As SetEventMember, for members that other tools read with ANNIEEventMember::Get
+  template<typename T> void PublishEventMember(const std::string& Name, T&& Value){
+    if(UseRecordFile) RecordWriter.SetEventMember(Name,Value);
+    else if(UseColumnFile) ColumnWriter.SetEventMember(Name,Value);
+    else ANNIEEventMember::Publish(ANNIEEvent,Name,std::forward<T>(Value),true);
+  }
+
  private:
 
   //####### MAPS THAT ARE LOADED FROM OR CONTAIN INFO FROM THE CSTORE (FROM MRD/PMT DECODING) #########
-  std::map<uint64_t, std::vector<std::pair<unsigned long, int> > > MRDEvents;  //Key: {MTCTime}, value: "WaveMap" with key (CardID,ChannelID), value FinishedWaveform
-  std::map<uint64_t, std::string>  TriggerTypeMap;  //Key: {MTCTime}, value: string noting what type of trigger occured for the event 
-  std::map<uint64_t, int> MRDBeamLoopbackMap;  //Key: {MTCTime}, value: beam loopback TDC
-  std::map<uint64_t, int> MRDCosmicLoopbackMap;  //Key: {MTCTime}, value: cosmic loopback TDC
-  std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t> > >* InProgressTankEvents;  //Key: {MTCTime}, value: map of in-progress PMT trigger decoding from WaveBank
-  std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t> > > FinishedTankEvents;  //Key: {MTCTime}, value: map of fully-built waveforms from WaveBank
+  MRDEventMap* MRDEvents = nullptr;  //Key: {MRD timestamp}, value: decoded MRD trigger.  Owned by the MRDDataDecoder; built entries are erased here
+  std::map<uint64_t, TankWaveMap>* InProgressTankEvents;  //Key: {MTCTime}, value: map of in-progress PMT trigger decoding from WaveBank
+  std::map<uint64_t, TankWaveMap> FinishedTankEvents;  //Key: {MTCTime}, value: map of fully-built waveforms from WaveBank
   Store RunInfoPostgress;   //Has Run number, subrun number, etc...
 
-  std::map<std::vector<int>,int> TankPMTCrateSpaceToChannelNumMap;
-  std::map<std::vector<int>,int> AuxCrateSpaceToChannelNumMap;
-  std::map<std::vector<int>,int> MRDCrateSpaceToChannelNumMap;
+  CrateSpaceTable* CrateSpace = nullptr;  //Crate/slot/channel to channel key lookup, owned by LoadGeometry
   BoostStore *RawData;
   BoostStore *TrigData;
 
   //######### INFORMATION USED FOR PAIRING UP TANK AND MRD DATA TRIGGERS ########
   int EventsPerPairing;  //Determines how many Tank and MRD events are needed before starting to pair up for event building
   
-  std::vector<uint64_t> FinishedTankTimestamps;  //Contains timestamps for PMT Events that are fully built
+  std::set<uint64_t> FinishedTankTimestamps;  //Contains timestamps for PMT Events that are fully built
 
-  std::vector<uint64_t> UnpairedTankTimestamps;  //Contains timestamps for all PMT events that haven't been paired to an MRD TS
-  std::vector<uint64_t> UnpairedMRDTimestamps;  //Contains timestamps for all MRD events that haven't been paired to a PMT TS
+  //Kept sorted so pairing is a single merge of the two streams
+  std::set<uint64_t> UnpairedTankTimestamps;  //Contains timestamps for all PMT events that haven't been paired to an MRD TS
+  std::set<uint64_t> UnpairedMRDTimestamps;  //Contains timestamps for all MRD events that haven't been paired to a PMT TS
   std::map<uint64_t,uint64_t> UnbuiltTankMRDPairs; //Pairs of Tank PMT/MRD counters ready to be built if all PMT waveforms are ready
   
   std::vector<uint64_t> OrphanTankTimestamps;  //Contains timestamps for all PMT events that were out of step with the rest of the stream
@@ -88,6 +106,17 @@ class ANNIEEventBuilder: public Tool {
   bool DataStreamsSynced;
 
   BoostStore *ANNIEEvent = nullptr;
+  //OutputFormat "RecordFile": events are appended as compressed records instead of
+  //being saved through the ANNIEEvent BoostStore; run information is written once per file
+  std::string OutputFormat;
+  bool UseRecordFile = false;
+  int RecordEventsPerFlush;
+  ANNIEEventRecordWriter RecordWriter;
+  //OutputFormat "ColumnFile": one column per ANNIEEvent key, with an index per event, so
+  //readers can load only the keys they need and jump straight to any event
+  bool UseColumnFile = false;
+  int ColumnEventsPerChunk;
+  ANNIEEventColumnWriter ColumnWriter;
   std::map<unsigned long, std::vector<Hit>> *TDCData = nullptr;
 
   std::string InputFile;
@@ -111,6 +140,7 @@ class ANNIEEventBuilder: public Tool {
   double CurrentDriftVariance = 0;
 
   int MRDPMTTimeDiffTolerance;   //Threshold relative to current drift mean where an event will be put to the orphanage
+  int DriftTrackingEvents;       //Number of pairs over which the drift estimate used while pairing is averaged
   int DriftWarningValue;
   int OrphanWarningValue;    //Number of orphanage placements in a pairing event to print a warning
   bool IsNewMRDData;
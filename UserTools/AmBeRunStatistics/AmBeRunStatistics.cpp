@@ -62,8 +62,8 @@ bool AmBeRunStatistics::Execute(){
   // Get a pointer to the ANNIEEvent Store
   auto* annie_event = m_data->Stores["ANNIEEvent"];
 
-  annie_event->Get("CalibratedADCAuxData", calibrated_auxwaveform_map);
-  annie_event->Get("RecoADCAuxHits", aux_pulse_map);
+  calibrated_auxwaveform_map = ANNIEEventMember::Get<std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > > >(annie_event, "CalibratedADCAuxData");
+  aux_pulse_map = ANNIEEventMember::Get<std::map<unsigned long, std::vector< std::vector<ADCPulse>> > >(annie_event, "RecoADCAuxHits");
 
   ADCPulse SiPM1_MaxPulse;
   ADCPulse SiPM2_MaxPulse;
@@ -229,8 +229,12 @@ void AmBeRunStatistics::GetSiPMPulseInfo(ADCPulse& SiPM1_Pulse,
   double S1MaxAmplitude = 0;
   double S2MaxAmplitude = 0;
 
+  //No pulses to look at if the hit finder didn't make any
+  const std::map<unsigned long, std::vector< std::vector<ADCPulse>> > no_pulses;
+  const auto& aux_pulses = aux_pulse_map ? *aux_pulse_map : no_pulses;
+
   //Calibrate the SIPM waveforms
-  for (const auto& temp_pair : aux_pulse_map) {
+  for (const auto& temp_pair : aux_pulses) {
     const auto& channel_key = temp_pair.first;
     //For now, only calibrate the SiPM waveforms
     if(AuxChannelNumToTypeMap->at(channel_key) != "SiPM1" &&
@@ -241,7 +245,7 @@ void AmBeRunStatistics::GetSiPMPulseInfo(ADCPulse& SiPM1_Pulse,
       std::cout << "AmBeRunStatistics tool: Found SiPM channel " << 
         AuxChannelNumToTypeMap->at(channel_key) << "with channel key " << channel_key << std::endl;
     }
-    std::vector< std::vector<ADCPulse>> sipm_minibuffers = temp_pair.second;
+    const std::vector< std::vector<ADCPulse>>& sipm_minibuffers = temp_pair.second;
     size_t num_minibuffers = sipm_minibuffers.size();  //Should be size 1 in FrankDAQ mode
     for (size_t mb = 0; mb < num_minibuffers; ++mb) {
       std::vector<ADCPulse> thisbuffer_pulses = sipm_minibuffers.at(mb);
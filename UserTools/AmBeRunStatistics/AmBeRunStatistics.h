@@ -9,6 +9,7 @@
 #include "Waveform.h"
 #include "CalibratedADCWaveform.h"
 #include "Hit.h"
+#include "ANNIEEventMember.h"
 #include "TF1.h"
 #include "TCanvas.h"
 #include "TH2.h"
@@ -51,10 +52,10 @@ class AmBeRunStatistics: public Tool {
   int verbosity;
   std::string outputfile;
   TFile* ambe_file_out = nullptr;
-  // Build the calibrated waveforms
-  std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > >
-    calibrated_auxwaveform_map;
-  std::map<unsigned long, std::vector< std::vector<ADCPulse>> > aux_pulse_map;
+  // Build the calibrated waveforms (owned by the ANNIEEvent store)
+  const std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > >*
+    calibrated_auxwaveform_map = nullptr;
+  const std::map<unsigned long, std::vector< std::vector<ADCPulse>> >* aux_pulse_map = nullptr;
   std::map<unsigned long, std::vector<Hit>>* AuxHits = nullptr;
 
   std::map<int,std::string>* AuxChannelNumToTypeMap;
@@ -146,14 +146,14 @@ bool ClusterFinder::Execute(){
   int annieeventexists = m_data->Stores.count("ANNIEEvent");
   if(!annieeventexists){ cerr<<"no ANNIEEvent store!"<<endl;}
   
-  std::map<unsigned long, std::vector<std::vector<ADCPulse>>> RecoADCHits;
-
   // Some initialization
-  v_hittimes.clear();
+  v_tank_hits.clear();
+  v_tank_hits_by_time.clear();
   v_hittimes_sorted.clear();
-  v_mini_hits.clear();
-  m_time_Nhits.clear();
+  v_window_first.clear();
+  v_window_last.clear();
   v_clusters.clear();
+  n_window_hits = 0;
   v_local_cluster_times.clear();
   m_all_clusters->clear();
   m_all_clusters_detkey->clear();
@@ -164,7 +164,8 @@ bool ClusterFinder::Execute(){
   
   m_data->Stores["ANNIEEvent"]->Get("EventNumber", evnum);
   m_data->Stores["ANNIEEvent"]->Get("BeamStatus", BeamStatus);
-  bool got_recoadc = m_data->Stores["ANNIEEvent"]->Get("RecoADCHits",RecoADCHits);
+  const auto* RecoADCHits = ANNIEEventMember::Get<std::map<unsigned long, std::vector<std::vector<ADCPulse>>>>(m_data->Stores["ANNIEEvent"],"RecoADCHits");
+  bool got_recoadc = (RecoADCHits != nullptr);
 
   if (HitStoreName == "MCHits"){
     bool got_mchits = m_data->Stores["ANNIEEvent"]->Get("MCHits", MCHits);
@@ -214,7 +215,7 @@ bool ClusterFinder::Execute(){
   if(HitStoreName=="Hits"){
     int vectsize = Hits->size();
     if (verbose > 0) std::cout <<"Hits size: "<<vectsize<<std::endl;
-    for(std::pair<unsigned long, std::vector<Hit>>&& apair : *Hits){
+    for(std::pair<const unsigned long, std::vector<Hit>>& apair : *Hits){
       unsigned long chankey = apair.first;
       Detector* thistube = geom->ChannelToDetector(chankey);
       int detectorkey = thistube->GetDetectorID();
@@ -223,146 +224,105 @@ bool ClusterFinder::Execute(){
         PMT_ishit[detectorkey] = 1;
         for (Hit &ahit : ThisPMTHits){
           if (verbose > 2) std::cout << "Key: " << detectorkey << ", charge "<<ahit.GetCharge()<<", time "<<ahit.GetTime()<<std::endl;
-          if (ahit.GetTime() < end_of_window_time_cut*AcqTimeWindow) v_hittimes.push_back(ahit.GetTime()); // fill a vector with all hit times (unsorted)
+          v_tank_hits.push_back(TankHit{&ahit, (unsigned long) detectorkey});
+          if (ahit.GetTime() < end_of_window_time_cut*AcqTimeWindow) n_window_hits++;
         }
       }
     }
   }
 
-  if (v_hittimes.size() == 0) {
+  if (n_window_hits == 0) {
     if (verbose > 1) cout << "No hits, event is skipped..." << endl;
     return true;
   }
 
-  if (verbose > 2) {
-    for (std::vector<double>::iterator it = v_hittimes.begin(); it != v_hittimes.end(); ++it) {
-      cout << "Hit time -> " << *it << endl;
-    }
-  }
+  // Sort the tank hits by time. Hits before the end of window time cut come first,
+  // and only those are used to look for clusters
+  v_tank_hits_by_time.resize(v_tank_hits.size());
+  for (size_t i_hit = 0; i_hit < v_tank_hits.size(); i_hit++) v_tank_hits_by_time[i_hit] = i_hit;
+  std::stable_sort(v_tank_hits_by_time.begin(), v_tank_hits_by_time.end(), [this](size_t a, size_t b){
+    return v_tank_hits[a].hit->GetTime() < v_tank_hits[b].hit->GetTime();
+  });
+  for (size_t i_hit : v_tank_hits_by_time) v_hittimes_sorted.push_back(v_tank_hits[i_hit].hit->GetTime());
+  std::vector<double>::iterator end_of_window_hits = v_hittimes_sorted.begin() + n_window_hits;
 
-  // Now sort the hit time array, fill the highest time in a new array until the old array is empty
-  do {
-    double max_time =0;
-    int i_max_time =0;
-    for (std::vector<double>::iterator it = v_hittimes.begin(); it != v_hittimes.end(); ++it) {
-      if (*it > max_time) {
-        max_time = *it;
-        i_max_time = std::distance(v_hittimes.begin(),it);
-      } 
-    }
-    v_hittimes_sorted.insert(v_hittimes_sorted.begin(),max_time);
-    v_hittimes.erase(v_hittimes.begin() + i_max_time);
-  } while (v_hittimes.size() != 0);
-  
   if (verbose > 2) {
-    for (std::vector<double>::iterator it = v_hittimes_sorted.begin(); it != v_hittimes_sorted.end(); ++it) {
+    for (std::vector<double>::iterator it = v_hittimes_sorted.begin(); it != end_of_window_hits; ++it) {
       cout << "Hit time (sorted) -> " << *it << endl;
     }
   }
 
-  // Move a time window within the array and look for the window with the highest number of hits
-  for (std::vector<double>::iterator it = v_hittimes_sorted.begin(); it != v_hittimes_sorted.end(); ++it) {
-    if (*it + ClusterFindingWindow > AcqTimeWindow || *it > end_of_window_time_cut*AcqTimeWindow) {
+  // Move a time window over the sorted hits, starting at each hit time, and count the hits in
+  // [start, start + ClusterFindingWindow). The end of the window only ever moves forward.
+  std::vector<double>::iterator window_end = v_hittimes_sorted.begin();
+  for (std::vector<double>::iterator it = v_hittimes_sorted.begin(); it != end_of_window_hits; ++it) {
+    if (it != v_hittimes_sorted.begin() && *it == *(it-1)) continue;  // same window as the last hit
+    if (*it + ClusterFindingWindow > AcqTimeWindow) {
       if (verbose > 2) cout << "Cluster Finding loop: Reaching the end of the acquisition time window.." << endl;
       break;
     }
-    thiswindow_Nhits = 0;   
-    v_mini_hits.clear();
-    for (double j_time = *it; j_time < *it + ClusterFindingWindow; j_time+=2){  // loops through times in the window and check if there's a hit at this time
-      for(std::vector<double>::iterator it2 = v_hittimes_sorted.begin(); it2 != v_hittimes_sorted.end(); ++it2) {
-        if (*it2 == j_time) {
-          thiswindow_Nhits++;
-          v_mini_hits.push_back(*it2);
-        }
-      }
-    }
-    if (!v_mini_hits.empty()) {
-      m_time_Nhits.insert(std::pair<double,std::vector<double>>(*it,v_mini_hits)); // fill a map with a pair (window start time; vector of hit times in window)  
-    }
+    while (window_end != end_of_window_hits && *window_end < *it + ClusterFindingWindow) ++window_end;
+    v_window_first.push_back(std::distance(v_hittimes_sorted.begin(), it));
+    v_window_last.push_back(std::distance(v_hittimes_sorted.begin(), window_end));
+    if (verbose > 3) cout << "Window at time " << *it << " has " << v_window_last.back() - v_window_first.back() << " hits" << endl;
   }
-  if (verbose > 1) cout << "Map of times and Nhits filled..." << endl;
-  if (verbose > 2){
-      for (std::map<double,std::vector<double>>::iterator it = m_time_Nhits.begin(); it != m_time_Nhits.end(); ++it) {
-        if (int(it->second.size()) > MinHitsPerCluster) {
-          if(verbose>3) cout << "Map of time and NHits: Time = " << it->first << ", NHits = " << it->second.size() << endl;
-          if(verbose>3) cout << "Look at the back of the vector (before): " << it->second.back() << endl;
-          for (std::vector<double>::iterator itt = it->second.begin(); itt != it->second.end(); ++itt) {
-          cout << "At this time, hits are: " << *itt << endl;  
-        }       
-      }
-    }
+  if (verbose > 1) cout << "Windows and Nhits filled..." << endl;
+
+  // Now take the window with the most hits as a cluster (the earliest one, if several have as many),
+  // remove its hits from all the other windows and repeat. Windows are kept in a max-heap by their
+  // number of hits. That number can only go down as hits are removed, so a window taken from the top
+  // is only a cluster if its count is still up to date; otherwise it is put back with the new count.
+  v_removed_hits.assign(n_window_hits + 1, 0);
+  v_hit_removed.assign(n_window_hits, false);
+  std::priority_queue<std::pair<int,int>> windows_by_Nhits;  // {Nhits, -window index}
+  for (size_t i_window = 0; i_window < v_window_first.size(); i_window++) {
+    windows_by_Nhits.push(std::make_pair(int(v_window_last[i_window] - v_window_first[i_window]), -int(i_window)));
   }
-  v_mini_hits.clear();
-
-  // Now loop on the time/Nhits map to find maxima (clusters) 
-  max_Nhits = 0;
-  local_cluster = 0;
-  v_clusters.clear();
-  do {
-    //cout << "Start do loop" << endl;
-    max_Nhits = 0;
-    for (std::map<double,std::vector<double>>::iterator it = m_time_Nhits.begin(); it != m_time_Nhits.end(); ++it) {
-      if (int(it->second.size()) > max_Nhits) {
-        max_Nhits = it->second.size();
-        local_cluster = it->first;
-      } 
+  while (!windows_by_Nhits.empty()) {
+    std::pair<int,int> top = windows_by_Nhits.top();
+    windows_by_Nhits.pop();
+    size_t i_window = -top.second;
+    size_t first = v_window_first[i_window];
+    size_t last = v_window_last[i_window];
+    int window_Nhits = int(last - first) - (CountRemovedHits(last) - CountRemovedHits(first));
+    if (window_Nhits != top.first) {
+      if (window_Nhits > 0) windows_by_Nhits.push(std::make_pair(window_Nhits, top.second));
+      continue;
     }
-    if (max_Nhits < MinHitsPerCluster) {
-      if (verbose > 1 ) cout << "No more clusters with > " << MinHitsPerCluster<< " hits" << endl; 
-      break;
-    } else {
-      if (verbose > 0) cout << "Cluster found at " << local_cluster << " ns with " << max_Nhits << " hits" << endl;
-      v_clusters.push_back(local_cluster);
-      // Remove the cluster and its surroundings for the next loop over the cluster map
-      for (std::map<double,std::vector<double>>::iterator it = m_time_Nhits.begin(); it != m_time_Nhits.end(); ++it) {
-        //cout << "On the map hits: time " << it->first << " and hits tot " << it->second.size() << endl;
-        //cout << "Look at the back of the vector (between): " << it->second.back() << endl;
-        for (std::vector<double>::iterator itt = it->second.begin(); itt != it->second.end(); ++itt) {
-          //cout << "hits are " << *itt << endl;
-          if (*itt >= local_cluster && *itt <= local_cluster + ClusterFindingWindow) { //if hit time is in the window, replace it with dummy value to be removed later
-            it->second.at(std::distance(it->second.begin(), itt)) = dummy_hittime_value;
-          }
-        }
-        //cout << "Loop of setting dummy hit time values is done..." << endl;
-        //cout << "Before erasing values, vector of hits is " << it->second.size() << " hits long" << endl;
-        //cout << "Look at the back of the vector (after): " << it->second.back() << endl;
-
-        // This loops erases the dummy hit times values that were flagged before so they are not used anymore by other clusters
-        for(std::vector<double>::iterator itt = it->second.end()-1; itt != it->second.begin()-1; --itt) {
-          cout << "Time: " << it->first << ", hit time: " << *itt << endl;
-          if (*itt == dummy_hittime_value) {
-            it->second.erase(it->second.begin() + std::distance(it->second.begin(), itt)); 
-            if (verbose > 2) cout << "Erasing " << it->first << " " << *itt << endl;
-          }
-        }
-        cout << "Erasing loop is done and new size of mini_hits is " << it->second.size() << " hits" << endl;
-      }
+    if (window_Nhits < MinHitsPerCluster) break;
+
+    double local_cluster = v_hittimes_sorted[first];
+    if (verbose > 0) cout << "Cluster found at " << local_cluster << " ns with " << window_Nhits << " hits" << endl;
+    v_clusters.push_back(local_cluster);
+    // Remove the hits of the cluster and its surroundings for the next clusters
+    std::vector<double>::iterator removed_end = std::upper_bound(v_hittimes_sorted.begin() + first, end_of_window_hits, local_cluster + ClusterFindingWindow);
+    for (size_t i_hit = first; i_hit < size_t(std::distance(v_hittimes_sorted.begin(), removed_end)); i_hit++) {
+      if (!v_hit_removed[i_hit]) RemoveHit(i_hit);
     }
-  } while (true); 
-  m_time_Nhits.clear();
+  }
+  if (verbose > 1) cout << "No more clusters with > " << MinHitsPerCluster << " hits" << endl;
 
-  // Now loop on the hit map again to get info about those local maxima, cluster per cluster
+  // Now get info about those clusters, cluster per cluster. The hits in each cluster are kept in
+  // the order of the Hits map.
+  double first_cluster = (v_clusters.empty()) ? 0 : *std::min_element(v_clusters.begin(),v_clusters.end());
   for (std::vector<double>::iterator it = v_clusters.begin(); it != v_clusters.end(); ++it) {
     double local_cluster_charge = 0;
     double local_cluster_time = 0;
     v_local_cluster_times.clear();
-    for(std::pair<unsigned long, std::vector<Hit>>&& apair : *Hits){
-      unsigned long chankey = apair.first;
-      Detector* thistube = geom->ChannelToDetector(chankey);
-      int detectorkey = thistube->GetDetectorID();
-      if (thistube->GetDetectorElement()=="Tank"){
-        std::vector<Hit>& ThisPMTHits = apair.second;
-        PMT_ishit[detectorkey] = 1;
-        for (Hit &ahit : ThisPMTHits){
-          if (ahit.GetTime() >= *it && ahit.GetTime() <= *it + ClusterFindingWindow) {
-            local_cluster_charge += ahit.GetCharge();
-            v_local_cluster_times.push_back(ahit.GetTime());
-            cout << "Local cluster at " << *it << " and hit is " << ahit.GetTime() << endl;
-          }
-        }
-      }
+    v_cluster_hits.clear();
+    std::vector<double>::iterator cluster_begin = std::lower_bound(v_hittimes_sorted.begin(), v_hittimes_sorted.end(), *it);
+    std::vector<double>::iterator cluster_end = std::upper_bound(cluster_begin, v_hittimes_sorted.end(), *it + ClusterFindingWindow);
+    for (std::vector<double>::iterator itt = cluster_begin; itt != cluster_end; ++itt) {
+      v_cluster_hits.push_back(v_tank_hits_by_time[std::distance(v_hittimes_sorted.begin(), itt)]);
+    }
+    std::sort(v_cluster_hits.begin(), v_cluster_hits.end());
+    for (size_t i_hit : v_cluster_hits) {
+      const Hit& ahit = *v_tank_hits[i_hit].hit;
+      local_cluster_charge += ahit.GetCharge();
+      v_local_cluster_times.push_back(ahit.GetTime());
+      if (verbose > 2) cout << "Local cluster at " << *it << " and hit is " << ahit.GetTime() << endl;
     }
-    
+
     for (std::vector<double>::iterator itt = v_local_cluster_times.begin(); itt != v_local_cluster_times.end(); ++itt) {
      local_cluster_time += *itt;
     }
@@ -372,33 +332,18 @@ bool ClusterFinder::Execute(){
     h_Cluster_charges->Fill(local_cluster_charge);
     if (draw_2D) h_Cluster_charge_time->Fill(local_cluster_time,local_cluster_charge);
     if (v_clusters.size() > 1) {
-      h_Cluster_deltaT->Fill(local_cluster_time - *std::min_element(v_clusters.begin(),v_clusters.end()));
-      if (draw_2D) h_Cluster_charge_deltaT->Fill(local_cluster_time - *std::min_element(v_clusters.begin(),v_clusters.end()),local_cluster_charge);
+      h_Cluster_deltaT->Fill(local_cluster_time - first_cluster);
+      if (draw_2D) h_Cluster_charge_deltaT->Fill(local_cluster_time - first_cluster,local_cluster_charge);
     }
     if (verbose > 2) cout << "Next cluster ..." << endl;
 
     // Fills the map of clusters (to be passed through CStore)
-    for(std::pair<unsigned long, std::vector<Hit>>&& apair : *Hits) {   
-      unsigned long chankey = apair.first;
-      Detector* thistube = geom->ChannelToDetector(chankey);
-      unsigned long detectorkey = thistube->GetDetectorID();
-      if (thistube->GetDetectorElement()=="Tank"){
-        std::vector<Hit>& ThisPMTHits = apair.second;
-        PMT_ishit[detectorkey] = 1;
-        for (Hit &ahit : ThisPMTHits){
-          if (ahit.GetTime() >= *it && ahit.GetTime() <= *it + ClusterFindingWindow) { 
-            if(m_all_clusters->count(local_cluster_time)==0) {
-              m_all_clusters->emplace(local_cluster_time, std::vector<Hit>{ahit});
-              m_all_clusters_detkey->emplace(local_cluster_time, std::vector<unsigned long>{detectorkey});
-            } else { 
-              m_all_clusters->at(local_cluster_time).push_back(ahit);
-              m_all_clusters_detkey->at(local_cluster_time).push_back(detectorkey);
-            }
-          }
-        }  
-      }
+    std::vector<Hit>& cluster_hits = (*m_all_clusters)[local_cluster_time];
+    std::vector<unsigned long>& cluster_detkeys = (*m_all_clusters_detkey)[local_cluster_time];
+    for (size_t i_hit : v_cluster_hits) {
+      cluster_hits.push_back(*v_tank_hits[i_hit].hit);
+      cluster_detkeys.push_back(v_tank_hits[i_hit].detkey);
     }
-  
   }
 
   // Load the cluster map in a CStore for use by a subsequent tool
@@ -417,15 +362,15 @@ bool ClusterFinder::Execute(){
 
   if (got_recoadc){
 
-    int recoadcsize = RecoADCHits.size();
+    int recoadcsize = RecoADCHits->size();
     int adc_loop = 0;
     if (verbose > 0) std::cout <<"RecoADCHits size: "<<recoadcsize<<std::endl;
-    for (std::pair<unsigned long, std::vector<std::vector<ADCPulse>>> apair : RecoADCHits){
+    for (const std::pair<const unsigned long, std::vector<std::vector<ADCPulse>>>& apair : *RecoADCHits){
       unsigned long chankey = apair.first;
       Detector *thistube = geom->ChannelToDetector(chankey);
       int detectorkey = thistube->GetDetectorID();
       if (thistube->GetDetectorElement()=="Tank"){
-        std::vector<std::vector<ADCPulse>> pulses = apair.second;
+        const std::vector<std::vector<ADCPulse>>& pulses = apair.second;
         for (int i_minibuffer = 0; i_minibuffer < int(pulses.size()); i_minibuffer++){
           std::vector<ADCPulse> apulsevector = pulses.at(i_minibuffer);
           for (int i_pulse=0; i_pulse < int(apulsevector.size()); i_pulse++){
@@ -453,6 +398,17 @@ bool ClusterFinder::Execute(){
   return true;
 }
 
+void ClusterFinder::RemoveHit(size_t i_hit){
+  v_hit_removed[i_hit] = true;
+  for (size_t i = i_hit + 1; i < v_removed_hits.size(); i += i & (~i + 1)) v_removed_hits[i]++;
+}
+
+int ClusterFinder::CountRemovedHits(size_t end){
+  int removed = 0;
+  for (size_t i = end; i > 0; i -= i & (~i + 1)) removed += v_removed_hits[i];
+  return removed;
+}
+
 
 bool ClusterFinder::Finalise(){
 
@@ -4,6 +4,7 @@
 #include <string>
 #include <iostream>
 #include <algorithm>
+#include <queue>
 #include <cmath>
 #include <fstream>
 
@@ -12,6 +13,7 @@
 #include "Tool.h"
 #include "Hit.h"
 #include "ADCPulse.h"
+#include "ANNIEEventMember.h"
 #include "BeamStatus.h"
 #include "TriggerClass.h"
 #include "Detector.h"
@@ -48,6 +50,8 @@ class ClusterFinder: public Tool {
   bool Initialise(std::string configfile,DataModel &data); ///< Initialise Function for setting up Tool resources. @param configfile The path and name of the dynamic configuration file to read in. @param data A reference to the transient data class used to pass information between Tools.
   bool Execute(); ///< Execute function used to perform Tool purpose.
   bool Finalise(); ///< Finalise function used to clean up resources.
+  void RemoveHit(size_t i_hit); ///< Mark the i_hit-th sorted hit time as taken by a cluster
+  int CountRemovedHits(size_t end); ///< Number of hits marked by RemoveHit() among the first end sorted hit times
 
 
  private:
@@ -111,20 +115,25 @@ class ClusterFinder: public Tool {
   std::map<unsigned long, double> rawarea_mean;
 
   // Arrays and vectors
-  std::vector<double> v_hittimes; // array used to sort hits times
-  std::vector<double> v_hittimes_sorted;
-  std::vector<double> v_mini_hits;
-  std::map<double, std::vector<double>> m_time_Nhits;
+  struct TankHit {
+    const Hit* hit;
+    unsigned long detkey;
+  };
+  std::vector<TankHit> v_tank_hits; // tank hits, in the order of the Hits map
+  std::vector<size_t> v_tank_hits_by_time; // indices of v_tank_hits sorted by hit time
+  std::vector<double> v_hittimes_sorted; // hit times of v_tank_hits_by_time
+  std::vector<size_t> v_window_first; // for each cluster finding window: first and one past
+  std::vector<size_t> v_window_last;  // the last index of its hits in v_hittimes_sorted
+  std::vector<int> v_removed_hits; // Fenwick tree of the hits already taken by a cluster
+  std::vector<bool> v_hit_removed;
+  std::vector<size_t> v_cluster_hits;
   std::vector<double> v_clusters;
   std::vector<double> v_local_cluster_times;
   std::map<double,std::vector<Hit>>* m_all_clusters;  
   std::map<double,std::vector<unsigned long>>* m_all_clusters_detkey; 
  
   // Other variables
-  int max_Nhits = 0;
-  double local_cluster = 0;
-  int thiswindow_Nhits = 0;
-  int dummy_hittime_value = -9999;
+  size_t n_window_hits = 0; // number of hits before the end of window time cut
  
   //define file to save data
   TFile *file_out = nullptr;
@@ -272,16 +272,12 @@ bool EventSelector::NHitCountCheck(int NHitCut) {
   }
 }
 
-// This function isn't working now, because the MRDTracks store must have been changed. 
-// We have to contact Marcus and ask how we can retieve the MRD track information. 
 bool EventSelector::EventSelectionByMRDReco() {
   /// Get number of subentries
   int NumMrdTracks = 0;
-  double mrdtracklength = 0.;
   double MaximumMRDTrackLength = 0;
-  int mrdlayershit = 0;
-  bool mrdtrackisstoped = false;
   int longesttrackEntryNumber = -9999;
+  std::vector<MrdTrack>* theMrdTracks = nullptr;
   
   /// check if "MRDTracks" store exists
 	int mrdtrackexists = m_data->Stores.count("MRDTracks");
@@ -304,20 +300,23 @@ bool EventSelector::EventSelectionByMRDReco() {
     return false;
   }
   // If mrd track is found
-  // MRD tracks are saved in the "MRDTracks" Store. Each entry is an MRD track
+  // MRD tracks are saved in the "MRDTracks" vector of the "MRDTracks" Store
+  getmrdtracks = m_data->Stores.at("MRDTracks")->Get("MRDTracks",theMrdTracks);
+  if(!getmrdtracks || theMrdTracks==nullptr || theMrdTracks->size()<(size_t)NumMrdTracks) {
+    Log("EventSelector Tool: Error retrieving the MRDTracks vector!",v_error,verbosity);
+    return false;
+  }
   
   for(int entrynum=0; entrynum<NumMrdTracks; entrynum++) {
-    //m_data->Stores["MRDTracks"]->GetEntry(entrynum);
-    m_data->Stores.at("MRDTracks")->Get("TrackLength",mrdtracklength);
-    m_data->Stores.at("MRDTracks")->Get("LayersHit",mrdlayershit);
+    double mrdtracklength = theMrdTracks->at(entrynum).TrackLength;
     if(MaximumMRDTrackLength<mrdtracklength) {
       MaximumMRDTrackLength = mrdtracklength;
       longesttrackEntryNumber = entrynum;
     }
   }
+  if(longesttrackEntryNumber<0) return false;
   // check if the longest track is stopped inside MRD
-  //m_data->Stores["MRDTracks"]->GetEntry(longesttrackEntryNumber);
-  m_data->Stores.at("MRDTracks")->Get("IsMrdStopped",mrdtrackisstoped);
+  bool mrdtrackisstoped = theMrdTracks->at(longesttrackEntryNumber).IsMrdStopped;
   if(!mrdtrackisstoped) return false;
   return true;
 }
@@ -46,10 +46,10 @@ bool FindMrdTracks::Initialise(std::string configfile, DataModel &data){
 	}
 
 	// create a store for holding MRD tracks to pass to downstream Tools
-	// will be a single entry BoostStore containing a vector of single entry BoostStores
+	// will be a single entry BoostStore containing a vector of MrdTracks
 	m_data->Stores["MRDTracks"] = new BoostStore(true,0);
 	// the vector of MRD tracks found in the current event
-	theMrdTracks = new std::vector<BoostStore>(5);
+	theMrdTracks = new std::vector<MrdTrack>(5);
 	// in case we don't find any tracks in the first event, we should populate the entry in the MRDTracks
 	// boost store so that other downstream tools that expect it will indeed find it.
 	m_data->Stores["MRDTracks"]->Set("MRDTracks",theMrdTracks,false);
@@ -349,7 +349,7 @@ if your class contains pointers, use TrackArray.Clear("C"). You MUST then provid
 	gROOT->cd();
 	
 	// save MRD tracks to the store for downstream tools
-	Log("FindMrdTracks tool: Writing MRD tracks to MRDTracks BoostStore",v_debug,verbosity);
+	Log("FindMrdTracks tool: Writing MRD tracks to MRDTracks store",v_debug,verbosity);
 	m_data->Stores["MRDTracks"]->Set("NumMrdSubEvents",nummrdsubeventsthisevent);
 	m_data->Stores["MRDTracks"]->Set("NumMrdTracks",nummrdtracksthisevent);
 	if(nummrdtracksthisevent>theMrdTracks->size()){
@@ -386,93 +386,83 @@ if your class contains pointers, use TrackArray.Clear("C"). You MUST then provid
 		for(unsigned int tracki=0; tracki<thetracks->size(); tracki++){
 			cMRDTrack* atrack = &thetracks->at(tracki);
 			
-			// get the BoostStore to hold this track
-			Log("FindMrdTracks: Getting Booststore at subevi = "+std::to_string(subevi)+" and tracki = "+std::to_string(tracki)+", global tracki = "+std::to_string(itrack_global),v_debug,verbosity);
-			BoostStore* thisTrackAsBoostStore = &(theMrdTracks->at(itrack_global));
+			// get the entry to hold this track, resetting it so nothing is left over from previous events
+			Log("FindMrdTracks: Filling MrdTrack at subevi = "+std::to_string(subevi)+" and tracki = "+std::to_string(tracki)+", global tracki = "+std::to_string(itrack_global),v_debug,verbosity);
+			MrdTrack& thisTrack = theMrdTracks->at(itrack_global);
+			thisTrack = MrdTrack();
 			itrack_global++;
-			// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
 			// If no tracks are found to match the reconstructed event vertex, the TrackCombiner Tool
-			// may perform a cruder reconstruction and append an Mrd Track to this vector.
-			// Since we don't remove and re-create the BoostStores each Execute, any members that are
-			// not updated by both tools could result in spurious track properties being propagated!
-			// !!!!!!!!!!!!! It is therefore crucial to keep these two Tools in sync! !!!!!!!!!!!!!!!
-			// XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX
-			// IF ADDING MEMBERS TO THE MRDTRACK BOOSTSTORE HERE, ADD THEM TO THE TRACKCOMBINER TOO!
-			// XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX
-			// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
+			// may perform a cruder reconstruction and append an MrdTrack to this vector.
+			// IF ADDING MEMBERS TO THE MRDTRACK HERE, FILL THEM IN THE TRACKCOMBINER TOO!
 			
 			// fill with this track's data
-			thisTrackAsBoostStore->Set("MrdTrackID",atrack->GetTrackID());
+			thisTrack.MrdTrackID = atrack->GetTrackID();
 			if(subevi!=atrack->GetMrdSubEventID()){
 				Log("FindMrdTracks Tool Error: cMRDTrack::GetMrdSubEventID in wrong subevi!",v_error,verbosity);
 			}
-			thisTrackAsBoostStore->Set("MrdSubEventID",atrack->GetMrdSubEventID());
-			thisTrackAsBoostStore->Set("InterceptsTank",atrack->GetInterceptsTank());
-			thisTrackAsBoostStore->Set("StartTime",atrack->GetStartTime());
+			thisTrack.MrdSubEventID = atrack->GetMrdSubEventID();
+			thisTrack.InterceptsTank = atrack->GetInterceptsTank();
+			thisTrack.StartTime = atrack->GetStartTime();
 			// convert start posn from TVector3 to ANNIEEVENT Position class
-			Position startpos(atrack->GetStartVertex().X() / 100.,
-							  atrack->GetStartVertex().Y() / 100.,
-							  atrack->GetStartVertex().Z() / 100.);
+			thisTrack.StartVertex = Position(atrack->GetStartVertex().X() / 100.,
+											 atrack->GetStartVertex().Y() / 100.,
+											 atrack->GetStartVertex().Z() / 100.);
 			// same for endpos
-			Position endpos(  atrack->GetStopVertex().X() / 100.,
-							  atrack->GetStopVertex().Y() / 100.,
-							  atrack->GetStopVertex().Z() / 100.);
-			thisTrackAsBoostStore->Set("StartVertex",startpos);
-			thisTrackAsBoostStore->Set("StopVertex",endpos);
-			thisTrackAsBoostStore->Set("TrackAngle",atrack->GetTrackAngle());
-			thisTrackAsBoostStore->Set("TrackAngleError",atrack->GetTrackAngleError()); // TODO!!!
-			thisTrackAsBoostStore->Set("LayersHit",atrack->GetLayersHit());
-			thisTrackAsBoostStore->Set("TrackLength",atrack->GetTrackLength() / 100.);
-			thisTrackAsBoostStore->Set("IsMrdPenetrating",atrack->GetIsPenetrating());
-			thisTrackAsBoostStore->Set("EnergyLoss",atrack->GetEnergyLoss());
-			thisTrackAsBoostStore->Set("EnergyLossError",atrack->GetEnergyLossError());
-			thisTrackAsBoostStore->Set("IsMrdStopped",atrack->GetIsStopped());
-			thisTrackAsBoostStore->Set("IsMrdSideExit",atrack->GetIsSideExit());
-			thisTrackAsBoostStore->Set("PenetrationDepth",atrack->GetPenetrationDepth() / 100.);
-			thisTrackAsBoostStore->Set("HtrackFitChi2",atrack->GetHtrackFitChi2());
-			thisTrackAsBoostStore->Set("HtrackFitCov",atrack->GetHtrackFitCov());
-			thisTrackAsBoostStore->Set("VtrackFitChi2",atrack->GetVtrackFitChi2());
-			thisTrackAsBoostStore->Set("VtrackFitCov",atrack->GetVtrackFitCov());
-			thisTrackAsBoostStore->Set("PMTsHit",atrack->GetPMTsHit());
+			thisTrack.StopVertex = Position( atrack->GetStopVertex().X() / 100.,
+											 atrack->GetStopVertex().Y() / 100.,
+											 atrack->GetStopVertex().Z() / 100.);
+			thisTrack.TrackAngle = atrack->GetTrackAngle();
+			thisTrack.TrackAngleError = atrack->GetTrackAngleError(); // TODO!!!
+			thisTrack.LayersHit = atrack->GetLayersHit();
+			thisTrack.TrackLength = atrack->GetTrackLength() / 100.;
+			thisTrack.IsMrdPenetrating = atrack->GetIsPenetrating();
+			thisTrack.EnergyLoss = atrack->GetEnergyLoss();
+			thisTrack.EnergyLossError = atrack->GetEnergyLossError();
+			thisTrack.IsMrdStopped = atrack->GetIsStopped();
+			thisTrack.IsMrdSideExit = atrack->GetIsSideExit();
+			thisTrack.PenetrationDepth = atrack->GetPenetrationDepth() / 100.;
+			thisTrack.HtrackFitChi2 = atrack->GetHtrackFitChi2();
+			thisTrack.HtrackFitCov = atrack->GetHtrackFitCov();
+			thisTrack.VtrackFitChi2 = atrack->GetVtrackFitChi2();
+			thisTrack.VtrackFitCov = atrack->GetVtrackFitCov();
+			thisTrack.PMTsHit = atrack->GetPMTsHit();
 			
-			thisTrackAsBoostStore->Set("HtrackOrigin",atrack->GetHtrackOrigin());
-			thisTrackAsBoostStore->Set("HtrackOriginError",atrack->GetHtrackOriginError());
-			thisTrackAsBoostStore->Set("HtrackGradient",atrack->GetHtrackGradient());
-			thisTrackAsBoostStore->Set("HtrackGradientError",atrack->GetHtrackGradientError());
-			thisTrackAsBoostStore->Set("VtrackOrigin",atrack->GetVtrackOrigin());
-			thisTrackAsBoostStore->Set("VtrackOriginError",atrack->GetVtrackOriginError());
-			thisTrackAsBoostStore->Set("VtrackGradient",atrack->GetVtrackGradient());
-			thisTrackAsBoostStore->Set("VtrackGradientError",atrack->GetVtrackGradientError());
+			thisTrack.HtrackOrigin = atrack->GetHtrackOrigin();
+			thisTrack.HtrackOriginError = atrack->GetHtrackOriginError();
+			thisTrack.HtrackGradient = atrack->GetHtrackGradient();
+			thisTrack.HtrackGradientError = atrack->GetHtrackGradientError();
+			thisTrack.VtrackOrigin = atrack->GetVtrackOrigin();
+			thisTrack.VtrackOriginError = atrack->GetVtrackOriginError();
+			thisTrack.VtrackGradient = atrack->GetVtrackGradient();
+			thisTrack.VtrackGradientError = atrack->GetVtrackGradientError();
 			
 			// convert back projections to Position class
-			Position TankExitPoint( atrack->GetTankExitPoint().X() / 100.,
-									atrack->GetTankExitPoint().Y() / 100.,
-									atrack->GetTankExitPoint().Z() / 100.);
-			Position MrdEntryPoint( atrack->GetMrdEntryPoint().X() / 100.,
-									atrack->GetMrdEntryPoint().Y() / 100.,
-									atrack->GetMrdEntryPoint().Z() / 100.);
-			thisTrackAsBoostStore->Set("TankExitPoint",TankExitPoint);
-			thisTrackAsBoostStore->Set("MrdEntryPoint",MrdEntryPoint);
-			thisTrackAsBoostStore->Set("TrackIndex",tracki);
+			thisTrack.TankExitPoint = Position( atrack->GetTankExitPoint().X() / 100.,
+												atrack->GetTankExitPoint().Y() / 100.,
+												atrack->GetTankExitPoint().Z() / 100.);
+			thisTrack.MrdEntryPoint = Position( atrack->GetMrdEntryPoint().X() / 100.,
+												atrack->GetMrdEntryPoint().Y() / 100.,
+												atrack->GetMrdEntryPoint().Z() / 100.);
+			thisTrack.TrackIndex = tracki;
 			
 			// this stuff either isn't important or isn't yet implemented, don't store:
-//			thisTrackAsBoostStore->Set("NumPMTsHit",atrack->GetNumPMTsHit());
-//			thisTrackAsBoostStore->Set("KEStart",atrack->GetKEStart());
-//			thisTrackAsBoostStore->Set("KEEnd",atrack->GetKEEnd());
-//			thisTrackAsBoostStore->Set("ParticlePID",atrack->GetParticlePID());
-//			thisTrackAsBoostStore->Set("NumLayersHit",atrack->GetNumLayersHit());
-//			thisTrackAsBoostStore->Set("LayerEdeps",atrack->GetEdeps());
-//			thisTrackAsBoostStore->Set("NumDigits",atrack->GetNumDigits());
-//			thisTrackAsBoostStore->Set("MrdEntryBoundsX",atrack->GetMrdEntryBoundsX());
-//			thisTrackAsBoostStore->Set("MrdEntryBoundsY",atrack->GetMrdEntryBoundsY());
-//			//thisTrackAsBoostStore->Set("TrueTrackID",atrack->GetTrueTrackID());
-//			//thisTrackAsBoostStore->Set("TrueTrack",atrack->GetTrueTrack());
-//			thisTrackAsBoostStore->Set("DigitIds",atrack->GetDigitIds());
-//			thisTrackAsBoostStore->Set("DigitQs",atrack->GetDigitQs());
-//			thisTrackAsBoostStore->Set("DigitTs",atrack->GetDigitTs());
-//			thisTrackAsBoostStore->Set("DigiNumPhots",atrack->GetDigiNumPhots());
-//			thisTrackAsBoostStore->Set("DigiPhotTs",atrack->GetDigiPhotTs());
-//			thisTrackAsBoostStore->Set("DigiPhotParents",atrack->GetDigiPhotParents());
+//			thisTrack.NumPMTsHit = atrack->GetNumPMTsHit();
+//			thisTrack.KEStart = atrack->GetKEStart();
+//			thisTrack.KEEnd = atrack->GetKEEnd();
+//			thisTrack.ParticlePID = atrack->GetParticlePID();
+//			thisTrack.NumLayersHit = atrack->GetNumLayersHit();
+//			thisTrack.LayerEdeps = atrack->GetEdeps();
+//			thisTrack.NumDigits = atrack->GetNumDigits();
+//			thisTrack.MrdEntryBoundsX = atrack->GetMrdEntryBoundsX();
+//			thisTrack.MrdEntryBoundsY = atrack->GetMrdEntryBoundsY();
+//			//thisTrack.TrueTrackID = atrack->GetTrueTrackID();
+//			//thisTrack.TrueTrack = atrack->GetTrueTrack();
+//			thisTrack.DigitIds = atrack->GetDigitIds();
+//			thisTrack.DigitQs = atrack->GetDigitQs();
+//			thisTrack.DigitTs = atrack->GetDigitTs();
+//			thisTrack.DigiNumPhots = atrack->GetDigiNumPhots();
+//			thisTrack.DigiPhotTs = atrack->GetDigiPhotTs();
+//			thisTrack.DigiPhotParents = atrack->GetDigiPhotParents();
 		}
 	}
 	std::cout <<"Setting MRDTracks"<<std::endl;
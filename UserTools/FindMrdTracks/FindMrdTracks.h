@@ -85,7 +85,7 @@ private:
 	
 	// For saving to the BoostStore to pass between Tools
 	// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-	std::vector<BoostStore>* theMrdTracks;
+	std::vector<MrdTrack>* theMrdTracks;
 	
 	// For Debug Drawing Tracks During Looping
 	// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
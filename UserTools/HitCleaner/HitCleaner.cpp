@@ -1,24 +1,5 @@
 #include "HitCleaner.h"
 
-static HitCleaner* fgHitCleaner = 0;
-
-HitCleaner* HitCleaner::Instance()
-{
-  if( !fgHitCleaner ){
-    fgHitCleaner = new HitCleaner();
-  }
-
-  if( !fgHitCleaner ){
-    assert(fgHitCleaner);
-  }
-
-  if( fgHitCleaner ){
-
-  }
-
-  return fgHitCleaner;
-}
-
 HitCleaner::HitCleaner():Tool(){}
 	
 HitCleaner::~HitCleaner() {
@@ -163,46 +144,6 @@ bool HitCleaner::Finalise(){
   return true;
 }
 
-void HitCleaner::Config(int config)
-{
-  HitCleaner::Instance()->SetConfig(config);
-}
-
-void HitCleaner::PmtMinPulseHeight(double min)
-{
-  HitCleaner::Instance()->SetPmtMinPulseHeight(min);
-}
-  
-void HitCleaner::PmtNeighbourRadius(double radius)
-{
-  HitCleaner::Instance()->SetPmtNeighbourRadius(radius);
-}
-  
-void HitCleaner::PmtNeighbourDigits(int digits)
-{
-  HitCleaner::Instance()->SetPmtNeighbourDigits(digits);
-}
-  
-void HitCleaner::PmtClusterRadius(double radius)
-{
-  HitCleaner::Instance()->SetPmtClusterRadius(radius);
-}
-  
-void HitCleaner::MinClusterDigits(int digits)
-{
-  HitCleaner::Instance()->SetMinClusterDigits(digits);
-}
-  
-void HitCleaner::PmtTimeWindowN(double windowN)
-{
-  HitCleaner::Instance()->SetPmtTimeWindowNeighbours(windowN);
-}
-
-void HitCleaner::PmtTimeWindowC(double windowC)
-{
-  HitCleaner::Instance()->SetPmtTimeWindowClusters(windowC);
-}
-
 void HitCleaner::PrintParameters()
 {
   std::cout << " *** HitCleaner::PrintParameters() *** " << std::endl;
@@ -370,69 +311,21 @@ std::vector<RecoDigit*>* HitCleaner::FilterByNeighbours(std::vector<RecoDigit*>*
 
   int* numNeighbours = new int[Ndigits];
 
-  for( int idigit=0; idigit<Ndigits; idigit++ ){
-    numNeighbours[idigit] = 0;
-  }
-
   // count number of neighbours
   // ==========================
-  for( int idigit1=0; idigit1<myDigitList->size(); idigit1++ ){
-  	RecoDigit* fdigit1 = (RecoDigit*)(myDigitList->at(idigit1));
-  	TString digit1Type = fdigit1->GetDigitType();
-    for( int idigit2=idigit1+1; idigit2<myDigitList->size(); idigit2++ ){
-      RecoDigit* fdigit2 = (RecoDigit*)(myDigitList->at(idigit2));
-      TString digit2Type = fdigit2->GetDigitType();
-
-      double dx = fdigit1->GetPosition().X() - fdigit2->GetPosition().X();
-      double dy = fdigit1->GetPosition().Y() - fdigit2->GetPosition().Y();
-      double dz = fdigit1->GetPosition().Z() - fdigit2->GetPosition().Z();
-      double dt = fdigit1->GetCalTime() - fdigit2->GetCalTime();
-      double drsq = dx*dx + dy*dy + dz*dz;
-      
-      if(digit1Type == RecoDigit::PMT8inch && digit2Type == RecoDigit::PMT8inch) {
-        if( drsq>0.0
-         && drsq<fPmtNeighbourRadius*fPmtNeighbourRadius
-         && fabs(dt)<fPmtTimeWindowN ){
-          numNeighbours[idigit1]++;
-          numNeighbours[idigit2]++;
-        }	
-      }
-      
-      if(digit1Type == RecoDigit::lappd_v0 && digit2Type == RecoDigit::lappd_v0) {
-        if( drsq>0.0
-         && drsq<fLappdNeighbourRadius*fLappdNeighbourRadius
-         && fabs(dt)<fLappdTimeWindowN ){
-          numNeighbours[idigit1]++;
-          numNeighbours[idigit2]++;
-        }	
-      }
-      
-      if(digit1Type == RecoDigit::PMT8inch && digit2Type == RecoDigit::lappd_v0) {
-        if( drsq>0.0
-            && drsq<fPmtNeighbourRadius*fPmtNeighbourRadius
-            && fabs(dt)<fPmtTimeWindowN ){
-          numNeighbours[idigit1]++;
-        }	
-        if( drsq>0.0
-            && drsq<fLappdNeighbourRadius*fLappdNeighbourRadius
-            && fabs(dt)<fLappdTimeWindowN ){
-          numNeighbours[idigit2]++;
-        }	   
-      }
+  // a PMT digit counts the digits within the PMT radius and time window
+  // as neighbours, a LAPPD digit those within the LAPPD radius and window
+  this->BuildDigitGrid(myDigitList, std::max(fabs(fPmtNeighbourRadius),fabs(fLappdNeighbourRadius)));
 
-      if(digit1Type == RecoDigit::lappd_v0 && digit2Type == RecoDigit::PMT8inch) {
-        if( drsq>0.0
-            && drsq<fLappdNeighbourRadius*fLappdNeighbourRadius
-            && fabs(dt)<fLappdTimeWindowN ){
-          numNeighbours[idigit1]++;
-        }	
-        if( drsq>0.0
-            && drsq<fPmtNeighbourRadius*fPmtNeighbourRadius
-            && fabs(dt)<fPmtTimeWindowN ){
-          numNeighbours[idigit2]++;
-        }	   
-      }
+  for( int idigit=0; idigit<Ndigits; idigit++ ){
+    if( fDigitType[idigit]==RecoDigit::PMT8inch ){
+      this->FindNeighbours(idigit, fPmtNeighbourRadius, fPmtTimeWindowN, vNeighbours);
     }
+    else if( fDigitType[idigit]==RecoDigit::lappd_v0 ){
+      this->FindNeighbours(idigit, fLappdNeighbourRadius, fLappdTimeWindowN, vNeighbours);
+    }
+    else vNeighbours.clear();
+    numNeighbours[idigit] = vNeighbours.size();
   }
 
   // filter by number of neighbours
@@ -509,63 +402,24 @@ std::vector<RecoCluster*>* HitCleaner::RecoClusters(std::vector<RecoDigit*>* myD
 
   // run clustering algorithm
   // ========================
+  // as for the neighbours, the radius and time window depend on the type
+  // of the digit the others are added to. Cluster digits are added in
+  // the order of the digit list.
+  this->BuildDigitGrid(myDigitList, std::max(fabs(fPmtClusterRadius),fabs(fLappdClusterRadius)));
+
   for( int idigit1=0; idigit1<vClusterDigitList.size(); idigit1++ ){
   	RecoClusterDigit* fdigit1 = (RecoClusterDigit*)(vClusterDigitList.at(idigit1));
-  	int digit1Type = fdigit1->GetDigitType();
-    for( int idigit2=idigit1+1; idigit2<vClusterDigitList.size(); idigit2++ ){
-
-      RecoClusterDigit* fdigit2 = (RecoClusterDigit*)(vClusterDigitList.at(idigit2));
-      int digit2Type = fdigit2->GetDigitType();
-
-      double dx = fdigit1->GetX() - fdigit2->GetX();
-      double dy = fdigit1->GetY() - fdigit2->GetY();
-      double dz = fdigit1->GetZ() - fdigit2->GetZ();
-      double dt = fdigit1->GetTime() - fdigit2->GetTime();
-      double drsq = dx*dx + dy*dy + dz*dz;
-      if(digit1Type == RecoDigit::PMT8inch && digit2Type == RecoDigit::PMT8inch) {
-        if( drsq>0.0
-         && drsq<fPmtClusterRadius*fPmtClusterRadius
-         && fabs(dt)<fPmtTimeWindowC ){
-          fdigit1->AddClusterDigit(fdigit2);
-          fdigit2->AddClusterDigit(fdigit1);
-        }	
-      }
-      
-      if(digit1Type == RecoDigit::lappd_v0 && digit2Type == RecoDigit::lappd_v0) {
-        if( drsq>0.0
-         && drsq<fLappdClusterRadius*fLappdClusterRadius
-         && fabs(dt)<fLappdTimeWindowC ){
-          fdigit1->AddClusterDigit(fdigit2);
-          fdigit2->AddClusterDigit(fdigit1);
-        }	
-      }
-      
-      if(digit1Type == RecoDigit::PMT8inch && digit2Type == RecoDigit::lappd_v0) {
-        if( drsq>0.0
-         && drsq<fPmtClusterRadius*fPmtClusterRadius
-         && fabs(dt)<fPmtTimeWindowC ){
-          fdigit1->AddClusterDigit(fdigit2);
-        }	
-        if( drsq>0.0
-         && drsq<fLappdClusterRadius*fLappdClusterRadius
-         && fabs(dt)<fLappdTimeWindowC ){
-          fdigit2->AddClusterDigit(fdigit1);
-        }
-      }
-      
-      if(digit1Type == RecoDigit::lappd_v0 && digit2Type == RecoDigit::PMT8inch) {
-        if( drsq>0.0
-         && drsq<fLappdClusterRadius*fLappdClusterRadius
-         && fabs(dt)<fLappdTimeWindowC ){
-          fdigit1->AddClusterDigit(fdigit2);
-        }	
-        if( drsq>0.0
-         && drsq<fPmtClusterRadius*fPmtClusterRadius
-         && fabs(dt)<fPmtTimeWindowC ){
-          fdigit2->AddClusterDigit(fdigit1);
-        }	
-      }
-      
+  	int digit1Type = fDigitType[idigit1];
+    if( digit1Type == RecoDigit::PMT8inch ){
+      this->FindNeighbours(idigit1, fPmtClusterRadius, fPmtTimeWindowC, vNeighbours);
+    }
+    else if( digit1Type == RecoDigit::lappd_v0 ){
+      this->FindNeighbours(idigit1, fLappdClusterRadius, fLappdTimeWindowC, vNeighbours);
+    }
+    else vNeighbours.clear();
+
+    for( int ineighbour=0; ineighbour<vNeighbours.size(); ineighbour++ ){
+      fdigit1->AddClusterDigit(vClusterDigitList.at(vNeighbours.at(ineighbour)));
     }
   }
   
@@ -587,9 +441,7 @@ std::vector<RecoCluster*>* HitCleaner::RecoClusters(std::vector<RecoDigit*>* myD
         for( int jdigit=0; jdigit<vClusterDigitCollection.size(); jdigit++ ){
 	  //std::cout <<"jdigit = "<<jdigit<<", vClusterDigitCollection.size() = "<<vClusterDigitCollection.size()<<std::endl;
           RecoClusterDigit* cdigit = (RecoClusterDigit*)(vClusterDigitCollection.at(jdigit));
-          TString digitType = cdigit->GetDigitType();
-	        double nDigits = cdigit->GetNClusterDigits();
-	        vNdigitsCluster.push_back(nDigits);	 
+          int digitType = cdigit->GetDigitType();
 	               
 	        if (digitType==RecoDigit::PMT8inch && cdigit->GetNClusterDigits() > fPmtMinHitsPerCluster) {
              if( cdigit->IsAllClustered()==0 ){
@@ -639,6 +491,119 @@ std::vector<RecoCluster*>* HitCleaner::RecoClusters(std::vector<RecoDigit*>* myD
   return fClusterList;
 }
 
+void HitCleaner::BuildDigitGrid(std::vector<RecoDigit*>* myDigitList, double cellsize)
+{
+  // copy the digit positions and times
+  // ==================================
+  int Ndigits = myDigitList->size();
+  fDigitX.resize(Ndigits);
+  fDigitY.resize(Ndigits);
+  fDigitZ.resize(Ndigits);
+  fDigitT.resize(Ndigits);
+  fDigitType.resize(Ndigits);
+  for( int idigit=0; idigit<Ndigits; idigit++ ){
+    RecoDigit* recoDigit = (RecoDigit*)(myDigitList->at(idigit));
+    const Position& pos = recoDigit->GetPosition();
+    fDigitX[idigit] = pos.X();
+    fDigitY[idigit] = pos.Y();
+    fDigitZ[idigit] = pos.Z();
+    fDigitT[idigit] = recoDigit->GetCalTime();
+    fDigitType[idigit] = recoDigit->GetDigitType();
+  }
+  if( Ndigits==0 ) return;
+
+  // size the grid
+  // =============
+  fGridMinX = *std::min_element(fDigitX.begin(),fDigitX.end());
+  fGridMinY = *std::min_element(fDigitY.begin(),fDigitY.end());
+  fGridMinZ = *std::min_element(fDigitZ.begin(),fDigitZ.end());
+  double extent = std::max(*std::max_element(fDigitX.begin(),fDigitX.end()) - fGridMinX,
+                  std::max(*std::max_element(fDigitY.begin(),fDigitY.end()) - fGridMinY,
+                           *std::max_element(fDigitZ.begin(),fDigitZ.end()) - fGridMinZ));
+  // cells a little larger than the search radius, so that rounding can't put two digits
+  // closer than the radius more than one cell apart, and no more than 1e5 cells wide
+  fGridCellSize = std::max(cellsize*(1.0+1.0e-9), extent*1.0e-5);
+  if( !(fGridCellSize>0.0) ) fGridCellSize = 1.0;
+  fGridNy = (long long)(extent/fGridCellSize) + 1;
+  fGridNz = fGridNy;
+
+  // sort the digits by cell, then by time
+  // =====================================
+  fDigitCell.resize(Ndigits);
+  vGridOrder.resize(Ndigits);
+  for( int idigit=0; idigit<Ndigits; idigit++ ){
+    long long ix = (long long)((fDigitX[idigit]-fGridMinX)/fGridCellSize);
+    long long iy = (long long)((fDigitY[idigit]-fGridMinY)/fGridCellSize);
+    long long iz = (long long)((fDigitZ[idigit]-fGridMinZ)/fGridCellSize);
+    fDigitCell[idigit] = (ix*fGridNy + iy)*fGridNz + iz;
+    vGridOrder[idigit] = idigit;
+  }
+  std::sort(vGridOrder.begin(), vGridOrder.end(), [this](int a, int b){
+    if( fDigitCell[a]!=fDigitCell[b] ) return fDigitCell[a]<fDigitCell[b];
+    if( fDigitT[a]!=fDigitT[b] ) return fDigitT[a]<fDigitT[b];
+    return a<b;
+  });
+  vGridCell.resize(Ndigits);
+  vGridTime.resize(Ndigits);
+  for( int n=0; n<Ndigits; n++ ){
+    vGridCell[n] = fDigitCell[vGridOrder[n]];
+    vGridTime[n] = fDigitT[vGridOrder[n]];
+  }
+}
+
+void HitCleaner::FindNeighbours(int idigit, double radius, double timewindow, std::vector<int>& neighbours)
+{
+  neighbours.clear();
+  if( !(radius*radius>0.0) || !(timewindow>0.0) ) return;
+
+  double x = fDigitX[idigit];
+  double y = fDigitY[idigit];
+  double z = fDigitZ[idigit];
+  double t = fDigitT[idigit];
+  // the time search is widened slightly, the exact time cut is made below
+  double tsearch = timewindow + 1.0e-9*(1.0 + fabs(t) + timewindow);
+
+  long long ix = (long long)((x-fGridMinX)/fGridCellSize);
+  long long iy = (long long)((y-fGridMinY)/fGridCellSize);
+  long long iz = (long long)((z-fGridMinZ)/fGridCellSize);
+
+  // look in the 27 cells around the digit
+  // =====================================
+  for( long long jx=ix-1; jx<=ix+1; jx++ ){
+    if( jx<0 ) continue;
+    for( long long jy=iy-1; jy<=iy+1; jy++ ){
+      if( jy<0 || jy>=fGridNy ) continue;
+      for( long long jz=iz-1; jz<=iz+1; jz++ ){
+        if( jz<0 || jz>=fGridNz ) continue;
+        long long cell = (jx*fGridNy + jy)*fGridNz + jz;
+        std::vector<long long>::iterator cellbegin = std::lower_bound(vGridCell.begin(), vGridCell.end(), cell);
+        std::vector<long long>::iterator cellend = std::upper_bound(cellbegin, vGridCell.end(), cell);
+        if( cellbegin==cellend ) continue;
+        int first = std::lower_bound(vGridTime.begin() + (cellbegin-vGridCell.begin()), vGridTime.begin() + (cellend-vGridCell.begin()), t-tsearch) - vGridTime.begin();
+        int last = std::upper_bound(vGridTime.begin() + first, vGridTime.begin() + (cellend-vGridCell.begin()), t+tsearch) - vGridTime.begin();
+
+        for( int n=first; n<last; n++ ){
+          int jdigit = vGridOrder[n];
+          if( fDigitType[jdigit]!=RecoDigit::PMT8inch && fDigitType[jdigit]!=RecoDigit::lappd_v0 ) continue;
+          double dx = x - fDigitX[jdigit];
+          double dy = y - fDigitY[jdigit];
+          double dz = z - fDigitZ[jdigit];
+          double dt = t - fDigitT[jdigit];
+          double drsq = dx*dx + dy*dy + dz*dz;
+          if( drsq>0.0
+           && drsq<radius*radius
+           && fabs(dt)<timewindow ){
+            neighbours.push_back(jdigit);
+          }
+        }
+      }
+    }
+  }
+
+  // in the order of the digit list
+  std::sort(neighbours.begin(), neighbours.end());
+}
+
 std::vector<RecoDigit*>* HitCleaner::FilterByTruthInfo(std::vector<RecoDigit*>* DigitList)
 {
 	std::string name = " HitCleaner::FilterByTruthInfo(() ";
@@ -4,6 +4,8 @@
 #include <string>
 #include <iostream>
 #include <vector>
+#include <algorithm>
+#include <cmath>
 
 #include "Tool.h"
 #include "RecoCluster.h"
@@ -28,17 +30,6 @@ class HitCleaner: public Tool {
     kPulseHeightAndTruthInfo = 3
   } FilterConfig_t;
 
-  static HitCleaner* Instance();
-
-  static void Config(int config);
-  static void PmtMinPulseHeight(double min);
-  static void PmtNeighbourRadius(double radius);
-  static void PmtNeighbourDigits(int digits);
-  static void PmtClusterRadius(double radius);
-  static void MinClusterDigits(int digits);
-  static void PmtTimeWindowN(double windowN);
-  static void PmtTimeWindowC(double windowC);
-
   void PrintParameters();
 
   void SetConfig(int config)               { fConfig = config; }
@@ -69,6 +60,13 @@ class HitCleaner: public Tool {
   std::vector<RecoDigit*>* FilterByTruthInfo(std::vector<RecoDigit*>* digitlist); //use truth information. Only for testing the code
   std::vector<RecoCluster*>* RecoClusters(std::vector<RecoDigit*>* digitlist);
 
+  /// \brief Copy the positions, times and types of the digits and sort them into a
+  /// grid of cells at least cellsize wide, for FindNeighbours()
+  void BuildDigitGrid(std::vector<RecoDigit*>* digitlist, double cellsize);
+  /// \brief Indices of the PMT and LAPPD digits within radius and timewindow of digit idigit,
+  /// in increasing order. radius must not be larger than the cellsize of the grid.
+  void FindNeighbours(int idigit, double radius, double timewindow, std::vector<int>& neighbours);
+
 
  private:
   void Reset();
@@ -97,9 +95,23 @@ class HitCleaner: public Tool {
   int    fMinClusterDigits;
 
   // internal containers
-  std::vector<Double_t> vNdigitsCluster;  
   std::vector<RecoClusterDigit*> vClusterDigitList;
   std::vector<RecoClusterDigit*> vClusterDigitCollection;
+  std::vector<int> vNeighbours;
+
+  // digits indexed by BuildDigitGrid()
+  std::vector<double> fDigitX;
+  std::vector<double> fDigitY;
+  std::vector<double> fDigitZ;
+  std::vector<double> fDigitT;
+  std::vector<int> fDigitType;
+  std::vector<long long> fDigitCell;
+  double fGridMinX, fGridMinY, fGridMinZ;
+  double fGridCellSize;
+  long long fGridNy, fGridNz;
+  std::vector<int> vGridOrder;           // digit indices sorted by cell, then time
+  std::vector<long long> vGridCell;      // cell of each entry of vGridOrder
+  std::vector<double> vGridTime;         // time of each entry of vGridOrder
 
   // vectors of filtered digitss
   std::vector<RecoDigit*>* fFilterAll;
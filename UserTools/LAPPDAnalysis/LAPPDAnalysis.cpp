@@ -12,6 +12,8 @@ bool LAPPDAnalysis::Initialise(std::string configfile, DataModel &data){
   m_data= &data; //assigning transient data pointer
   /////////////////////////////////////////////////////////////////
 
+  m_variables.Get("PersistOutput",PersistOutput);
+
   return true;
 }
 
@@ -23,17 +25,17 @@ bool LAPPDAnalysis::Execute(){
   //BaselineSubtract
     Waveform<double> bwav;
     // get raw lappd data
-    map<int,vector<Waveform<double>>> rawlappddata;
-    m_data->Stores["ANNIEEvent"]->Get("RawLAPPDData",rawlappddata);
+    const map<int,vector<Waveform<double>>> nolappddata;
+    const auto& rawlappddata = ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],"RawLAPPDData",nolappddata);
     
 
     // the filtered Waveform
     std::map<int,vector<Waveform<double>>> blsublappddata;
 
-    map <int, vector<Waveform<double>>> :: iterator itr;
+    map <int, vector<Waveform<double>>> :: const_iterator itr;
     for (itr = rawlappddata.begin(); itr != rawlappddata.end(); ++itr){
       int channelno = itr->first;
-      vector<Waveform<double>> Vwavs = itr->second;
+      const vector<Waveform<double>>& Vwavs = itr->second;
       vector<Waveform<double>> Vfwavs;
 
       //loop over all Waveforms
@@ -47,7 +49,7 @@ bool LAPPDAnalysis::Execute(){
         blsublappddata.insert(pair <int,vector<Waveform<double>>> (channelno,Vfwavs));
       }
 
-    m_data->Stores["ANNIEEvent"]->Set("BLsubtractedLAPPDData",blsublappddata);
+    ANNIEEventMember::Publish(m_data->Stores["ANNIEEvent"],"BLsubtractedLAPPDData",std::move(blsublappddata),PersistOutput);
 
 
 
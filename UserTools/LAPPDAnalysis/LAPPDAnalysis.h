@@ -7,6 +7,7 @@
 #include "TH1.h"
 #include "TF1.h"
 #include "Tool.h"
+#include "ANNIEEventMember.h"
 
 class LAPPDAnalysis: public Tool {
 
@@ -27,6 +28,7 @@ class LAPPDAnalysis: public Tool {
       double Deltat;
       double LowBLfitrange;
       double HiBLfitrange;
+      bool PersistOutput = false;
 
 
 
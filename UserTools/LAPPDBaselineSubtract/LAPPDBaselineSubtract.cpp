@@ -19,6 +19,7 @@ bool LAPPDBaselineSubtract::Initialise(std::string configfile, DataModel &data){
   m_variables.Get("SampleSize",Deltat);
   m_variables.Get("LowBLfitrange", LowBLfitrange);
   m_variables.Get("HiBLfitrange",HiBLfitrange);
+  m_variables.Get("PersistOutput",PersistOutput);
 
   return true;
 }
@@ -29,16 +30,16 @@ bool LAPPDBaselineSubtract::Execute(){
   Waveform<double> bwav;
 
   // get raw lappd data
-  std::map<int,vector<Waveform<double>>> rawlappddata;
-  m_data->Stores["ANNIEEvent"]->Get("RawLAPPDData",rawlappddata);
+  const std::map<int,vector<Waveform<double>>> nolappddata;
+  const auto& rawlappddata = ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],"RawLAPPDData",nolappddata);
 
   // the filtered Waveform
   std::map<int,vector<Waveform<double>>> blsublappddata;
 
-  map <int, vector<Waveform<double>>> :: iterator itr;
+  map <int, vector<Waveform<double>>> :: const_iterator itr;
   for (itr = rawlappddata.begin(); itr != rawlappddata.end(); ++itr){
     int channelno = itr->first;
-    vector<Waveform<double>> Vwavs = itr->second;
+    const vector<Waveform<double>>& Vwavs = itr->second;
     vector<Waveform<double>> Vfwavs;
 
     //loop over all Waveforms
@@ -52,7 +53,7 @@ bool LAPPDBaselineSubtract::Execute(){
       blsublappddata.insert(pair <int,vector<Waveform<double>>> (channelno,Vfwavs));
     }
 
-  m_data->Stores["ANNIEEvent"]->Set("BLsubtractedLAPPDData",blsublappddata);
+  ANNIEEventMember::Publish(m_data->Stores["ANNIEEvent"],"BLsubtractedLAPPDData",std::move(blsublappddata),PersistOutput);
 
   return true;
 }
@@ -22,6 +22,7 @@ bool LAPPDFilter::Initialise(std::string configfile, DataModel &data){
   m_variables.Get("Nsamples", DimSize);
   m_variables.Get("CutoffFrequency", CutoffFrequency);
   m_variables.Get("SampleSize",Deltat);
+  m_variables.Get("PersistOutput",PersistOutput);
   return true;
 }
 
@@ -31,18 +32,18 @@ bool LAPPDFilter::Execute(){
   Waveform<double> bwav;
 
   // get raw lappd data
-  std::map<int,vector<Waveform<double>>> rawlappddata;
+  const std::map<int,vector<Waveform<double>>> nolappddata;
 
   //m_data->Stores["ANNIEEvent"]->Get("RawLAPPDData",rawlappddata);
-  m_data->Stores["ANNIEEvent"]->Get(FilterInputWavLabel,rawlappddata);
+  const auto& rawlappddata = ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],FilterInputWavLabel,nolappddata);
 
   // the filtered Waveform
   std::map<int,vector<Waveform<double>>> filteredlappddata;
 
-  map <int, vector<Waveform<double>>> :: iterator itr;
+  map <int, vector<Waveform<double>>> :: const_iterator itr;
   for (itr = rawlappddata.begin(); itr != rawlappddata.end(); ++itr){
     int channelno = itr->first;
-    vector<Waveform<double>> Vwavs = itr->second;
+    const vector<Waveform<double>>& Vwavs = itr->second;
     vector<Waveform<double>> Vfwavs;
 
     //loop over all Waveforms
@@ -56,7 +57,7 @@ bool LAPPDFilter::Execute(){
       filteredlappddata.insert(pair <int,vector<Waveform<double>>> (channelno,Vfwavs));
     }
 
-  m_data->Stores["ANNIEEvent"]->Set("FiltLAPPDData",filteredlappddata);
+  ANNIEEventMember::Publish(m_data->Stores["ANNIEEvent"],"FiltLAPPDData",std::move(filteredlappddata),PersistOutput);
 
 
   return true;
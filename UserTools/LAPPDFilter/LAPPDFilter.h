@@ -6,6 +6,7 @@
 #include "TVirtualFFT.h"
 
 #include "Tool.h"
+#include "ANNIEEventMember.h"
 #include "TH1D.h"
 #include "TMath.h"
 
@@ -30,6 +31,7 @@ class LAPPDFilter: public Tool {
   double CutoffFrequency;
   double Deltat;
   string FilterInputWavLabel;
+  bool PersistOutput = false;
 
 
 };
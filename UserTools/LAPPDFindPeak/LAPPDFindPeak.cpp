@@ -33,17 +33,17 @@ bool LAPPDFindPeak::Execute(){
   //std::cout<<"In Peak Finding Tool..............................."<<std::endl;
 
   // get raw lappd data
-  std::map<int,vector<Waveform<double>>> rawlappddata;
-  m_data->Stores["ANNIEEvent"]->Get(PeakInputWavLabel,rawlappddata);
+  const std::map<int,vector<Waveform<double>>> nolappddata;
+  const auto& rawlappddata = ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],PeakInputWavLabel,nolappddata);
   //bool testval =  m_data->Stores["ANNIEEvent"]->Get("RawLAPPDData",rawlappddata);
 
   // make reconstructed pulses
   std::map<int,vector<LAPPDPulse>> SimpleRecoLAPPDPulses;
 
-  map <int, vector<Waveform<double>>> :: iterator itr;
+  map <int, vector<Waveform<double>>> :: const_iterator itr;
   for (itr = rawlappddata.begin(); itr != rawlappddata.end(); ++itr){
     int channelno = itr->first;
-    vector<Waveform<double>> Vwavs = itr->second;
+    const vector<Waveform<double>>& Vwavs = itr->second;
 
     //loop over all Waveforms
     std::vector<LAPPDPulse> thepulses;
@@ -8,6 +8,7 @@
 #include "TVector3.h"
 
 #include "Tool.h"
+#include "ANNIEEventMember.h"
 
 class LAPPDFindPeak: public Tool {
 
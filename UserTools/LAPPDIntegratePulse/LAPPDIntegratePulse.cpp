@@ -32,15 +32,15 @@ bool LAPPDIntegratePulse::Initialise(std::string configfile, DataModel &data){
 bool LAPPDIntegratePulse::Execute(){
 
   // get raw lappd data
-  std::map<int,vector<Waveform<double>>> rawlappddata;
-  bool testval =  m_data->Stores["ANNIEEvent"]->Get("RawLAPPDData",rawlappddata);
+  const std::map<int,vector<Waveform<double>>> nolappddata;
+  const auto& rawlappddata = ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],"RawLAPPDData",nolappddata);
 
   std::map<int,vector<double>> thecharge;
 
-  map <int, vector<Waveform<double>>> :: iterator itr;
+  map <int, vector<Waveform<double>>> :: const_iterator itr;
   for (itr = rawlappddata.begin(); itr != rawlappddata.end(); ++itr){
     int channelno = itr->first;
-    vector<Waveform<double>> Vwavs = itr->second;
+    const vector<Waveform<double>>& Vwavs = itr->second;
 
     //loop over all Waveforms
     vector<double> acharge;
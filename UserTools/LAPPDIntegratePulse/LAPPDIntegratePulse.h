@@ -5,6 +5,7 @@
 #include <iostream>
 
 #include "Tool.h"
+#include "ANNIEEventMember.h"
 
 class LAPPDIntegratePulse: public Tool {
 
@@ -64,7 +64,7 @@ bool LAPPDParseScope::Execute(){
   }
 
   // add the map of Waveforms to the Boost Store
-  m_data->Stores["ANNIEEvent"]->Set("RawLAPPDData",RawLAPPDData);
+  ANNIEEventMember::Publish(m_data->Stores["ANNIEEvent"],"RawLAPPDData",std::move(RawLAPPDData),true);
 
   iter++;
 
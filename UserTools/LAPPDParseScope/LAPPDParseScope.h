@@ -5,6 +5,7 @@
 #include <iostream>
 #include <TRandom3.h>
 #include "Tool.h"
+#include "ANNIEEventMember.h"
 
 class LAPPDParseScope: public Tool {
 
@@ -134,13 +134,11 @@ LAPPDTree->Branch("PulseNum",&PulseNum);
 }
  LAPPDTree->Fill(); 
       // get raw lappd data
-  std::map<int,vector<Waveform<double>>> rawlappddata;
-  m_data->Stores["ANNIEEvent"]->Get("RawLAPPDData",rawlappddata);
+  const std::map<int,vector<Waveform<double>>> nolappddata;
+  const auto& rawlappddata = ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],"RawLAPPDData",nolappddata);
   // get filtered data
-  std::map<int,vector<Waveform<double>>> filteredlappddata;
-  if(isFiltered) m_data->Stores["ANNIEEvent"]->Get("FiltLAPPDData",filteredlappddata);
-  std::map<int,vector<Waveform<double>>> BLsubtractedlappddata;
-  if(isBLsub)    m_data->Stores["ANNIEEvent"]->Get("BLsubtractedLAPPDData",BLsubtractedlappddata);
+  const auto& filteredlappddata = isFiltered ? ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],"FiltLAPPDData",nolappddata) : nolappddata;
+  const auto& BLsubtractedlappddata = isBLsub ? ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],"BLsubtractedLAPPDData",nolappddata) : nolappddata;
   // get charge information
   std::map<int, vector<double>> TheCharges;
   if(isIntegrated) m_data->Stores["ANNIEEvent"]->Get("theCharges",TheCharges);
@@ -149,22 +147,22 @@ LAPPDTree->Branch("PulseNum",&PulseNum);
   m_data->Stores["ANNIEEvent"]->Get("CFDRecoLAPPDPulses",CFDRecoLAPPDPulses);
 
   // loop over all channels
-  std::map<int, vector<Waveform<double>>> :: iterator itr;
+  std::map<int, vector<Waveform<double>>> :: const_iterator itr;
   for (itr = rawlappddata.begin(); itr != rawlappddata.end(); ++itr){
 
     int channelno = itr->first;
-    vector<Waveform<double>> Vwavs = itr->second;
+    const vector<Waveform<double>>& Vwavs = itr->second;
 
     vector<Waveform<double>> Vfwavs;
     if(isFiltered){
-      std::map<int, vector<Waveform<double>>>::iterator fp;
+      std::map<int, vector<Waveform<double>>>::const_iterator fp;
       fp = filteredlappddata.find(channelno);
       Vfwavs = fp->second;
     }
 
     vector<Waveform<double>> Vblswavs;
     if(isBLsub){
-      std::map<int, vector<Waveform<double>>>::iterator bp;
+      std::map<int, vector<Waveform<double>>>::const_iterator bp;
       bp = BLsubtractedlappddata.find(channelno);
       Vblswavs = bp->second;
     }
@@ -32,8 +32,8 @@ bool LAPPDcfd::Execute(){
   Waveform<double> bwav;
 
   // get raw lappd data from the Boost Store
-  std::map<int,vector<Waveform<double>>> rawlappddata;
-  bool testval =  m_data->Stores["ANNIEEvent"]->Get(CFDInputWavLabel,rawlappddata);
+  const std::map<int,vector<Waveform<double>>> nolappddata;
+  const auto& rawlappddata = ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],CFDInputWavLabel,nolappddata);
 
   // get first-level pulse reco from the Boost Store
   std::map<int,vector<LAPPDPulse>> SimpleRecoLAPPDPulses;
@@ -50,12 +50,12 @@ bool LAPPDcfd::Execute(){
   std::map<int,vector<LAPPDPulse>> CFDRecoLAPPDPulses;
 
   // Loop over all channels
-  map <int, vector<Waveform<double>>> :: iterator itr;
+  map <int, vector<Waveform<double>>> :: const_iterator itr;
   for (itr = rawlappddata.begin(); itr != rawlappddata.end(); ++itr){
 
     // Get the channel number and a vector of Waveforms
     int channelno = itr->first;
-    vector<Waveform<double>> Vwavs = itr->second;
+    const vector<Waveform<double>>& Vwavs = itr->second;
 
     // get the vector of pulses correseponding to the channel
     map<int, vector<LAPPDPulse>>::iterator p;
@@ -11,6 +11,7 @@
 #include "TH1D.h"
 
 #include "Tool.h"
+#include "ANNIEEventMember.h"
 
 class LAPPDcfd: public Tool {
 
@@ -1,5 +1,7 @@
 // standard library includes
+#include <algorithm>
 #include <fstream>
+#include <sstream>
 
 // ToolAnalysis includes
 #include "LoadANNIEEvent.h"
@@ -18,6 +20,43 @@ bool LoadANNIEEvent::Initialise(std::string config_filename, DataModel &data) {
   m_variables.Get("verbose", verbosity_);
   m_variables.Get("EventOffset", offset_evnum);
 
+  std::string input_format = "BoostStore";
+  m_variables.Get("InputFormat", input_format);
+  use_column_file_ = ( input_format == "ColumnFile" );
+  use_record_file_ = ( input_format == "RecordFile" );
+  if ( !use_column_file_ && !use_record_file_ && input_format != "BoostStore" ) {
+    Log("Error: Unknown InputFormat \"" + input_format + "\" in the configuration"
+      " for the LoadANNIEEvent tool (use BoostStore, ColumnFile or RecordFile)", 0,
+      verbosity_);
+    return false;
+  }
+
+  // Comma-separated list of the ANNIEEvent keys to load from column files
+  std::string columns_to_load;
+  if ( m_variables.Get("ColumnsToLoad", columns_to_load) && columns_to_load != "All" ) {
+    std::stringstream columns_stream(columns_to_load);
+    std::string column_name;
+    while ( std::getline(columns_stream, column_name, ',') ) {
+      if ( !column_name.empty() ) columns_to_load_.push_back(column_name);
+    }
+  }
+
+  // Hit and waveform maps are set as pointers, so tools reading them share
+  // one copy instead of each deserialising their own
+  using namespace ANNIEEventColumn;
+  this->AddLoaders<int>(false);
+  this->AddLoaders<uint32_t>(false);
+  this->AddLoaders<uint64_t>(false);
+  this->AddLoaders<double>(false);
+  this->AddLoaders<bool>(false);
+  this->AddLoaders<std::string>(false);
+  this->AddLoaders<TimeClass>(false);
+  this->AddLoaders<StringIntMap>(false);
+  this->AddLoaders<WaveformMap>(true);
+  this->AddLoaders<std::vector<Hit> >(false);
+  this->AddLoaders<HitMap>(true);
+  this->AddLoaders<MCHitMap>(true);
+
   std::string input_list_filename;
   bool got_input_file_list = m_variables.Get("FileForListOfInputs",
     input_list_filename);
@@ -65,16 +104,36 @@ bool LoadANNIEEvent::Execute() {
       if (annie_event) delete annie_event;
     }
 
-    // Create a new ANNIEEvent Store
-    m_data->Stores["ANNIEEvent"] = new BoostStore(false,
-      BOOST_STORE_MULTIEVENT_FORMAT);
-
-    // Load it from the new input file
     std::string input_filename = input_filenames_.at(current_file_);
     std::cout <<"Reading in current file "<<current_file_<<std::endl;
-    m_data->Stores["ANNIEEvent"]->Initialise(input_filename);
-    m_data->Stores["ANNIEEvent"]->Header->Get("TotalEntries",
-      total_entries_in_file_);
+    if ( use_column_file_ ) {
+      // Column files are mapped, and each event's columns copied into a
+      // plain ANNIEEvent store when it is loaded
+      m_data->Stores["ANNIEEvent"] = new BoostStore(false, 2);
+      if ( !this->OpenColumnFile(input_filename) ) return false;
+      total_entries_in_file_ = column_reader_.GetNumEvents();
+    }
+    else if ( use_record_file_ ) {
+      // Record files are indexed when opened, and each event's members
+      // deserialised into a plain ANNIEEvent store when it is loaded
+      m_data->Stores["ANNIEEvent"] = new BoostStore(false, 2);
+      if ( !record_reader_.Open(input_filename) ) {
+        Log("Error: Could not open the ANNIEEvent record file \"" + input_filename
+          + '\"', 0, verbosity_);
+        return false;
+      }
+      total_entries_in_file_ = record_reader_.GetNumEvents();
+    }
+    else {
+      // Create a new ANNIEEvent Store
+      m_data->Stores["ANNIEEvent"] = new BoostStore(false,
+        BOOST_STORE_MULTIEVENT_FORMAT);
+
+      // Load it from the new input file
+      m_data->Stores["ANNIEEvent"]->Initialise(input_filename);
+      m_data->Stores["ANNIEEvent"]->Header->Get("TotalEntries",
+        total_entries_in_file_);
+    }
   }
 
    bool user_event=false;
@@ -91,9 +150,21 @@ bool LoadANNIEEvent::Execute() {
     " ANNIEEvent input file \"" + input_filenames_.at(current_file_)
     + '\"', 1, verbosity_);
  
-  if (current_entry_ != offset_evnum) m_data->Stores["ANNIEEvent"]->Delete();	//ensures that we can access pointers without problems
+  if ( use_column_file_ ) {
+    // Any event is a lookup in the column indices, so no entries are read
+    // on the way to it
+    m_data->Stores["ANNIEEvent"]->Delete();
+    this->LoadColumnEvent(current_entry_);
+  }
+  else if ( use_record_file_ ) {
+    m_data->Stores["ANNIEEvent"]->Delete();
+    if ( !this->LoadRecordEvent(current_entry_) ) return false;
+  }
+  else {
+    if (current_entry_ != offset_evnum) m_data->Stores["ANNIEEvent"]->Delete();	//ensures that we can access pointers without problems
 
-  m_data->Stores["ANNIEEvent"]->GetEntry(current_entry_);  
+    m_data->Stores["ANNIEEvent"]->GetEntry(current_entry_);
+  }
   ++current_entry_;
   
   if ( current_entry_ >= total_entries_in_file_ ) {
@@ -113,5 +184,79 @@ bool LoadANNIEEvent::Execute() {
 
 
 bool LoadANNIEEvent::Finalise() {
+  column_reader_.Close();
+  record_reader_.Close();
+  return true;
+}
+
+bool LoadANNIEEvent::OpenColumnFile(const std::string& input_filename) {
+
+  if ( !column_reader_.Open(input_filename) ) {
+    Log("Error: Could not open the ANNIEEvent column file \"" + input_filename
+      + '\"', 0, verbosity_);
+    return false;
+  }
+
+  selected_columns_.clear();
+  for ( size_t column = 0; column < column_reader_.GetNumColumns(); ++column ) {
+    const std::string& name = column_reader_.GetColumnName(column);
+    if ( !columns_to_load_.empty() && std::find(columns_to_load_.begin(),
+      columns_to_load_.end(), name) == columns_to_load_.end() ) continue;
+
+    const std::string& type = column_reader_.GetColumnType(column);
+    auto loader = column_loaders_.find(type);
+    if ( loader == column_loaders_.end() ) {
+      Log("Warning: ANNIEEvent column \"" + name + "\" has a type (" + type
+        + ") that LoadANNIEEvent cannot load.  It will be skipped.", v_warning,
+        verbosity_);
+      continue;
+    }
+    selected_columns_.emplace_back(column, loader->second);
+  }
+
+  for ( const auto& name : columns_to_load_ ) {
+    if ( column_reader_.FindColumn(name) < 0 ) {
+      Log("Warning: ANNIEEvent column \"" + name + "\" requested in"
+        " ColumnsToLoad is not in \"" + input_filename + '\"', v_warning,
+        verbosity_);
+    }
+  }
+
+  Log("Loading " + std::to_string(selected_columns_.size()) + " of "
+    + std::to_string(column_reader_.GetNumColumns()) + " ANNIEEvent columns",
+    v_message, verbosity_);
+  return true;
+}
+
+void LoadANNIEEvent::LoadColumnEvent(uint64_t event) {
+  for ( const auto& selected : selected_columns_ ) {
+    (this->*selected.second)(selected.first, event);
+  }
+}
+
+bool LoadANNIEEvent::LoadRecordEvent(uint64_t event) {
+
+  if ( !record_reader_.ReadEvent(event) ) {
+    Log("Error: Could not read entry " + std::to_string(event) + " of the"
+      " ANNIEEvent record file \"" + input_filenames_.at(current_file_) + '\"', 0,
+      verbosity_);
+    return false;
+  }
+
+  // Run constants first, so an event member of the same name takes precedence
+  for ( const auto* members : { &record_reader_.GetRunConstants(),
+    &record_reader_.GetEventMembers() } )
+  {
+    for ( const auto& member : *members ) {
+      auto loader = record_loaders_.find(member.second.Type);
+      if ( loader == record_loaders_.end() ) {
+        Log("Warning: ANNIEEvent member \"" + member.first + "\" has a type ("
+          + member.second.Type + ") that LoadANNIEEvent cannot load.  It will be"
+          " skipped.", v_warning, verbosity_);
+        continue;
+      }
+      (this->*loader->second)(member.first);
+    }
+  }
   return true;
 }
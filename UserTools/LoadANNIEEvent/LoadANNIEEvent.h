@@ -3,9 +3,12 @@
 // standard library includes
 #include <string>
 #include <vector>
+#include <map>
 
 // ToolAnalysis includes
 #include "Tool.h"
+#include "ANNIEEventColumnFile.h"
+#include "ANNIEEventRecordFile.h"
 
 class LoadANNIEEvent: public Tool {
 
@@ -17,7 +20,60 @@ class LoadANNIEEvent: public Tool {
     bool Finalise();
 
   private:
-  
+
+    /// @brief Opens the current input file with the column reader and picks
+    /// the columns that will be loaded
+    bool OpenColumnFile(const std::string& input_filename);
+
+    /// @brief Fills the ANNIEEvent store with the selected columns of an event
+    void LoadColumnEvent(uint64_t event);
+
+    /// @brief Fills the ANNIEEvent store with an event of the current record
+    /// file and the run constants in force for it
+    bool LoadRecordEvent(uint64_t event);
+
+    /// @brief Registers the column and record loaders of a member type
+    template<class T> void AddLoaders(bool as_pointer) {
+      const std::string type = ANNIEEventColumn::Type<T>::Name();
+      column_loaders_[type] = as_pointer ? &LoadANNIEEvent::LoadColumnPointer<T>
+        : &LoadANNIEEvent::LoadColumnValue<T>;
+      record_loaders_[type] = as_pointer ? &LoadANNIEEvent::LoadRecordPointer<T>
+        : &LoadANNIEEvent::LoadRecordValue<T>;
+    }
+
+    /// @brief Column loaders.  Members the producers Set as pointers (hit maps)
+    /// are loaded as owned pointers, everything else by value.
+    template<class T> void LoadColumnValue(size_t column, uint64_t event) {
+      T value;
+      if ( column_reader_.Get(column, event, value) ) {
+        m_data->Stores["ANNIEEvent"]->Set(column_reader_.GetColumnName(column), value);
+      }
+    }
+    template<class T> void LoadColumnPointer(size_t column, uint64_t event) {
+      T* value = new T;
+      if ( column_reader_.Get(column, event, *value) ) {
+        m_data->Stores["ANNIEEvent"]->Set(column_reader_.GetColumnName(column), value, true);
+      }
+      else delete value;
+    }
+    typedef void (LoadANNIEEvent::*ColumnLoader)(size_t, uint64_t);
+
+    /// @brief Record loaders, as for the columns
+    template<class T> void LoadRecordValue(const std::string& name) {
+      T value;
+      if ( record_reader_.Get(name, value) ) {
+        m_data->Stores["ANNIEEvent"]->Set(name, value);
+      }
+    }
+    template<class T> void LoadRecordPointer(const std::string& name) {
+      T* value = new T;
+      if ( record_reader_.Get(name, *value) ) {
+        m_data->Stores["ANNIEEvent"]->Set(name, value, true);
+      }
+      else delete value;
+    }
+    typedef void (LoadANNIEEvent::*RecordLoader)(const std::string&);
+
     int v_error = 0;
     int v_warning = 1;
     int v_message = 2;
@@ -48,5 +104,31 @@ class LoadANNIEEvent: public Tool {
     /// @brief Flag indicating whether we need to load a new file
     bool need_new_file_;
 
+    /// @brief Flag indicating the input files are columnar ANNIEEvent files
+    /// (InputFormat ColumnFile) instead of BoostStores
+    bool use_column_file_;
+
+    /// @brief Flag indicating the input files are ANNIEEvent record files
+    /// (InputFormat RecordFile) instead of BoostStores
+    bool use_record_file_;
+
+    /// @brief Names of the ANNIEEvent keys to load from column files (all if empty)
+    std::vector<std::string> columns_to_load_;
+
+    /// @brief Reader for the current column file
+    ANNIEEventColumnReader column_reader_;
+
+    /// @brief Loader for each column type that can be put in the ANNIEEvent store
+    std::map<std::string, ColumnLoader> column_loaders_;
+
+    /// @brief The columns of the current file that are loaded, with their loaders
+    std::vector<std::pair<size_t, ColumnLoader> > selected_columns_;
+
+    /// @brief Reader for the current record file
+    ANNIEEventRecordReader record_reader_;
+
+    /// @brief Loader for each member type that can be read from record files
+    std::map<std::string, RecordLoader> record_loaders_;
+
     std::stringstream logmessage;
 };
@@ -98,6 +98,15 @@ bool LoadGeometry::Initialise(std::string configfile, DataModel &data){
   m_data->CStore.Set("AuxCrateSpaceToChannelNumMap",AuxCrateSpaceToChannelNumMap);
   m_data->CStore.Set("AuxChannelNumToTypeMap",AuxChannelNumToTypeMap);
   m_data->CStore.Set("LAPPDCrateSpaceToChannelNumMap",LAPPDCrateSpaceToChannelNumMap);
+
+  //Dense electronics space lookup for the decoders and event building
+  CrateSpaceLookup = new CrateSpaceTable;
+  CrateSpaceLookup->AddCrateMap(*TankPMTCrateSpaceToChannelNumMap,CrateSpaceTable::TankPMT);
+  CrateSpaceLookup->AddCrateMap(*AuxCrateSpaceToChannelNumMap,CrateSpaceTable::Aux);
+  CrateSpaceLookup->AddCrateMap(*MRDCrateSpaceToChannelNumMap,CrateSpaceTable::MRD);
+  CrateSpaceLookup->SetLoopback(7,11,15,CrateSpaceTable::BeamLoopback);     //FIXME: don't hard-code the trigger channels?
+  CrateSpaceLookup->SetLoopback(7,11,14,CrateSpaceTable::CosmicLoopback);   //FIXME: don't hard-code the trigger channels?
+  m_data->CStore.Set("CrateSpaceTable",CrateSpaceLookup,false);
    //AnnieGeometry->GetChannel(0); // trigger InitChannelMap
 
   return true;
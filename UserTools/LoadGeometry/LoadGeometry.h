@@ -6,6 +6,7 @@
 
 #include "Tool.h"
 #include "Geometry.h"
+#include "CrateSpaceTable.h"
 #include <boost/algorithm/string.hpp>
 
 class LoadGeometry: public Tool {
@@ -67,6 +68,7 @@ class LoadGeometry: public Tool {
   std::map<int,double>* ChannelNumToTankPMTSPEChargeMap;
   std::map<int,std::string>* AuxChannelNumToTypeMap;
   std::map<std::vector<unsigned int>,int>* LAPPDCrateSpaceToChannelNumMap;
+  CrateSpaceTable* CrateSpaceLookup;  //The Tank PMT, Aux and MRD maps above in one dense table
 
   //Vector of strings indicating variables of interest and their data types in
   //The MRD file.  Used in the LoadFACCMRDDetectors() method
@@ -11,12 +11,14 @@ bool LoadRawData::Initialise(std::string configfile, DataModel &data){
 
   verbosity = 0;
   DummyRunInfo = false;
+  PrefetchEntries = 0;
 
   m_variables.Get("verbosity",verbosity);
   m_variables.Get("BuildType",BuildType);
   m_variables.Get("Mode",Mode);
   m_variables.Get("InputFile",InputFile);
   m_variables.Get("DummyRunInfo",DummyRunInfo);
+  m_variables.Get("PrefetchEntries",PrefetchEntries);
 
   m_data= &data; //assigning transient data pointer
   
@@ -43,6 +45,15 @@ bool LoadRawData::Initialise(std::string configfile, DataModel &data){
   FileCompleted = false;
   TankEntriesCompleted = false;
   MRDEntriesCompleted = false;
+
+  //Files in SingleFile and FileList modes are known up front, so they can be read ahead
+  if(PrefetchEntries > 0 && (Mode == "SingleFile" || Mode == "FileList")){
+    if(Mode == "SingleFile") PrefetchFileList.push_back(InputFile);
+    else PrefetchFileList = OrganizedFileList;
+    UsePrefetch = true;
+    PrefetchThread = std::thread(&LoadRawData::PrefetchLoop, this);
+    Log("LoadRawData tool: Prefetching up to "+to_string(PrefetchEntries)+" entries per data stream",v_message,verbosity);
+  }
   return true;
 }
 
@@ -67,9 +78,13 @@ bool LoadRawData::Execute(){
       return true;
     } else if (TankEntryNum==0 && MRDEntryNum == 0){
       Log("LoadRawData Tool: Loading Raw Data file as BoostStore",v_message,verbosity); 
-      RawData->Initialise(InputFile.c_str());
-      if(verbosity>4) RawData->Print(false);
-      this->LoadPMTMRDData();
+      if(UsePrefetch){
+        if(!this->LoadPrefetchedFileInfo()) return false;
+      } else {
+        RawData->Initialise(InputFile.c_str());
+        if(verbosity>4) RawData->Print(false);
+        this->LoadPMTMRDData();
+      }
     } else {
       Log("LoadRawData Tool: Continuing Raw Data file processing",v_message,verbosity); 
     }
@@ -85,9 +100,13 @@ bool LoadRawData::Execute(){
       if(verbosity>v_warning) std::cout << "LoadRawData tool: Next file to load: "+OrganizedFileList.at(FileNum) << std::endl;
       CurrentFile = OrganizedFileList.at(FileNum);
       Log("LoadRawData Tool: LoadingRaw Data file as BoostStore",v_debug,verbosity); 
-      RawData->Initialise(CurrentFile.c_str());
-      if(verbosity>4) RawData->Print(false);
-      this->LoadPMTMRDData();
+      if(UsePrefetch){
+        if(!this->LoadPrefetchedFileInfo()) return false;
+      } else {
+        RawData->Initialise(CurrentFile.c_str());
+        if(verbosity>4) RawData->Print(false);
+        this->LoadPMTMRDData();
+      }
     } else {
      if(verbosity>v_message) std::cout << "LoadRawDataTool: continuing file " << OrganizedFileList.at(FileNum) << std::endl;
     }
@@ -127,9 +146,13 @@ bool LoadRawData::Execute(){
     std::cout << "LoadRawData Tool: Current progress in file processing: MRDEntryNum = "<< MRDEntryNum <<", fraction = "<<((double)MRDEntryNum/(double)mrdtotalentries)*100 << std::endl;
     if(!TankPaused && !TankEntriesCompleted){
       Log("LoadRawData Tool: Procesing PMTData Entry "+to_string(TankEntryNum),v_debug, verbosity);
-      PMTData->GetEntry(TankEntryNum);
-      Log("LoadRawData Tool: Getting the PMT card data entry",v_debug, verbosity);
-      PMTData->Get("CardData",*Cdata);
+      if(UsePrefetch){
+        if(!this->TakePrefetchedTankEntry()) return false;
+      } else {
+        PMTData->GetEntry(TankEntryNum);
+        Log("LoadRawData Tool: Getting the PMT card data entry",v_debug, verbosity);
+        PMTData->Get("CardData",*Cdata);
+      }
       Log("LoadRawData Tool: Setting PMT card data entry into CStore",v_debug, verbosity);
       m_data->CStore.Set("CardData",Cdata);
       Log("LoadRawData Tool: Setting Tank Entry Num CStore",v_debug, verbosity);
@@ -142,8 +165,12 @@ bool LoadRawData::Execute(){
   if(BuildType == "MRD" || BuildType == "TankAndMRD"){
     if(!MRDPaused && !MRDEntriesCompleted){
       Log("LoadRawData Tool: Procesing CCData Entry "+to_string(MRDEntryNum),v_debug, verbosity);
-      MRDData->GetEntry(MRDEntryNum);
-      MRDData->Get("Data",*Mdata);
+      if(UsePrefetch){
+        if(!this->TakePrefetchedMRDEntry()) return false;
+      } else {
+        MRDData->GetEntry(MRDEntryNum);
+        MRDData->Get("Data",*Mdata);
+      }
       m_data->CStore.Set("MRDData",Mdata,true);
       MRDEntryNum+=1;
     }
@@ -157,6 +184,8 @@ bool LoadRawData::Execute(){
     Postgress.Set("SubRunNumber",-1);
     Postgress.Set("RunType",-1);
     Postgress.Set("StarTime",-1);
+  } else if(UsePrefetch){
+    Postgress = FilePostgress;
   } else{
     BoostStore RunInfo(false,0);
     RawData->Get("RunInformation",RunInfo);
@@ -167,6 +196,16 @@ bool LoadRawData::Execute(){
 
   m_data->CStore.Set("RunInfoPostgress",Postgress);
 
+  //Read-ahead diagnostics: empty queues and a growing stall time mean reading is the
+  //bottleneck; full queues and a growing reader wait time mean decoding is
+  if(UsePrefetch){
+    std::lock_guard<std::mutex> lock(PrefetchMutex);
+    m_data->CStore.Set("PrefetchTankQueueDepth",(int)TankQueue.size());
+    m_data->CStore.Set("PrefetchMRDQueueDepth",(int)MRDQueue.size());
+    m_data->CStore.Set("PrefetchStallTime",PrefetchStallTime);
+    m_data->CStore.Set("PrefetchReaderWaitTime",PrefetchReaderWaitTime);
+  }
+
   if(TankEntryNum == tanktotalentries){
     Log("LoadRawData Tool: ALL PMT ENTRIES COLLECTED.",v_debug, verbosity);
     TankEntriesCompleted = true;
@@ -192,6 +231,9 @@ bool LoadRawData::Execute(){
 
 
 bool LoadRawData::Finalise(){
+  this->StopPrefetchThread();
+  if(UsePrefetch) Log("LoadRawData Tool: Waited "+to_string(PrefetchStallTime)+" s for prefetched data, prefetch thread waited "+
+      to_string(PrefetchReaderWaitTime)+" s for queue space",v_message,verbosity);
   RawData->Close();
   RawData->Delete();
   delete RawData;
@@ -227,6 +269,155 @@ void LoadRawData::LoadPMTMRDData(){
   return;
 }
 
+void LoadRawData::PrefetchLoop(){
+  //Runs on the prefetch thread.  It owns its own BoostStores and never touches the
+  //CStore; everything it reads is handed over through the queues under PrefetchMutex.
+  bool ReadTank = (BuildType == "Tank" || BuildType == "TankAndMRD");
+  bool ReadMRD = (BuildType == "MRD" || BuildType == "TankAndMRD");
+  for (int FileIndex=0; FileIndex<(int)PrefetchFileList.size(); FileIndex++){
+    BoostStore FileData(false,0);
+    BoostStore FilePMTData(false,2);
+    BoostStore FileMRDData(false,2);
+    PrefetchedFileInfo Info;
+    FileData.Initialise(PrefetchFileList.at(FileIndex).c_str());
+    if(ReadTank){
+      FileData.Get("PMTData",FilePMTData);
+      FilePMTData.Header->Get("TotalEntries",Info.TankTotalEntries);
+    }
+    if(ReadMRD){
+      FileData.Get("CCData",FileMRDData);
+      FileMRDData.Header->Get("TotalEntries",Info.MRDTotalEntries);
+    }
+    if(!DummyRunInfo){
+      BoostStore RunInfo(false,0);
+      FileData.Get("RunInformation",RunInfo);
+      RunInfo.Get("Postgress",Info.Postgress);
+    }
+    int TankTotal = Info.TankTotalEntries;
+    int MRDTotal = Info.MRDTotalEntries;
+    {
+      std::lock_guard<std::mutex> lock(PrefetchMutex);
+      PrefetchedFiles.emplace(FileIndex, Info);
+    }
+    PrefetchReady.notify_all();
+
+    //Entries go onto the queues in file order, so the next file is only started once
+    //both data streams of this one have been read.
+    int TankEntry = 0;
+    int MRDEntry = 0;
+    while((ReadTank && TankEntry<TankTotal) || (ReadMRD && MRDEntry<MRDTotal)){
+      bool DoTank = false;
+      bool DoMRD = false;
+      {
+        std::unique_lock<std::mutex> lock(PrefetchMutex);
+        std::chrono::steady_clock::time_point WaitStart = std::chrono::steady_clock::now();
+        PrefetchSpace.wait(lock, [&]{
+          return StopPrefetch ||
+              (ReadTank && TankEntry<TankTotal && (int)TankQueue.size()<PrefetchEntries) ||
+              (ReadMRD && MRDEntry<MRDTotal && (int)MRDQueue.size()<PrefetchEntries); });
+        PrefetchReaderWaitTime += std::chrono::duration<double>(std::chrono::steady_clock::now()-WaitStart).count();
+        if(StopPrefetch) return;
+        DoTank = ReadTank && TankEntry<TankTotal && (int)TankQueue.size()<PrefetchEntries;
+        DoMRD = ReadMRD && MRDEntry<MRDTotal && (int)MRDQueue.size()<PrefetchEntries;
+      }
+      if(DoTank){
+        PrefetchedTankEntry Entry;
+        Entry.FileIndex = FileIndex;
+        FilePMTData.GetEntry(TankEntry);
+        FilePMTData.Get("CardData",Entry.Cdata);
+        TankEntry+=1;
+        {
+          std::lock_guard<std::mutex> lock(PrefetchMutex);
+          TankQueue.push_back(std::move(Entry));
+        }
+        PrefetchReady.notify_all();
+      }
+      if(DoMRD){
+        PrefetchedMRDEntry Entry;
+        Entry.FileIndex = FileIndex;
+        FileMRDData.GetEntry(MRDEntry);
+        FileMRDData.Get("Data",Entry.Mdata);
+        MRDEntry+=1;
+        {
+          std::lock_guard<std::mutex> lock(PrefetchMutex);
+          MRDQueue.push_back(std::move(Entry));
+        }
+        PrefetchReady.notify_all();
+      }
+    }
+    FileMRDData.Close(); FileMRDData.Delete();
+    FilePMTData.Close(); FilePMTData.Delete();
+    FileData.Close(); FileData.Delete();
+  }
+  {
+    std::lock_guard<std::mutex> lock(PrefetchMutex);
+    PrefetchFinished = true;
+  }
+  PrefetchReady.notify_all();
+  return;
+}
+
+bool LoadRawData::LoadPrefetchedFileInfo(){
+  std::unique_lock<std::mutex> lock(PrefetchMutex);
+  std::chrono::steady_clock::time_point WaitStart = std::chrono::steady_clock::now();
+  PrefetchReady.wait(lock, [this]{ return PrefetchedFiles.count(FileNum) || PrefetchFinished; });
+  PrefetchStallTime += std::chrono::duration<double>(std::chrono::steady_clock::now()-WaitStart).count();
+  std::map<int, PrefetchedFileInfo>::iterator it = PrefetchedFiles.find(FileNum);
+  if(it == PrefetchedFiles.end()){
+    Log("LoadRawData Tool: ERROR prefetch thread finished without opening file "+to_string(FileNum),v_error,verbosity);
+    return false;
+  }
+  tanktotalentries = it->second.TankTotalEntries;
+  mrdtotalentries = it->second.MRDTotalEntries;
+  FilePostgress = it->second.Postgress;
+  PrefetchedFiles.erase(it);
+  return true;
+}
+
+bool LoadRawData::TakePrefetchedTankEntry(){
+  std::unique_lock<std::mutex> lock(PrefetchMutex);
+  std::chrono::steady_clock::time_point WaitStart = std::chrono::steady_clock::now();
+  PrefetchReady.wait(lock, [this]{ return !TankQueue.empty() || PrefetchFinished; });
+  PrefetchStallTime += std::chrono::duration<double>(std::chrono::steady_clock::now()-WaitStart).count();
+  if(TankQueue.empty() || TankQueue.front().FileIndex != FileNum){
+    Log("LoadRawData Tool: ERROR no prefetched PMTData entry "+to_string(TankEntryNum)+" for file "+to_string(FileNum),v_error,verbosity);
+    return false;
+  }
+  //Swapping hands the entry over without copying the CardData
+  Cdata->swap(TankQueue.front().Cdata);
+  TankQueue.pop_front();
+  lock.unlock();
+  PrefetchSpace.notify_one();
+  return true;
+}
+
+bool LoadRawData::TakePrefetchedMRDEntry(){
+  std::unique_lock<std::mutex> lock(PrefetchMutex);
+  std::chrono::steady_clock::time_point WaitStart = std::chrono::steady_clock::now();
+  PrefetchReady.wait(lock, [this]{ return !MRDQueue.empty() || PrefetchFinished; });
+  PrefetchStallTime += std::chrono::duration<double>(std::chrono::steady_clock::now()-WaitStart).count();
+  if(MRDQueue.empty() || MRDQueue.front().FileIndex != FileNum){
+    Log("LoadRawData Tool: ERROR no prefetched CCData entry "+to_string(MRDEntryNum)+" for file "+to_string(FileNum),v_error,verbosity);
+    return false;
+  }
+  *Mdata = std::move(MRDQueue.front().Mdata);
+  MRDQueue.pop_front();
+  lock.unlock();
+  PrefetchSpace.notify_one();
+  return true;
+}
+
+void LoadRawData::StopPrefetchThread(){
+  if(!PrefetchThread.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lock(PrefetchMutex);
+    StopPrefetch = true;
+  }
+  PrefetchSpace.notify_all();
+  PrefetchThread.join();
+  return;
+}
+
 std::vector<std::string> LoadRawData::OrganizeRunParts(std::string FileList)
 {
   std::vector<std::string> OrganizedFiles;
@@ -3,6 +3,12 @@
 
 #include <string>
 #include <iostream>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #include "Tool.h"
 #include "CardData.h"
@@ -10,6 +16,22 @@
 #include "BoostStore.h"
 #include "Store.h"
 
+//A PMTData or CCData entry read ahead by the prefetch thread
+struct PrefetchedTankEntry{
+  int FileIndex;  //Index of the entry's file in the prefetch file list
+  std::vector<CardData> Cdata;
+};
+struct PrefetchedMRDEntry{
+  int FileIndex;
+  MRDOut Mdata;
+};
+//Header information of a raw data file opened by the prefetch thread
+struct PrefetchedFileInfo{
+  int TankTotalEntries = 0;
+  int MRDTotalEntries = 0;
+  Store Postgress;
+};
+
 /**
  * \class LoadRawData
  *
@@ -41,6 +63,30 @@ class LoadRawData: public Tool {
   std::string InputFile;
   std::vector<std::string> OrganizeRunParts(std::string InputFile); //Parses all run files in InputFile and returns a vector of file paths organized by part
 
+  //Read-ahead of raw data files.  In SingleFile and FileList modes, a background
+  //thread opens the files in order and deserialises up to PrefetchEntries entries
+  //of each data stream ahead of Execute.  Execute only takes entries off the queues.
+  int PrefetchEntries;  //Queue depth per data stream; 0 reads entries in Execute
+  bool UsePrefetch = false;
+  std::vector<std::string> PrefetchFileList;
+  std::thread PrefetchThread;
+  std::mutex PrefetchMutex;
+  std::condition_variable PrefetchReady;  //Signalled when the prefetch thread has read an entry or file header
+  std::condition_variable PrefetchSpace;  //Signalled when Execute takes an entry off a queue
+  std::deque<PrefetchedTankEntry> TankQueue;
+  std::deque<PrefetchedMRDEntry> MRDQueue;
+  std::map<int, PrefetchedFileInfo> PrefetchedFiles;  //Key: index in PrefetchFileList
+  bool StopPrefetch = false;
+  bool PrefetchFinished = false;
+  Store FilePostgress;  //Run information of the current file, read by the prefetch thread
+  double PrefetchStallTime = 0;  //Seconds Execute has waited for the prefetch thread
+  double PrefetchReaderWaitTime = 0;  //Seconds the prefetch thread has waited for queue space
+  void PrefetchLoop();
+  bool LoadPrefetchedFileInfo();  //Waits for the header of file FileNum and takes the entry counts and run info from it
+  bool TakePrefetchedTankEntry();  //Waits for the next PMTData entry and swaps it into Cdata
+  bool TakePrefetchedMRDEntry();  //Waits for the next CCData entry and moves it into Mdata
+  void StopPrefetchThread();
+
 
   int FileNum = 0;
   int tanktotalentries;
@@ -16,10 +16,19 @@ bool MRDDataDecoder::Initialise(std::string configfile, DataModel &data){
 
   m_variables.Get("verbosity",verbosity);
 
-  m_data->CStore.Get("MRDCrateSpaceToChannelNumMap",MRDCrateSpaceToChannelNumMap);
+  bool got_table = m_data->CStore.Get("CrateSpaceTable",CrateSpace);
+  if(!got_table || CrateSpace==nullptr){
+    Log("MRDDataDecoder Tool: Error! No CrateSpaceTable in the CStore. Is LoadGeometry run first?",v_error,verbosity);
+    return false;
+  }
   m_data->CStore.Set("NewMRDDataAvailable",false);
 
   m_data->CStore.Set("PauseMRDDecoding",false);
+
+  //Decoded triggers are added to MRDEvents, which the ANNIEEventBuilder reads
+  //through the CStore pointer and erases entries from once they are built
+  MRDEvents = new MRDEventMap;
+  m_data->CStore.Set("MRDEvents",MRDEvents,false);
   Log("MRDDataDecoder Tool: Initialized successfully",v_message,verbosity);
   return true;
 }
@@ -47,78 +56,43 @@ bool MRDDataDecoder::Execute(){
   /////////////////// getting MRD Data ////////////////////
   Log("MRDDataDecoder Tool: Accessing MRDData from CStore",v_message,verbosity); 
   m_data->CStore.Get("MRDData",mrddata);
-  std::string mrdTriggertype = "No Loopback";
-  std::vector<unsigned long> chankeys;
   unsigned long timestamp = mrddata->TimeStamp;    //in ms since 1970/1/1
-  std::vector<std::pair<unsigned long, int>> ChankeyTimePairs;
-  MRDEvents.emplace(timestamp,ChankeyTimePairs);
+  MRDTriggerRecord MRDEvent;
+  MRDEvent.Hits.reserve(mrddata->Hits.size());
   
   bool cosmic_loopback = false;
   bool beam_loopback = false;
-  int cosmic_tdc = -1;
-  int beam_tdc = -1;
-  std::vector<int> CrateSlotChannel_Beam{7,11,15};
-  std::vector<int> CrateSlotChannel_Cosmic{7,11,14};
     
   //For each entry, loop over all crates and get data
-  for (unsigned int i_data = 0; i_data < mrddata->Crate.size(); i_data++){
-    int crate = mrddata->Crate.at(i_data);
-    int slot = mrddata->Slot.at(i_data);
-    int channel = mrddata->Channel.at(i_data);
-    int hittimevalue = mrddata->Value.at(i_data);
-    std::vector<int> CrateSlotChannel{crate,slot,channel};
-    unsigned long chankey = MRDCrateSpaceToChannelNumMap[CrateSlotChannel];
-    if (CrateSlotChannel != CrateSlotChannel_Beam && CrateSlotChannel != CrateSlotChannel_Cosmic){
-      std::pair <unsigned long,int> keytimepair(chankey,hittimevalue);  //chankey will be 0 when looking at loopback channels that don't have an entry in the mapping-->skip
-      MRDEvents[timestamp].push_back(keytimepair);
+  for (const MRDHit& hit : mrddata->Hits){
+    int crate = hit.Crate();
+    int slot = hit.Slot();
+    int channel = hit.Channel();
+    int hittimevalue = hit.Value();
+    const CrateSpaceTable::Entry& entry = CrateSpace->Get(crate,slot,channel);
+    if (entry.Role == CrateSpaceTable::CosmicLoopback) {cosmic_loopback=true; MRDEvent.CosmicLoopbackTDC = hittimevalue;}
+    else if (entry.Role == CrateSpaceTable::BeamLoopback) {beam_loopback=true; MRDEvent.BeamLoopbackTDC = hittimevalue;}
+    else {
+      //chankey will be 0 for channels that don't have an entry in the MRD mapping
+      unsigned long chankey = (entry.Type == CrateSpaceTable::MRD) ? entry.ChannelKey : 0;
+      MRDEvent.Hits.emplace_back(chankey,hittimevalue);
     }
-    if (crate == 7 && slot == 11 && channel == 14) {cosmic_loopback=true; cosmic_tdc = hittimevalue;}   //FIXME: don't hard-code the trigger channels?
-    if (crate == 7 && slot == 11 && channel == 15) {beam_loopback=true; beam_tdc = hittimevalue;}     //FIXME: don't hard-code the trigger channels?
   }
   
-  if (beam_loopback) mrdTriggertype = "Beam";
-  if (cosmic_loopback) mrdTriggertype = "Cosmic";      //prefer cosmic loopback over beam loopback (cosmic event will always also have a beam loopback entry)
-
-  CosmicLoopbackMap.emplace(timestamp,cosmic_tdc);
-  BeamLoopbackMap.emplace(timestamp,beam_tdc);
-
-  //Entry processing done.  Label the trigger type and increment index
-  TriggerTypeMap.emplace(timestamp,mrdTriggertype);
-
-  //MRD Data file fully processed.   
-  //Push the map of TriggerTypeMap and FinishedMRDHits 
-  //to the CStore for ANNIEEvent to start Building ANNIEEvents. 
-  Log("MRDDataDecoder Tool: Saving Finished MRD Data into CStore.",v_debug, verbosity);
-  //FIXME: add a check for if there is or is not an entry in the CStore
-  m_data->CStore.Get("MRDEvents",CStoreMRDEvents);
-  CStoreMRDEvents.insert(MRDEvents.begin(),MRDEvents.end());
-  m_data->CStore.Set("MRDEvents",CStoreMRDEvents);
-
-  m_data->CStore.Get("MRDEventTriggerTypes",CStoreTriggerTypeMap);
-  CStoreTriggerTypeMap.insert(TriggerTypeMap.begin(),TriggerTypeMap.end());
-  m_data->CStore.Set("MRDEventTriggerTypes",CStoreTriggerTypeMap);
- 
-  m_data->CStore.Get("MRDBeamLoopback",CStoreBeamLoopbackMap);
-  CStoreBeamLoopbackMap.insert(BeamLoopbackMap.begin(),BeamLoopbackMap.end());
-  m_data->CStore.Set("MRDBeamLoopback",CStoreBeamLoopbackMap);
- 
-  m_data->CStore.Get("MRDCosmicLoopback",CStoreCosmicLoopbackMap);
-  CStoreCosmicLoopbackMap.insert(CosmicLoopbackMap.begin(),CosmicLoopbackMap.end());
-  m_data->CStore.Set("MRDCosmicLoopback",CStoreCosmicLoopbackMap);
+  if (beam_loopback) MRDEvent.TriggerType = "Beam";
+  if (cosmic_loopback) MRDEvent.TriggerType = "Cosmic";      //prefer cosmic loopback over beam loopback (cosmic event will always also have a beam loopback entry)
+
+  //Entry processing done.  Add the trigger to the MRDEvents for the
+  //ANNIEEvent to start Building ANNIEEvents.  A timestamp already
+  //waiting to be built keeps its first trigger.
+  Log("MRDDataDecoder Tool: Adding Finished MRD Data to MRDEvents.",v_debug, verbosity);
+  MRDEvents->emplace(timestamp,std::move(MRDEvent));
   
   m_data->CStore.Set("NewMRDDataAvailable",true);
 
-  //Check the size of the WaveBank to see if things are bloating
-  Log("MRDDataDecoder Tool: Size of MRDEvents in CStore (# MRD Triggers processed):" + 
-          to_string(CStoreMRDEvents.size()),v_debug, verbosity);
-  Log("MRDDataDecoder Tool: Size of TriggerTypeMap in CStore:" + 
-          to_string(CStoreTriggerTypeMap.size()),v_debug, verbosity);
-
-  std::cout << "MRD EVENT CSTORE ENTRIES SET SUCCESSFULLY.  Clearing MRDEvents map from this file." << std::endl;
-  MRDEvents.clear();
-  TriggerTypeMap.clear();
-  BeamLoopbackMap.clear();
-  CosmicLoopbackMap.clear();
+  //Check the size of MRDEvents to see if things are bloating
+  Log("MRDDataDecoder Tool: Size of MRDEvents (# MRD Triggers waiting to be built):" + 
+          to_string(MRDEvents->size()),v_debug, verbosity);
 
   ////////////// END EXECUTE LOOP ///////////////
   return true;
@@ -126,6 +100,8 @@ bool MRDDataDecoder::Execute(){
 
 
 bool MRDDataDecoder::Finalise(){
+  m_data->CStore.Remove("MRDEvents");  //the CStore owns MRDEvents and deletes it here
+  MRDEvents = nullptr;
   Log("MRDDataDecoder tool exitting",v_message,verbosity);
   return true;
 }
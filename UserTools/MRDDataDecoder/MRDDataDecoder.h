@@ -11,6 +11,7 @@
 #include "TriggerData.h"
 #include "BoostStore.h"
 #include "Store.h"
+#include "CrateSpaceTable.h"
 
 /**
  * \class MRDDataDecoder
@@ -38,18 +39,13 @@ class MRDDataDecoder: public Tool {
  private:
 
   MRDOut* mrddata=nullptr;
-  //Map used to relate MRD Crate Space value to channel key
-  std::map<std::vector<int>,int> MRDCrateSpaceToChannelNumMap;
+  //Electronics space lookup built by LoadGeometry; relates MRD Crate Space
+  //values to channel keys and marks the trigger loopback channels
+  CrateSpaceTable* CrateSpace = nullptr;
 
-  //Maps that store completed waveforms from cards
-  std::map<uint64_t, std::vector<std::pair<unsigned long, int> > > MRDEvents;  //Key: {MTCTime}, value: "WaveMap" with key (CardID,ChannelID), value FinishedWaveform
-  std::map<uint64_t, std::vector<std::pair<unsigned long, int> > > CStoreMRDEvents;  //Key: {MTCTime}, value: "WaveMap" with key (CardID,ChannelID), value FinishedWaveform
-  std::map<uint64_t, int> BeamLoopbackMap;  //KEY: {MTCTime}, value: Beam loopback TDC value
-  std::map<uint64_t, int> CosmicLoopbackMap;  //KEY: {MTCTime}, value: Cosmic loopback TDC value
-  std::map<uint64_t, int> CStoreBeamLoopbackMap;  //KEY: {MTCTime}, value: Beam loopback TDC value
-  std::map<uint64_t, int> CStoreCosmicLoopbackMap;  //KEY: {MTCTime}, value: Cosmic loopback TDC value
-  std::map<uint64_t, std::string>  TriggerTypeMap;  //Key: {MTCTime}, value: string noting what type of trigger occured for the event 
-  std::map<uint64_t, std::string>  CStoreTriggerTypeMap;  //Key: {MTCTime}, value: string noting what type of trigger occured for the event 
+  //Decoded MRD triggers waiting to be built. Allocated by this tool, then owned
+  //by the CStore ("MRDEvents"), which shares it with the ANNIEEventBuilder
+  MRDEventMap* MRDEvents = nullptr;
 
   // Notes whether DAQ is in lock step running
   // Number of PMTs that must be found in a WaveSet to build the event
@@ -23,15 +23,15 @@ bool MRDPulseFinder::Initialise(std::string configfile, DataModel &data){
 
 bool MRDPulseFinder::Execute(){
 
-  m_data->Stores["ANNIEEvent"]->Get("RawADCData", rawadcdata);
+  rawadcdata = ANNIEEventMember::Get<std::map<unsigned long, std::vector<Waveform<unsigned short>>>>(m_data->Stores["ANNIEEvent"], "RawADCData");
   m_data->Stores["ANNIEEvent"]->Get("EventNumber", evnum);
-  m_data->Stores["ANNIEEvent"]->Get("CalibratedADCData", caladc);
+  caladc = ANNIEEventMember::Get<std::map<unsigned long, std::vector<CalibratedADCWaveform<double>>>>(m_data->Stores["ANNIEEvent"], "CalibratedADCData");
 
   map<int,map<int,std::vector<ADCPulse>>> MiniBufferPulses;
 
-  map<unsigned long,std::vector<Waveform<unsigned short>>> :: iterator itr;
+  map<unsigned long,std::vector<Waveform<unsigned short>>> :: const_iterator itr;
   //map<unsigned long,std::vector<CalibratedADCWaveform<double>>> :: iterator itrr;
-  int vectsize = rawadcdata.begin()->second.size();
+  int vectsize = (rawadcdata && !rawadcdata->empty()) ? rawadcdata->begin()->second.size() : 0;
 
   for(int aaa=0; aaa<vectsize; aaa++){
 
@@ -39,10 +39,10 @@ bool MRDPulseFinder::Execute(){
     map<int,std::vector<ADCPulse>> ChannelPulses;
     channelno = 0;
     //for(itr=rawadcdata.begin(),itrr=caladc.begin(); itr!=rawadcdata.end(),itrr!=caladc.end(); ++itr,++itrr){
-    for(itr=rawadcdata.begin(); itr!=rawadcdata.end(); ++itr){
+    for(itr=rawadcdata->begin(); itr!=rawadcdata->end(); ++itr){
 
       unsigned long ck = itr->first;
-      std::vector<Waveform<unsigned short>> TheWaveforms = itr->second;
+      const std::vector<Waveform<unsigned short>>& TheWaveforms = itr->second;
       //unsigned long ckey = itrr->first;
       //std::vector<CalibratedADCWaveform<double>> somecalwavs = itrr->second;
       //CalibratedADCWaveform<double> onecalwav = somecalwavs.at(aaa);
@@ -8,6 +8,7 @@
 #include "Waveform.h"
 #include "ADCPulse.h"
 #include "CalibratedADCWaveform.h"
+#include "ANNIEEventMember.h"
 
 class MRDPulseFinder: public Tool {
 
@@ -30,8 +31,8 @@ class MRDPulseFinder: public Tool {
    double sigbline;
    int channelno;
    int minibuffernum;
-   std::map<unsigned long, std::vector<Waveform<unsigned short>>> rawadcdata;
-   std::map<unsigned long, std::vector<CalibratedADCWaveform<double>>> caladc;
+   const std::map<unsigned long, std::vector<Waveform<unsigned short>>>* rawadcdata = nullptr;  // Owned by the ANNIEEvent store
+   const std::map<unsigned long, std::vector<CalibratedADCWaveform<double>>>* caladc = nullptr;
 
 
 };
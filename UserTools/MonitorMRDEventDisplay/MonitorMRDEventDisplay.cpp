@@ -164,24 +164,11 @@ bool MonitorMRDEventDisplay::Execute(){
 
     OutN = MRDout.OutN;
     Trigger = MRDout.Trigger;
-    Value = MRDout.Value;
-    Slot = MRDout.Slot;
-    Channel = MRDout.Channel;
-    Crate = MRDout.Crate;
     TimeStamp = MRDout.TimeStamp;
 
     MonitorMRDEventDisplay::PlotMRDEvent();
 
-    Value.clear();
-    Slot.clear();
-    Channel.clear();
-    Crate.clear();
-
-    MRDout.Value.clear();
-    MRDout.Slot.clear();
-    MRDout.Channel.clear();
-    MRDout.Crate.clear();
-    MRDout.Type.clear();
+    MRDout.Hits.clear();
     evnum++;
 
   } else if (State == "DataFile" || State == "Wait"){
@@ -246,12 +233,12 @@ void MonitorMRDEventDisplay::PlotMRDEvent(){
   //fill the Event Display
 
   if (verbosity > 1)  std::cout <<"MonitorMRDEventDisplay: Filling MRD EventDisplay"<<std::endl;
-  for (unsigned int i_data = 0; i_data < Value.size(); i_data++){
+  for (const MRDHit& hit : MRDout.Hits){
   
-    int crate_id = Crate.at(i_data);
-    int slot_id = Slot.at(i_data);
-    int channel_id = Channel.at(i_data);
-    int tdc_value = Value.at(i_data);
+    int crate_id = hit.Crate();
+    int slot_id = hit.Slot();
+    int channel_id = hit.Channel();
+    int tdc_value = hit.Value();
 
     if (tdc_value > max_tdc) max_tdc = tdc_value;
     if (tdc_value < min_tdc) min_tdc = tdc_value;
@@ -59,8 +59,6 @@ class MonitorMRDEventDisplay: public Tool {
 
 		//MRD store includes the following variables
 		unsigned int OutN, Trigger;
-		std::vector<unsigned int> Value, Slot, Channel, Crate;
-		std::vector<std::string> Type;
 		ULong64_t TimeStamp;
 		long current_stamp;
 
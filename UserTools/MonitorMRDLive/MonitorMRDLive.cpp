@@ -493,45 +493,45 @@ bool MonitorMRDLive::Execute(){
 
     OutN = MRDout.OutN;
     Trigger = MRDout.Trigger;
-    Value = MRDout.Value;
-    Slot = MRDout.Slot;
-    Channel = MRDout.Channel;
-    Crate = MRDout.Crate;
     TimeStamp = MRDout.TimeStamp;
 
     if (verbosity > 2){
       std::cout <<"OutN: "<<OutN<<std::endl;
       std::cout <<"Trigger: "<<Trigger<<std::endl;
-      std::cout <<"MRD data size: "<<Value.size()<<std::endl;
+      std::cout <<"MRD data size: "<<MRDout.Hits.size()<<std::endl;
       std::cout <<"TimeStamp: "<<TimeStamp<<std::endl;
     }
 
     std::string trigger_type = "no loopback";
     if (verbosity > 2) std::cout <<"MonitorMRDLive: Read in Data: >>>>>>>>>>>>>>>>>>> "<<std::endl;
-    for (unsigned int i_entry = 0; i_entry < Channel.size(); i_entry++){
-      if (verbosity > 2) std::cout <<"Crate "<<Crate.at(i_entry)<<", Slot "<<Slot.at(i_entry)<<", Channel "<<Channel.at(i_entry)<<std::endl;
-      std::vector<int>::iterator it = std::find(nr_slot.begin(), nr_slot.end(), (Slot.at(i_entry))+(Crate.at(i_entry)-min_crate)*100);
+    for (const MRDHit& hit : MRDout.Hits){
+      unsigned int crate = hit.Crate();
+      unsigned int slot = hit.Slot();
+      unsigned int channel = hit.Channel();
+      unsigned int value = hit.Value();
+      if (verbosity > 2) std::cout <<"Crate "<<crate<<", Slot "<<slot<<", Channel "<<channel<<std::endl;
+      std::vector<int>::iterator it = std::find(nr_slot.begin(), nr_slot.end(), slot+(crate-min_crate)*100);
       if (it == nr_slot.end()){
         std::cout <<"ERROR (MonitorMRDLive): Read-out Crate/Slot/Channel number not active according to configuration file. Check the configfile to process the data..."<<std::endl;
-        std::cout <<"Crate: "<<Crate.at(i_entry)<<", Slot: "<<Slot.at(i_entry)<<std::endl;
+        std::cout <<"Crate: "<<crate<<", Slot: "<<slot<<std::endl;
         continue;
       }
       int active_slot_nr = std::distance(nr_slot.begin(),it);
-      int ch = active_slot_nr*num_channels+Channel.at(i_entry);
-      if (verbosity > 2) std::cout <<", ch nr: "<<ch<<", TDC: "<<Value.at(i_entry)<<", timestamp: "<<TimeStamp<<std::endl;
-      live_tdc.at(ch).push_back(Value.at(i_entry));
+      int ch = active_slot_nr*num_channels+channel;
+      if (verbosity > 2) std::cout <<", ch nr: "<<ch<<", TDC: "<<value<<", timestamp: "<<TimeStamp<<std::endl;
+      live_tdc.at(ch).push_back(value);
       live_timestamp.at(ch).push_back(TimeStamp);
-      live_tdc_hour.at(ch).push_back(Value.at(i_entry));
+      live_tdc_hour.at(ch).push_back(value);
       live_timestamp_hour.at(ch).push_back(TimeStamp);
       for (unsigned int i_loopback=0; i_loopback< loopback_crate.size(); i_loopback++){
-        if (Crate.at(i_entry) == loopback_crate.at(i_loopback) && Slot.at(i_entry) == loopback_slot.at(i_loopback) && Channel.at(i_entry) == loopback_channel.at(i_loopback)) trigger_type = loopback_name.at(i_loopback);
+        if (crate == loopback_crate.at(i_loopback) && slot == loopback_slot.at(i_loopback) && channel == loopback_channel.at(i_loopback)) trigger_type = loopback_name.at(i_loopback);
       }
     }
 
     vector_timestamp.push_back(TimeStamp);
     vector_timestamp_hour.push_back(TimeStamp);
-    vector_nchannels.push_back(Channel.size());
-    vector_nchannels_hour.push_back(Channel.size());
+    vector_nchannels.push_back(MRDout.Hits.size());
+    vector_nchannels_hour.push_back(MRDout.Hits.size());
     vector_triggertype.push_back(trigger_type);
     current_stamp = TimeStamp;
 
@@ -544,16 +544,7 @@ bool MonitorMRDLive::Execute(){
     MonitorMRDLive::MRDTDCPlots();
 
     //clean up
-    Value.clear();
-    Slot.clear();
-    Channel.clear();
-    Crate.clear();
-    Type.clear();
-    MRDout.Value.clear();
-    MRDout.Slot.clear();
-    MRDout.Channel.clear();
-    MRDout.Crate.clear();
-    MRDout.Type.clear();
+    MRDout.Hits.clear();
 
     //only for debugging memory leaks, otherwise comment out
     //std::cout <<"MonitorMRDLive: List of Objects (after execute step)"<<std::endl;
@@ -657,32 +648,36 @@ void MonitorMRDLive::MRDTDCPlots(){
   double times_slots[num_crates][num_slots] = {0};
   double n_times_slots[num_crates][num_slots] = {0};
 
-  for (unsigned int i=0;i<Value.size();i++){
-
-    hTimes->Fill(Value.at(i));
-    times_slots[Crate.at(i)-min_crate][Slot.at(i)-1] += Value.at(i);    //slot numbers start at 1
-    n_times_slots[Crate.at(i)-min_crate][Slot.at(i)-1]++;
-    if (Value.at(i) > max_ch) max_ch = Value.at(i);
-    if (Value.at(i) < min_ch) min_ch = Value.at(i);
-
-    if (Crate.at(i) == min_crate) {
-      if(active_channel[0][Slot.at(i)-1]==1) {
-      std::vector<int>::iterator it = std::find(active_slots_cr1.begin(),active_slots_cr1.end(),Slot.at(i));
+  for (const MRDHit& hit : MRDout.Hits){
+    unsigned int crate = hit.Crate();
+    unsigned int slot = hit.Slot();
+    unsigned int channel = hit.Channel();
+    unsigned int value = hit.Value();
+
+    hTimes->Fill(value);
+    times_slots[crate-min_crate][slot-1] += value;    //slot numbers start at 1
+    n_times_slots[crate-min_crate][slot-1]++;
+    if (value > max_ch) max_ch = value;
+    if (value < min_ch) min_ch = value;
+
+    if (crate == min_crate) {
+      if(active_channel[0][slot-1]==1) {
+      std::vector<int>::iterator it = std::find(active_slots_cr1.begin(),active_slots_cr1.end(),slot);
       int index = std::distance(active_slots_cr1.begin(),it);
-      hChannel_cr1->SetBinContent((index)*num_channels+Channel.at(i)+1,Value.at(i));     //slot numbers start at +1?
-      h2D_cr1->SetBinContent(Slot.at(i),Channel.at(i)+1,Value.at(i));
+      hChannel_cr1->SetBinContent((index)*num_channels+channel+1,value);     //slot numbers start at +1?
+      h2D_cr1->SetBinContent(slot,channel+1,value);
       } else {
-      std::cout <<"ERROR (MonitorMRDLive): Slot # "<<Slot.at(i)<<" is not connected according to the configuration file. Abort this entry..."<<std::endl;
+      std::cout <<"ERROR (MonitorMRDLive): Slot # "<<slot<<" is not connected according to the configuration file. Abort this entry..."<<std::endl;
       continue;
       }
-    } else if (Crate.at(i) == min_crate+1) {
-      if(active_channel[1][Slot.at(i)-1]==1) {
-      std::vector<int>::iterator it = std::find(active_slots_cr2.begin(),active_slots_cr2.end(),Slot.at(i));
+    } else if (crate == min_crate+1) {
+      if(active_channel[1][slot-1]==1) {
+      std::vector<int>::iterator it = std::find(active_slots_cr2.begin(),active_slots_cr2.end(),slot);
       int index = std::distance(active_slots_cr2.begin(),it);
-      hChannel_cr2->SetBinContent(n_active_slots_cr1*num_channels+(index)*num_channels+Channel.at(i)+1,Value.at(i));
-      h2D_cr2->SetBinContent(Slot.at(i),Channel.at(i)+1,Value.at(i));
+      hChannel_cr2->SetBinContent(n_active_slots_cr1*num_channels+(index)*num_channels+channel+1,value);
+      h2D_cr2->SetBinContent(slot,channel+1,value);
       } else {
-      std::cout <<"ERROR (MonitorMRDLive): Slot # "<<Slot.at(i)<<" is not connected according to the configuration file. Abort this entry..."<<std::endl;
+      std::cout <<"ERROR (MonitorMRDLive): Slot # "<<slot<<" is not connected according to the configuration file. Abort this entry..."<<std::endl;
       continue;
       }
     } else std::cout <<"ERROR (MonitorMRDLive): The read-in crate number does not exist. Continue with next event... "<<std::endl;
@@ -76,8 +76,6 @@ class MonitorMRDLive: public Tool {
 
   //MRD store includes the following variables
   unsigned int OutN, Trigger;
-  std::vector<unsigned int> Value, Slot, Channel, Crate;
-  std::vector<std::string> Type;
   ULong64_t TimeStamp;
   long current_stamp;
 
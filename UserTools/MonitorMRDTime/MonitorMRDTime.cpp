@@ -559,44 +559,48 @@ void MonitorMRDTime::ReadInData(){
     if (verbosity > 3){
       std::cout <<"------------------------------------------------------------------------------------------------------------------------"<<std::endl;
       std::cout <<"Entry: "<<i_event<<", TimeStamp: "<<timestamp<<std::endl;
-      std::cout <<"Slot size: "<<MRDout.Slot.size()<<", Crate size: "<<MRDout.Crate.size()<<", Channel size: "<<MRDout.Channel.size()<<std::endl;
-      std::cout <<"OutN: "<<MRDout.OutN<<", Trigger: "<<MRDout.Trigger<<", Type size: "<<MRDout.Type.size()<<std::endl;
+      std::cout <<"Number of hits: "<<MRDout.Hits.size()<<std::endl;
+      std::cout <<"OutN: "<<MRDout.OutN<<", Trigger: "<<MRDout.Trigger<<std::endl;
     }
 
-    if (MRDout.Slot.size() == 0) n_zerohits++;
+    if (MRDout.Hits.size() == 0) n_zerohits++;
 
     //looping over all channels in event
     bool no_loopback = true;
     vector_nhits.assign(num_active_slots*num_channels,0.);
 
-    for (unsigned int i_entry = 0; i_entry < MRDout.Slot.size(); i_entry++){
+    for (const MRDHit& hit : MRDout.Hits){
+      unsigned int crate = hit.Crate();
+      unsigned int slot = hit.Slot();
+      unsigned int channel = hit.Channel();
+      unsigned int value = hit.Value();
 
       //print out information if needed for debugging hardware
-      if (verbosity > 3) std::cout <<"MonitorMRDTime: Channel entry: Crate "<<MRDout.Crate.at(i_entry)<<", Slot "<<MRDout.Slot.at(i_entry)<<", Channel "<<MRDout.Channel.at(i_entry)<<", TDC value: "<<MRDout.Value.at(i_entry)<<std::endl;
+      if (verbosity > 3) std::cout <<"MonitorMRDTime: Channel entry: Crate "<<crate<<", Slot "<<slot<<", Channel "<<channel<<", TDC value: "<<value<<std::endl;
 
       int active_slot_nr;
-      std::vector<int>::iterator it = std::find(nr_slot.begin(), nr_slot.end(), (MRDout.Slot.at(i_entry))+(MRDout.Crate.at(i_entry)-min_crate)*100);
+      std::vector<int>::iterator it = std::find(nr_slot.begin(), nr_slot.end(), slot+(crate-min_crate)*100);
       if (it == nr_slot.end()){
         if (verbosity > 0){
           std::cout <<"WARNING (MonitorMRDTime): Read-out Crate/Slot/Channel number not active according to configuration file. Check the configfile to process the data..."<<std::endl;
-          std::cout <<"WARNING (MonitorMRDTime): Crate: "<<MRDout.Crate.at(i_entry)<<", Slot: "<<MRDout.Slot.at(i_entry)<<std::endl;
+          std::cout <<"WARNING (MonitorMRDTime): Crate: "<<crate<<", Slot: "<<slot<<std::endl;
         }
         continue;
       }
       count++;
       active_slot_nr = std::distance(nr_slot.begin(),it);
-      std::vector<unsigned int> crate_slot_temp{MRDout.Crate.at(i_entry),MRDout.Slot.at(i_entry)};
+      std::vector<unsigned int> crate_slot_temp{crate,slot};
       int check_active_slot = CrateSlot_to_ActiveSlot[crate_slot_temp];
 
       //fill data in live vectors
-      int ch = active_slot_nr*num_channels+MRDout.Channel.at(i_entry);
-      tdc_file.at(ch).push_back(MRDout.Value.at(i_entry));
+      int ch = active_slot_nr*num_channels+channel;
+      tdc_file.at(ch).push_back(value);
       timestamp_file.at(ch).push_back(MRDout.TimeStamp);
       vector_nhits[ch]++;
-      tdc_file_times_single.push_back(MRDout.Value.at(i_entry));
+      tdc_file_times_single.push_back(value);
 
       for (unsigned int i_trigger = 0; i_trigger < loopback_name.size(); i_trigger++){
-        if (MRDout.Crate.at(i_entry) == loopback_crate.at(i_trigger) && MRDout.Slot.at(i_entry) == loopback_slot.at(i_trigger) && MRDout.Channel.at(i_entry) == loopback_channel.at(i_trigger)) no_loopback = false;
+        if (crate == loopback_crate.at(i_trigger) && slot == loopback_slot.at(i_trigger) && channel == loopback_channel.at(i_trigger)) no_loopback = false;
       }
     }
 
@@ -607,12 +611,8 @@ void MonitorMRDTime::ReadInData(){
 
     tdc_file_times.push_back(tdc_file_times_single);
 
-    //clear MRDout member vectors afterwards
-    MRDout.Value.clear();
-    MRDout.Slot.clear();
-    MRDout.Channel.clear();
-    MRDout.Crate.clear();
-    MRDout.Type.clear();
+    //clear MRDout hits afterwards
+    MRDout.Hits.clear();
   }
 
   n_normalhits = total_number_entries - n_zerohits - n_doublehits;
@@ -113,7 +113,6 @@ bool MonitorTankTime::Initialise(std::string configfile, DataModel &data){
     for (unsigned int i_channel = 0; i_channel < u_num_channels_tank; i_channel++){
       std::vector<unsigned int> crateslotch{temp_crate,temp_slot,i_channel+1};
       map_ch_to_crateslotch.emplace(num_active_slots*num_channels_tank+i_channel,crateslotch);
-      map_crateslotch_to_ch.emplace(crateslotch,num_active_slots*num_channels_tank+i_channel);
     }
     num_active_slots++;
   }
@@ -171,7 +170,6 @@ bool MonitorTankTime::Initialise(std::string configfile, DataModel &data){
   //-------------------------------------------------------
 
   m_data->Stores["ANNIEEvent"]->Header->Get("AnnieGeometry",geom);
-  m_data->CStore.Get("PMTCrateSpaceToChannelNumMap",PMTCrateSpaceToChannelNumMap);
   Position center_position = geom->GetTankCentre();
   tank_center_x = center_position.X();
   tank_center_y = center_position.Y();
@@ -812,7 +810,7 @@ void MonitorTankTime::InitializeHists(){
 
 }
 
-void MonitorTankTime::LoopThroughDecodedEvents(std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t>>> finishedPMTWaves){
+void MonitorTankTime::LoopThroughDecodedEvents(const std::map<uint64_t, TankWaveMap>& finishedPMTWaves){
 
   Log("MonitorTankTime: LoopThroughDecodedEvents",v_message,verbosity);
 
@@ -827,7 +825,7 @@ void MonitorTankTime::LoopThroughDecodedEvents(std::map<uint64_t, std::map<std::
   timestamp_file.clear();
 
   int i_timestamp = 0;
-  for (std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t>>>::iterator it = finishedPMTWaves.begin(); it != finishedPMTWaves.end(); it++){
+  for (std::map<uint64_t, TankWaveMap>::const_iterator it = finishedPMTWaves.begin(); it != finishedPMTWaves.end(); it++){
 
     uint64_t timestamp = it->first;
     uint64_t timestamp_temp = timestamp - utc_to_fermi;			//conversion from UTC time to Fermilab US time
@@ -842,12 +840,12 @@ void MonitorTankTime::LoopThroughDecodedEvents(std::map<uint64_t, std::map<std::
     channels_mean.assign(num_active_slots*num_channels_tank,0.);
     channels_sigma.assign(num_active_slots*num_channels_tank,0.);
 
-    std::map<std::vector<int>, std::vector<uint16_t>> afinishedPMTWaves = finishedPMTWaves.at(timestamp);
-    for(std::pair<std::vector<int>, std::vector<uint16_t>> apair : afinishedPMTWaves){
+    const TankWaveMap& afinishedPMTWaves = it->second;
+    for(const std::pair<const CardChannelKey, std::vector<uint16_t>>& apair : afinishedPMTWaves){
 
-      int CardID = apair.first.at(0);
-      int ChannelID = apair.first.at(1);
-      std::vector<uint16_t> awaveform = apair.second;
+      int CardID = CardChannelKeyToCardID(apair.first);
+      int ChannelID = CardChannelKeyToChannelID(apair.first);
+      const std::vector<uint16_t>& awaveform = apair.second;
       int num_samples = int(awaveform.size()) - 50;
       int CrateNum, SlotNum;
       this->CardIDToElectronicsSpace(CardID, CrateNum, SlotNum);
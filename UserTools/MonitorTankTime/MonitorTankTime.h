@@ -60,7 +60,7 @@ class MonitorTankTime: public Tool {
   //configuration and initialization functions
   void ReadInConfiguration();
   void InitializeHists(); ///< Function to initialize all histograms and canvases
-  void LoopThroughDecodedEvents(std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t>>> finishedPMTWaves);
+  void LoopThroughDecodedEvents(const std::map<uint64_t, TankWaveMap>& finishedPMTWaves);
   void WriteToFile();
   void ReadFromFile(ULong64_t timestamp_end, double time_frame);
 
@@ -116,8 +116,7 @@ class MonitorTankTime: public Tool {
 
   
   //CStore variables
-  std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t> > > FinishedPMTWaves;  //MCT, vector<int,int>{crate,slot}, vector<int>{waveform]
-  std::map<std::vector<int>,int>* PMTCrateSpaceToChannelNumMap = nullptr;
+  std::map<uint64_t, TankWaveMap> FinishedPMTWaves;  //MCT, CardChannelKey{card,channel}, vector<int>{waveform]
 
 
   //variables for time calculations
@@ -163,7 +162,6 @@ class MonitorTankTime: public Tool {
   std::vector<unsigned int> active_slots_cr1;
   std::vector<unsigned int> active_slots_cr2;
   std::vector<unsigned int> active_slots_cr3;
-  std::map<std::vector<unsigned int>,int> map_crateslotch_to_ch;
   std::map<std::vector<unsigned int>,int> map_crateslot_to_slot;  //map crate & slot id to the position in the data storing vectors
   std::map<int,std::vector<unsigned int>> map_ch_to_crateslotch;
   std::map<int,std::vector<unsigned int>> map_slot_to_crateslot;
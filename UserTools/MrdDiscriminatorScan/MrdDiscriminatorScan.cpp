@@ -430,16 +430,16 @@ bool MrdDiscriminatorScan::CountChannelHits(BoostStore* MRDData, std::map<int,st
 		// so just for interest
 		if(readouti == 0){
 			Log("First entry of next file had timestamp: " + timestampclass.AsString(),v_debug,verbosity);
-			//Log("There were " + to_string(mrdReadout.Channel.size())+" hits in this readout",v_debug,verbosity);
+			//Log("There were " + to_string(mrdReadout.Hits.size())+" hits in this readout",v_debug,verbosity);
 		}
 		
 		// loop over all hits in this readout
-		for (int hiti = 0; hiti < mrdReadout.Slot.size(); hiti++){
+		for (const MRDHit& hit : mrdReadout.Hits){
 			
 			// get the channel info
-			int crate_num = mrdReadout.Crate.at(hiti);
-			int slot_num = mrdReadout.Slot.at(hiti);
-			int channel_num = mrdReadout.Channel.at(hiti);
+			int crate_num = hit.Crate();
+			int slot_num = hit.Slot();
+			int channel_num = hit.Channel();
 			// n.b. crate 8 slot 9 channel ? is the trigger? XXX
 			
 			// increment the map, creating the necessary keys first if necessary
@@ -455,7 +455,7 @@ bool MrdDiscriminatorScan::CountChannelHits(BoostStore* MRDData, std::map<int,st
 			hit_counts_on_channels.at(crate_num).at(slot_num).at(channel_num)++;
 			
 //			// XXX all the following is unneeded, merely for demonstration XXX
-//			unsigned int hit_time_ticks = mrdReadout.Value.at(hiti);
+//			unsigned int hit_time_ticks = hit.Value();
 //			// combine the crate and slot number to a unique card index
 //			int tdc_index = slot_num+(crate_num-min_crate)*100;
 //			// check if this TDC contains any currently channels - 
@@ -474,12 +474,8 @@ bool MrdDiscriminatorScan::CountChannelHits(BoostStore* MRDData, std::map<int,st
 			
 		}  // end of loop over hits this readout
 		
-		//clear mrdReadout vectors afterwards.... do we need to do this? XXX
-		mrdReadout.Value.clear();
-		mrdReadout.Slot.clear();
-		mrdReadout.Channel.clear();
-		mrdReadout.Crate.clear();
-		mrdReadout.Type.clear();
+		//clear mrdReadout hits afterwards.... do we need to do this? XXX
+		mrdReadout.Hits.clear();
 	}  // loop to next readout
 	
 	return true;
@@ -292,40 +292,40 @@ bool MrdDistributions::Execute(){
 	ClearBranchVectors();
 	Log("MrdDistributions Tool: Looping over theMrdTracks",v_debug,verbosity);
 	for(int tracki=0; tracki<numtracksinev; tracki++){
-		BoostStore* thisTrackAsBoostStore = &(theMrdTracks->at(tracki));
-		if(verbosity>3) cout<<"track "<<tracki<<" at "<<thisTrackAsBoostStore<<endl;
-		// Get the track details from the BoostStore
-		thisTrackAsBoostStore->Get("MrdTrackID",MrdTrackID);                    // int
-		thisTrackAsBoostStore->Get("MrdSubEventID",MrdSubEventID);              // int
-		thisTrackAsBoostStore->Get("InterceptsTank",InterceptsTank);            // bool
-		thisTrackAsBoostStore->Get("StartTime",StartTime);                      // [ns]
-		thisTrackAsBoostStore->Get("StartVertex",StartVertex);                  // [m]
-		thisTrackAsBoostStore->Get("StopVertex",StopVertex);                    // [m]
-		thisTrackAsBoostStore->Get("TrackAngle",TrackAngle);                    // [rad]
-		thisTrackAsBoostStore->Get("TrackAngleError",TrackAngleError);          // dx/dz  TODO
-		thisTrackAsBoostStore->Get("HtrackOrigin",HtrackOrigin);                // x posn at global z=0, [cm]
-		thisTrackAsBoostStore->Get("HtrackOriginError",HtrackOriginError);      // [cm]
-		thisTrackAsBoostStore->Get("HtrackGradient",HtrackGradient);            // dx/dz
-		thisTrackAsBoostStore->Get("HtrackGradientError",HtrackGradientError);  // [no units]
-		thisTrackAsBoostStore->Get("VtrackOrigin",VtrackOrigin);                // [cm]
-		thisTrackAsBoostStore->Get("VtrackOriginError",VtrackOriginError);      // [cm]
-		thisTrackAsBoostStore->Get("VtrackGradient",VtrackGradient);            // dy/dz
-		thisTrackAsBoostStore->Get("VtrackGradientError",VtrackGradientError);  // [no units]
-		thisTrackAsBoostStore->Get("LayersHit",LayersHit);                      // vector<int>
-		thisTrackAsBoostStore->Get("TrackLength",TrackLength);                  // [m]
-		thisTrackAsBoostStore->Get("EnergyLoss",EnergyLoss);                    // [MeV]
-		thisTrackAsBoostStore->Get("EnergyLossError",EnergyLossError);          // [MeV]
-		thisTrackAsBoostStore->Get("IsMrdPenetrating",IsMrdPenetrating);        // bool
-		thisTrackAsBoostStore->Get("IsMrdStopped",IsMrdStopped);                // bool
-		thisTrackAsBoostStore->Get("IsMrdSideExit",IsMrdSideExit);              // bool
-		thisTrackAsBoostStore->Get("PenetrationDepth",PenetrationDepth);        // [m]
-		thisTrackAsBoostStore->Get("HtrackFitChi2",HtrackFitChi2);              // 
-		thisTrackAsBoostStore->Get("HtrackFitCov",HtrackFitCov);                // 
-		thisTrackAsBoostStore->Get("VtrackFitChi2",VtrackFitChi2);              // 
-		thisTrackAsBoostStore->Get("VtrackFitCov",VtrackFitCov);                // 
-		thisTrackAsBoostStore->Get("PMTsHit",PMTsHit);                          // 
-		thisTrackAsBoostStore->Get("TankExitPoint",TankExitPoint);              // [m]
-		thisTrackAsBoostStore->Get("MrdEntryPoint",MrdEntryPoint);              // [m]
+		const MrdTrack& thisTrack = theMrdTracks->at(tracki);
+		if(verbosity>3) cout<<"track "<<tracki<<" at "<<&thisTrack<<endl;
+		// Get the track details
+		MrdTrackID = thisTrack.MrdTrackID;                    // int
+		MrdSubEventID = thisTrack.MrdSubEventID;              // int
+		InterceptsTank = thisTrack.InterceptsTank;            // bool
+		StartTime = thisTrack.StartTime;                      // [ns]
+		StartVertex = thisTrack.StartVertex;                  // [m]
+		StopVertex = thisTrack.StopVertex;                    // [m]
+		TrackAngle = thisTrack.TrackAngle;                    // [rad]
+		TrackAngleError = thisTrack.TrackAngleError;          // dx/dz  TODO
+		HtrackOrigin = thisTrack.HtrackOrigin;                // x posn at global z=0, [cm]
+		HtrackOriginError = thisTrack.HtrackOriginError;      // [cm]
+		HtrackGradient = thisTrack.HtrackGradient;            // dx/dz
+		HtrackGradientError = thisTrack.HtrackGradientError;  // [no units]
+		VtrackOrigin = thisTrack.VtrackOrigin;                // [cm]
+		VtrackOriginError = thisTrack.VtrackOriginError;      // [cm]
+		VtrackGradient = thisTrack.VtrackGradient;            // dy/dz
+		VtrackGradientError = thisTrack.VtrackGradientError;  // [no units]
+		LayersHit = thisTrack.LayersHit;                      // vector<int>
+		TrackLength = thisTrack.TrackLength;                  // [m]
+		EnergyLoss = thisTrack.EnergyLoss;                    // [MeV]
+		EnergyLossError = thisTrack.EnergyLossError;          // [MeV]
+		IsMrdPenetrating = thisTrack.IsMrdPenetrating;        // bool
+		IsMrdStopped = thisTrack.IsMrdStopped;                // bool
+		IsMrdSideExit = thisTrack.IsMrdSideExit;              // bool
+		PenetrationDepth = thisTrack.PenetrationDepth;        // [m]
+		HtrackFitChi2 = thisTrack.HtrackFitChi2;              // 
+		HtrackFitCov = thisTrack.HtrackFitCov;                // 
+		VtrackFitChi2 = thisTrack.VtrackFitChi2;              // 
+		VtrackFitCov = thisTrack.VtrackFitCov;                // 
+		PMTsHit = thisTrack.PMTsHit;                          // 
+		TankExitPoint = thisTrack.TankExitPoint;              // [m]
+		MrdEntryPoint = thisTrack.MrdEntryPoint;              // [m]
 		
 		// some additional histograms are available in the MrdPaddlePlot Tool,
 		// since the cMRDTrack classes used for reconstruction contain mrdcluster objects
@@ -53,7 +53,7 @@ class MrdDistributions: public Tool {
 	
 	// Variables from MRDTracks BoostStore
 	// ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
-	std::vector<BoostStore>* theMrdTracks; // the actual tracks
+	std::vector<MrdTrack>* theMrdTracks; // the actual tracks
 	int MrdTrackID;
 	int MCTruthParticleID;
 	int MrdSubEventID;
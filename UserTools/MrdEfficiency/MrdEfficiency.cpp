@@ -301,11 +301,11 @@ bool MrdEfficiency::Execute(){
 	std::map<int,std::vector<int>> paddlesInTrackReco;
 	std::vector<int> recoIds;
 	for(int tracki=0; tracki<numtracksinev; tracki++){
-		BoostStore* thisTrackAsBoostStore = &(theMrdTracks->at(tracki));
-		// Get the track details from the BoostStore
+		const MrdTrack& thisTrack = theMrdTracks->at(tracki);
+		// Get the track details
 		PMTsHit.clear();
-		thisTrackAsBoostStore->Get("PMTsHit",PMTsHit);
-		thisTrackAsBoostStore->Get("MrdTrackID",MrdTrackID);
+		PMTsHit = thisTrack.PMTsHit;
+		MrdTrackID = thisTrack.MrdTrackID;
 		if(PMTsHit.size()) paddlesInTrackReco.emplace(MrdTrackID,PMTsHit);
 		recoIds.push_back(MrdTrackID);
 	}
@@ -448,7 +448,7 @@ bool MrdEfficiency::Execute(){
 	
 	// put the matching map into the store
 	// maps MC particle ids, from MCParticle::GetParticleID(),
-	// to MRD track ids, from thisTrackAsBoostStore->Get("MrdTrackID",MrdTrackID);
+	// to MRD track ids, from MrdTrackID = thisTrack.MrdTrackID;
 	m_data->CStore.Set("Reco_to_True_Id_Map",Reco_to_True_Id_Map);
 	m_data->CStore.Set("True_to_Reco_Id_Map",True_to_Reco_Id_Map);
 	
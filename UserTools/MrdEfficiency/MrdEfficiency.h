@@ -30,7 +30,7 @@ class MrdEfficiency: public Tool {
 	private:
 	std::map<int,std::map<unsigned long,double>>* ParticleId_to_MrdTubeIds; // the MC Truth information
 	std::map<unsigned long,int> channelkey_to_mrdpmtid;           // 
-	std::vector<BoostStore>* theMrdTracks;                        // the reconstructed tracks
+	std::vector<MrdTrack>* theMrdTracks;                        // the reconstructed tracks
 	std::vector<MCParticle>* MCParticles=nullptr;                 // the true particles
 	std::vector<int> PMTsHit;
 	int MrdTrackID;
@@ -146,17 +146,17 @@ bool MrdPaddleEfficiencyPreparer::Execute(){
 			
 			for(int tracki=0; tracki<numtracksinev; tracki++){
 				
-				BoostStore* thisTrackAsBoostStore = &(theMrdTracks->at(tracki));
+				const MrdTrack& thisTrack = theMrdTracks->at(tracki);
 				PMTsHit.clear();
 				LayersHit.clear();
 
 				//get track properties that are needed for the efficiency analysis
 				
-				thisTrackAsBoostStore->Get("StartVertex",StartVertex);
-				thisTrackAsBoostStore->Get("StopVertex",StopVertex);
-				thisTrackAsBoostStore->Get("PMTsHit",PMTsHit);
-				thisTrackAsBoostStore->Get("LayersHit",LayersHit);
-				thisTrackAsBoostStore->Get("MrdTrackID",MrdTrackID);
+				StartVertex = thisTrack.StartVertex;
+				StopVertex = thisTrack.StopVertex;
+				PMTsHit = thisTrack.PMTsHit;
+				LayersHit = thisTrack.LayersHit;
+				MrdTrackID = thisTrack.MrdTrackID;
 
 				numpmtshit = PMTsHit.size();
 				numlayershit = LayersHit.size();
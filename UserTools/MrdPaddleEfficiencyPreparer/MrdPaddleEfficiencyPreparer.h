@@ -45,7 +45,7 @@ class MrdPaddleEfficiencyPreparer: public Tool {
  private:
 
  	int verbosity;
- 	std::vector<BoostStore>* theMrdTracks;                        // the reconstructed tracks
+ 	std::vector<MrdTrack>* theMrdTracks;                        // the reconstructed tracks
  	std::string MRDTriggertype;
 	std::string outputfile; 
 	Geometry *geom = nullptr;
@@ -1,5 +1,60 @@
 #include "PMTDataDecoder.h"
 
+#include <endian.h>
+
+namespace {
+
+  //The 40 12-bit samples of a frame are packed little-endian into the frame's first 15
+  //big-endian 32-bit words.  Every 3 words (96 bits) hold exactly 8 samples, so a frame
+  //is unpacked as 5 identical groups with no shift register carried between them.
+  constexpr int SAMPLES_PER_GROUP = 8;
+  constexpr int WORDS_PER_GROUP = 3;
+  constexpr int GROUPS_PER_FRAME = 5;
+  constexpr uint16_t RECORD_HEADER_FIRST_SAMPLE = 0x000;
+  constexpr uint16_t RECORD_HEADER_SECOND_SAMPLE = 0xFFF;
+
+  //Unpack one group.  Also returns a bitmask of the samples equal to the
+  //two record header labels so headers are found in the same pass.
+  inline void UnpackSampleGroup(const uint32_t* words, uint16_t* samples,
+          unsigned int& zero_bits, unsigned int& fff_bits)
+  {
+    uint32_t a = be32toh(words[0]);
+    uint32_t b = be32toh(words[1]);
+    uint32_t c = be32toh(words[2]);
+    samples[0] = a & 0xfff;
+    samples[1] = (a >> 12) & 0xfff;
+    samples[2] = ((a >> 24) | (b << 8)) & 0xfff;
+    samples[3] = (b >> 4) & 0xfff;
+    samples[4] = (b >> 16) & 0xfff;
+    samples[5] = ((b >> 28) | (c << 4)) & 0xfff;
+    samples[6] = (c >> 8) & 0xfff;
+    samples[7] = (c >> 20) & 0xfff;
+    zero_bits = 0;
+    fff_bits = 0;
+    for (int i = 0; i < SAMPLES_PER_GROUP; i++){
+      zero_bits |= (unsigned int)(samples[i] == RECORD_HEADER_FIRST_SAMPLE) << i;
+      fff_bits |= (unsigned int)(samples[i] == RECORD_HEADER_SECOND_SAMPLE) << i;
+    }
+  }
+
+  //Unpack all samples of one frame.  Returns a mask with bit i set if a record header
+  //(0x000 followed by 0xFFF) starts at sample i.
+  inline uint64_t UnpackFrame(const uint32_t* words, uint16_t* samples)
+  {
+    uint64_t zero_mask = 0;
+    uint64_t fff_mask = 0;
+    unsigned int zero_bits, fff_bits;
+    for (int group = 0; group < GROUPS_PER_FRAME; group++){
+      UnpackSampleGroup(words + group*WORDS_PER_GROUP, samples + group*SAMPLES_PER_GROUP,
+              zero_bits, fff_bits);
+      zero_mask |= (uint64_t)zero_bits << (group*SAMPLES_PER_GROUP);
+      fff_mask |= (uint64_t)fff_bits << (group*SAMPLES_PER_GROUP);
+    }
+    return zero_mask & (fff_mask >> 1);
+  }
+
+}
+
 PMTDataDecoder::PMTDataDecoder():Tool(){}
 
 
@@ -21,9 +76,11 @@ bool PMTDataDecoder::Initialise(std::string configfile, DataModel &data){
   m_variables.Get("verbosity",verbosity);
   m_variables.Get("Mode",Mode);
   m_variables.Get("ADCCountsToBuildWaves",ADCCountsToBuild);
+  NumDecodeThreads = 1;
+  m_variables.Get("NumDecodeThreads",NumDecodeThreads);
+  if (NumDecodeThreads < 1) NumDecodeThreads = 1;
 
   if (Mode != "Monitoring" && Mode != "Offline") Mode = "Offline";
-  if (Mode == "Monitoring") PMTData = new BoostStore(false,2);
   CDEntryNum = 0;
   
   //Default mode of operation is the continuous flow of data for the live monitoring
@@ -33,7 +90,25 @@ bool PMTDataDecoder::Initialise(std::string configfile, DataModel &data){
   CurrentSubrunNum = -1;
   // Initialize RawData
 
-  FinishedPMTWaves = new std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t> > >; 
+  FinishedPMTWaves = new std::map<uint64_t, TankWaveMap>; 
+
+  //Reserve WaveBank slots for every card in the geometry's crate maps; cards not
+  //in the maps still get slots when they are first seen
+  std::map<std::vector<int>,int> TankPMTCrateSpaceToChannelNumMap;
+  std::map<std::vector<int>,int> AuxCrateSpaceToChannelNumMap;
+  m_data->CStore.Get("TankPMTCrateSpaceToChannelNumMap",TankPMTCrateSpaceToChannelNumMap);
+  m_data->CStore.Get("AuxCrateSpaceToChannelNumMap",AuxCrateSpaceToChannelNumMap);
+  std::set<std::vector<int>> CrateSlots;
+  for (auto const& crate_entry : TankPMTCrateSpaceToChannelNumMap) CrateSlots.insert(std::vector<int>{crate_entry.first.at(0),crate_entry.first.at(1)});
+  for (auto const& crate_entry : AuxCrateSpaceToChannelNumMap) CrateSlots.insert(std::vector<int>{crate_entry.first.at(0),crate_entry.first.at(1)});
+  WaveBank.reserve(CrateSlots.size()*WAVEBANK_CHANNELS_PER_CARD);
+  Log("PMTDataDecoder Tool: Reserved WaveBank slots for "+to_string(CrateSlots.size())+" cards",v_debug,verbosity);
+
+  //The ToolChain thread decodes too, so NumDecodeThreads-1 workers are started
+  DecodeContexts.resize(NumDecodeThreads);
+  NextCardJob = 0;
+  for (int i=1; i<NumDecodeThreads; i++) DecodeWorkers.emplace_back(&PMTDataDecoder::DecodeWorkerLoop, this, i);
+  Log("PMTDataDecoder Tool: Decoding CardData with "+to_string(NumDecodeThreads)+" threads",v_message,verbosity);
 
   m_data->CStore.Set("PauseTankDecoding",false);
   std::cout << "PMTDataDecoder Tool: Initialized successfully" << std::endl;
@@ -64,6 +139,7 @@ bool PMTDataDecoder::Execute(){
     else if (State == "DataFile"){
       // Full PMTData file ready to parse
       if (verbosity > v_message) std::cout<<"PMTDataDecoder: New raw data file available."<<std::endl;
+      BoostStore* PMTData = nullptr;
       m_data->Stores["PMTData"]->Get("FileData",PMTData);
       PMTData->Print(false);
       
@@ -75,8 +151,8 @@ bool PMTDataDecoder::Execute(){
       fifo2.clear();
       
       SequenceMap.clear();
-      TriggerTimeBank.clear();
-      WaveBank.clear();
+      UnprocessedEntries.clear();
+      this->ClearWaveBank();
       
       NumPMTDataProcessed = 0;
       int ExecuteEntryNum = 0;
@@ -103,7 +179,7 @@ bool PMTDataDecoder::Execute(){
             std::cout<<"PMTDataDecoder Tool: CardData's CardID="<<Cdata_old.at(CardDataIndex).CardID<<std::endl;
             std::cout<<"PMTDataDecoder Tool: CardData's data vector size="<<Cdata_old.at(CardDataIndex).Data.size()<<std::endl;
           }
-          CardData aCardData = Cdata_old.at(CardDataIndex);
+          CardData& aCardData = Cdata_old.at(CardDataIndex);
           //Check if card experienced any data loss
           int FIFOstate = aCardData.FIFOstate;
           if(FIFOstate == 1){  //FIFO overflow
@@ -118,56 +194,31 @@ bool PMTDataDecoder::Execute(){
           if (IsNextInSequence) {
 	        Log("PMTDataDecoder Tool: CardData"+to_string(aCardData.CardID)+" is next in sequence. Decoding... ",v_debug, verbosity);
 	        Log("PMTDataDecoder Tool:  CardData has SequenceID... "+to_string(aCardData.SequenceID),v_debug, verbosity);
-            //For this CardData entry, decode raw binary frames.  Locates header markers
-            //And separates the Frame Header from the data stream bits.
-            std::vector<DecodedFrame> ThisCardDFs;
-            ThisCardDFs = this->DecodeFrames(aCardData.Data);
-            if(ThisCardDFs.size() == 0) Log("PMTDataDecoder Tool:  CardData object has no data. ",v_debug, verbosity);
-            else{
-              // Parse each decoded frame's data stream and frame header 
-              for (unsigned int i=0; i < ThisCardDFs.size(); i++){
-                this->ParseFrame(aCardData.CardID,ThisCardDFs.at(i));
-              }
-              NumPMTDataProcessed+=1;
-            }
+            this->QueueCardData(aCardData);
           } else {
 	        Log("PMTDataDecoder Tool WARNING: CardData OUT OF SEQUENCE!!!",v_warning, verbosity);
             //This CardData will be needed later when it's next in sequence.  
             //Log it in the Out-Of-Order (OOO) Data seen so far.
-            int OOOCardID = aCardData.CardID; 
-            int OOOSequenceID = aCardData.SequenceID;
-            int OOOBoostEntry = CDEntryNum;
-            int OOOCardDataIndex = CardDataIndex;
-            std::vector<int> OOOProperties{OOOSequenceID, OOOBoostEntry, OOOCardDataIndex};
 	        Log("PMTDataDecoder Tool:  Storing CardID... " +
                 to_string(aCardData.CardID),v_warning, verbosity);
 	        Log("PMTDataDecoder Tool:  Storing Of SequenceID... " + 
                 to_string(aCardData.SequenceID),v_warning, verbosity);
 	        Log("PMTDataDecoder Tool:  Into UnprocessedEntries. Map ",v_warning, verbosity);
-            if(UnprocessedEntries.count(OOOCardID)==0){
-              deque<std::vector<int>> OOOqueue;
-              OOOqueue.push_back(OOOProperties);
-              UnprocessedEntries.emplace(OOOCardID,OOOqueue);
-            } else {
-              if (OOOSequenceID < UnprocessedEntries.at(OOOCardID).at(0).at(0)){
-                //This new out-of-order entry has the smallest SequenceID
-                UnprocessedEntries.at(OOOCardID).push_front(OOOProperties);
-              } else {
-                //Not the earliest for now; just put it at the back
-                UnprocessedEntries.at(OOOCardID).push_back(OOOProperties);
-              }
-            }
+            //Cdata_old is reloaded for the next entry, so the CardData can be moved
+            this->BufferOutOfOrderCardData(std::move(aCardData));
           }
 	}
+        //Cdata_old is reloaded with the next entry, so its queued CardData are decoded now
+        this->DecodeQueuedCardData();
         Log("PMTDataDecoder Tool: PMTData Entry "+to_string(CDEntryNum)+" processed",v_debug, verbosity);
         ExecuteEntryNum += 1; 
         CDEntryNum+=1; 
       }
         
       this->ParseOOOsNowInOrder();
+      this->DecodeQueuedCardData();
         
-      CStorePMTWaves = *FinishedPMTWaves;
-      m_data->CStore.Set("FinishedPMTWaves",CStorePMTWaves);
+      m_data->CStore.Set("FinishedPMTWaves",*FinishedPMTWaves);
       m_data->CStore.Set("NewTankPMTDataAvailable",true);
       m_data->CStore.Set("FIFOError1",fifo1);
       m_data->CStore.Set("FIFOError2",fifo2);
@@ -205,7 +256,6 @@ bool PMTDataDecoder::Execute(){
   //Check if we are starting a new file 
   if (FileCompleted) m_data->CStore.Set("TankPMTFileComplete",false);
 
-  m_data->CStore.Get("PMTDataPointer",PMTData);
   m_data->CStore.Get("CurrentTankEntryNum",CurrentEntryNum);
 
   // Load RawData BoostStore to use in execute loop
@@ -228,8 +278,8 @@ bool PMTDataDecoder::Execute(){
   else if (RunNumber != CurrentRunNum){ //New run has been encountered
     Log("PMTDataDecoder Tool: New run encountered.  Clearing event building maps",v_message,verbosity); 
     SequenceMap.clear();
-    TriggerTimeBank.clear();
-    WaveBank.clear();
+    UnprocessedEntries.clear();
+    this->ClearWaveBank();
     CurrentRunNum = RunNumber;
   }
   else if (SubRunNumber != CurrentSubrunNum){ //New run has been encountered
@@ -238,8 +288,8 @@ bool PMTDataDecoder::Execute(){
     // EXACTLY in sequence with the end of the prev. run.  Will they be eventually?
     // This prevents freezing up on OUT OF SEQUENCE!! errors
     SequenceMap.clear();
-    TriggerTimeBank.clear();
-    WaveBank.clear();
+    UnprocessedEntries.clear();
+    this->ClearWaveBank();
     CurrentSubrunNum = SubRunNumber;
   }
 
@@ -248,7 +298,7 @@ bool PMTDataDecoder::Execute(){
   Log("PMTDataDecoder Tool: entry has #CardData classes = "+to_string(Cdata->size()),v_debug, verbosity);
   
   for (unsigned int CardDataIndex=0; CardDataIndex<Cdata->size(); CardDataIndex++){
-    CardData aCardData = Cdata->at(CardDataIndex);
+    CardData& aCardData = Cdata->at(CardDataIndex);
     if(verbosity>v_debug){
       std::cout<<"PMTDataDecoder Tool: Loading next CardData from entry's index " << CardDataIndex <<std::endl;
       std::cout<<"PMTDataDecoder Tool: CardData's CardID="<<aCardData.CardID<<std::endl;
@@ -266,45 +316,19 @@ bool PMTDataDecoder::Execute(){
     if (IsNextInSequence) {
       Log("PMTDataDecoder Tool: CardData"+to_string(aCardData.CardID)+" is next in sequence. Decoding... ",v_debug, verbosity);
       Log("PMTDataDecoder Tool:  CardData has SequenceID... "+to_string(aCardData.SequenceID),v_debug, verbosity);
-      //For this CardData entry, decode raw binary frames.  Locates header markers
-      //And separates the Frame Header from the data stream bits.
-      std::vector<DecodedFrame> ThisCardDFs;
-      ThisCardDFs = this->DecodeFrames(aCardData.Data);
-      if(ThisCardDFs.size() == 0) Log("PMTDataDecoder Tool:  CardData object has no data. ",v_debug, verbosity);
-      else{
-        // Parse each decoded frame's data stream and frame header 
-        for (unsigned int i=0; i < ThisCardDFs.size(); i++){
-          this->ParseFrame(aCardData.CardID,ThisCardDFs.at(i));
-        }
-        NumPMTDataProcessed+=1;
-      }
+      this->QueueCardData(aCardData);
     } else {
       Log("PMTDataDecoder Tool WARNING: CardData OUT OF SEQUENCE!!!",v_warning, verbosity);
       //This CardData will be needed later when it's next in sequence.  
       //Log it in the Out-Of-Order (OOO) Data seen so far.
-      int OOOCardID = aCardData.CardID; 
-      int OOOSequenceID = aCardData.SequenceID;
-      int OOOBoostEntry = CurrentEntryNum;
-      int OOOCardDataIndex = CardDataIndex;
-      std::vector<int> OOOProperties{OOOSequenceID, OOOBoostEntry, OOOCardDataIndex};
       Log("PMTDataDecoder Tool:  Storing CardID... " +
               to_string(aCardData.CardID),v_warning, verbosity);
       Log("PMTDataDecoder Tool:  Storing Of SequenceID... " + 
               to_string(aCardData.SequenceID),v_warning, verbosity);
       Log("PMTDataDecoder Tool:  Into UnprocessedEntries. Map ",v_warning, verbosity);
-      if(UnprocessedEntries.count(OOOCardID)==0){
-        deque<std::vector<int>> OOOqueue;
-        OOOqueue.push_back(OOOProperties);
-        UnprocessedEntries.emplace(OOOCardID,OOOqueue);
-      } else {
-        if (OOOSequenceID < UnprocessedEntries.at(OOOCardID).at(0).at(0)){
-          //This new out-of-order entry has the smallest SequenceID
-          UnprocessedEntries.at(OOOCardID).push_front(OOOProperties);
-        } else {
-          //Not the earliest for now; just put it at the back
-          UnprocessedEntries.at(OOOCardID).push_back(OOOProperties);
-        }
-      }
+      //The CardData vector is refilled by LoadRawData for every entry and this tool
+      //is its only reader, so the CardData can be moved into the reorder buffer
+      this->BufferOutOfOrderCardData(std::move(aCardData));
     }
   }
 
@@ -314,6 +338,9 @@ bool PMTDataDecoder::Execute(){
   ///////////////Parse any in OOO vectors that are now in order ///////////////// 
   this->ParseOOOsNowInOrder();
 
+  //Decode this entry's in-sequence CardData, one job per card
+  this->DecodeQueuedCardData();
+
   //PARSING COMPLETE THIS LOOP: PRINT SOME DIAGNOSTICS 
   if(verbosity>v_error) std::cout << "Number of unprocessed entries right now: " << 
      UnprocessedEntries.size() << std::endl;
@@ -332,7 +359,7 @@ bool PMTDataDecoder::Execute(){
 
   //Check the size of the WaveBank to see if things are bloating
   Log("PMTDataDecoder Tool: Size of WaveBank (# waveforms partially built): " + 
-          to_string(WaveBank.size()),v_message, verbosity);
+          to_string(NumWavesInProgress),v_message, verbosity);
   Log("PMTDataDecoder Tool: Size of FinishedPMTWaves from this execution (# triggers with at least one wave fully):" + 
           to_string(FinishedPMTWaves->size()),v_message, verbosity);
   
@@ -343,11 +370,18 @@ bool PMTDataDecoder::Execute(){
 bool PMTDataDecoder::Finalise(){
 
   Log("PMTDataDecoder tool exitting",v_warning,verbosity);
+  {
+    std::lock_guard<std::mutex> lock(DecodeMutex);
+    StopDecodeWorkers = true;
+  }
+  DecodeStart.notify_all();
+  for (unsigned int i=0; i<DecodeWorkers.size(); i++) DecodeWorkers.at(i).join();
+  DecodeWorkers.clear();
   delete FinishedPMTWaves; 
   return true;
 }
 
-bool PMTDataDecoder::CheckIfCardNextInSequence(CardData aCardData)
+bool PMTDataDecoder::CheckIfCardNextInSequence(const CardData& aCardData)
 {
   if(verbosity>vv_debug) std::cout << "CHECKING IF CARD ID " << aCardData.CardID << "NEXT IN SEQUENCE: HAS SID  " << aCardData.SequenceID << std::endl;
   bool IsNextInSequence = false;
@@ -368,52 +402,157 @@ bool PMTDataDecoder::CheckIfCardNextInSequence(CardData aCardData)
   return IsNextInSequence;
 }
 
+void PMTDataDecoder::BufferOutOfOrderCardData(CardData&& aCardData)
+{
+  //This CardData will be needed later when it's next in sequence.  Hold on to it
+  //in the card's reorder buffer, ordered by SequenceID.
+  int OOOCardID = aCardData.CardID;
+  int OOOSequenceID = aCardData.SequenceID;
+  std::map<int, CardData>& ReorderBuffer = UnprocessedEntries[OOOCardID];
+  if(!ReorderBuffer.emplace(OOOSequenceID, std::move(aCardData)).second){
+    Log("PMTDataDecoder Tool: WARNING SequenceID "+to_string(OOOSequenceID)+
+            " already waiting in reorder buffer of CardID "+to_string(OOOCardID)+".  Dropping duplicate.",v_warning,verbosity);
+  }
+  return;
+}
+
+void PMTDataDecoder::QueueCardData(const CardData& aCardData)
+{
+  //Add the CardData to its card's job.  The card's shared decoding state is created
+  //here, on the ToolChain thread, so decoding threads never have to insert into it.
+  int CardID = aCardData.CardID;
+  std::map<int, int>::iterator it = CardJobIndex.find(CardID);
+  if(it == CardJobIndex.end()){
+    this->GetCardWaveSlots(CardID);
+    SyncCounters[CardID];
+    it = CardJobIndex.emplace(CardID, CardJobs.size()).first;
+    CardJobs.emplace_back();
+    CardJobs.back().CardID = CardID;
+  }
+  CardJobs.at(it->second).Queue.push_back(&aCardData);
+  return;
+}
+
+void PMTDataDecoder::DecodeQueuedCardData()
+{
+  if(CardJobs.empty()) return;
+  Log("PMTDataDecoder Tool: Decoding queued CardData of "+to_string(CardJobs.size())+" cards",v_debug, verbosity);
+  NextCardJob = 0;
+  if(DecodeWorkers.empty() || CardJobs.size() == 1){
+    this->RunCardJobs(DecodeContexts.at(0));
+  } else {
+    {
+      std::lock_guard<std::mutex> lock(DecodeMutex);
+      DecodeGeneration+=1;
+      WorkersBusy = DecodeWorkers.size();
+    }
+    DecodeStart.notify_all();
+    this->RunCardJobs(DecodeContexts.at(0));
+    std::unique_lock<std::mutex> lock(DecodeMutex);
+    DecodeDone.wait(lock, [this]{ return WorkersBusy == 0; });
+  }
+  CardJobs.clear();
+  CardJobIndex.clear();
+  ReleasedCardData.clear();
+  this->MergeDecodeContexts();
+  return;
+}
+
+void PMTDataDecoder::DecodeWorkerLoop(int WorkerIndex)
+{
+  unsigned long LastGeneration = 0;
+  while(true){
+    {
+      std::unique_lock<std::mutex> lock(DecodeMutex);
+      DecodeStart.wait(lock, [this, LastGeneration]{ return StopDecodeWorkers || DecodeGeneration != LastGeneration; });
+      if(StopDecodeWorkers) return;
+      LastGeneration = DecodeGeneration;
+    }
+    this->RunCardJobs(DecodeContexts.at(WorkerIndex));
+    {
+      std::lock_guard<std::mutex> lock(DecodeMutex);
+      WorkersBusy-=1;
+    }
+    DecodeDone.notify_one();
+  }
+}
+
+void PMTDataDecoder::RunCardJobs(DecodeContext& Context)
+{
+  //Take card jobs until none are left.  A card's CardData are all decoded by the
+  //thread that took its job, in the order they were queued.
+  for (unsigned int job = NextCardJob++; job < CardJobs.size(); job = NextCardJob++){
+    const CardDecodeJob& Job = CardJobs[job];
+    for (unsigned int i=0; i<Job.Queue.size(); i++) this->DecodeCardData(Context, *Job.Queue[i]);
+  }
+  return;
+}
+
+void PMTDataDecoder::MergeDecodeContexts()
+{
+  for (unsigned int c=0; c<DecodeContexts.size(); c++){
+    DecodeContext& Context = DecodeContexts[c];
+    for (auto& FinishedTrigger : Context.FinishedWaves){
+      TankWaveMap& WaveMap = (*FinishedPMTWaves)[FinishedTrigger.first];
+      for (auto& FinishedWave : FinishedTrigger.second){
+        WaveMap.emplace(FinishedWave.first, std::move(FinishedWave.second));
+      }
+    }
+    Context.FinishedWaves.clear();
+    if(Context.NewWavesBuilt) NewWavesBuilt = true;
+    NumWavesInProgress += Context.WavesInProgressChange;
+    NumPMTDataProcessed += Context.NumCardDataDecoded;
+    Context.NewWavesBuilt = false;
+    Context.WavesInProgressChange = 0;
+    Context.NumCardDataDecoded = 0;
+  }
+  return;
+}
+
+void PMTDataDecoder::DecodeCardData(DecodeContext& Context, const CardData& aCardData)
+{
+  //For this CardData entry, decode raw binary frames.  Locates header markers
+  //And separates the Frame Header from the data stream bits.
+  int NumFrames = this->DecodeFrames(Context, aCardData.Data);
+  if(NumFrames == 0) Log("PMTDataDecoder Tool:  CardData object has no data. ",v_debug, verbosity);
+  else{
+    // Parse each decoded frame's data stream and frame header
+    for (int i=0; i < NumFrames; i++){
+      this->ParseFrame(Context, aCardData.CardID, Context.DecodedFrames[i]);
+    }
+    Context.NumCardDataDecoded+=1;
+  }
+  return;
+}
+
 bool PMTDataDecoder::ParseOneCardOOOs(int CardID)
 {
-  //Now, we want to loop through the Out-Of-Order card data and see if any of it
-  //is in order.  Each time a CardData is actually in order now, look again after
-  //parsing the In-Order to see if any other cards are also now in order.
+  //Queue the Out-Of-Order card data at the front of this card's reorder buffer
+  //for decoding for as long as it's next in the card's sequence.
   bool ProcessedAnOOO = false;
-  Log("PMTDataDecoder Tool: Parsing any in-order data for CardID "+to_string(CardID),v_debug,verbosity); 
-  deque<std::vector<int>> OOOProperties = UnprocessedEntries.at(CardID);
-  bool IsNextInSequence = false;
-  Log("PMTDataDecoder Tool: Get this CardIDs next in sequence ",v_debug,verbosity); 
-  int NextInCardsSequence = SequenceMap.at(CardID);
-  std::vector<int> NowInOrderInds;
-  Log("PMTDataDecoder Tool: Looping through CardID OOOProperties ",v_debug,verbosity); 
-  for (unsigned int i=0; i < OOOProperties.size();i++){
-    std::vector<int> OOOProperty = OOOProperties.at(i);
-    int OOOSequenceID = OOOProperty.at(0);
-    int OOOBoostEntry = OOOProperty.at(1);
-    int OOOCardVectorInd = OOOProperty.at(2);
-    if(OOOSequenceID == NextInCardsSequence){
-      //This OOO CardData is now next in order.  Parse it.
-      Log("PMTDataDecoder Tool: Out of order card is next in sequence!",v_debug,verbosity); 
-      PMTData->GetEntry(OOOBoostEntry);
-      PMTData->Get("CardData",*Cdata);
-      CardData aCardData = Cdata->at(OOOCardVectorInd);
-      std::vector<DecodedFrame> ThisCardDFs;
-      ThisCardDFs = this->DecodeFrames(aCardData.Data);
-      //Now, loop through each frame and Parse their information
-      for (unsigned int j=0; j < ThisCardDFs.size(); j++){
-        this->ParseFrame(aCardData.CardID,ThisCardDFs.at(j));
-      }
-      NowInOrderInds.push_back(i);
-      ProcessedAnOOO = true;
-      NumPMTDataProcessed+=1;
+  Log("PMTDataDecoder Tool: Parsing any in-order data for CardID "+to_string(CardID),v_debug,verbosity);
+  std::map<int, CardData>& ReorderBuffer = UnprocessedEntries.at(CardID);
+  std::map<int, int>::iterator NextInCardsSequence = SequenceMap.find(CardID);
+  if(NextInCardsSequence == SequenceMap.end()) return ProcessedAnOOO;
+  while(!ReorderBuffer.empty()){
+    std::map<int, CardData>::iterator OOOEntry = ReorderBuffer.begin();
+    if(OOOEntry->first < NextInCardsSequence->second){
+      //The sequence has already moved past this entry; it can never be in order
+      Log("PMTDataDecoder Tool: WARNING Dropping out of order CardData with SequenceID "+
+              to_string(OOOEntry->first)+" behind the sequence of CardID "+to_string(CardID),v_warning,verbosity);
+      ReorderBuffer.erase(OOOEntry);
+      continue;
     }
+    if(OOOEntry->first != NextInCardsSequence->second) break;
+    //This OOO CardData is now next in order.  Queue it; it's kept in ReleasedCardData
+    //until the queue is decoded.
+    Log("PMTDataDecoder Tool: Out of order card is next in sequence!",v_debug,verbosity);
+    ReleasedCardData.push_back(std::move(OOOEntry->second));
+    this->QueueCardData(ReleasedCardData.back());
+    NextInCardsSequence->second+=1;
+    ReorderBuffer.erase(OOOEntry);
+    ProcessedAnOOO = true;
   }
-  //Delete all OOOProperties that are now in order.  Start from the
-  //Back index and move forward  in deletion.
-  std::sort(NowInOrderInds.begin(), NowInOrderInds.end());
-  std::reverse(NowInOrderInds.begin(), NowInOrderInds.end());
-  for (unsigned int j=0;j < NowInOrderInds.size();j++){
-    int OrderedInd = NowInOrderInds.at(j);
-    OOOProperties.erase(OOOProperties.begin()+OrderedInd);
-  }
-  UnprocessedEntries.at(CardID) = OOOProperties;
-  //If any data for a card that was out-of-order was re-ordered, loop through again
-  //And try to resolve any now-fixed OOOs
   return ProcessedAnOOO;
 }
 
@@ -421,131 +560,93 @@ bool PMTDataDecoder::ParseOneCardOOOs(int CardID)
 void PMTDataDecoder::ParseOOOsNowInOrder()
 {
   //Now, we want to loop through the Out-Of-Order card data and see if any of it
-  //is in order.  Each time a CardData is actually in order now, look again after
-  //parsing the In-Order to see if any other cards are also now in order.
-  std::vector<int> UnprocCardIDs;
-  for (std::map<int, deque<std::vector<int>>>::iterator it=UnprocessedEntries.begin();
+  //is in order.  Each card's reorder buffer is drained until its front is no
+  //longer next in sequence.
+  for (std::map<int, std::map<int, CardData>>::iterator it=UnprocessedEntries.begin();
           it!=UnprocessedEntries.end(); ++it) {
-    UnprocCardIDs.push_back(it->first);
-  }
-  for(unsigned int i=0;i<UnprocCardIDs.size(); i++){
-    int UnprocCardID = UnprocCardIDs.at(i);
-    if (verbosity > v_message) std::cout << "Trying to Parse unprocessed entries for CardID " <<UnprocCardID << std::endl;
-    bool OOOResolved = true;
-    while(OOOResolved){ //Keep re-parsing out-of-order card data as long as one is found in order
-      OOOResolved = this->ParseOneCardOOOs(UnprocCardID);
-    }
+    if (verbosity > v_message) std::cout << "Trying to Parse unprocessed entries for CardID " << it->first << std::endl;
+    this->ParseOneCardOOOs(it->first);
   }
   return;
 }
 
-std::vector<DecodedFrame> PMTDataDecoder::DecodeFrames(std::vector<uint32_t> bank)
+int PMTDataDecoder::DecodeFrames(DecodeContext& Context, const std::vector<uint32_t>& bank)
 {
   Log("PMTDataDecoder Tool: Decoding frames now ",v_debug, verbosity);
   Log("PMTDataDecoder Tool: Bank size is "+to_string(bank.size()),v_debug, verbosity);
-  uint64_t tempword;
-  std::vector<DecodedFrame> frames;  //What we will return
-  std::vector<uint16_t> samples;
-  samples.resize(40); //Well, if there's 480 bits per frame of samples max, this fits it
   if(verbosity>v_message) std::cout << "DECODING A CARDDATA'S DATA BANK.  SIZE OF BANK: " << bank.size() << std::endl;
   if(verbosity>v_message) std::cout << "THIS SHOULD HOLD AN INTEGER NUMBER OF FRAMES.  EACH FRAME HAS" << std::endl;
   if(verbosity>v_message) std::cout << "512 BITs, split into 16 32-bit INTEGERS.  THIS SHOUDL BE DIVISIBLE BY 16" << std::endl;
-  for (unsigned int frame = 0; frame<bank.size()/16; ++frame) {  // if each frame has 16 32-bit ints, nframes = bank_size/16
-    struct DecodedFrame thisframe;
-    int sampleindex = 0;
-    int wordindex = 16*frame;  //Index of first 32-bit int for this frame
-    int bitsleft = 0;  //# bits to shift to the left in the temp word
-    bool haverecheader_part1 = false;
-    while (sampleindex < 40) {  //Parse out this whole frame
-      if (bitsleft < 12) {
-        if(verbosity>vv_debug) std::cout << "DATA STREAM STEP AT SAMPLE INDEX" << sampleindex << std::endl;
-        tempword += ((uint64_t)be32toh(bank[wordindex]))<<bitsleft;
-        if(verbosity>vv_debug) std::cout << "DATA STREAM SNAPSHOT WITH NEXT 32-bit WORD FROM FRAME " << std::bitset<64>(tempword) << std::endl;
-        bitsleft += 32;
-        wordindex += 1;
-      }
-      //Logic to search for record headers
-      if((tempword&0xfff)==RECORD_HEADER_LABELPART1) haverecheader_part1 = true;
-      else if (haverecheader_part1 && ((tempword&0xfff)==RECORD_HEADER_LABELPART2)){
-        if(verbosity>vv_debug) std::cout << "FOUND A RECORD HEADER. AT INDEX " << sampleindex << std::endl;
-        thisframe.has_recordheader=true;
-        thisframe.recordheader_starts.push_back(sampleindex-1);
-        haverecheader_part1 = false;
-      }
-      else haverecheader_part1 = false;
-     
-      //Takie the first 12 bits of the tempword at each loop, and shift tempword
-      samples[sampleindex] = tempword&0xfff;
-      if(verbosity>vv_debug) std::cout << "FIRST 12 BITS IN THIS SNAPSHOT: " << std::bitset<16>(tempword&0xfff) << dec << std::endl;
-      tempword = tempword>>12;
-      bitsleft -= 12;
-      sampleindex += 1;
-    } //END parse out this frame
-    thisframe.frameheader = be32toh(bank[16*frame+15]);  //Frameid is held in the frame's last 32-bit word
+  int NumFrames = bank.size()/WORDS_PER_FRAME;
+  //Buffers only grow, so after the first few CardData no allocation happens here
+  std::vector<uint16_t>& FrameSamples = Context.FrameSamples;
+  std::vector<DecodedFrame>& DecodedFrames = Context.DecodedFrames;
+  if(FrameSamples.size() < (size_t)NumFrames*SAMPLES_PER_FRAME) FrameSamples.resize(NumFrames*SAMPLES_PER_FRAME);
+  if(DecodedFrames.size() < (size_t)NumFrames) DecodedFrames.resize(NumFrames);
+  for (int frame = 0; frame<NumFrames; ++frame) {
+    const uint32_t* words = bank.data() + WORDS_PER_FRAME*frame;
+    DecodedFrame& thisframe = DecodedFrames[frame];
+    thisframe.samples = FrameSamples.data() + SAMPLES_PER_FRAME*frame;
+    thisframe.recordheader_mask = UnpackFrame(words, FrameSamples.data() + SAMPLES_PER_FRAME*frame);
+    thisframe.has_recordheader = (thisframe.recordheader_mask != 0);
+    thisframe.frameheader = be32toh(words[WORDS_PER_FRAME-1]);  //Frameid is held in the frame's last 32-bit word
     if(verbosity>vv_debug) std::cout << "FRAMEHEADER last 8 bits: " << std::bitset<32>(thisframe.frameheader>>24) << std::endl;
-    thisframe.samples = samples;
-    if(verbosity>vv_debug) std::cout << "LENGTH OF SAMPLES AFTER DECODING A FRAME: " << dec << thisframe.samples.size() << std::endl;
-    frames.push_back(thisframe);
+    if(verbosity>vv_debug) std::cout << "RECORD HEADER MASK OF FRAME: " << std::bitset<SAMPLES_PER_FRAME>(thisframe.recordheader_mask) << std::endl;
   }
   Log("PMTDataDecoder Tool: Decoding frames complete ",v_debug, verbosity);
-  return frames;
+  return NumFrames;
 }
 
-void PMTDataDecoder::ParseFrame(int CardID, DecodedFrame DF)
+void PMTDataDecoder::ParseFrame(DecodeContext& Context, int CardID, const DecodedFrame& DF)
 { 
   //Decoded frame infomration is moved to the
-  //TriggerTimeBank and WaveBank.  
+  //WaveBank.  
   //Get the ID in the frame header.  Need to know if a channel, or sync signal
-  unsigned channel_mask; 
   int ChannelID = DF.frameheader >> 24; //TODO: Use something more intricate?
                                   //Bitrange defined by Jonathan (511 downto 504)
   if(verbosity>4) std::cout << "Parsing frame with CardID and ChannelID-" << 
       CardID << "," << ChannelID << std::endl;
   if(!DF.has_recordheader && (ChannelID != SYNCFRAME_HEADERID)){
     //All samples are waveforms for channel record that already exists in the WaveBank.
-    this->AddSamplesToWaveBank(CardID, ChannelID, DF.samples);
+    this->AddSamplesToWaveBank(CardID, ChannelID, DF.samples, DF.samples+SAMPLES_PER_FRAME);
   } else if (ChannelID != SYNCFRAME_HEADERID){
     int WaveSecBegin = 0;
     //We need to get the rest of a wave from WaveSecBegin to where the header starts
     //FIXME: this works if there's already a wave being built.  You need to parse 
     //a record header in the wavebank first if it's the first thing in the frame though
-    if(verbosity>v_debug) {
-      for (unsigned int j = 0; j<DF.recordheader_starts.size(); j++){
-          std::cout << DF.recordheader_starts.at(j) << std::endl;
-      }
-    }
-    for (unsigned int j = 0; j<DF.recordheader_starts.size(); j++){
+    int RecordHeaderLength = SAMPLES_RIGHTOF_000+1;
+    uint64_t RecordHeaders = DF.recordheader_mask;
+    while (RecordHeaders != 0){
+      int RecordHeaderStart = __builtin_ctzll(RecordHeaders);
+      RecordHeaders &= RecordHeaders - 1;
       //TODO: More graceful way to handle this?  It's already happened once
-      if(WaveSecBegin>DF.recordheader_starts.at(j)){
+      if(WaveSecBegin>RecordHeaderStart){
         if (verbosity > v_warning) std::cout << "WARNING: Record header label found inside another record header." << 
             "This is likely due a 000FFF in the counter.  Skipping record header and " <<
             "continuing" << std::endl;
         continue;
       }
-      if(verbosity>vv_debug)std::cout << "RECORD HEADER INDEX" << DF.recordheader_starts.at(j) << std::endl;
+      if(RecordHeaderStart+RecordHeaderLength > SAMPLES_PER_FRAME){
+        if (verbosity > v_warning) std::cout << "WARNING: Record header label found too close to the end " <<
+            "of the frame to hold a full header.  Skipping record header." << std::endl;
+        break;
+      }
+      if(verbosity>vv_debug)std::cout << "RECORD HEADER INDEX" << RecordHeaderStart << std::endl;
       if(verbosity>vv_debug)std::cout << "WAVESECBEGIN IS " << WaveSecBegin << std::endl;
-      std::vector<uint16_t> WaveSlice(DF.samples.begin()+WaveSecBegin, 
-              DF.samples.begin()+DF.recordheader_starts.at(j));
-      Log("PMTDataDecoder Tool: Length of waveslice: "+to_string(WaveSlice.size()),vv_debug, verbosity);
+      Log("PMTDataDecoder Tool: Length of waveslice: "+to_string(RecordHeaderStart-WaveSecBegin),vv_debug, verbosity);
       //Add this WaveSlice to the wave bank
-      this->AddSamplesToWaveBank(CardID, ChannelID, WaveSlice);
+      this->AddSamplesToWaveBank(CardID, ChannelID, DF.samples+WaveSecBegin, DF.samples+RecordHeaderStart);
       //Since we have acquired the wave up to the next record header, the wave is done.
       //Store it in the FinishedWaves map.
-      this->StoreFinishedWaveform(CardID, ChannelID);
+      this->StoreFinishedWaveform(Context, CardID, ChannelID);
       //Now, we have the header coming next.  Get it and parse it, starting whatever
       //Entries in maps are needed. 
-      std::vector<uint16_t> RecordHeader(DF.samples.begin()+
-              DF.recordheader_starts.at(j), DF.samples.begin()+
-              DF.recordheader_starts.at(j)+SAMPLES_RIGHTOF_000+1);
-      this->ParseRecordHeader(CardID, ChannelID, RecordHeader);
-      WaveSecBegin = DF.recordheader_starts.at(j)+SAMPLES_RIGHTOF_000+1;
+      this->ParseRecordHeader(Context, CardID, ChannelID, DF.samples+RecordHeaderStart);
+      WaveSecBegin = RecordHeaderStart+RecordHeaderLength;
     }
     // No more record headers from here; just parse the rest of whatever 
     // waveform is being looked at
-    int WaveSecEnd = DF.samples.size()-1;
-    std::vector<uint16_t> WaveSlice(DF.samples.begin()+WaveSecBegin, 
-            DF.samples.end());
-    this->AddSamplesToWaveBank(CardID, ChannelID, WaveSlice);
+    this->AddSamplesToWaveBank(CardID, ChannelID, DF.samples+WaveSecBegin, DF.samples+SAMPLES_PER_FRAME);
   }
   else {
     this->ParseSyncFrame(CardID, DF);
@@ -553,108 +654,127 @@ void PMTDataDecoder::ParseFrame(int CardID, DecodedFrame DF)
   return;
 }
 
-void PMTDataDecoder::ParseSyncFrame(int CardID, DecodedFrame DF)
+void PMTDataDecoder::ParseSyncFrame(int CardID, const DecodedFrame& DF)
 {
   if(verbosity>vv_debug) std::cout << "PRINTING ALL DATA IN A SYNC FRAME FOR CARD" << CardID << std::endl;
   uint64_t SyncCounter = 0;
   for (int i=0; i < 6; i++){
-    if(verbosity>vv_debug) std::cout << "SYNC FRAME DATA AT INDEX " << i << ": " << DF.samples.at(i) << std::endl;
-    SyncCounter += ((uint64_t)DF.samples.at(i)) << (12*i);
+    if(verbosity>vv_debug) std::cout << "SYNC FRAME DATA AT INDEX " << i << ": " << DF.samples[i] << std::endl;
+    SyncCounter += ((uint64_t)DF.samples[i]) << (12*i);
     if(verbosity>vv_debug) std::cout << "SYNC COUNTER WITH CURRENT SAMPLE PUT AT LEFT: " << SyncCounter << std::endl;
   }
-  std::map<int, std::vector<uint64_t>>::iterator it = SyncCounters.find(CardID);
-  if(it != SyncCounters.end()) SyncCounters.at(CardID).push_back(SyncCounter);
-  else {
-    std::vector<uint64_t> SyncVec{SyncCounter};
-    SyncCounters.emplace(CardID,SyncVec);
-  }
+  //The card's entry was made by QueueCardData; only this card's decoding thread appends to it
+  SyncCounters.at(CardID).push_back(SyncCounter);
   return;
 }
 
-void PMTDataDecoder::ParseRecordHeader(int CardID, int ChannelID, std::vector<uint16_t> RH)
+void PMTDataDecoder::ParseRecordHeader(DecodeContext& Context, int CardID, int ChannelID, const uint16_t* RH)
 {
-  //We need to get the MTC count and make a new entry in TriggerTimeBank and WaveBank
+  //We need to get the MTC count and start a new wave in the WaveBank
   //First 4 samples; Just get the bits from 24 to 37 (is counter (61 downto 48)
   //Last 4 samples; All the first 48 bits of the MTC count.
   Log("PMTDataDecoder Tool: Parsing an encountered header ",v_debug, verbosity);
   if(verbosity>vv_debug){
     std::cout << "BIT WORDS IN RECORD HEADER: " << std::endl;
-    for (unsigned int j=0; j<RH.size(); j++){
-      std::cout << std::bitset<16>(RH.at(j)) << dec << std::endl;
+    for (unsigned int j=0; j<SAMPLES_RIGHTOF_000+1; j++){
+      std::cout << std::bitset<16>(RH[j]) << dec << std::endl;
     }
   }
-  std::vector<uint16_t> CounterEnd(RH.begin()+2, RH.begin()+4);
-  std::vector<uint16_t> CounterBegin(RH.begin()+4, RH.begin()+8);
+  const uint16_t* CounterEnd = RH+2;    //2 samples
+  const uint16_t* CounterBegin = RH+4;  //4 samples
   uint64_t ClockCount=0;
   int samplewidth=12;  //each uint16 really only holds 12 bits of info. (see DecodeFrame)
-  //std::reverse(CounterBegin.begin(),CounterBegin.end());
-  for (unsigned int j=0; j<CounterBegin.size(); j++){
-    ClockCount += ((uint64_t)CounterBegin.at(j) << j*samplewidth);
+  for (unsigned int j=0; j<4; j++){
+    ClockCount += ((uint64_t)CounterBegin[j] << j*samplewidth);
   }
-  for (unsigned int j=0; j<CounterEnd.size(); j++){
-    ClockCount += ((uint64_t)CounterEnd.at(j) << ((CounterBegin.size() + j)*samplewidth));
+  for (unsigned int j=0; j<2; j++){
+    ClockCount += ((uint64_t)CounterEnd[j] << ((4 + j)*samplewidth));
   }
-  std::vector<int> wave_key{CardID,ChannelID};
-  std::vector<uint16_t> Waveform;
-  
-  //Update the TriggerTimeBank and WaveBank with new entries, since this channel's
+  //Start a new wave in this channel's WaveBank slot, since this channel's
   //Wave data is coming up next
   Log("PMTDataDecoder Tool: Parsed Clock counter for header is "+to_string(ClockCount),v_debug, verbosity);
   Log("PMTDataDecoder Tool: Parsed Clock time for header is "+to_string(ClockCount*8),v_debug, verbosity);
-  TriggerTimeBank.emplace(wave_key,ClockCount*8);
+  WaveSlot& Slot = this->GetWaveSlot(CardID, ChannelID);
+  if(Slot.InProgress) return;  //Wave already being built for this channel; keep it
   Log("PMTDataDecoder Tool: Placing empty waveform in WaveBank ",v_debug, verbosity);
-  WaveBank.emplace(wave_key,Waveform);
+  Slot.InProgress = true;
+  Slot.TriggerTime = ClockCount*8;
+  Slot.Samples.clear();
+  Slot.Samples.reserve(Slot.LastWaveLength);
+  Context.WavesInProgressChange+=1;
   return;
 }
 
 
-void PMTDataDecoder::StoreFinishedWaveform(int CardID, int ChannelID)
+int PMTDataDecoder::GetCardWaveSlots(int CardID)
+{
+  if(CardID >= (int)CardSlotIndex.size()) CardSlotIndex.resize(CardID+1,-1);
+  int& FirstSlot = CardSlotIndex[CardID];
+  if(FirstSlot < 0){
+    Log("PMTDataDecoder Tool: Adding WaveBank slots for CardID "+to_string(CardID),v_debug, verbosity);
+    FirstSlot = WaveBank.size();
+    WaveBank.resize(WaveBank.size()+WAVEBANK_CHANNELS_PER_CARD);
+  }
+  return FirstSlot;
+}
+
+PMTDataDecoder::WaveSlot& PMTDataDecoder::GetWaveSlot(int CardID, int ChannelID)
+{
+  //Slots of queued cards already exist, so this never resizes while decoding
+  return WaveBank[CardSlotIndex[CardID] + (ChannelID & (WAVEBANK_CHANNELS_PER_CARD-1))];
+}
+
+void PMTDataDecoder::ClearWaveBank()
+{
+  for (unsigned int i=0; i<WaveBank.size(); i++){
+    WaveBank[i].InProgress = false;
+    WaveBank[i].Samples.clear();
+  }
+  NumWavesInProgress = 0;
+  return;
+}
+
+void PMTDataDecoder::StoreFinishedWaveform(DecodeContext& Context, int CardID, int ChannelID)
 {
   //Get the full waveform from the Wave Bank
-  std::vector<int> wave_key{CardID,ChannelID};
-  //Check there's a wave in the map
-  if(WaveBank.count(wave_key)==0){
+  WaveSlot& Slot = this->GetWaveSlot(CardID, ChannelID);
+  //Check there's a wave in the slot
+  if(!Slot.InProgress){
     Log("PMTDataDecoder::StoreFinishedWaveform: No waveform at wave key. ",v_message, verbosity);
     Log("PMTDataDecoder::StoreFinishedWaveForm: Continuing without saving any waves",v_message, verbosity);
     return;
   }
-  std::vector<uint16_t> FinishedWave = WaveBank.at(wave_key);
-  uint64_t FinishedWaveTrigTime = TriggerTimeBank.at(wave_key);  //Conversion from counter ticks to ns
-  Log("PMTDataDecoder Tool: Finished Wave Length"+to_string(WaveBank.size()),v_debug, verbosity);
+  uint64_t FinishedWaveTrigTime = Slot.TriggerTime;
+  Log("PMTDataDecoder Tool: Finished Wave Length"+to_string(Slot.Samples.size()),v_debug, verbosity);
   Log("PMTDataDecoder Tool: Finished Wave Clock time (ns)"+to_string(FinishedWaveTrigTime),v_debug, verbosity);
 
-  if(FinishedWave.size()>ADCCountsToBuild){
-    NewWavesBuilt = true;
-    if(FinishedPMTWaves->count(FinishedWaveTrigTime) == 0) {
-      std::map<std::vector<int>, std::vector<uint16_t> > WaveMap;
-      WaveMap.emplace(wave_key,FinishedWave);
-      FinishedPMTWaves->emplace(FinishedWaveTrigTime,WaveMap);
-    } else {
-      FinishedPMTWaves->at(FinishedWaveTrigTime).emplace(wave_key,FinishedWave);
-    }
+  Slot.LastWaveLength = Slot.Samples.size();
+  if(Slot.Samples.size()>ADCCountsToBuild){
+    Context.NewWavesBuilt = true;
+    //Creates the trigger's WaveMap if it doesn't exist yet; the wave is moved, not copied.
+    //MergeDecodeContexts moves it on into FinishedPMTWaves.
+    Context.FinishedWaves[FinishedWaveTrigTime].emplace(MakeCardChannelKey(CardID,ChannelID),std::move(Slot.Samples));
   }
-  //Clear the finished wave from WaveBank and TriggerTimeBank for the new wave
-  //to start being put together
-  WaveBank.erase(wave_key);
-  TriggerTimeBank.erase(wave_key);
+  //Free the slot for the new wave to start being put together
+  Slot.InProgress = false;
+  Slot.Samples.clear();
+  Context.WavesInProgressChange-=1;
   return;
 }
   
 void PMTDataDecoder::AddSamplesToWaveBank(int CardID, int ChannelID, 
-        std::vector<uint16_t> WaveSlice)
+        const uint16_t* SliceBegin, const uint16_t* SliceEnd)
 {
-  Log("PMTDataDecoder Tool: Adding Waveslice to waveform.  Num. Samples: "+to_string(WaveSlice.size()),vv_debug, verbosity);
+  Log("PMTDataDecoder Tool: Adding Waveslice to waveform.  Num. Samples: "+to_string(SliceEnd-SliceBegin),vv_debug, verbosity);
   //TODO: Make sure the above is always divisible by 4!
   //Add the WaveSlice to the proper vector in the WaveBank.
-  std::vector<int> wave_key{CardID,ChannelID};
-  if(WaveBank.count(wave_key)==0){
+  WaveSlot& Slot = this->GetWaveSlot(CardID, ChannelID);
+  if(!Slot.InProgress){
     Log("PMTDataDecoder Tool: HAVE WAVE SLICE BUT NO WAVE BEING BUILT.: ",v_warning, verbosity);
     Log("PMTDataDecoder Tool: WAVE SLICE WILL NOT BE SAVED, DATA LOST",v_warning, verbosity);
     return;
   } else {
-  WaveBank.at(wave_key).insert(WaveBank.at(wave_key).end(),
-                               WaveSlice.begin(),
-                               WaveSlice.end());
+    Slot.Samples.insert(Slot.Samples.end(), SliceBegin, SliceEnd);
   }
   return;
 }
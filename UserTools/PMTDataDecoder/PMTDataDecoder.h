@@ -5,6 +5,11 @@
 #include <iostream>
 #include <bitset>
 #include <deque>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include "Tool.h"
 #include "CardData.h"
@@ -27,13 +32,34 @@
 */
 
 
+//Each 512-bit frame is sixteen 32-bit words; the first 15 hold 40 12-bit samples
+//and the last holds the frame header.
+const int WORDS_PER_FRAME = 16;
+const int SAMPLES_PER_FRAME = 40;
+
 struct DecodedFrame{
   bool has_recordheader;
   uint32_t frameheader;
-  std::vector<uint16_t> samples;
-  std::vector<int> recordheader_starts; //Holds indices where a record header starts in samples
-  ~DecodedFrame(){
-  }
+  const uint16_t* samples; //Points to this frame's SAMPLES_PER_FRAME samples in DecodeContext::FrameSamples
+  uint64_t recordheader_mask; //Bit i is set if a record header starts at samples[i]
+};
+
+//Scratch buffers and outputs of one decoding thread.  Each thread decodes whole cards,
+//so the only state shared between threads is per-card (WaveBank slots, SyncCounters).
+struct DecodeContext{
+  //Buffers filled by DecodeFrames; reused for every CardData so decoding doesn't allocate
+  std::vector<uint16_t> FrameSamples;  //All samples of the current CardData, SAMPLES_PER_FRAME per frame
+  std::vector<DecodedFrame> DecodedFrames;
+  std::map<uint64_t, TankWaveMap> FinishedWaves;  //Waves finished since the last merge into FinishedPMTWaves
+  bool NewWavesBuilt = false;
+  int WavesInProgressChange = 0;
+  int NumCardDataDecoded = 0;
+};
+
+//CardData of one card waiting to be decoded, in sequence order
+struct CardDecodeJob{
+  int CardID;
+  std::vector<const CardData*> Queue;
 };
 
 
@@ -47,19 +73,22 @@ class PMTDataDecoder: public Tool {
   bool Initialise(std::string configfile,DataModel &data); ///< Initialise Function for setting up Tool resources. @param configfile The path and name of the dynamic configuration file to read in. @param data A reference to the transient data class used to pass information between Tools.
   bool Execute(); ///< Execute function used to perform Tool purpose.
   bool Finalise(); ///< Finalise function used to clean up resources.
-  std::vector<DecodedFrame> DecodeFrames(std::vector<uint32_t> bank);
-
-  void ParseFrame(int CardID, DecodedFrame DF);
-  void ParseSyncFrame(int CardID, DecodedFrame DF);
-  void ParseRecordHeader(int CardID, int ChannelID, std::vector<uint16_t> RH);
-  void StoreFinishedWaveform(int CardID, int ChannelID);
-  void AddSamplesToWaveBank(int CardID, int ChannelID, std::vector<uint16_t> WaveSlice);
-  bool CheckIfCardNextInSequence(CardData aCardData);
+  int DecodeFrames(DecodeContext& Context, const std::vector<uint32_t>& bank); ///< Unpacks bank into the context's DecodedFrames/FrameSamples. Returns the number of frames decoded.
+
+  void ParseFrame(DecodeContext& Context, int CardID, const DecodedFrame& DF);
+  void ParseSyncFrame(int CardID, const DecodedFrame& DF);
+  void ParseRecordHeader(DecodeContext& Context, int CardID, int ChannelID, const uint16_t* RH);
+  void StoreFinishedWaveform(DecodeContext& Context, int CardID, int ChannelID);
+  void AddSamplesToWaveBank(int CardID, int ChannelID, const uint16_t* SliceBegin, const uint16_t* SliceEnd);
+  bool CheckIfCardNextInSequence(const CardData& aCardData);
+  void DecodeCardData(DecodeContext& Context, const CardData& aCardData); // Decodes and parses all frames of an in-sequence CardData
+  void BufferOutOfOrderCardData(CardData&& aCardData); // Moves a CardData into its card's reorder buffer
+  void QueueCardData(const CardData& aCardData); // Adds an in-sequence CardData to its card's decode job
+  void DecodeQueuedCardData(); // Decodes all queued CardData (across NumDecodeThreads threads) and merges the finished waves
   void BuildReadyEvents();
 
-  bool ParseOneCardOOOs(int CardID); // Gets a single CardID's UnprocessedEntries vector and
-                                     // Parses any cards that are now in order 
-                              // If any is in order, it's data frames are decoded and parsed.
+  bool ParseOneCardOOOs(int CardID); // Queues entries from the front of a single CardID's
+                                     // reorder buffer for decoding while they are next in sequence
   void ParseOOOsNowInOrder(); // Checks if any Out-Of-Order Sequence data is now in order.
                               // If any is in order, it's data frames are decoded and parsed.
 
@@ -68,7 +97,7 @@ class PMTDataDecoder: public Tool {
   std::string InputFile;
   std::string Mode;
 
-  bool NewWavesBuilt;
+  bool NewWavesBuilt;  //Set when DecodeQueuedCardData merges any new finished waves
   int CurrentEntryNum = 0;
   int ADCCountsToBuild;  //If a finished wave doesn't have this many ADC counts at least, don't add it for building
   int CDEntryNum = 0; 
@@ -89,7 +118,6 @@ class PMTDataDecoder: public Tool {
   //get the entire header.
   unsigned int SAMPLES_RIGHTOF_000 = 7;
 
-  BoostStore* PMTData;
   std::vector<CardData>* Cdata = nullptr;
   std::vector<CardData> Cdata_old;
 
@@ -106,19 +134,47 @@ class PMTDataDecoder: public Tool {
   std::vector<int> fifo2;
 
 
-  std::map<int, deque<std::vector<int>>> UnprocessedEntries; //Key is CardID, Value is vector of vector{SequenceID, BoostEntry, CdataVectorIndex}
-
-  //Maps used in decoding frames; specifically, holds record header and record waveform info
-  std::map<std::vector<int>, uint64_t> TriggerTimeBank;  //Key: {cardID, channelID}. Value: trigger time associated with wave in WaveBank 
-  std::map<std::vector<int>, std::vector<uint16_t>> WaveBank;  //Key: {cardID, channelID}. Value: Waveform being built for this Card and ADC Channel. 
+  //Decoding jobs and worker pool.  Each card's queued CardData is decoded by a single
+  //thread in sequence order; threads take the next card job as they finish one.
+  int NumDecodeThreads;
+  std::vector<DecodeContext> DecodeContexts;  //Index 0 is used by the ToolChain thread
+  std::vector<CardDecodeJob> CardJobs;
+  std::map<int, int> CardJobIndex;  //Key: CardID.  Value: index in CardJobs
+  std::deque<CardData> ReleasedCardData;  //Out-of-order CardData released from the reorder buffers, kept until decoded
+  std::atomic<unsigned int> NextCardJob;
+  std::vector<std::thread> DecodeWorkers;
+  std::mutex DecodeMutex;
+  std::condition_variable DecodeStart;
+  std::condition_variable DecodeDone;
+  unsigned long DecodeGeneration = 0;  //Incremented each time a batch of card jobs is handed to the workers
+  int WorkersBusy = 0;
+  bool StopDecodeWorkers = false;
+  void DecodeWorkerLoop(int WorkerIndex);
+  void RunCardJobs(DecodeContext& Context);
+  void MergeDecodeContexts();
+
+  std::map<int, std::map<int, CardData>> UnprocessedEntries; //Key is CardID, Value is reorder buffer of out-of-order CardData keyed by SequenceID
+
+  //Waveforms currently being built from the decoded frames.  Each card gets a block of
+  //WAVEBANK_CHANNELS_PER_CARD slots (one per possible frame header channel ID) the first
+  //time it's seen, so finding a channel's wave is two array lookups.
+  struct WaveSlot{
+    bool InProgress = false;   //True once a record header has started this wave
+    uint64_t TriggerTime = 0;  //Trigger time (ns) from the record header of this wave
+    std::vector<uint16_t> Samples;
+    size_t LastWaveLength = 0; //Length of the previous wave; used to reserve the next one
+  };
+  static const int WAVEBANK_CHANNELS_PER_CARD = 256;
+  int GetCardWaveSlots(int CardID); //Index of the card's first WaveBank slot.  Adds the card's slots if needed, so only call from the ToolChain thread for new cards
+  WaveSlot& GetWaveSlot(int CardID, int ChannelID);
+  void ClearWaveBank();
+  std::vector<int> CardSlotIndex;  //Index: CardID.  Value: Index of the card's first slot in WaveBank, -1 if not seen yet
+  std::vector<WaveSlot> WaveBank;
+  int NumWavesInProgress = 0;
   std::map<int,std::vector<uint64_t>> SyncCounters; //Key: cardID.  Value: vector of sync counters filled in the order they arrive.
 
-  //Maps that store completed waveforms from cards
-  std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t> > >* FinishedPMTWaves;  //Key: {MTCTime}, value: "WaveMap" with key (CardID,ChannelID), value FinishedWaveform
-  std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t> > > FinishedPMTWaves_old;  //Key: {MTCTime}, value: "WaveMap" with key (CardID,ChannelID), value FinishedWaveform
-  std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t> > > CStorePMTWaves;  //Key: {MTCTime}, value: "WaveMap" with key (CardID,ChannelID), value FinishedWaveform
-  bool NewWaveBuilt;
-  std::map<uint64_t, std::map<std::vector<int>, std::vector<uint16_t> > > CStoreTankEvents;  //Key: {MTCTime}, value: "WaveMap" with key (CardID,ChannelID), value FinishedWaveform
+  //Map that stores completed waveforms from cards.  Finished waves are moved here out of the WaveBank
+  std::map<uint64_t, TankWaveMap>* FinishedPMTWaves;  //Key: {MTCTime}, value: "WaveMap" with key (CardID,ChannelID), value FinishedWaveform
 
   // Notes whether DAQ is in lock step running
   // Number of PMTs that must be found in a WaveSet to build the event
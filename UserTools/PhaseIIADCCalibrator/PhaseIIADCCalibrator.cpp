@@ -14,6 +14,10 @@
 
 #include <thread>
 #include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <iterator>
 
 // ToolAnalysis includes
 #include "PhaseIIADCCalibrator.h"
@@ -36,6 +40,7 @@ bool PhaseIIADCCalibrator::Initialise(std::string config_filename, DataModel& da
   //Set defaults in case config file has no entries
   adc_window_db = "none";
   make_led_waveforms = false;
+  persist_output = false;
   BEType = "ze3ra";
  
   // algorithm selection
@@ -70,17 +75,23 @@ bool PhaseIIADCCalibrator::Initialise(std::string config_filename, DataModel& da
   // get LED waveform-making variables
   m_variables.Get("MakeCalLEDWaveforms",make_led_waveforms);
   m_variables.Get("WindowIntegrationDB", adc_window_db); 
+  m_variables.Get("PersistOutput", persist_output);
   
   // get ROOT fitting variables
   if(BEType == "rootfit"){
-    m_variables.Get("drawBaselineRootFit",draw_baseline_fit);
+    get_ok = m_variables.Get("drawBaselineRootFit",draw_baseline_fit);
     if(not get_ok) draw_baseline_fit=false;
-    m_variables.Get("BaselineFitStartSample",baseline_start_sample);
+    get_ok = m_variables.Get("UseRootFit",use_root_fit);
+    if(not get_ok) use_root_fit=false;
+    if(draw_baseline_fit) use_root_fit=true; // drawing needs the ROOT fit
+    get_ok = m_variables.Get("BaselineFitStartSample",baseline_start_sample);
     if(not get_ok) baseline_start_sample=0;
     get_ok = m_variables.Get("BaselineFitOrder",baseline_fit_order);
     if(not get_ok) baseline_fit_order = 1; // default to linear fit
     get_ok = m_variables.Get("RedoFitWithoutOutliers",redo_fit_without_outliers);
     if(not get_ok) redo_fit_without_outliers = false; // whether to redo the fit after removing outliers
+    get_ok = m_variables.Get("BaselineRefitPasses",baseline_refit_passes);
+    if(not get_ok) baseline_refit_passes = 1; // number of outlier removal and refit passes
     get_ok = m_variables.Get("RefitThresholdAdcCounts", refit_threshold); // but only if wfrm range exceeds this
     if(not get_ok) refit_threshold = 5.; // something suitable
     refit_threshold*=ADC_TO_VOLT;
@@ -108,6 +119,19 @@ bool PhaseIIADCCalibrator::Initialise(std::string config_filename, DataModel& da
     m_data->CStore.Set("RootTApplicationUsers",tapplicationusers);
   }
 
+  // Calibrate channels on several threads; the ROOT fit shares one TGraph and
+  // TF1, so it has to stay on one
+  num_threads = 1;
+  m_variables.Get("NumThreads", num_threads);
+  if (num_threads < 1) num_threads = 1;
+  if (use_root_fit && num_threads > 1) {
+    Log("PhaseIIADCCalibrator Tool: UseRootFit or drawBaselineRootFit set, calibrating on a single thread", v_warning, verbosity);
+    num_threads = 1;
+  }
+
+  // The F-test critical value only depends on the configuration, so find it
+  // now; the calibration threads then only read f_critical_values
+  if (BEType == "ze3ra" || BEType == "ze3ra_multi") get_f_critical_value(num_baseline_samples);
 
   
 
@@ -115,6 +139,12 @@ bool PhaseIIADCCalibrator::Initialise(std::string config_filename, DataModel& da
 
   m_data->CStore.Set("NumBaselineSamples",num_baseline_samples);
 
+  // The ToolChain thread calibrates too, so num_threads-1 workers are started
+  calibration_contexts.resize(num_threads);
+  next_calibration_job = 0;
+  for (int i = 1; i < num_threads; ++i) calibration_workers.emplace_back(&PhaseIIADCCalibrator::calibration_worker_loop, this, i);
+  Log("PhaseIIADCCalibrator Tool: Calibrating channels with " + std::to_string(num_threads) + " threads", v_message, verbosity);
+
   return true;
 }
 
@@ -131,23 +161,20 @@ bool PhaseIIADCCalibrator::Execute() {
     return false;
   }
 
-  // Load the map containing the ADC raw waveform data
-  std::map<unsigned long, std::vector<Waveform<unsigned short> > >
-    raw_waveform_map;
-  // Load the map containing the ADC raw waveform data
-  std::map<unsigned long, std::vector<Waveform<unsigned short> > >
-    raw_auxwaveform_map;
-
-  bool got_raw_data = annie_event->Get("RawADCData", raw_waveform_map);
-  bool got_rawaux_data = annie_event->Get("RawADCAuxData", raw_auxwaveform_map);
+  // Get the maps containing the ADC raw waveform data. These are shared
+  // with the other tools rather than copied.
+  const auto* raw_waveform_map = ANNIEEventMember::Get<std::map<unsigned long,
+    std::vector<Waveform<unsigned short> > > >(annie_event, "RawADCData");
+  const auto* raw_auxwaveform_map = ANNIEEventMember::Get<std::map<unsigned long,
+    std::vector<Waveform<unsigned short> > > >(annie_event, "RawADCAuxData");
 
   // Check for problems
-  if ( !got_raw_data ) {
+  if ( !raw_waveform_map ) {
     Log("Error: The PhaseIIADCCalibrator tool could not find the RawADCData entry", 0,
       verbosity);
     return false;
   }
-  else if ( raw_waveform_map.empty() ) {
+  else if ( raw_waveform_map->empty() ) {
     Log("Error: The PhaseIIADCCalibrator tool found an empty RawADCData entry", 0,
       verbosity);
     return false;
@@ -167,78 +194,73 @@ bool PhaseIIADCCalibrator::Execute() {
   std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > >
     calibrated_led_waveform_map;
 
-  //Calibrate raw detector waveforms
-  for (const auto& temp_pair : raw_waveform_map) {
-    const auto& channel_key = temp_pair.first;
+  // One calibration job per channel
+  calibration_jobs.clear();
+  for (const auto& temp_pair : *raw_waveform_map) {
     //Default running: raw_waveforms only has one entry.  If we go to a
     //hefty-mode style of running though, this could have multiple minibuffers
-    const auto& raw_waveforms = temp_pair.second;
-    Log("Making calibrated waveforms for ADC channel " +
-      std::to_string(channel_key), 3, verbosity);
-
-    if(BEType == "ze3ra"){
-      calibrated_waveform_map[channel_key] = make_calibrated_waveforms_ze3ra(raw_waveforms);
-    } else if(BEType == "ze3ra_multi"){
-      calibrated_waveform_map[channel_key] = make_calibrated_waveforms_ze3ra_multi(raw_waveforms);
-    } else if(BEType == "rootfit"){
-      calibrated_waveform_map[channel_key] = make_calibrated_waveforms_rootfit(raw_waveforms);
-    } else if (BEType == "simple"){
-      calibrated_waveform_map[channel_key] = make_calibrated_waveforms_simple(raw_waveforms);
-    }
-
-    if(make_led_waveforms){
-      Log("Also making LED window waveforms for ADC channel " +
-        std::to_string(channel_key), 3, verbosity);
-      std::vector<Waveform<unsigned short>> LEDWaveforms;
-      this->make_raw_led_waveforms(channel_key,raw_waveforms,LEDWaveforms);
-      raw_led_waveform_map.emplace(channel_key,LEDWaveforms);
-      if(BEType == "ze3ra"){
-        calibrated_led_waveform_map[channel_key] = make_calibrated_waveforms_ze3ra(LEDWaveforms);
-      } else if(BEType == "ze3ra_multi"){
-        calibrated_led_waveform_map[channel_key] = make_calibrated_waveforms_ze3ra_multi(LEDWaveforms);
-      } else if(BEType == "rootfit"){
-        calibrated_led_waveform_map[channel_key] = make_calibrated_waveforms_rootfit(LEDWaveforms);
-      } else if(BEType == "simple"){
-        calibrated_led_waveform_map[channel_key] = make_calibrated_waveforms_simple(LEDWaveforms);
-      }
-    }
+    calibration_jobs.push_back({temp_pair.first, &temp_pair.second, false});
   }
   
   //Calibrate the SIPM waveforms
-  for (const auto& temp_pair : raw_auxwaveform_map) {
-    const auto& channel_key = temp_pair.first;
-    Log("Channel key for Aux channel is " +
-      std::to_string(channel_key), 3, verbosity);
-    //For now, only calibrate the SiPM waveforms
-    Log("Type for Aux channel is " +
-      AuxChannelNumToTypeMap->at(channel_key), 3, verbosity);
-    if(AuxChannelNumToTypeMap->at(channel_key) != "SiPM1" && 
-       AuxChannelNumToTypeMap->at(channel_key) != "SiPM2") continue; 
-    //Default running: raw_waveforms only has one entry.  If we go to a
-    //hefty-mode style of running though, this could have multiple minibuffers
-    const auto& raw_auxwaveforms = temp_pair.second;
-
-    Log("Making calibrated waveforms for Auxiliary channel " +
-      std::to_string(channel_key), 3, verbosity);
+  if (raw_auxwaveform_map) {
+    for (const auto& temp_pair : *raw_auxwaveform_map) {
+      const auto& channel_key = temp_pair.first;
+      Log("Channel key for Aux channel is " +
+        std::to_string(channel_key), 3, verbosity);
+      //For now, only calibrate the SiPM waveforms
+      Log("Type for Aux channel is " +
+        AuxChannelNumToTypeMap->at(channel_key), 3, verbosity);
+      if(AuxChannelNumToTypeMap->at(channel_key) != "SiPM1" && 
+         AuxChannelNumToTypeMap->at(channel_key) != "SiPM2") continue; 
+      calibration_jobs.push_back({channel_key, &temp_pair.second, true});
+    }
+  }
 
-    if(BEType == "ze3ra"){
-      calibrated_auxwaveform_map[channel_key] = make_calibrated_waveforms_ze3ra(raw_auxwaveforms);
-    } else if(BEType == "ze3ra_multi"){
-      calibrated_auxwaveform_map[channel_key] = make_calibrated_waveforms_ze3ra_multi(raw_auxwaveforms);
-    } else if(BEType == "rootfit"){
-      calibrated_auxwaveform_map[channel_key] = make_calibrated_waveforms_rootfit(raw_auxwaveforms);
-    } else if (BEType == "simple"){
-      calibrated_auxwaveform_map[channel_key] = make_calibrated_waveforms_simple(raw_auxwaveforms);
+  // Calibrate the channels, sharing them out with the workers if there are any
+  next_calibration_job = 0;
+  if (calibration_workers.empty() || calibration_jobs.size() < 2) {
+    this->run_calibration_jobs(calibration_contexts.at(0));
+  } else {
+    {
+      std::lock_guard<std::mutex> lock(calibration_mutex);
+      calibration_generation += 1;
+      workers_busy = calibration_workers.size();
     }
+    calibration_start.notify_all();
+    this->run_calibration_jobs(calibration_contexts.at(0));
+    std::unique_lock<std::mutex> lock(calibration_mutex);
+    calibration_done.wait(lock, [this]{ return workers_busy == 0; });
   }
+  calibration_jobs.clear();
+
+  // Merge the waveforms calibrated by each thread
+  std::exception_ptr calibration_error;
+  for (auto& context : calibration_contexts) {
+    calibrated_waveform_map.insert(std::make_move_iterator(context.calibrated_waveforms.begin()),
+      std::make_move_iterator(context.calibrated_waveforms.end()));
+    calibrated_auxwaveform_map.insert(std::make_move_iterator(context.calibrated_auxwaveforms.begin()),
+      std::make_move_iterator(context.calibrated_auxwaveforms.end()));
+    raw_led_waveform_map.insert(std::make_move_iterator(context.raw_led_waveforms.begin()),
+      std::make_move_iterator(context.raw_led_waveforms.end()));
+    calibrated_led_waveform_map.insert(std::make_move_iterator(context.calibrated_led_waveforms.begin()),
+      std::make_move_iterator(context.calibrated_led_waveforms.end()));
+    context.calibrated_waveforms.clear();
+    context.calibrated_auxwaveforms.clear();
+    context.raw_led_waveforms.clear();
+    context.calibrated_led_waveforms.clear();
+    if (context.error && !calibration_error) calibration_error = context.error;
+    context.error = nullptr;
+  }
+  if (calibration_error) std::rethrow_exception(calibration_error);
 
   Log("PhaseIIADCCalibrator Tool: Setting CalibratedADCData",v_debug,verbosity);
-  annie_event->Set("CalibratedADCData", calibrated_waveform_map);
-  annie_event->Set("CalibratedADCAuxData", calibrated_auxwaveform_map);
+  ANNIEEventMember::Publish(annie_event, "CalibratedADCData", std::move(calibrated_waveform_map), persist_output);
+  ANNIEEventMember::Publish(annie_event, "CalibratedADCAuxData", std::move(calibrated_auxwaveform_map), persist_output);
   if(make_led_waveforms){
     std::cout <<"Setting LEDADCData"<<std::endl;
-    annie_event->Set("CalibratedLEDADCData", calibrated_led_waveform_map);
-    annie_event->Set("RawLEDADCData", raw_led_waveform_map);
+    ANNIEEventMember::Publish(annie_event, "CalibratedLEDADCData", std::move(calibrated_led_waveform_map), persist_output);
+    ANNIEEventMember::Publish(annie_event, "RawLEDADCData", std::move(raw_led_waveform_map), persist_output);
   }
   std::cout <<"Set CalibratedADCData"<<std::endl;
 
@@ -248,6 +270,14 @@ bool PhaseIIADCCalibrator::Execute() {
 
 bool PhaseIIADCCalibrator::Finalise() {
   
+  {
+    std::lock_guard<std::mutex> lock(calibration_mutex);
+    stop_calibration_workers = true;
+  }
+  calibration_start.notify_all();
+  for (auto& worker : calibration_workers) worker.join();
+  calibration_workers.clear();
+
   if(BEType == "rootfit"){
     Log("PhaseIIADCCalibrator Tool: Cleaning up ROOT fitting objects",v_message,verbosity);
     //std::cout<<"dumping gObjecTable:"<<std::endl;
@@ -277,42 +307,84 @@ bool PhaseIIADCCalibrator::Finalise() {
   return true;
 }
 
-void PhaseIIADCCalibrator::ze3ra_baseline(
-  const  Waveform<unsigned short> raw_data,
-  double& baseline, double& sigma_baseline, size_t num_baseline_samples,size_t starting_sample)
+std::vector< CalibratedADCWaveform<double> >
+PhaseIIADCCalibrator::make_calibrated_waveforms(
+  const std::vector< Waveform<unsigned short> >& raw_waveforms)
 {
+  if(BEType == "ze3ra"){
+    return make_calibrated_waveforms_ze3ra(raw_waveforms);
+  } else if(BEType == "ze3ra_multi"){
+    return make_calibrated_waveforms_ze3ra_multi(raw_waveforms);
+  } else if(BEType == "rootfit"){
+    return make_calibrated_waveforms_rootfit(raw_waveforms);
+  } else {
+    return make_calibrated_waveforms_simple(raw_waveforms);
+  }
+}
 
-  // Signal ADC means, variances, and F-distribution probability values
-  // ("P") for the first num_baseline_samples from each minibuffer
-  // (in Hefty mode) or from each sub-minibuffer (in non-Hefty mode)
-  std::vector<double> means;
-  std::vector<double> variances;
-  std::vector<double> Ps;
+void PhaseIIADCCalibrator::calibrate_channel(const CalibrationJob& job,
+  CalibrationContext& context)
+{
+  const auto& channel_key = job.channel_key;
+  const auto& raw_waveforms = *job.raw_waveforms;
+  if (job.is_aux) {
+    Log("Making calibrated waveforms for Auxiliary channel " +
+      std::to_string(channel_key), 3, verbosity);
+    context.calibrated_auxwaveforms[channel_key] = make_calibrated_waveforms(raw_waveforms);
+    return;
+  }
 
-  // Using the Phase I non-hefty algorithm. Split the early part of the waveform 
-  // into sub-minibuffers and compute the mean and variance of each one.
-  const auto& data = raw_data.Samples();
-  for (size_t sub_mb = 0u; sub_mb < num_sub_waveforms; ++sub_mb) {
-    std::vector<unsigned short> sub_mb_data(
-      data.cbegin()+ starting_sample + sub_mb * num_baseline_samples,
-      data.cbegin() + starting_sample + (1u + sub_mb) * num_baseline_samples);
+  Log("Making calibrated waveforms for ADC channel " +
+    std::to_string(channel_key), 3, verbosity);
+  context.calibrated_waveforms[channel_key] = make_calibrated_waveforms(raw_waveforms);
 
-    double mean, var;
-    ComputeMeanAndVariance(sub_mb_data, mean, var, num_baseline_samples);
+  if(make_led_waveforms){
+    Log("Also making LED window waveforms for ADC channel " +
+      std::to_string(channel_key), 3, verbosity);
+    std::vector<Waveform<unsigned short>> LEDWaveforms;
+    this->make_raw_led_waveforms(channel_key,raw_waveforms,LEDWaveforms);
+    context.calibrated_led_waveforms[channel_key] = make_calibrated_waveforms(LEDWaveforms);
+    context.raw_led_waveforms.emplace(channel_key,std::move(LEDWaveforms));
+  }
+}
 
-    means.push_back(mean);
-    variances.push_back(var);
+void PhaseIIADCCalibrator::run_calibration_jobs(CalibrationContext& context)
+{
+  // Take channels until none are left. Exceptions are kept for the
+  // ToolChain thread to rethrow once all threads are done.
+  for (unsigned int job = next_calibration_job++; job < calibration_jobs.size(); job = next_calibration_job++) {
+    try {
+      this->calibrate_channel(calibration_jobs[job], context);
+    }
+    catch (...) {
+      if (!context.error) context.error = std::current_exception();
+    }
   }
+}
 
-  // Compute probabilities for the F-distribution test for each waveform chunk
-  for (size_t j = 0; j < variances.size() - 1; ++j) {
-    double sigma2_j = variances.at(j);
-    double sigma2_jp1 = variances.at(j + 1);
-    double F;
-    if (sigma2_j > sigma2_jp1) F = sigma2_j / sigma2_jp1;
-    else F = sigma2_jp1 / sigma2_j;
+void PhaseIIADCCalibrator::calibration_worker_loop(int worker_index)
+{
+  unsigned long last_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(calibration_mutex);
+      calibration_start.wait(lock, [this, last_generation]{ return stop_calibration_workers || calibration_generation != last_generation; });
+      if (stop_calibration_workers) return;
+      last_generation = calibration_generation;
+    }
+    this->run_calibration_jobs(calibration_contexts.at(worker_index));
+    {
+      std::lock_guard<std::mutex> lock(calibration_mutex);
+      workers_busy -= 1;
+    }
+    calibration_done.notify_one();
+  }
+}
 
-    double nu = (num_baseline_samples - 1) / 2.;
+namespace {
+  // Two-tailed F-test p-value for the variance ratio F >= 1 of two samples
+  // with nu = (n - 1) / 2
+  double f_test_probability(double F, double nu) {
     double P = annie_math::Regularized_Beta_Function(1. / (1. + F), nu, nu);
 
     // Two-tailed hypothesis test (we need to exclude unusually small values
@@ -325,9 +397,119 @@ void PhaseIIADCCalibrator::ze3ra_baseline(
     // Numerical Recipes includes this check in a similar block of code,
     // so I'll add it just in case.
     if (P > 1.) P = 2. - P;
+    return P;
+  }
+
+  // Sample mean and variance of the ADC counts in [begin, end), computed from
+  // integer sums so the loop has no dependencies between samples and the
+  // compiler can vectorise it. Matches ComputeMeanAndVariance().
+  void window_mean_and_variance(const unsigned short* begin,
+    const unsigned short* end, double& mean, double& var)
+  {
+    const size_t n = (end > begin) ? end - begin : 0;
+    if (n == 0) {
+      mean = std::numeric_limits<double>::quiet_NaN();
+      var = mean;
+      return;
+    }
+    uint64_t sum = 0, sum2 = 0;
+    for (const unsigned short* x = begin; x != end; ++x) {
+      sum += *x;
+      sum2 += static_cast<uint32_t>(*x) * *x;
+    }
+    mean = static_cast<double>(sum) / n;
+    if (n == 1) var = 0.;
+    else var = (static_cast<double>(sum2) - mean * sum) / (n - 1);
+    if (var < 0.) var = 0.;
+  }
+}
 
-    Ps.push_back(P);
+double PhaseIIADCCalibrator::get_f_critical_value(size_t num_samples) {
+  auto key = std::make_pair(num_samples, p_critical);
+  auto found = f_critical_values.find(key);
+  if (found != f_critical_values.end()) return found->second;
+
+  // The p-value falls monotonically from 1 at F = 1, so every pair of
+  // sub-waveforms with F below the critical value passes the test. Find it
+  // once by bisection instead of evaluating the beta function for every pair.
+  double F_critical;
+  double nu = (num_samples - 1) / 2.;
+  if (p_critical >= 1.) F_critical = 1.;
+  else if (p_critical <= 0. || num_samples < 2) F_critical = std::numeric_limits<double>::infinity();
+  else {
+    double F_low = 1., F_high = 2.;
+    while (f_test_probability(F_high, nu) > p_critical && F_high < 1e12) {
+      F_low = F_high;
+      F_high *= 2.;
+    }
+    for (int i = 0; i < 200 && (F_high - F_low) > 1e-12 * F_high; ++i) {
+      double F_mid = 0.5 * (F_low + F_high);
+      if (f_test_probability(F_mid, nu) > p_critical) F_low = F_mid;
+      else F_high = F_mid;
+    }
+    F_critical = F_low;
   }
+  Log("PhaseIIADCCalibrator Tool: F-test critical value for " + std::to_string(num_samples)
+    + " samples and p_critical " + std::to_string(p_critical) + " is "
+    + std::to_string(F_critical), v_debug, verbosity);
+  f_critical_values.emplace(key, F_critical);
+  return F_critical;
+}
+
+void PhaseIIADCCalibrator::ze3ra_baseline(
+  const  Waveform<unsigned short>& raw_data,
+  double& baseline, double& sigma_baseline, size_t num_baseline_samples,size_t starting_sample)
+{
+
+  // Using the Phase I non-hefty algorithm. Split the early part of the waveform
+  // into sub-minibuffers and compute the mean and variance of each one.
+  // Only whole sub-minibuffers are used: the F critical value below is for
+  // num_baseline_samples samples, so sub-minibuffers running past the end of
+  // the waveform are skipped. If not even one fits, the samples left after
+  // starting_sample are used as a single sub-minibuffer.
+  const auto& data = raw_data.Samples();
+  const size_t num_available = (data.size() > starting_sample)
+    ? data.size() - starting_sample : 0;
+  size_t num_windows = (num_baseline_samples > 0)
+    ? std::min(num_sub_waveforms, num_available / num_baseline_samples) : 0;
+  size_t window_length = num_baseline_samples;
+  if (num_windows == 0) {
+    num_windows = 1;
+    window_length = num_available;
+    Log("PhaseIIADCCalibrator Tool: waveform too short for a full baseline window (" + std::to_string(
+      num_available) + " samples after sample " + std::to_string(starting_sample)
+      + "), using the remaining samples", v_debug, verbosity);
+  }
+  else if (num_windows < num_sub_waveforms) {
+    Log("PhaseIIADCCalibrator Tool: waveform only fits " + std::to_string(num_windows) + " of "
+      + std::to_string(num_sub_waveforms) + " baseline windows", v_debug,
+      verbosity);
+  }
+
+  // Signal ADC means, variances, and F-distribution variance ratios ("F")
+  // for the first num_baseline_samples from each minibuffer
+  // (in Hefty mode) or from each sub-minibuffer (in non-Hefty mode)
+  std::vector<double> means(num_windows);
+  std::vector<double> variances(num_windows);
+  std::vector<double> Fs(num_windows - 1);
+
+  const unsigned short* first = data.data() + std::min(starting_sample, data.size());
+  for (size_t sub_mb = 0u; sub_mb < num_windows; ++sub_mb) {
+    window_mean_and_variance(first, first + window_length,
+      means[sub_mb], variances[sub_mb]);
+    first += window_length;
+  }
+
+  // Compare the variances of neighbouring waveform chunks. A pair passes
+  // the F-test when its p-value is above p_critical, i.e. when its variance
+  // ratio is below the critical F value for this many samples.
+  for (size_t j = 0; j < Fs.size(); ++j) {
+    double sigma2_j = variances[j];
+    double sigma2_jp1 = variances[j + 1];
+    if (sigma2_j > sigma2_jp1) Fs[j] = sigma2_j / sigma2_jp1;
+    else Fs[j] = sigma2_jp1 / sigma2_j;
+  }
+  const double F_critical = get_f_critical_value(num_baseline_samples);
 
   // Compute the mean and standard deviation of the baseline signal
   // for this RawChannel using the mean and standard deviation from
@@ -337,11 +519,11 @@ void PhaseIIADCCalibrator::ze3ra_baseline(
   sigma_baseline = 0.;
   double variance_baseline = 0.;
   size_t num_passing = 0;
-  for (size_t k = 0; k < Ps.size(); ++k) {
-    if (Ps.at(k) > p_critical) {
+  for (size_t k = 0; k < Fs.size(); ++k) {
+    if (Fs[k] < F_critical) {
       ++num_passing;
-      baseline += means.at(k);
-      variance_baseline += variances.at(k);
+      baseline += means[k];
+      variance_baseline += variances[k];
     }
   }
 
@@ -363,24 +545,28 @@ void PhaseIIADCCalibrator::ze3ra_baseline(
   else {
     // If none of the minibuffers passed the F-distribution test,
     // choose the one closest to passing (i.e., the one with the largest
-    // P-value) and adopt its baseline statistics. For a sufficiently large
-    // number of minibuffers (e.g., 40), such a situation should be very rare.
+    // P-value, which is the smallest F) and adopt its baseline statistics.
+    // For a sufficiently large number of minibuffers (e.g., 40), such a
+    // situation should be very rare.
     // TODO: consider changing this approach
-    auto max_iter = std::max_element(Ps.cbegin(), Ps.cend());
-    int max_index = std::distance(Ps.cbegin(), max_iter);
+    size_t min_index = 0;
+    for (size_t k = 1; k < Fs.size(); ++k) {
+      if (Fs[k] < Fs[min_index] || std::isnan(Fs[min_index])) min_index = k;
+    }
 
-    baseline = means.at(max_index);
-    sigma_baseline = std::sqrt( variances.at(max_index) );
+    baseline = means.at(min_index);
+    sigma_baseline = std::sqrt( variances.at(min_index) );
   }
 
   std::string mb_temp_string = "minibuffer";
 
   if (verbosity >= 4) {
-    for ( size_t x = 0; x < Ps.size(); ++x ) {
+    double nu = (num_baseline_samples - 1) / 2.;
+    for ( size_t x = 0; x < Fs.size(); ++x ) {
       Log("  " + mb_temp_string + " " + std::to_string(x) + ", mean = "
         + std::to_string(means.at(x)) + ", var = "
         + std::to_string(variances.at(x)) + ", p-value = "
-        + std::to_string(Ps.at(x)), 4, verbosity);
+        + std::to_string(f_test_probability(Fs.at(x), nu)), 4, verbosity);
     }
   }
 
@@ -400,17 +586,17 @@ PhaseIIADCCalibrator::make_calibrated_waveforms_simple(
   // Determine the baseline for the set of raw waveforms (assumed to all
   // come from the same readout for the same channel)
   std::vector< CalibratedADCWaveform<double> > calibrated_waveforms;
+  calibrated_waveforms.reserve(raw_waveforms.size());
   for (const auto& raw_waveform : raw_waveforms) {
     double baseline, sigma_baseline;
-    std::vector<double> cal_data;
     const std::vector<unsigned short>& raw_data = raw_waveform.Samples();
+    std::vector<double> cal_data(raw_data.size());
     ComputeMeanAndVariance(raw_data, baseline, sigma_baseline, num_baseline_samples);
-    for (const auto& sample : raw_data) {
-      cal_data.push_back((static_cast<double>(sample) - baseline)
-        * ADC_TO_VOLT);
+    for (size_t i = 0; i < raw_data.size(); ++i) {
+      cal_data[i] = (static_cast<double>(raw_data[i]) - baseline) * ADC_TO_VOLT;
     }
     calibrated_waveforms.emplace_back(raw_waveform.GetStartTime(),
-      cal_data, baseline, sigma_baseline);
+      std::move(cal_data), baseline, sigma_baseline);
   }
   return calibrated_waveforms;
 }
@@ -424,19 +610,20 @@ PhaseIIADCCalibrator::make_calibrated_waveforms_ze3ra(
   // Determine the baseline for the set of raw waveforms (assumed to all
   // come from the same readout for the same channel)
   std::vector< CalibratedADCWaveform<double> > calibrated_waveforms;
+  calibrated_waveforms.reserve(raw_waveforms.size());
   for (const auto& raw_waveform : raw_waveforms) {
     double baseline, sigma_baseline;
     ze3ra_baseline(raw_waveform, baseline, sigma_baseline,
       num_baseline_samples, 0);
-    std::vector<double> cal_data;
     const std::vector<unsigned short>& raw_data = raw_waveform.Samples();
-    for (const auto& sample : raw_data) {
-      cal_data.push_back((static_cast<double>(sample) - baseline)
-        * ADC_TO_VOLT);
+    std::vector<double> cal_data(raw_data.size());
+    for (size_t i = 0; i < raw_data.size(); ++i) {
+      cal_data[i] = (static_cast<double>(raw_data[i]) - baseline) * ADC_TO_VOLT;
     }
   
+    // The samples are moved into the calibrated waveform rather than copied
     calibrated_waveforms.emplace_back(raw_waveform.GetStartTime(),
-      cal_data, baseline, sigma_baseline);
+      std::move(cal_data), baseline, sigma_baseline);
   }
   return calibrated_waveforms;
 }
@@ -450,6 +637,7 @@ PhaseIIADCCalibrator::make_calibrated_waveforms_ze3ra_multi(
   // Determine the baseline for the set of raw waveforms (assumed to all
   // come from the same readout for the same channel)
   std::vector< CalibratedADCWaveform<double> > calibrated_waveforms;
+  calibrated_waveforms.reserve(raw_waveforms.size());
   for (const auto& raw_waveform : raw_waveforms) {
     std::vector<uint16_t> baselines;
     std::vector<size_t> RepresentationRegion;
@@ -476,6 +664,7 @@ PhaseIIADCCalibrator::make_calibrated_waveforms_ze3ra_multi(
     }
     std::vector<double> cal_data;
     const std::vector<unsigned short>& raw_data = raw_waveform.Samples();
+    cal_data.reserve(raw_data.size());
     for (const auto& asample: raw_data){
       for(int j = 0; j<RepresentationRegion.size(); j++){
         if(asample < RepresentationRegion.at(j)){
@@ -491,17 +680,283 @@ PhaseIIADCCalibrator::make_calibrated_waveforms_ze3ra_multi(
     double bl_estimates_mean, bl_estimates_var;
     ComputeMeanAndVariance(baselines, bl_estimates_mean, bl_estimates_var);
     calibrated_waveforms.emplace_back(raw_waveform.GetStartTime(),
-      cal_data, bl_estimates_mean, bl_estimates_var);
+      std::move(cal_data), bl_estimates_mean, bl_estimates_var);
   }
   return calibrated_waveforms;
 }
 
 
 
+namespace {
+  // Solves the (n x n, row-major) system A x = b by Gaussian elimination with
+  // partial pivoting. A is destroyed and b replaced by x. Returns false if A
+  // is singular.
+  bool solve_linear_system(std::vector<double>& A, std::vector<double>& b) {
+    const size_t n = b.size();
+    for (size_t col = 0; col < n; ++col) {
+      size_t pivot = col;
+      for (size_t row = col + 1; row < n; ++row) {
+        if (std::fabs(A[row*n + col]) > std::fabs(A[pivot*n + col])) pivot = row;
+      }
+      if (!(std::fabs(A[pivot*n + col]) > 0.)) return false;
+      if (pivot != col) {
+        for (size_t k = 0; k < n; ++k) std::swap(A[pivot*n + k], A[col*n + k]);
+        std::swap(b[pivot], b[col]);
+      }
+      for (size_t row = col + 1; row < n; ++row) {
+        double factor = A[row*n + col] / A[col*n + col];
+        for (size_t k = col; k < n; ++k) A[row*n + k] -= factor * A[col*n + k];
+        b[row] -= factor * b[col];
+      }
+    }
+    for (size_t col = n; col-- > 0; ) {
+      double sum = b[col];
+      for (size_t k = col + 1; k < n; ++k) sum -= A[col*n + k] * b[k];
+      b[col] = sum / A[col*n + col];
+    }
+    return true;
+  }
+
+  double evaluate_polynomial(const std::vector<double>& coefficients, double t) {
+    double value = 0.;
+    for (size_t k = coefficients.size(); k-- > 0; ) value = value * t + coefficients[k];
+    return value;
+  }
+
+  // Converts the coefficients of a polynomial in t = (x - centre) / scale
+  // into coefficients of x, for printing
+  std::vector<double> polynomial_in_x(const std::vector<double>& coefficients,
+    double centre, double scale)
+  {
+    std::vector<double> result(coefficients.size(), 0.);
+    for (size_t k = 0; k < coefficients.size(); ++k) {
+      double binomial = 1.;
+      for (size_t j = 0; j <= k; ++j) {
+        // C(k,j) x^j (-centre)^(k-j) / scale^k
+        result[j] += coefficients[k] * binomial * std::pow(-centre, k - j) / std::pow(scale, k);
+        binomial = binomial * (k - j) / (j + 1);
+      }
+    }
+    return result;
+  }
+}
+
+const PhaseIIADCCalibrator::BaselineFitProjection&
+PhaseIIADCCalibrator::get_baseline_fit_projection(size_t first_sample,
+  size_t last_sample)
+{
+  std::lock_guard<std::mutex> lock(baseline_fit_mutex);
+  auto key = std::make_tuple(first_sample, last_sample, baseline_fit_order);
+  auto found = baseline_fit_projections.find(key);
+  if (found == baseline_fit_projections.end()) {
+    found = baseline_fit_projections.emplace(key, BaselineFitProjection()).first;
+    make_baseline_fit_projection(first_sample, last_sample, found->second);
+  }
+  return found->second;
+}
+
+void PhaseIIADCCalibrator::make_baseline_fit_projection(size_t first_sample,
+  size_t last_sample, BaselineFitProjection& projection)
+{
+  projection.first_sample = first_sample;
+  projection.last_sample = last_sample;
+  projection.order = baseline_fit_order;
+  projection.ok = false;
+  projection.matrix.clear();
+
+  const size_t num_params = baseline_fit_order + 1;
+  const size_t num_samples = (last_sample >= first_sample) ? last_sample - first_sample + 1 : 0;
+  if (baseline_fit_order < 0 || num_samples < num_params) {
+    Log("PhaseIIADCCalibrator Tool: Cannot fit a pol" + std::to_string(baseline_fit_order)
+      + " to " + std::to_string(num_samples) + " baseline samples!", v_warning, verbosity);
+    return;
+  }
+  projection.centre = 0.5 * (first_sample + last_sample);
+  projection.scale = std::max(0.5 * (last_sample - first_sample), 1.);
+
+  // Normal matrix V^T V of the Vandermonde matrix V for this sample grid
+  std::vector<double> powers(num_samples * num_params);
+  std::vector<double> normal_matrix(num_params * num_params, 0.);
+  for (size_t i = 0; i < num_samples; ++i) {
+    double t = (first_sample + i - projection.centre) / projection.scale;
+    double power = 1.;
+    for (size_t k = 0; k < num_params; ++k) {
+      powers[i*num_params + k] = power;
+      power *= t;
+    }
+    for (size_t j = 0; j < num_params; ++j) {
+      for (size_t k = 0; k < num_params; ++k) {
+        normal_matrix[j*num_params + k] += powers[i*num_params + j] * powers[i*num_params + k];
+      }
+    }
+  }
+
+  // Invert it one column at a time
+  std::vector<double> inverse(num_params * num_params);
+  for (size_t col = 0; col < num_params; ++col) {
+    std::vector<double> A(normal_matrix);
+    std::vector<double> unit(num_params, 0.);
+    unit[col] = 1.;
+    if (!solve_linear_system(A, unit)) {
+      Log("PhaseIIADCCalibrator Tool: Baseline fit normal matrix is singular!", v_warning, verbosity);
+      return;
+    }
+    for (size_t row = 0; row < num_params; ++row) inverse[row*num_params + col] = unit[row];
+  }
+
+  projection.matrix.assign(num_params * num_samples, 0.);
+  for (size_t k = 0; k < num_params; ++k) {
+    for (size_t i = 0; i < num_samples; ++i) {
+      double sum = 0.;
+      for (size_t j = 0; j < num_params; ++j) sum += inverse[k*num_params + j] * powers[i*num_params + j];
+      projection.matrix[k*num_samples + i] = sum;
+    }
+  }
+  projection.ok = true;
+  Log("PhaseIIADCCalibrator Tool: Prepared pol" + std::to_string(baseline_fit_order)
+    + " baseline fit of samples " + std::to_string(first_sample) + " to "
+    + std::to_string(last_sample), v_debug, verbosity);
+}
+
+// version based on a least-squares polynomial fit, solved directly
+std::vector< CalibratedADCWaveform<double> >
+PhaseIIADCCalibrator::make_calibrated_waveforms_polyfit(
+  const std::vector< Waveform<unsigned short> >& raw_waveforms)
+{
+  std::vector< CalibratedADCWaveform<double> > calibrated_waveforms;
+  calibrated_waveforms.reserve(raw_waveforms.size());
+  const size_t num_params = baseline_fit_order + 1;
+
+  for (const auto& raw_waveform : raw_waveforms) {
+    const std::vector<unsigned short>& raw_data = raw_waveform.Samples();
+    const size_t nsamples = raw_data.size();
+    std::vector<double> cal_data(nsamples);
+    if (nsamples == 0) {
+      calibrated_waveforms.emplace_back(raw_waveform.GetStartTime(), std::move(cal_data), 0., 0.);
+      continue;
+    }
+
+    // Same sample range as the ROOT fit: from BaselineFitStartSample up to
+    // NumBaselineSamples (or the whole waveform if that doesn't fit)
+    size_t fit_end = num_baseline_samples;
+    if (fit_end == 0 || baseline_start_sample >= nsamples || fit_end > nsamples - baseline_start_sample) fit_end = nsamples;
+    size_t last_sample = std::min(fit_end, nsamples - 1);
+    const BaselineFitProjection& projection =
+      get_baseline_fit_projection(baseline_start_sample, last_sample);
+    bool fit_succeeded = projection.ok;
+
+    // Baseline polynomial evaluated at every sample
+    std::vector<double> baseline_vals(nsamples, 0.);
+    if (fit_succeeded) {
+      const size_t num_fit_samples = last_sample - projection.first_sample + 1;
+      const unsigned short* fit_data = raw_data.data() + projection.first_sample;
+      std::vector<double> coefficients(num_params, 0.);
+      for (size_t k = 0; k < num_params; ++k) {
+        const double* row = projection.matrix.data() + k*num_fit_samples;
+        double sum = 0.;
+        for (size_t i = 0; i < num_fit_samples; ++i) sum += row[i] * fit_data[i];
+        coefficients[k] = sum;
+      }
+      for (size_t i = 0; i < nsamples; ++i) {
+        baseline_vals[i] = evaluate_polynomial(coefficients, (i - projection.centre) / projection.scale);
+      }
+      if (verbosity >= v_debug) {
+        std::vector<double> fitpars = polynomial_in_x(coefficients, projection.centre, projection.scale);
+        std::string fit_message="PhaseIIADCCalibrator Tool: Baseline fit success: fit function was: ";
+        for (size_t orderi = 0; orderi < num_params; ++orderi) {
+          fit_message+= to_string(fitpars.at(orderi))+"*x^"+to_string(orderi);
+          if (orderi+1 < num_params) fit_message+=" + ";
+        }
+        Log(fit_message, v_debug, verbosity);
+      }
+    }
+
+    double cal_data_min = std::numeric_limits<double>::max();
+    double cal_data_max = std::numeric_limits<double>::lowest();
+    for (size_t i = 0; i < nsamples; ++i) {
+      cal_data[i] = (static_cast<double>(raw_data[i]) - baseline_vals[i]) * ADC_TO_VOLT;
+      cal_data_min = std::min(cal_data_min, cal_data[i]);
+      cal_data_max = std::max(cal_data_max, cal_data[i]);
+    }
+
+    // If large pulses may have skewed the fit, drop the top 5% of calibrated
+    // samples and fit the remainder of the whole waveform again, adding that
+    // fit to the baseline. Each pass starts from the previous pass's result.
+    double sigma_baseline = 0;
+    std::vector<double> sorted_data;
+    for (int pass = 0; fit_succeeded && redo_fit_without_outliers && pass < baseline_refit_passes
+         && (cal_data_max - cal_data_min) > refit_threshold; ++pass) {
+      Log("PhaseIIADCCalibrator Tool: Removing outliers and refitting, pass " + std::to_string(pass),
+        v_debug, verbosity);
+
+      // 95% quantile of the calibrated samples, interpolating between samples
+      sorted_data = cal_data;
+      double position = 0.95 * (nsamples - 1);
+      size_t lower = static_cast<size_t>(position);
+      std::nth_element(sorted_data.begin(), sorted_data.begin() + lower, sorted_data.end());
+      double upper_threshold = sorted_data[lower];
+      if (lower + 1 < nsamples) {
+        double next = *std::min_element(sorted_data.begin() + lower + 1, sorted_data.end());
+        upper_threshold += (position - lower) * (next - upper_threshold);
+      }
+
+      if (pass == 0) {
+        double mean = 0., var = 0.;
+        for (const double& cal_sample : cal_data) mean += cal_sample;
+        mean /= nsamples;
+        for (const double& cal_sample : cal_data) var += (cal_sample - mean) * (cal_sample - mean);
+        sigma_baseline = std::sqrt(var / nsamples);
+      }
+
+      // Least-squares fit of the remaining samples (in ADC counts) at their
+      // positions in the waveform
+      const double centre = 0.5 * (nsamples - 1);
+      const double scale = std::max(0.5 * (nsamples - 1), 1.);
+      std::vector<double> normal_matrix(num_params * num_params, 0.);
+      std::vector<double> correction(num_params, 0.);
+      std::vector<double> powers(num_params);
+      size_t num_kept = 0;
+      for (size_t i = 0; i < nsamples; ++i) {
+        if (cal_data[i] > upper_threshold) continue;
+        ++num_kept;
+        double t = (i - centre) / scale;
+        double power = 1.;
+        for (size_t k = 0; k < num_params; ++k) { powers[k] = power; power *= t; }
+        double residual = cal_data[i] / ADC_TO_VOLT;
+        for (size_t j = 0; j < num_params; ++j) {
+          correction[j] += powers[j] * residual;
+          for (size_t k = 0; k < num_params; ++k) normal_matrix[j*num_params + k] += powers[j] * powers[k];
+        }
+      }
+      if (num_kept < num_params || !solve_linear_system(normal_matrix, correction)) {
+        Log("PhaseIIADCCalibrator Tool: polynomial re-fit of baseline failed!",v_warning,verbosity);
+        break;
+      }
+
+      cal_data_min = std::numeric_limits<double>::max();
+      cal_data_max = std::numeric_limits<double>::lowest();
+      for (size_t i = 0; i < nsamples; ++i) {
+        baseline_vals[i] += evaluate_polynomial(correction, (i - centre) / scale);
+        cal_data[i] = (static_cast<double>(raw_data[i]) - baseline_vals[i]) * ADC_TO_VOLT;
+        cal_data_min = std::min(cal_data_min, cal_data[i]);
+        cal_data_max = std::max(cal_data_max, cal_data[i]);
+      }
+    }
+
+    // DC offset: the baseline polynomial at x = 0. FIXME this doesn't fully capture the correction applied
+    double baseline = baseline_vals[0];
+    calibrated_waveforms.emplace_back(raw_waveform.GetStartTime(), std::move(cal_data), baseline, sigma_baseline);
+  }
+  return calibrated_waveforms;
+}
+
 // version based on a polynomial fit done via ROOT
 std::vector< CalibratedADCWaveform<double> >
 PhaseIIADCCalibrator::make_calibrated_waveforms_rootfit(
   const std::vector< Waveform<unsigned short> >& raw_waveforms){
+  // Unless the ROOT fit is asked for (UseRootFit, or drawing the fits), use the
+  // direct least-squares solution, which needs no ROOT objects
+  if(not use_root_fit) return make_calibrated_waveforms_polyfit(raw_waveforms);
   Log("PhaseIIADCCalibrator Tool: Doing ROOT based baseline subtraction", v_debug, verbosity);
   std::vector< CalibratedADCWaveform<double> > calibrated_waveforms;
   
@@ -14,9 +14,17 @@
 #include "annie_math.h"
 #include "ANNIEalgorithms.h"
 #include "ANNIEconstants.h"
+#include "ANNIEEventMember.h"
 #include <boost/algorithm/string.hpp>
 
 #include <sstream>
+#include <map>
+#include <tuple>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
 
 class TApplication;
 class TCanvas;
@@ -39,9 +47,14 @@ class PhaseIIADCCalibrator : public Tool {
     /// object using a technique taken from the ZE3RA code.
     /// @details See section 2.2 of https://arxiv.org/pdf/1106.0808.pdf for a
     /// description of the algorithm.
-    void ze3ra_baseline(const Waveform<unsigned short> raw_data,
+    void ze3ra_baseline(const Waveform<unsigned short>& raw_data,
       double& baseline, double& sigma_baseline, size_t num_baseline_samples, size_t starting_sample);
 
+    /// @brief Get the variance ratio F above which two sub-waveforms of
+    /// num_samples each fail the F-test in ze3ra_baseline(), i.e. the F
+    /// at which the two-tailed p-value equals p_critical.
+    double get_f_critical_value(size_t num_samples);
+
     std::vector< CalibratedADCWaveform<double> > make_calibrated_waveforms_ze3ra(
       const std::vector< Waveform<unsigned short> >& raw_waveforms);
     
@@ -49,8 +62,43 @@ class PhaseIIADCCalibrator : public Tool {
       const std::vector< Waveform<unsigned short> >& raw_waveforms);
     
     /// @brief Fit a polynomial to the baseline of each waveform.
+    /// @details The fit is done with ROOT only when UseRootFit or
+    /// drawBaselineRootFit is set; otherwise make_calibrated_waveforms_polyfit()
+    /// is used.
     std::vector< CalibratedADCWaveform<double> > make_calibrated_waveforms_rootfit(
       const std::vector<Waveform<short unsigned int> >& raw_waveforms);
+
+    /// @brief Least-squares polynomial baseline fit without ROOT.
+    /// @details Matches the ROOT fit without outlier removal; the outlier
+    /// refit differs (see the README).
+    std::vector< CalibratedADCWaveform<double> > make_calibrated_waveforms_polyfit(
+      const std::vector<Waveform<short unsigned int> >& raw_waveforms);
+
+    // Least-squares solution for a baseline window, reused for every
+    // waveform with the same number of samples. The polynomial is fitted in
+    // t = (sample - centre) / scale to keep the normal equations well conditioned.
+    struct BaselineFitProjection {
+      size_t first_sample = 0;
+      size_t last_sample = 0;
+      int order = -1;
+      double centre = 0.;
+      double scale = 1.;
+      bool ok = false;
+      // (order+1) x (number of samples) matrix (V^T V)^-1 V^T, row-major.
+      // Coefficients in t are this matrix times the samples.
+      std::vector<double> matrix;
+    };
+
+    /// @brief Set up projection for fitting samples first_sample
+    /// to last_sample (inclusive) with a polynomial of order baseline_fit_order
+    void make_baseline_fit_projection(size_t first_sample, size_t last_sample,
+      BaselineFitProjection& projection);
+
+    /// @brief Get the projection for fitting samples first_sample to
+    /// last_sample, making it the first time it is needed. Safe to call
+    /// from several calibration threads.
+    const BaselineFitProjection& get_baseline_fit_projection(size_t first_sample,
+      size_t last_sample);
     
     /// @brief Calculate mean and standard deviation using num_baseline_samples at beginning of waveform
     std::vector< CalibratedADCWaveform<double> > make_calibrated_waveforms_simple(
@@ -80,6 +128,11 @@ class PhaseIIADCCalibrator : public Tool {
     // is the maximum p-value for which we will reject the null hypothesis
     // of equal variances.
     double p_critical;
+
+    // Critical F values already found by get_f_critical_value().
+    // Key: {number of samples per sub-waveform, p_critical}
+    // Filled in Initialise(), so calibration threads only read it.
+    std::map<std::pair<size_t, double>, double> f_critical_values;
    
     //ze3ra and ze3ra_multi configurables 
     size_t num_baseline_samples;
@@ -91,15 +144,26 @@ class PhaseIIADCCalibrator : public Tool {
 
     bool make_led_waveforms;
     std::string adc_window_db; 
+
+    //Save the calibrated (and LED) waveforms with the ANNIEEvent
+    bool persist_output;
     
     size_t num_waveform_points;
     size_t baseline_start_sample;
     
     int baseline_fit_order;
+    int baseline_refit_passes;
+
+    // Baseline fit projections made so far.
+    // Key: {first sample, last sample, polynomial order}
+    // Entries are never removed, so references to them stay valid.
+    std::map<std::tuple<size_t, size_t, int>, BaselineFitProjection> baseline_fit_projections;
+    std::mutex baseline_fit_mutex;
     bool redo_fit_without_outliers;
     double refit_threshold; // V range of the initial baseline subtracted waveform must be > this to trigger refit
     
-    // ROOT stuff for drawing the fit of the baseline
+    // ROOT stuff for fitting and drawing the fit of the baseline
+    bool use_root_fit=false;
     bool draw_baseline_fit=false;
     TApplication* rootTApp=nullptr;
     TCanvas* baselineFitCanvas=nullptr;
@@ -107,6 +171,44 @@ class PhaseIIADCCalibrator : public Tool {
     TF1* calibrated_waveform_fit=nullptr;
     TH1D* raw_datapoint_hist=nullptr;
     int drawcount=0;
+
+    // Calibration of a single channel's waveforms
+    struct CalibrationJob {
+      unsigned long channel_key;
+      const std::vector< Waveform<unsigned short> >* raw_waveforms;
+      bool is_aux;
+    };
+
+    // Waveforms calibrated by one thread. These are merged into the
+    // ANNIEEvent maps (which are ordered by channel key) once all channels
+    // are done, so the output doesn't depend on the number of threads.
+    struct CalibrationContext {
+      std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > > calibrated_waveforms;
+      std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > > calibrated_auxwaveforms;
+      std::map<unsigned long, std::vector<Waveform<unsigned short> > > raw_led_waveforms;
+      std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > > calibrated_led_waveforms;
+      std::exception_ptr error;  // First exception thrown while calibrating
+    };
+
+    std::vector< CalibratedADCWaveform<double> > make_calibrated_waveforms(
+      const std::vector< Waveform<unsigned short> >& raw_waveforms);
+    void calibrate_channel(const CalibrationJob& job, CalibrationContext& context);
+
+    // Calibration jobs and worker pool. Threads take the next channel
+    // as they finish one; the ToolChain thread calibrates channels too.
+    int num_threads;
+    std::vector<CalibrationContext> calibration_contexts;  // Index 0 is used by the ToolChain thread
+    std::vector<CalibrationJob> calibration_jobs;
+    std::atomic<unsigned int> next_calibration_job;
+    std::vector<std::thread> calibration_workers;
+    std::mutex calibration_mutex;
+    std::condition_variable calibration_start;
+    std::condition_variable calibration_done;
+    unsigned long calibration_generation = 0;  // Incremented each time a batch of jobs is handed to the workers
+    int workers_busy = 0;
+    bool stop_calibration_workers = false;
+    void calibration_worker_loop(int worker_index);
+    void run_calibration_jobs(CalibrationContext& context);
     
     // verbosity levels: if 'verbosity' < this level, the message type will be logged.
     int v_error=0;
@@ -1,6 +1,8 @@
 // ToolAnalysis includes
 #include "PhaseIIADCHitFinder.h"
 
+#include <iterator>
+
 PhaseIIADCHitFinder::PhaseIIADCHitFinder() : Tool() {}
 
 bool PhaseIIADCHitFinder::Initialise(std::string config_filename, DataModel& data) {
@@ -22,6 +24,7 @@ bool PhaseIIADCHitFinder::Initialise(std::string config_filename, DataModel& dat
   pulse_window_start_shift = -3;
   pulse_window_end_shift = 25;
   adc_window_db = "none"; //Used when pulse_finding_approach="fixed_windows"
+  persist_output = false;
 
   //Load any configurables set in the config file
   m_variables.Get("verbosity",verbosity); 
@@ -34,6 +37,10 @@ bool PhaseIIADCHitFinder::Initialise(std::string config_filename, DataModel& dat
   m_variables.Get("PulseWindowStart", pulse_window_start_shift);
   m_variables.Get("PulseWindowEnd", pulse_window_end_shift);
   m_variables.Get("WindowIntegrationDB", adc_window_db); 
+  m_variables.Get("PersistOutput", persist_output);
+  num_threads = 1;
+  m_variables.Get("NumThreads", num_threads);
+  if (num_threads < 1) num_threads = 1;
 
   if ((pulse_window_start_shift > 0) || (pulse_window_end_shift) < 0){
     Log("PhaseIIADCHitFinder Tool: WARNING... trigger threshold crossing will not be inside pulse window.  Threshold" 
@@ -68,6 +75,12 @@ bool PhaseIIADCHitFinder::Initialise(std::string config_filename, DataModel& dat
   hit_map = new std::map<unsigned long,std::vector<Hit>>;
   aux_hit_map = new std::map<unsigned long,std::vector<Hit>>;
 
+  // The ToolChain thread finds pulses too, so num_threads-1 workers are started
+  hit_finding_contexts.resize(num_threads);
+  next_hit_finding_job = 0;
+  for (int i = 1; i < num_threads; ++i) hit_finding_workers.emplace_back(&PhaseIIADCHitFinder::hit_finding_worker_loop, this, i);
+  Log("PhaseIIADCHitFinder Tool: Finding pulses with " + std::to_string(num_threads) + " threads", v_message, verbosity);
+
   return true;
 }
 
@@ -88,96 +101,141 @@ bool PhaseIIADCHitFinder::Execute() {
       return false;
     }
 
-    // Load the maps containing the ADC raw waveform data
-    bool got_raw_data = false;
-    bool got_rawaux_data = false;
+    // Get the maps containing the ADC raw waveform data. These are shared
+    // with the other tools rather than copied.
+    raw_waveform_map = nullptr;
+    raw_aux_waveform_map = nullptr;
     if(use_led_waveforms){
-      got_raw_data = annie_event->Get("RawLEDADCData", raw_waveform_map);
+      raw_waveform_map = ANNIEEventMember::Get<WaveformMap>(annie_event, "RawLEDADCData");
     } else {
-      got_raw_data = annie_event->Get("RawADCData", raw_waveform_map);
-      got_rawaux_data = annie_event->Get("RawADCAuxData", raw_aux_waveform_map);
+      raw_waveform_map = ANNIEEventMember::Get<WaveformMap>(annie_event, "RawADCData");
+      raw_aux_waveform_map = ANNIEEventMember::Get<WaveformMap>(annie_event, "RawADCAuxData");
     }
     // Check for problems
-    if ( !got_raw_data ) {
+    if ( !raw_waveform_map ) {
       Log("Error: The PhaseIIADCHitFinder tool could not find the RawADCData entry", v_error,
         verbosity);
       return false;
     }
-    if ( !got_rawaux_data ) {
+    if ( !raw_aux_waveform_map ) {
       Log("Error: The PhaseIIADCHitFinder tool could not find the RawADCAuxData entry", v_error,
         verbosity);
       return false;
     }
-    else if ( raw_waveform_map.empty() ) {
+    else if ( raw_waveform_map->empty() ) {
       Log("Error: The PhaseIIADCHitFinder tool found an empty RawADCData entry", v_error,
         verbosity);
       return false;
     }
     
-    // Load the maps containing the ADC calibrated waveform data
-    bool got_calibrated_data = false;
-    bool got_calibratedaux_data = false;
+    // Get the maps containing the ADC calibrated waveform data
+    calibrated_waveform_map = nullptr;
+    calibrated_aux_waveform_map = nullptr;
     if(use_led_waveforms){
-      got_calibrated_data = annie_event->Get("CalibratedLEDADCData",
-        calibrated_waveform_map);
+      calibrated_waveform_map = ANNIEEventMember::Get<CalibratedWaveformMap>(annie_event,
+        "CalibratedLEDADCData");
     } else {
-      got_calibrated_data = annie_event->Get("CalibratedADCData",
-        calibrated_waveform_map);
-      got_calibratedaux_data = annie_event->Get("CalibratedADCAuxData", calibrated_aux_waveform_map);
+      calibrated_waveform_map = ANNIEEventMember::Get<CalibratedWaveformMap>(annie_event,
+        "CalibratedADCData");
+      calibrated_aux_waveform_map = ANNIEEventMember::Get<CalibratedWaveformMap>(annie_event,
+        "CalibratedADCAuxData");
     }
 
     // Check for problems
-    if ( !got_calibrated_data ) {
+    if ( !calibrated_waveform_map ) {
       Log("Error: The PhaseIIADCHitFinder tool could not find the CalibratedADCData"
         " entry", v_error, verbosity);
       return false;
     }
-    if ( !got_calibratedaux_data ) {
+    if ( !calibrated_aux_waveform_map ) {
       Log("Error: The PhaseIIADCHitFinder tool could not find the CalibratedADCAuxData"
         " entry", v_error, verbosity);
       return false;
     }
-    else if ( calibrated_waveform_map.empty() ) {
+    else if ( calibrated_waveform_map->empty() ) {
       Log("Error: The PhaseIIADCHitFinder tool found an empty CalibratedADCData entry",
         v_error, verbosity);
       return false;
     }
 
-    //Find pulses in the raw detector data
-    for (const auto& temp_pair : raw_waveform_map) {
+    // One hit finding job per channel
+    hit_finding_jobs.clear();
+    for (const auto& temp_pair : *raw_waveform_map) {
       const auto& achannel_key = temp_pair.first;
       const auto& araw_waveforms = temp_pair.second;
       //Don't make hit objects for any offline channels
       Channel* thischannel = geom->GetChannel(achannel_key);
       if(thischannel->GetStatus() == channelstatus::OFF) continue;
-      std::vector<CalibratedADCWaveform<double> > acalibrated_waveforms = calibrated_waveform_map.at(achannel_key);
-      bool MadeMaps = this->build_pulse_and_hit_map(achannel_key, araw_waveforms, acalibrated_waveforms, pulse_map,*hit_map);
-      if(!MadeMaps){
-        Log("PhaseIIADCHitFinder Error: problem making PMT hit and pulse maps", 0, verbosity);
-        return false;
-      }
+      const auto& acalibrated_waveforms = calibrated_waveform_map->at(achannel_key);
+      hit_finding_jobs.push_back({achannel_key, &araw_waveforms, &acalibrated_waveforms, false});
     }
-    Log("PhaseIIADCHitFinder Tool: setting PMT RecoADCHits in annie event", v_debug, verbosity);
-    annie_event->Set("RecoADCHits", pulse_map);
-    Log("PhaseIIADCHitFinder Tool: setting PMT Hits in annie event", v_debug, verbosity);
-    annie_event->Set("Hits", hit_map,true);
-
-    Log("PhaseIIADCHitFinder Tool: Finding SiPM pulses in auxiliary channels", v_debug, verbosity);
-    //Find pulses in the raw auxiliary channel data
-    for (const auto& temp_pair : raw_aux_waveform_map) {
+    for (const auto& temp_pair : *raw_aux_waveform_map) {
       const auto& achannel_key = temp_pair.first;
       if(AuxChannelNumToTypeMap->at(achannel_key) != "SiPM1" &&
         AuxChannelNumToTypeMap->at(achannel_key) != "SiPM2") continue; 
       const auto& araw_waveforms = temp_pair.second;
-      std::vector<CalibratedADCWaveform<double> > acalibrated_waveforms = calibrated_aux_waveform_map.at(achannel_key);
-      bool MadeAuxMaps = this->build_pulse_and_hit_map(achannel_key, araw_waveforms, acalibrated_waveforms, aux_pulse_map,*aux_hit_map);
-      if(!MadeAuxMaps){
-        Log("PhaseIIADCHitFinder Error: problem making  Aux hit and pulse maps", 0, verbosity);
-        return false;
+      const auto& acalibrated_waveforms = calibrated_aux_waveform_map->at(achannel_key);
+      hit_finding_jobs.push_back({achannel_key, &araw_waveforms, &acalibrated_waveforms, true});
+    }
+
+    //Find pulses in the raw detector and auxiliary channel data, sharing the
+    //channels out with the workers if there are any
+    next_hit_finding_job = 0;
+    if (hit_finding_workers.empty() || hit_finding_jobs.size() < 2) {
+      this->run_hit_finding_jobs(hit_finding_contexts.at(0));
+    } else {
+      {
+        std::lock_guard<std::mutex> lock(hit_finding_mutex);
+        hit_finding_generation += 1;
+        workers_busy = hit_finding_workers.size();
       }
+      hit_finding_start.notify_all();
+      this->run_hit_finding_jobs(hit_finding_contexts.at(0));
+      std::unique_lock<std::mutex> lock(hit_finding_mutex);
+      hit_finding_done.wait(lock, [this]{ return workers_busy == 0; });
+    }
+    hit_finding_jobs.clear();
+
+    // Merge the pulses and hits found by each thread
+    bool MadeMaps = true;
+    bool MadeAuxMaps = true;
+    std::exception_ptr hit_finding_error;
+    for (auto& context : hit_finding_contexts) {
+      pulse_map.insert(std::make_move_iterator(context.pulse_map.begin()),
+        std::make_move_iterator(context.pulse_map.end()));
+      hit_map->insert(std::make_move_iterator(context.hit_map.begin()),
+        std::make_move_iterator(context.hit_map.end()));
+      aux_pulse_map.insert(std::make_move_iterator(context.aux_pulse_map.begin()),
+        std::make_move_iterator(context.aux_pulse_map.end()));
+      aux_hit_map->insert(std::make_move_iterator(context.aux_hit_map.begin()),
+        std::make_move_iterator(context.aux_hit_map.end()));
+      context.pulse_map.clear();
+      context.hit_map.clear();
+      context.aux_pulse_map.clear();
+      context.aux_hit_map.clear();
+      MadeMaps = MadeMaps && context.made_maps;
+      MadeAuxMaps = MadeAuxMaps && context.made_aux_maps;
+      context.made_maps = true;
+      context.made_aux_maps = true;
+      if (context.error && !hit_finding_error) hit_finding_error = context.error;
+      context.error = nullptr;
+    }
+    if (hit_finding_error) std::rethrow_exception(hit_finding_error);
+    if(!MadeMaps){
+      Log("PhaseIIADCHitFinder Error: problem making PMT hit and pulse maps", 0, verbosity);
+      return false;
+    }
+    Log("PhaseIIADCHitFinder Tool: setting PMT RecoADCHits in annie event", v_debug, verbosity);
+    ANNIEEventMember::Publish(annie_event, "RecoADCHits", std::move(pulse_map), persist_output);
+    Log("PhaseIIADCHitFinder Tool: setting PMT Hits in annie event", v_debug, verbosity);
+    annie_event->Set("Hits", hit_map,true);
+
+    if(!MadeAuxMaps){
+      Log("PhaseIIADCHitFinder Error: problem making  Aux hit and pulse maps", 0, verbosity);
+      return false;
     }
     Log("PhaseIIADCHitFinder Tool: setting RecoADCAuxHits in annie event", v_debug, verbosity);
-    annie_event->Set("RecoADCAuxHits", aux_pulse_map);
+    ANNIEEventMember::Publish(annie_event, "RecoADCAuxHits", std::move(aux_pulse_map), persist_output);
     Log("PhaseIIADCHitFinder Tool: setting AuxHits in annie event", v_debug, verbosity);
     annie_event->Set("AuxHits", aux_hit_map,true);
     return true;
@@ -191,9 +249,58 @@ bool PhaseIIADCHitFinder::Execute() {
 
 
 bool PhaseIIADCHitFinder::Finalise() {
+  {
+    std::lock_guard<std::mutex> lock(hit_finding_mutex);
+    stop_hit_finding_workers = true;
+  }
+  hit_finding_start.notify_all();
+  for (auto& worker : hit_finding_workers) worker.join();
+  hit_finding_workers.clear();
   return true;
 }
 
+void PhaseIIADCHitFinder::run_hit_finding_jobs(HitFindingContext& context)
+{
+  // Take channels until none are left. Exceptions are kept for the
+  // ToolChain thread to rethrow once all threads are done.
+  for (unsigned int job = next_hit_finding_job++; job < hit_finding_jobs.size(); job = next_hit_finding_job++) {
+    const HitFindingJob& Job = hit_finding_jobs[job];
+    try {
+      if (Job.is_aux) {
+        bool MadeAuxMaps = this->build_pulse_and_hit_map(Job.channel_key, *Job.raw_waveforms,
+          *Job.calibrated_waveforms, context.aux_pulse_map, context.aux_hit_map);
+        if (!MadeAuxMaps) context.made_aux_maps = false;
+      } else {
+        bool MadeMaps = this->build_pulse_and_hit_map(Job.channel_key, *Job.raw_waveforms,
+          *Job.calibrated_waveforms, context.pulse_map, context.hit_map);
+        if (!MadeMaps) context.made_maps = false;
+      }
+    }
+    catch (...) {
+      if (!context.error) context.error = std::current_exception();
+    }
+  }
+}
+
+void PhaseIIADCHitFinder::hit_finding_worker_loop(int worker_index)
+{
+  unsigned long last_generation = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(hit_finding_mutex);
+      hit_finding_start.wait(lock, [this, last_generation]{ return stop_hit_finding_workers || hit_finding_generation != last_generation; });
+      if (stop_hit_finding_workers) return;
+      last_generation = hit_finding_generation;
+    }
+    this->run_hit_finding_jobs(hit_finding_contexts.at(worker_index));
+    {
+      std::lock_guard<std::mutex> lock(hit_finding_mutex);
+      workers_busy -= 1;
+    }
+    hit_finding_done.notify_one();
+  }
+}
+
    
 
 unsigned short PhaseIIADCHitFinder::get_db_threshold(unsigned long channelkey){
@@ -286,8 +393,8 @@ std::map<unsigned long, std::vector<std::vector<int>>> PhaseIIADCHitFinder::load
 
 bool PhaseIIADCHitFinder::build_pulse_and_hit_map(
   unsigned long channel_key,
-  std::vector<Waveform<unsigned short> > raw_waveforms, 
-  std::vector<CalibratedADCWaveform<double> > calibrated_waveforms,
+  const std::vector<Waveform<unsigned short> >& raw_waveforms,
+  const std::vector<CalibratedADCWaveform<double> >& calibrated_waveforms,
   std::map<unsigned long, std::vector< std::vector<ADCPulse>> > & pmap,
   std::map<unsigned long,std::vector<Hit>>& hmap)
 {
@@ -310,8 +417,7 @@ bool PhaseIIADCHitFinder::build_pulse_and_hit_map(
     // Integrate each whole dang minibuffer and background subtract 
     size_t num_minibuffers = raw_waveforms.size();
     for (size_t mb = 0; mb < num_minibuffers; ++mb) {
-        Waveform<unsigned short> buffer_wave = raw_waveforms.at(mb);
-        int window_end = buffer_wave.GetSamples()->size()-1;
+        int window_end = raw_waveforms.at(mb).Samples().size()-1;
         std::vector<int> fullwindow{0,window_end};
         std::vector<std::vector<int>> onewindowvec{fullwindow};
         pulse_vec.push_back(this->find_pulses_bywindow(raw_waveforms.at(mb),
@@ -323,8 +429,7 @@ bool PhaseIIADCHitFinder::build_pulse_and_hit_map(
     // Integrate each whole dang minibuffer and background subtract 
     size_t num_minibuffers = raw_waveforms.size();
     for (size_t mb = 0; mb < num_minibuffers; ++mb) {
-        Waveform<unsigned short> buffer_wave = raw_waveforms.at(mb);
-        int window_end = buffer_wave.GetSamples()->size()-1;
+        int window_end = raw_waveforms.at(mb).Samples().size()-1;
         std::vector<int> fullwindow{0,window_end};
         std::vector<std::vector<int>> onewindowvec{fullwindow};
         pulse_vec.push_back(this->find_pulses_bywindow(raw_waveforms.at(mb),
@@ -382,10 +487,9 @@ bool PhaseIIADCHitFinder::build_pulse_and_hit_map(
   HitsOnPMT = this->convert_adcpulses_to_hits(channel_key,pulse_vec);
   Log("PhaseIIADCHitFinder: Filling hit map.",
       v_debug, verbosity);
-  for(int j=0; j < HitsOnPMT.size(); j++){
-    Hit ahit = HitsOnPMT.at(j);
-    if(hmap.count(channel_key)==0) hmap.emplace(channel_key, std::vector<Hit>{ahit});
-    else hmap.at(channel_key).push_back(ahit);
+  if(!HitsOnPMT.empty()){
+    std::vector<Hit>& channel_hits = hmap[channel_key];
+    channel_hits.insert(channel_hits.end(), HitsOnPMT.begin(), HitsOnPMT.end());
   }
   return true;
 }
@@ -393,7 +497,7 @@ bool PhaseIIADCHitFinder::build_pulse_and_hit_map(
 std::vector<ADCPulse> PhaseIIADCHitFinder::find_pulses_bywindow(
   const Waveform<unsigned short>& raw_minibuffer_data,
   const CalibratedADCWaveform<double>& calibrated_minibuffer_data,
-  std::vector<std::vector<int>> adc_windows, const unsigned long& channel_key,
+  const std::vector<std::vector<int>>& adc_windows, const unsigned long& channel_key,
   bool MaxHeightPulseOnly) const
 {
   //Sanity check that raw/calibrated minibuffers are same size
@@ -415,7 +519,7 @@ std::vector<ADCPulse> PhaseIIADCHitFinder::find_pulses_bywindow(
     // Integrate the pulse to get its area. Use a Riemann sum. Also get
     // the raw amplitude (maximum ADC value within the pulse) and the
     // sample at which the peak occurs.
-    std::vector<int> awindow = adc_windows.at(i);
+    const std::vector<int>& awindow = adc_windows.at(i);
     size_t wmin = static_cast<size_t>(awindow.at(0));
     size_t wmax = static_cast<size_t>(awindow.at(1));
     unsigned short max_ADC = std::numeric_limits<unsigned short>::lowest();
@@ -489,6 +593,49 @@ std::vector<ADCPulse> PhaseIIADCHitFinder::find_pulses_bywindow(
 }
 
 
+namespace {
+  // Index of the first sample in [begin, end) above (or, with below=true,
+  // under) threshold, or end if there is none. The samples are tested in
+  // blocks without an early exit, which the compiler can vectorise.
+  template<bool below> size_t find_crossing(const unsigned short* data,
+    size_t begin, size_t end, unsigned short threshold)
+  {
+    const size_t block = 16;
+    size_t s = begin;
+    for (; s + block <= end; s += block) {
+      bool crossed = false;
+      for (size_t i = 0; i < block; ++i) {
+        crossed |= below ? (data[s+i] < threshold) : (data[s+i] > threshold);
+      }
+      if (crossed) break;
+    }
+    for (; s < end; ++s) {
+      if (below ? (data[s] < threshold) : (data[s] > threshold)) return s;
+    }
+    return end;
+  }
+
+  // Raw area, maximum and peak sample of raw samples [first, last], plus the
+  // integral of the calibrated samples, in a single pass over the window.
+  void integrate_window(const unsigned short* raw, const double* calibrated,
+    size_t first, size_t last, unsigned long& raw_area, unsigned short& max_ADC,
+    size_t& peak_sample, double& calibrated_sum)
+  {
+    raw_area = 0;
+    max_ADC = std::numeric_limits<unsigned short>::lowest();
+    peak_sample = BOGUS_INT;
+    calibrated_sum = 0.;
+    for (size_t p = first; p <= last; ++p) {
+      raw_area += raw[p];
+      calibrated_sum += calibrated[p];
+      if (max_ADC < raw[p]) {
+        max_ADC = raw[p];
+        peak_sample = p;
+      }
+    }
+  }
+}
+
 std::vector<ADCPulse> PhaseIIADCHitFinder::find_pulses_bythreshold(
   const Waveform<unsigned short>& raw_minibuffer_data,
   const CalibratedADCWaveform<double>& calibrated_minibuffer_data,
@@ -513,8 +660,12 @@ std::vector<ADCPulse> PhaseIIADCHitFinder::find_pulses_bythreshold(
     std::round( calibrated_minibuffer_data.GetBaseline()
       + calibrated_minibuffer_data.GetSigmaBaseline() ));
 
-  bool in_pulse = false;
-  size_t num_samples = raw_minibuffer_data.Samples().size()-50;
+  // The last 50 samples are not searched
+  const std::vector<unsigned short>& raw_samples = raw_minibuffer_data.Samples();
+  const std::vector<double>& calibrated_samples = calibrated_minibuffer_data.Samples();
+  size_t num_samples = (raw_samples.size() > 50) ? raw_samples.size()-50 : 0;
+  const unsigned short* raw = raw_samples.data();
+  const double* calibrated = calibrated_samples.data();
 
   //Fixed integration window defined relative to ADC threshold crossings
   if(pulse_window_type == "fixed"){
@@ -522,21 +673,24 @@ std::vector<ADCPulse> PhaseIIADCHitFinder::find_pulses_bythreshold(
     std::vector<int> window_starts;
     std::vector<int> window_ends;
 
-    //First, we form a list of pulse starts and ends
-    for (size_t s = 0; s < num_samples; ++s) {
-      in_pulse = false;
-      //check if sample is within an already defined window
-      for (int i=0; i< window_starts.size(); i++){
-        if ((s>window_starts.at(i)) && (s<window_ends.at(i))){
-          in_pulse = true;
-          if(verbosity>4) std::cout << "PhaseIIADCHitFinder: FOUND PULSE" << std::endl;
-        }
-      }  
-      //if sample crosses threshold and isn't in a defined window, define a new window
-        if (!in_pulse && (raw_minibuffer_data.GetSample(s) > adc_threshold) ) {
-          window_starts.push_back(static_cast<int>(s) + pulse_window_start_shift);
-          window_ends.push_back(static_cast<int>(s) + pulse_window_end_shift);
-        }
+    //First, we form a list of pulse starts and ends in one pass over the
+    //samples. A sample crossing threshold opens a new window unless it is
+    //inside (not on the edge of) an earlier one. Windows are made in order
+    //of their crossing sample, so only the latest window starting before
+    //this sample can contain it; next_window counts the windows starting
+    //before the current sample.
+    size_t next_window = 0;
+    for (size_t s = find_crossing<false>(raw, 0, num_samples, adc_threshold);
+         s < num_samples; s = find_crossing<false>(raw, s+1, num_samples, adc_threshold)) {
+      while (next_window < window_starts.size() && window_starts[next_window] < static_cast<int>(s)) ++next_window;
+      bool in_pulse = (next_window > 0 && static_cast<int>(s) < window_ends[next_window-1]);
+      if (in_pulse) {
+        if(verbosity>4) std::cout << "PhaseIIADCHitFinder: FOUND PULSE" << std::endl;
+        continue;
+      }
+      //sample crosses threshold and isn't in a defined window, define a new window
+      window_starts.push_back(static_cast<int>(s) + pulse_window_start_shift);
+      window_ends.push_back(static_cast<int>(s) + pulse_window_end_shift);
     }
     //If any pulse crosses the sampling window, restrict it's value to within window
     for (int j=0; j<window_starts.size(); j++){
@@ -546,32 +700,23 @@ std::vector<ADCPulse> PhaseIIADCHitFinder::find_pulses_bythreshold(
     // Integrate the pulse to get its area. Use a Riemann sum. Also get
     // the raw amplitude (maximum ADC value within the pulse) and the
     // sample at which the peak occurs.
+    pulses.reserve(window_starts.size());
     for (int i = 0; i< window_starts.size(); i++){
       size_t pulse_start_sample = static_cast<size_t>(window_starts.at(i));
       size_t pulse_end_sample = static_cast<size_t>(window_ends.at(i));
-      unsigned long raw_area = 0; // ADC * samples
-      unsigned short max_ADC = std::numeric_limits<unsigned short>::lowest();
-      size_t peak_sample = BOGUS_INT;
-      for (size_t p = pulse_start_sample; p <= pulse_end_sample; ++p) {
-        raw_area += raw_minibuffer_data.GetSample(p);
-        if (max_ADC < raw_minibuffer_data.GetSample(p)) {
-          max_ADC = raw_minibuffer_data.GetSample(p);
-          peak_sample = p;
-        }
-      }
+      unsigned long raw_area; // ADC * samples
+      unsigned short max_ADC;
+      size_t peak_sample;
+      // Calculated the charge detected in this pulse (nC)
+      // using the calibrated waveform (integral in V * samples)
+      double charge;
+      integrate_window(raw, calibrated, pulse_start_sample, pulse_end_sample,
+        raw_area, max_ADC, peak_sample, charge);
 
       // The amplitude of the pulse (V)
       double calibrated_amplitude
         = calibrated_minibuffer_data.GetSample(peak_sample);
 
-      // Calculated the charge detected in this pulse (nC)
-      // using the calibrated waveform
-      double charge = 0.;
-      // Integrate the calibrated pulse (to get a quantity in V * samples)
-      for (size_t p = pulse_start_sample; p <= pulse_end_sample; ++p) {
-        charge += calibrated_minibuffer_data.GetSample(p);
-      }
-
       // Convert the pulse integral to nC
       charge *= NS_PER_ADC_SAMPLE / ADC_IMPEDANCE;
 
@@ -588,64 +733,51 @@ std::vector<ADCPulse> PhaseIIADCHitFinder::find_pulses_bythreshold(
   } else if(pulse_window_type == "dynamic"){
     size_t pulse_start_sample = BOGUS_INT;
     size_t pulse_end_sample = BOGUS_INT;
-    for (size_t s = 0; s < num_samples; ++s) {
-      if ( !in_pulse && raw_minibuffer_data.GetSample(s) > adc_threshold ) {
-        in_pulse = true;
-        if(verbosity>4) std::cout << "PhaseIIADCHitFinder: FOUND PULSE" << std::endl;
-        if(static_cast<int>(s)-5 < 0) {
-          pulse_start_sample = 0;
-        } else {
-          pulse_start_sample = s-5;
-        }
+    size_t s = find_crossing<false>(raw, 0, num_samples, adc_threshold);
+    while (s < num_samples) {
+      if(verbosity>4) std::cout << "PhaseIIADCHitFinder: FOUND PULSE" << std::endl;
+      if(static_cast<int>(s)-5 < 0) {
+        pulse_start_sample = 0;
+      } else {
+        pulse_start_sample = s-5;
       }
-      // In the second test below, we force a pulse to end if we reach the end of
-      // the minibuffer.
-      else if ( in_pulse && ((raw_minibuffer_data.GetSample(s)
-        < baseline_plus_one_sigma) || (s == num_samples - 1)) )
-      {
-        in_pulse = false;
-        pulse_end_sample = s;
-        
-        // Integrate the pulse to get its area. Use a Riemann sum. Also get
-        // the raw amplitude (maximum ADC value within the pulse) and the
-        // sample at which the peak occurs.
-        unsigned long raw_area = 0; // ADC * samples
-        unsigned short max_ADC = std::numeric_limits<unsigned short>::lowest();
-        size_t peak_sample = BOGUS_INT;
-        for (size_t p = pulse_start_sample; p <= pulse_end_sample; ++p) {
-          raw_area += raw_minibuffer_data.GetSample(p);
-          if (max_ADC < raw_minibuffer_data.GetSample(p)) {
-            max_ADC = raw_minibuffer_data.GetSample(p);
-            peak_sample = p;
-          }
-        }
-        // The amplitude of the pulse (V)
-        double calibrated_amplitude
-          = calibrated_minibuffer_data.GetSample(peak_sample);
-
-        // Calculated the charge detected in this pulse (nC)
-        // using the calibrated waveform
-        double charge = 0.;
-        // Integrate the calibrated pulse (to get a quantity in V * samples)
-        for (size_t p = pulse_start_sample; p <= pulse_end_sample; ++p) {
-          charge += calibrated_minibuffer_data.GetSample(p);
-        }
+      // The pulse ends at the next sample below baseline + 1 sigma. We force
+      // a pulse to end if we reach the end of the minibuffer.
+      if (s + 1 >= num_samples) break;
+      pulse_end_sample = find_crossing<true>(raw, s+1, num_samples-1, baseline_plus_one_sigma);
+
+      // Integrate the pulse to get its area. Use a Riemann sum. Also get
+      // the raw amplitude (maximum ADC value within the pulse) and the
+      // sample at which the peak occurs.
+      unsigned long raw_area; // ADC * samples
+      unsigned short max_ADC;
+      size_t peak_sample;
+      // Calculated the charge detected in this pulse (nC)
+      // using the calibrated waveform (integral in V * samples)
+      double charge;
+      integrate_window(raw, calibrated, pulse_start_sample, pulse_end_sample,
+        raw_area, max_ADC, peak_sample, charge);
 
-        // Convert the pulse integral to nC
-        // FIXME: We need a static database with each PMT's impedance
-        charge *= NS_PER_ADC_SAMPLE / ADC_IMPEDANCE;
-        // TODO: consider adding code to merge pulses if they occur
-        // very close together (i.e. if the end of one is just a few samples away
-        // from the start of another)
-
-        // Store the freshly made pulse in the vector of found pulses
-        pulses.emplace_back(channel_key,
-          ( pulse_start_sample * NS_PER_ADC_SAMPLE ),
-          peak_sample * NS_PER_ADC_SAMPLE,
-          calibrated_minibuffer_data.GetBaseline(),
-          calibrated_minibuffer_data.GetSigmaBaseline(),
-          raw_area, max_ADC, calibrated_amplitude, charge);
-      }
+      // The amplitude of the pulse (V)
+      double calibrated_amplitude
+        = calibrated_minibuffer_data.GetSample(peak_sample);
+
+      // Convert the pulse integral to nC
+      // FIXME: We need a static database with each PMT's impedance
+      charge *= NS_PER_ADC_SAMPLE / ADC_IMPEDANCE;
+      // TODO: consider adding code to merge pulses if they occur
+      // very close together (i.e. if the end of one is just a few samples away
+      // from the start of another)
+
+      // Store the freshly made pulse in the vector of found pulses
+      pulses.emplace_back(channel_key,
+        ( pulse_start_sample * NS_PER_ADC_SAMPLE ),
+        peak_sample * NS_PER_ADC_SAMPLE,
+        calibrated_minibuffer_data.GetBaseline(),
+        calibrated_minibuffer_data.GetSigmaBaseline(),
+        raw_area, max_ADC, calibrated_amplitude, charge);
+
+      s = find_crossing<false>(raw, pulse_end_sample+1, num_samples, adc_threshold);
     }
   } else {
     if(verbosity > v_error){
@@ -656,12 +788,12 @@ std::vector<ADCPulse> PhaseIIADCHitFinder::find_pulses_bythreshold(
   return pulses;
 }
 
-std::vector<Hit> PhaseIIADCHitFinder::convert_adcpulses_to_hits(unsigned long channel_key,std::vector<std::vector<ADCPulse>> pulses){
+std::vector<Hit> PhaseIIADCHitFinder::convert_adcpulses_to_hits(unsigned long channel_key,const std::vector<std::vector<ADCPulse>>& pulses){
   std::vector<Hit> thispmt_hits;
   for(int i=0; i < pulses.size(); i++){
-    std::vector<ADCPulse> apulsevector = pulses.at(i);
+    const std::vector<ADCPulse>& apulsevector = pulses.at(i);
     for(int j=0; j < apulsevector.size(); j++){
-      ADCPulse apulse = apulsevector.at(j);
+      const ADCPulse& apulse = apulsevector.at(j);
       //Get the time and charge
       double time = apulse.peak_time();
       double charge = apulse.charge();
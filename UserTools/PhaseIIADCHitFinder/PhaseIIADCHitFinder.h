@@ -13,6 +13,11 @@
 #include <cmath>
 #include <limits>
 #include <stdexcept>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
 
 // ToolAnalysis includes
 #include "ADCPulse.h"
@@ -25,6 +30,7 @@
 #include "Waveform.h"
 #include "Constants.h"
 #include "Channel.h"
+#include "ANNIEEventMember.h"
 #include <boost/algorithm/string.hpp>
 
 class PhaseIIADCHitFinder : public Tool {
@@ -54,6 +60,7 @@ class PhaseIIADCHitFinder : public Tool {
     std::string adc_window_db;
     std::string pulse_window_type;
     bool use_led_waveforms;
+    bool persist_output;  //Save RecoADCHits and RecoADCAuxHits with the ANNIEEvent
     int pulse_window_start_shift;
     int pulse_window_end_shift;
     std::map<unsigned long, unsigned short> channel_threshold_map;
@@ -62,15 +69,15 @@ class PhaseIIADCHitFinder : public Tool {
    
     std::map<int,std::string>* AuxChannelNumToTypeMap;
 
-     // Load the map containing the ADC calibrated waveform data
-    std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > >
-      calibrated_waveform_map;
-    std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > >
-      calibrated_aux_waveform_map;
-    std::map<unsigned long, std::vector<Waveform<unsigned short> > >
-      raw_waveform_map;
-    std::map<unsigned long, std::vector<Waveform<unsigned short> > >
-      raw_aux_waveform_map;
+    typedef std::map<unsigned long, std::vector<Waveform<unsigned short> > > WaveformMap;
+    typedef std::map<unsigned long, std::vector<CalibratedADCWaveform<double> > > CalibratedWaveformMap;
+
+    // The ADC raw and calibrated waveform data of the current event, owned
+    // by the ANNIEEvent store
+    const CalibratedWaveformMap* calibrated_waveform_map = nullptr;
+    const CalibratedWaveformMap* calibrated_aux_waveform_map = nullptr;
+    const WaveformMap* raw_waveform_map = nullptr;
+    const WaveformMap* raw_aux_waveform_map = nullptr;
     
     // Build the map of pulses and Hit Map
     std::map<unsigned long, std::vector< std::vector<ADCPulse>> > pulse_map;
@@ -93,8 +100,8 @@ class PhaseIIADCHitFinder : public Tool {
 
     void ClearMaps();
     bool build_pulse_and_hit_map(unsigned long ckey,
-       std::vector<Waveform<unsigned short> > rawmap, 
-      std::vector<CalibratedADCWaveform<double> > calmap,
+      const std::vector<Waveform<unsigned short> >& rawmap,
+      const std::vector<CalibratedADCWaveform<double> >& calmap,
       std::map<unsigned long, std::vector< std::vector<ADCPulse>> > & pmap,
       std::map<unsigned long,std::vector<Hit>>& hmap);
     // Create a vector of ADCPulse objects using the raw and calibrated signals
@@ -109,11 +116,48 @@ class PhaseIIADCHitFinder : public Tool {
     std::vector<ADCPulse> find_pulses_bywindow(
       const Waveform<unsigned short>& raw_minibuffer_data,
       const CalibratedADCWaveform<double>& calibrated_minibuffer_data,
-      std::vector<std::vector<int>> adc_windows, const unsigned long& channel_key,
+      const std::vector<std::vector<int>>& adc_windows, const unsigned long& channel_key,
       bool MaxHeightPulseOnly) const;
 
     //Takes the ADC pulse vectors (one per minibuffer) and converts them to a vector of hits
-    std::vector<Hit> convert_adcpulses_to_hits(unsigned long channel_key,std::vector<std::vector<ADCPulse>> pulses);
+    std::vector<Hit> convert_adcpulses_to_hits(unsigned long channel_key,const std::vector<std::vector<ADCPulse>>& pulses);
+
+    // Pulse finding on a single channel's waveforms
+    struct HitFindingJob {
+      unsigned long channel_key;
+      const std::vector<Waveform<unsigned short> >* raw_waveforms;
+      const std::vector<CalibratedADCWaveform<double> >* calibrated_waveforms;
+      bool is_aux;
+    };
+
+    // Pulses and hits found by one thread. These are merged into the
+    // ANNIEEvent maps (which are ordered by channel key) once all channels
+    // are done, so the output doesn't depend on the number of threads.
+    struct HitFindingContext {
+      std::map<unsigned long, std::vector< std::vector<ADCPulse>> > pulse_map;
+      std::map<unsigned long,std::vector<Hit>> hit_map;
+      std::map<unsigned long, std::vector< std::vector<ADCPulse>> > aux_pulse_map;
+      std::map<unsigned long,std::vector<Hit>> aux_hit_map;
+      bool made_maps = true;
+      bool made_aux_maps = true;
+      std::exception_ptr error;  // First exception thrown while finding pulses
+    };
+
+    // Hit finding jobs and worker pool. Threads take the next channel
+    // as they finish one; the ToolChain thread finds pulses too.
+    int num_threads;
+    std::vector<HitFindingContext> hit_finding_contexts;  // Index 0 is used by the ToolChain thread
+    std::vector<HitFindingJob> hit_finding_jobs;
+    std::atomic<unsigned int> next_hit_finding_job;
+    std::vector<std::thread> hit_finding_workers;
+    std::mutex hit_finding_mutex;
+    std::condition_variable hit_finding_start;
+    std::condition_variable hit_finding_done;
+    unsigned long hit_finding_generation = 0;  // Incremented each time a batch of jobs is handed to the workers
+    int workers_busy = 0;
+    bool stop_hit_finding_workers = false;
+    void hit_finding_worker_loop(int worker_index);
+    void run_hit_finding_jobs(HitFindingContext& context);
 
 };
 
@@ -684,11 +684,11 @@ void PhaseIITreeMaker::LoadTankClusterHits(std::vector<Hit> cluster_hits){
 
 
 void PhaseIITreeMaker::LoadSiPMHits() {
-  std::map<unsigned long, std::vector< std::vector<ADCPulse>> > aux_pulse_map;
-  m_data->Stores.at("ANNIEEvent")->Get("RecoADCAuxHits", aux_pulse_map);
+  const auto* aux_pulse_map = ANNIEEventMember::Get<std::map<unsigned long, std::vector< std::vector<ADCPulse>> > >(m_data->Stores.at("ANNIEEvent"), "RecoADCAuxHits");
   fSiPM1NPulses = 0;
   fSiPM2NPulses = 0;
-  for (const auto& temp_pair : aux_pulse_map) {
+  if (!aux_pulse_map) return;
+  for (const auto& temp_pair : *aux_pulse_map) {
     const auto& channel_key = temp_pair.first;
     //For now, only calibrate the SiPM waveforms
     int sipm_number = -1;
@@ -698,10 +698,10 @@ void PhaseIITreeMaker::LoadSiPMHits() {
       sipm_number = 2;
     } else continue;
 
-    std::vector< std::vector<ADCPulse>> sipm_minibuffers = temp_pair.second;
+    const std::vector< std::vector<ADCPulse>>& sipm_minibuffers = temp_pair.second;
     size_t num_minibuffers = sipm_minibuffers.size();  //Should be size 1 in FrankDAQ mode
     for (size_t mb = 0; mb < num_minibuffers; ++mb) {
-      std::vector<ADCPulse> thisbuffer_pulses = sipm_minibuffers.at(mb);
+      const std::vector<ADCPulse>& thisbuffer_pulses = sipm_minibuffers.at(mb);
       if(sipm_number == 1) fSiPM1NPulses += thisbuffer_pulses.size();
       if(sipm_number == 2) fSiPM2NPulses += thisbuffer_pulses.size();
       for (size_t i = 0; i < thisbuffer_pulses.size(); i++){
@@ -768,22 +768,22 @@ int PhaseIITreeMaker::LoadMRDTrackReco(int SubEventID) {
   
   int NumClusterTracks = 0;
   for(int tracki=0; tracki<numtracksinev; tracki++){
-    BoostStore* thisTrackAsBoostStore = &(theMrdTracks->at(tracki));
+    const MrdTrack& thisTrack = theMrdTracks->at(tracki);
     int TrackEventID = -1; 
     //get track properties that are needed for the through-going muon selection
-	thisTrackAsBoostStore->Get("MrdSubEventID",TrackEventID);
+	TrackEventID = thisTrack.MrdSubEventID;
     if(TrackEventID!= SubEventID) continue;
  
 
     //If we're here, this track is associated with this cluster
-    thisTrackAsBoostStore->Get("StartVertex",StartVertex);
-    thisTrackAsBoostStore->Get("StopVertex",StopVertex);
-    thisTrackAsBoostStore->Get("TrackAngle",TrackAngle);
-    thisTrackAsBoostStore->Get("TrackAngleError",TrackAngleError);
-    thisTrackAsBoostStore->Get("PenetrationDepth",PenetrationDepth);
-    thisTrackAsBoostStore->Get("MrdEntryPoint",MrdEntryPoint);
-    thisTrackAsBoostStore->Get("EnergyLoss",EnergyLoss);
-    thisTrackAsBoostStore->Get("EnergyLossError",EnergyLossError);
+    StartVertex = thisTrack.StartVertex;
+    StopVertex = thisTrack.StopVertex;
+    TrackAngle = thisTrack.TrackAngle;
+    TrackAngleError = thisTrack.TrackAngleError;
+    PenetrationDepth = thisTrack.PenetrationDepth;
+    MrdEntryPoint = thisTrack.MrdEntryPoint;
+    EnergyLoss = thisTrack.EnergyLoss;
+    EnergyLossError = thisTrack.EnergyLossError;
     TrackLength = sqrt(pow((StopVertex.X()-StartVertex.X()),2)+pow(StopVertex.Y()-StartVertex.Y(),2)+pow(StopVertex.Z()-StartVertex.Z(),2)) * 100.0;
     EntryPointRadius = sqrt(pow(MrdEntryPoint.X(),2) + pow(MrdEntryPoint.Y(),2)) * 100.0; // convert to cm
     PenetrationDepth = PenetrationDepth*100.0;
@@ -17,6 +17,7 @@
 #include "Waveform.h"
 #include "CalibratedADCWaveform.h"
 #include "Hit.h"
+#include "ANNIEEventMember.h"
 #include "RecoDigit.h"
 #include "ANNIEalgorithms.h"
 #include "TimeClass.h"
@@ -139,7 +140,7 @@ class PhaseIITreeMaker: public Tool {
  
   // ************ Muon reconstruction level information ******** //
   std::string MRDTriggertype;
-  std::vector<BoostStore>* theMrdTracks;   // the reconstructed tracks
+  std::vector<MrdTrack>* theMrdTracks;   // the reconstructed tracks
   int numtracksinev;
   std::vector<double> fMRDTrackAngle;
   std::vector<double> fMRDTrackAngleError;
@@ -4,6 +4,7 @@
 // ToolAnalysis includes
 #include "ADCPulse.h"
 #include "ANNIEconstants.h"
+#include "ANNIEEventMember.h"
 #include "BeamStatus.h"
 #include "BoostStore.h"
 #include "HeftyInfo.h"
@@ -229,10 +230,17 @@ bool PhaseITreeMaker::Execute() {
   // reference to update it as we analyze the current ANNIEEvent
   auto& pos_info = ncv_position_info_.at(ncv_position_);
 
-  // Load the reconstructed ADC hits
-  std::map<unsigned long, std::vector< std::vector<ADCPulse> > > adc_hits;
-
-  get_object_from_store("RecoADCHits", adc_hits, *annie_event);
+  // Load the reconstructed ADC hits (shared with the tool that found them)
+  typedef std::map<unsigned long, std::vector< std::vector<ADCPulse> > >
+    ADCHitMap;
+  const ADCHitMap no_adc_hits;
+  const auto* shared_adc_hits = ANNIEEventMember::Get<ADCHitMap>(annie_event,
+    "RecoADCHits");
+  if ( !shared_adc_hits ) {
+    Log("Error: The PhaseITreeMaker tool could not find the RecoADCHits"
+      " entry", 0, verbosity_);
+  }
+  const auto& adc_hits = shared_adc_hits ? *shared_adc_hits : no_adc_hits;
   check_that_not_empty("RecoADCHits", adc_hits);
 
   int old_spill_number = spill_number_;
@@ -81,9 +81,9 @@ bool PrintADCData::Execute(){
   m_data->Stores["ANNIEEvent"]->Header->Get("TotalEntries",totalentries);
   if(verbosity>3) std::cout << "PrintADCData: Number of ANNIEEvent entries: " << totalentries << std::endl;
   if(verbosity>3) std::cout << "PrintADCData: looping through entries" << std::endl;
-  if(use_led_waveforms) m_data->Stores["ANNIEEvent"]->Get("RawLEDADCData",RawADCData);
-  else m_data->Stores["ANNIEEvent"]->Get("RawADCData",RawADCData);
-  m_data->Stores["ANNIEEvent"]->Get("RawADCAuxData",RawADCAuxData);
+  if(use_led_waveforms) RawADCData = ANNIEEventMember::Get<WaveformMap>(m_data->Stores["ANNIEEvent"],"RawLEDADCData");
+  else RawADCData = ANNIEEventMember::Get<WaveformMap>(m_data->Stores["ANNIEEvent"],"RawADCData");
+  RawADCAuxData = ANNIEEventMember::Get<WaveformMap>(m_data->Stores["ANNIEEvent"],"RawADCAuxData");
   m_data->Stores["ANNIEEvent"]->Get("RunNumber",RunNum);
   m_data->Stores["ANNIEEvent"]->Get("SubrunNumber",SubrunNum);
   if (CurrentRun == -1){
@@ -96,27 +96,27 @@ bool PrintADCData::Execute(){
     this->ClearOccupancyInfo();
   }
   
-  if(verbosity>2) std::cout << "Num. of PMT signals for entry: " << RawADCData.size() << std::endl;
-  auto get_pulses = m_data->Stores["ANNIEEvent"]->Get("RecoADCHits",RecoADCHits);
-  if(!get_pulses){
+  if(verbosity>2) std::cout << "Num. of PMT signals for entry: " << (RawADCData ? RawADCData->size() : 0) << std::endl;
+  RecoADCHits = ANNIEEventMember::Get<std::map<unsigned long, std::vector< std::vector<ADCPulse>> > >(m_data->Stores["ANNIEEvent"],"RecoADCHits");
+  if(!RecoADCHits){
   	Log("PrintADCData Tool: No reconstructed pulses! Did you run the ADCHitFinder first?",v_error,verbosity); 
   	return false;
   };
 
   //Print out the raw ADC waveforms to the opened ROOT file
-  if ( RawADCData.empty() ) {
+  if ( !RawADCData || RawADCData->empty() ) {
     Log("PrintADCData Error: Found an empty RawADCData entry in event", 0,
       verbosity);
   }
   else {
-    this->PrintInfoInData(RawADCData,false);
+    this->PrintInfoInData(*RawADCData,false);
   }
-  if ( RawADCAuxData.empty() ) {
+  if ( !RawADCAuxData || RawADCAuxData->empty() ) {
     Log("PrintADCData Error: Found an empty RawADCData entry in event", 0,
       verbosity);
   }
   else {
-    this->PrintInfoInData(RawADCAuxData,true);
+    this->PrintInfoInData(*RawADCAuxData,true);
   }
   return true;
 }
@@ -133,7 +133,7 @@ bool PrintADCData::Finalise(){
 }
 
 
-void PrintADCData::PrintInfoInData(std::map<unsigned long, std::vector<Waveform<uint16_t>> > RawADCData,
+void PrintADCData::PrintInfoInData(const std::map<unsigned long, std::vector<Waveform<uint16_t>> >& RawADCData,
         bool isAuxData)
 {
   for (const auto& temp_pair : RawADCData) {
@@ -141,9 +141,9 @@ void PrintADCData::PrintInfoInData(std::map<unsigned long, std::vector<Waveform<
     if(verbosity>4) std::cout << "Loading pulse information for channel key " << channel_key << std::endl;
     
     //If working with PMT ADC data, fill out pulse occupancy information
-    std::map<unsigned long, std::vector<std::vector<ADCPulse>>>::iterator it1 = RecoADCHits.find(channel_key);
-    if(!isAuxData && it1!=RecoADCHits.end()){
-      std::vector<std::vector<ADCPulse>> buffer_pulses = RecoADCHits.at(channel_key);
+    std::map<unsigned long, std::vector<std::vector<ADCPulse>>>::const_iterator it1 = RecoADCHits->find(channel_key);
+    if(!isAuxData && it1!=RecoADCHits->end()){
+      const std::vector<std::vector<ADCPulse>>& buffer_pulses = it1->second;
       int num_pulses = 0;
       for (int i = 0; i < buffer_pulses.size(); i++){
           std::vector<ADCPulse> onebuffer_pulses = buffer_pulses.at(i);
@@ -8,6 +8,7 @@
 
 #include "Tool.h"
 #include "ADCPulse.h"
+#include "ANNIEEventMember.h"
 #include "Position.h"
 #include "Detector.h"
 
@@ -40,7 +41,7 @@ class PrintADCData: public Tool {
   bool Execute(); ///< Execute function used to perform Tool purpose.
   bool Finalise(); ///< Finalise function used to clean up resources.
   void MakeYPhiHists();
-  void PrintInfoInData(std::map<unsigned long, std::vector<Waveform<uint16_t>> > RawADCData,
+  void PrintInfoInData(const std::map<unsigned long, std::vector<Waveform<uint16_t>> >& RawADCData,
         bool isAuxData); // Fill ROOT file with histograms from either PMT ADC data or auxiliary channel data.
                          // For now, all Aux Data will be output to the file regardless of any pulse activity
   void SaveOccupancyInfo(uint32_t Run, uint32_t Subrun);
@@ -82,9 +83,10 @@ class PrintADCData: public Tool {
   uint32_t CurrentSubrun;
   long EntryNum;
 
-  std::map<unsigned long, std::vector<Waveform<uint16_t>> > RawADCData;
-  std::map<unsigned long, std::vector<Waveform<uint16_t>> > RawADCAuxData;
-  std::map<unsigned long, std::vector< std::vector<ADCPulse>> > RecoADCHits;
+  typedef std::map<unsigned long, std::vector<Waveform<uint16_t>> > WaveformMap;
+  const WaveformMap* RawADCData = nullptr;     // Owned by the ANNIEEvent store
+  const WaveformMap* RawADCAuxData = nullptr;
+  const std::map<unsigned long, std::vector< std::vector<ADCPulse>> >* RecoADCHits = nullptr;
   int RunNumber;
 
   //Used to print information on how many pulses are found and % of events with a pulse
@@ -747,7 +747,8 @@ bool PulseSimulation::FillEmulatedPMTData(){
 				}
 			}
 		}
-		m_data->Stores.at("ANNIEEvent")->Set("RawADCData",RawADCData);
+		ANNIEEventMember::Publish(m_data->Stores.at("ANNIEEvent"),"RawADCData",std::move(RawADCData),true);
+		RawADCData.clear();
 	}
 	
 	// Fill the hefty timing file. 
@@ -4,6 +4,7 @@
 
 #include "Tool.h"
 #include "Waveform.h"
+#include "ANNIEEventMember.h"
 
 #include <string>
 #include <iostream>
@@ -51,23 +51,23 @@ bool RawLoadToRoot::Execute(){
   annieevent->Get("EventNumber", EventNumber);
   annieevent->Get("RunNumber", RunNumber);
   annieevent->Get("SubRunNumber", SubRunNumber);
-  annieevent->Get("RawADCData", RawADCData);
+  RawADCData = ANNIEEventMember::Get<std::map<unsigned long, std::vector<Waveform<unsigned short>>>>(annieevent, "RawADCData");
   annieevent->Get("TrigEvents",trigev);
-  annieevent->Get("CalibratedADCData", caladcdata);
+  caladcdata = ANNIEEventMember::Get<std::map<unsigned long, std::vector<CalibratedADCWaveform<double>>>>(annieevent, "CalibratedADCData");
 
   //restricts tool to range of trigger events specified in config file
-  if((lbound<=RelEventNumber && RelEventNumber<=ubound && onoffswitch==1)||onoffswitch==0){
+  if(RawADCData && caladcdata && ((lbound<=RelEventNumber && RelEventNumber<=ubound && onoffswitch==1)||onoffswitch==0)){
 
-    map<unsigned long,vector<Waveform<unsigned short>>> :: iterator itr;
-    map<unsigned long,std::vector<CalibratedADCWaveform<double>>> :: iterator ijk;
+    map<unsigned long,vector<Waveform<unsigned short>>> :: const_iterator itr;
+    map<unsigned long,std::vector<CalibratedADCWaveform<double>>> :: const_iterator ijk;
 
     int chancount=0;
-    for(itr=RawADCData.begin(),ijk=caladcdata.begin(); itr!=RawADCData.end(),ijk!=caladcdata.end(); ++itr,++ijk){  //loop through channels
+    for(itr=RawADCData->begin(),ijk=caladcdata->begin(); itr!=RawADCData->end(),ijk!=caladcdata->end(); ++itr,++ijk){  //loop through channels
 
       unsigned long ck = itr->first;
-      vector<Waveform<unsigned short>> TheWaveforms = itr->second;
+      const vector<Waveform<unsigned short>>& TheWaveforms = itr->second;
       unsigned long chank = ijk->first;
-      vector<CalibratedADCWaveform<double>> calwaves = ijk->second;
+      const vector<CalibratedADCWaveform<double>>& calwaves = ijk->second;
 
       for(int mmm=0; mmm<TheWaveforms.size(); mmm++){  //loop through minibuffers
 
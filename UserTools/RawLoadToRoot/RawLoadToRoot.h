@@ -11,6 +11,7 @@
 #include "TString.h"
 #include "ADCPulse.h"
 #include "CalibratedADCWaveform.h"
+#include "ANNIEEventMember.h"
 #include "TTree.h"
 
 class RawLoadToRoot: public Tool {
@@ -49,11 +50,11 @@ class RawLoadToRoot: public Tool {
    std::string key;
    std::string value;
 
-   std::map<unsigned long, std::vector<Waveform<unsigned short>>>
-    RawADCData;
+   const std::map<unsigned long, std::vector<Waveform<unsigned short>>>*
+    RawADCData = nullptr;  // Owned by the ANNIEEvent store
 
     map<int,map<int,std::vector<ADCPulse>>> trigev;
-    std::map<unsigned long, std::vector<CalibratedADCWaveform<double>>> caladcdata;
+    const std::map<unsigned long, std::vector<CalibratedADCWaveform<double>>>* caladcdata = nullptr;
 
 
 
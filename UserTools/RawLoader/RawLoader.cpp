@@ -203,7 +203,8 @@ bool RawLoader::Execute() {
     }
   }
 
-  annie_event->Set("RawADCData", raw_waveform_map);
+  const auto* shared_waveform_map = ANNIEEventMember::Publish(annie_event,
+    "RawADCData", std::move(raw_waveform_map), true);
 
   // Store the minibuffer timestamps to the Store if this is non-Hefty data
   // (allows us to get the timestamps without loading the full raw waveforms).
@@ -215,7 +216,7 @@ bool RawLoader::Execute() {
     // timestamps
     std::vector<TimeClass> mb_timestamps;
 
-    const auto& pair = *raw_waveform_map.cbegin();
+    const auto& pair = *shared_waveform_map->cbegin();
     const auto& raw_waveforms = pair.second;
 
     for (const auto& rwf : raw_waveforms) {
@@ -25,6 +25,7 @@
 #include "ANNIEconstants.h"
 #include "MinibufferLabel.h"
 #include "Waveform.h"
+#include "ANNIEEventMember.h"
 
 // recoANNIE includes                                                                                                                                                                                   #include "RawCard.h"
 #include "RawChannel.h"
@@ -48,10 +48,10 @@ bool SimpleTankEnergyCalibrator::Execute(){
   int annieeventexists = m_data->Stores.count("ANNIEEvent");
   if(!annieeventexists){ cerr<<"no ANNIEEvent store!"<<endl;}
   
-  std::map<unsigned long, std::vector<std::vector<ADCPulse>>> RecoADCHits;
   //First, get the hits from the Store
   m_data->Stores["ANNIEEvent"]->Get("EventNumber", evnum);
-  bool got_recoadc = m_data->Stores["ANNIEEvent"]->Get("RecoADCHits",RecoADCHits);
+  const auto* RecoADCHits = ANNIEEventMember::Get<std::map<unsigned long, std::vector<std::vector<ADCPulse>>>>(m_data->Stores["ANNIEEvent"],"RecoADCHits");
+  bool got_recoadc = (RecoADCHits != nullptr);
 
   bool got_hits = m_data->Stores["ANNIEEvent"]->Get("Hits", Hits);
   if (!got_hits){
@@ -129,18 +129,18 @@ bool SimpleTankEnergyCalibrator::Execute(){
   MrdEntryPoint.SetZ(-9999.);
 
   for(int tracki=0; tracki<numtracksinev; tracki++){
-    BoostStore* thisTrackAsBoostStore = &(theMrdTracks->at(tracki));
+    const MrdTrack& thisTrack = theMrdTracks->at(tracki);
     
     //get track properties that are needed for the through-going muon selection
-    thisTrackAsBoostStore->Get("StartVertex",StartVertex);
-    thisTrackAsBoostStore->Get("StopVertex",StopVertex);
-    thisTrackAsBoostStore->Get("TrackAngle",TrackAngle);
-    thisTrackAsBoostStore->Get("TrackAngleError",TrackAngleError);
-    thisTrackAsBoostStore->Get("PenetrationDepth",PenetrationDepth);
-    thisTrackAsBoostStore->Get("MrdEntryPoint",MrdEntryPoint);
-    thisTrackAsBoostStore->Get("NumLayersHit",LayersHit);
-    thisTrackAsBoostStore->Get("EnergyLoss",EnergyLoss);
-    thisTrackAsBoostStore->Get("EnergyLossError",EnergyLossError);
+    StartVertex = thisTrack.StartVertex;
+    StopVertex = thisTrack.StopVertex;
+    TrackAngle = thisTrack.TrackAngle;
+    TrackAngleError = thisTrack.TrackAngleError;
+    PenetrationDepth = thisTrack.PenetrationDepth;
+    MrdEntryPoint = thisTrack.MrdEntryPoint;
+    LayersHit = thisTrack.LayersHit.size();
+    EnergyLoss = thisTrack.EnergyLoss;
+    EnergyLossError = thisTrack.EnergyLossError;
     tracklength = sqrt(pow((StopVertex.X()-StartVertex.X()),2)+pow(StopVertex.Y()-StartVertex.Y(),2)+pow(StopVertex.Z()-StartVertex.Z(),2));
   }
 
@@ -9,6 +9,7 @@
 #include "Tool.h"
 #include "Hit.h"
 #include "ADCPulse.h"
+#include "ANNIEEventMember.h"
 #include "Position.h"
 #include "Geometry.h"
 #include <boost/algorithm/string.hpp>
@@ -67,7 +68,7 @@ class SimpleTankEnergyCalibrator: public Tool {
   std::map<int,std::vector<int>> paddlesInTrackReco;
 
   std::string MRDTriggertype;
-  std::vector<BoostStore>* theMrdTracks;   // the reconstructed tracks
+  std::vector<MrdTrack>* theMrdTracks;   // the reconstructed tracks
   double TrackAngle;
   double TrackAngleError;
   double PenetrationDepth;
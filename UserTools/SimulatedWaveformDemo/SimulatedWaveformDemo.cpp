@@ -130,8 +130,9 @@ bool SimulatedWaveformDemo::Execute(){
 	// < NEW >
 	// Phase 2 oriented ToolAnalysis approach to analysing waveforms is via ANNIEEvent::RawADCData
 	// This is a map<channelkey, vector<Waveform>>, where the vector contains one Waveform per minibuffer.
-	get_ok = m_data->Stores.at("ANNIEEvent")->Get("RawADCData",RawADCData);
-	if(not get_ok){
+	// It is owned by the ANNIEEvent, so we just get a pointer to it rather than a copy.
+	RawADCData = ANNIEEventMember::Get<std::map<unsigned long,std::vector<Waveform<uint16_t>>>>(m_data->Stores.at("ANNIEEvent"),"RawADCData");
+	if(RawADCData==nullptr){
 		Log("SimulatedWaveformDemo Tool: Failed to get RawADCData from ANNIEEvent!",v_error,verbosity);
 		return false;
 	}
@@ -144,16 +145,16 @@ bool SimulatedWaveformDemo::Execute(){
 	// =================================================================================================
 	if(WaveformSource==0){
 		// Method 1: Accessing waveforms via the RawADCData
-		Log("SimulatedWaveformDemo Tool: Looping over "+to_string(RawADCData.size())
+		Log("SimulatedWaveformDemo Tool: Looping over "+to_string(RawADCData->size())
 			 +" Tank PMT channels",v_debug,verbosity);
-		for(std::pair<const unsigned long,std::vector<Waveform<uint16_t>>>& achannel : RawADCData){
+		for(const std::pair<const unsigned long,std::vector<Waveform<uint16_t>>>& achannel : *RawADCData){
 			const unsigned long channelkey = achannel.first;
 			
 			// Each Waveform represents one minibuffer on this channel
 			Log("SimulatedWaveformDemo Tool: Looping over "+to_string(achannel.second.size())
 				 +" minibuffers",v_debug,verbosity);
-			for(Waveform<uint16_t>& wfrm : achannel.second){
-				std::vector<uint16_t>* samples = wfrm.GetSamples();
+			for(const Waveform<uint16_t>& wfrm : achannel.second){
+				const std::vector<uint16_t>* samples = &wfrm.Samples();
 				// Note that because these are built directly from the simulated minibuffers,
 				// samples will have the Phase 1 interleaving unless it is disabled in the
 				// PulseSimulation tool by passing config variable DoPhaseOneRiffle=0
@@ -8,6 +8,7 @@
 #include <chrono>
 
 #include "Tool.h"
+#include "ANNIEEventMember.h"
 
 #include "TApplication.h"
 #include "TSystem.h"
@@ -63,7 +64,7 @@ class SimulatedWaveformDemo: public Tool {
 	std::vector< const std::vector<uint16_t>* > pmtDataVector;   // vector (per card) of waveforms
 	
 	// ANNIEEvent members:
-	std::map<unsigned long,std::vector<Waveform<uint16_t>>> RawADCData;
+	const std::map<unsigned long,std::vector<Waveform<uint16_t>>>* RawADCData=nullptr;
 	
 	// internal members:
 	int SamplesPerMinibuffer;
@@ -399,14 +399,13 @@ bool TankCalibrationDiffuser::Execute(){
   int annieeventexists = m_data->Stores.count("ANNIEEvent");
   if(!annieeventexists){ std::cerr<<"Error: No ANNIEEvent store!"<<endl; /*return false;*/};
 
-  std::map<unsigned long, std::vector<std::vector<ADCPulse>>> RecoADCHits; 
-
   //----------------------------------------------------------------------------
   //---------------get the members of the ANNIEEvent----------------------------
   //----------------------------------------------------------------------------
   m_data->Stores["ANNIEEvent"]->Get("EventNumber", evnum);
   m_data->Stores["ANNIEEvent"]->Get("BeamStatus", BeamStatus);
-  bool got_recoadc = m_data->Stores["ANNIEEvent"]->Get("RecoADCHits",RecoADCHits);
+  const auto* RecoADCHits = ANNIEEventMember::Get<std::map<unsigned long, std::vector<std::vector<ADCPulse>>>>(m_data->Stores["ANNIEEvent"],"RecoADCHits");
+  bool got_recoadc = (RecoADCHits != nullptr);
 
   if (HitStoreName == "MCHits"){
     bool got_mchits = m_data->Stores["ANNIEEvent"]->Get("MCHits", MCHits);
@@ -491,15 +490,15 @@ bool TankCalibrationDiffuser::Execute(){
 
   if (got_recoadc){
 
-    int recoadcsize = RecoADCHits.size();
+    int recoadcsize = RecoADCHits->size();
     int adc_loop = 0;
     if (verbose > 0) std::cout <<"RecoADCHits size: "<<recoadcsize<<std::endl;
-    for (std::pair<unsigned long, std::vector<std::vector<ADCPulse>>> apair : RecoADCHits){
+    for (const std::pair<const unsigned long, std::vector<std::vector<ADCPulse>>>& apair : *RecoADCHits){
       unsigned long chankey = apair.first;
       Detector *thistube = geom->ChannelToDetector(chankey);
       int detectorkey = thistube->GetDetectorID();
       if (thistube->GetDetectorElement()=="Tank"){
-        std::vector<std::vector<ADCPulse>> pulses = apair.second;
+        const std::vector<std::vector<ADCPulse>>& pulses = apair.second;
         for (int i_minibuffer = 0; i_minibuffer < pulses.size(); i_minibuffer++){
           std::vector<ADCPulse> apulsevector = pulses.at(i_minibuffer);
           for (int i_pulse=0; i_pulse < apulsevector.size(); i_pulse++){
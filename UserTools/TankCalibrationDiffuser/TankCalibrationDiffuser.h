@@ -11,6 +11,7 @@
 #include "Tool.h"
 #include "Hit.h"
 #include "ADCPulse.h"
+#include "ANNIEEventMember.h"
 #include "BeamStatus.h"
 #include "TriggerClass.h"
 #include "Detector.h"
@@ -1,6 +1,8 @@
 /* vim:set noexpandtab tabstop=4 wrap */
 #include "TimeClustering.h"
 
+#include <algorithm>
+
 // for sleeping
 #include <thread>          // std::this_thread::sleep_for
 #include <chrono>          // std::chrono::seconds
@@ -131,6 +133,26 @@ bool TimeClustering::Initialise(std::string configfile, DataModel &data){
 	// Get Detectors map to divide in horizontal and vertical layers
 	m_data->Stores["ANNIEEvent"]->Header->Get("AnnieGeometry",geom);
 
+	// Precompute the paddle orientation of every MRD / FMV channel, so the horizontal / vertical
+	// histograms can be filled without looking up the Detector and Paddle of each hit
+	if (MakeMrdDigitTimePlot){
+		std::map<std::string,std::map<unsigned long,Detector*> >* Detectors = geom->GetDetectors();
+		std::vector<std::string> paddlesets{"MRD","Veto"};
+		for (auto&& setname : paddlesets){
+			if (Detectors->count(setname)==0) continue;
+			for (auto&& apaddle : Detectors->at(setname)){
+				Paddle *mrdpaddle = (Paddle*) geom->GetDetectorPaddle(apaddle.first);
+				if (mrdpaddle==nullptr) continue;
+				for (auto&& achannel : *(apaddle.second->GetChannels())){
+					unsigned long chankey = achannel.first;
+					if (chankey >= paddleorientation.size()) paddleorientation.resize(chankey+1,-1);
+					paddleorientation.at(chankey) = mrdpaddle->GetOrientation(); // 0 is horizontal, 1 is vertical
+				}
+			}
+		}
+		Log("TimeClustering tool: Built paddle orientation table for "+std::to_string(paddleorientation.size())+" channelkeys",v_debug,verbosity);
+	}
+
 	return true;
 }
 
@@ -208,25 +230,24 @@ bool TimeClustering::Execute(){
 //				continue;
 //			}
 //			if(thedetector->GetDetectorElement()!="MRD") continue; // this is a veto hit, not an MRD hit. XXX keep this cut?
+			std::map<unsigned long,int>::iterator it_mrdpmtid = channelkey_to_mrdpmtid.find(chankey);
 			for(auto&& hitsonthismrdpmt : anmrdpmt.second){
-				if (channelkey_to_mrdpmtid.find(chankey) != channelkey_to_mrdpmtid.end()){
-					mrddigitpmtsthisevent.push_back(channelkey_to_mrdpmtid[chankey]);
+				if (it_mrdpmtid != channelkey_to_mrdpmtid.end()){
+					double digittime = hitsonthismrdpmt.GetTime();
+					mrddigitpmtsthisevent.push_back(it_mrdpmtid->second);
 					mrddigitchankeysthisevent.push_back(chankey);
-					mrddigittimesthisevent.push_back(hitsonthismrdpmt.GetTime());
+					mrddigittimesthisevent.push_back(digittime);
 					mrddigitchargesthisevent.push_back(hitsonthismrdpmt.GetCharge());
 					if(MakeMrdDigitTimePlot){  // XXX XXX XXX rename
 						// fill the histogram if we're checking
-						if (MakeSingleEventPlots) mrddigitts_single->Fill(hitsonthismrdpmt.GetTime());
-						mrddigitts->Fill(hitsonthismrdpmt.GetTime());
-						if (MRDTriggertype == "Cosmic") mrddigitts_cosmic->Fill(hitsonthismrdpmt.GetTime());
-						else if (MRDTriggertype == "Beam") mrddigitts_beam->Fill(hitsonthismrdpmt.GetTime());
-						else if (MRDTriggertype == "No Loopback") mrddigitts_noloopback->Fill(hitsonthismrdpmt.GetTime());       //this triggertype should not occur if everything is running smoothly, but it can serve as a good cross-check in any case
-						Detector* thistube = geom->ChannelToDetector(chankey);
-						unsigned long detkey = thistube->GetDetectorID();
-						Paddle *mrdpaddle = (Paddle*) geom->GetDetectorPaddle(detkey);
-						int orientation = mrdpaddle->GetOrientation(); // 0 is horizontal, 1 is vertical
-						if (orientation == 0) mrddigitts_horizontal->Fill(hitsonthismrdpmt.GetTime());
-						else mrddigitts_vertical->Fill(hitsonthismrdpmt.GetTime());
+						if (MakeSingleEventPlots) mrddigitts_single->Fill(digittime);
+						mrddigitts->Fill(digittime);
+						if (MRDTriggertype == "Cosmic") mrddigitts_cosmic->Fill(digittime);
+						else if (MRDTriggertype == "Beam") mrddigitts_beam->Fill(digittime);
+						else if (MRDTriggertype == "No Loopback") mrddigitts_noloopback->Fill(digittime);       //this triggertype should not occur if everything is running smoothly, but it can serve as a good cross-check in any case
+						int orientation = (chankey < paddleorientation.size()) ? paddleorientation[chankey] : -1;
+						if (orientation == 0) mrddigitts_horizontal->Fill(digittime);
+						else if (orientation == 1) mrddigitts_vertical->Fill(digittime);
 					}
 				} else {
 					Log("TimeClustering tool: Did not find channelkey "+std::to_string(chankey)+" in chankey_to_mrdpmtid map.",v_warning,verbosity);
@@ -269,22 +290,20 @@ bool TimeClustering::Execute(){
 					pmtidwcsim = channelkey_to_faccpmtid.at(chankey)-1;
 				}
 				if(pmtidwcsim>0){
+					double digittime = hitsonthismrdpmt.GetTime();
 					mrddigitpmtsthisevent.push_back(pmtidwcsim);
-					mrddigittimesthisevent.push_back(hitsonthismrdpmt.GetTime());
+					mrddigittimesthisevent.push_back(digittime);
 					mrddigitchargesthisevent.push_back(hitsonthismrdpmt.GetCharge());
 					if(MakeMrdDigitTimePlot){  // XXX XXX XXX rename
 						// fill the histogram if we're checking
-						if (MakeSingleEventPlots) mrddigitts_single->Fill(hitsonthismrdpmt.GetTime());
-						mrddigitts->Fill(hitsonthismrdpmt.GetTime());
-						if (MRDTriggertype == "Cosmic") mrddigitts_cosmic->Fill(hitsonthismrdpmt.GetTime());
-						else if (MRDTriggertype == "Beam") mrddigitts_beam->Fill(hitsonthismrdpmt.GetTime());
-						else if (MRDTriggertype == "No Loopback") mrddigitts_noloopback->Fill(hitsonthismrdpmt.GetTime());       //this triggertype should not occur if everything is running smoothly, but it can serve as a good cross-check in any case
-						Detector* thistube = geom->ChannelToDetector(chankey);
-						unsigned long detkey = thistube->GetDetectorID();
-						Paddle *mrdpaddle = (Paddle*) geom->GetDetectorPaddle(detkey);
-						int orientation = mrdpaddle->GetOrientation(); // 0 is horizontal, 1 is vertical
-						if (orientation == 0) mrddigitts_horizontal->Fill(hitsonthismrdpmt.GetTime());
-						else mrddigitts_vertical->Fill(hitsonthismrdpmt.GetTime());
+						if (MakeSingleEventPlots) mrddigitts_single->Fill(digittime);
+						mrddigitts->Fill(digittime);
+						if (MRDTriggertype == "Cosmic") mrddigitts_cosmic->Fill(digittime);
+						else if (MRDTriggertype == "Beam") mrddigitts_beam->Fill(digittime);
+						else if (MRDTriggertype == "No Loopback") mrddigitts_noloopback->Fill(digittime);       //this triggertype should not occur if everything is running smoothly, but it can serve as a good cross-check in any case
+						int orientation = (chankey < paddleorientation.size()) ? paddleorientation[chankey] : -1;
+						if (orientation == 0) mrddigitts_horizontal->Fill(digittime);
+						else if (orientation == 1) mrddigitts_vertical->Fill(digittime);
 					}
 				} else {
 					Log("TimeClustering tool: Did not find channelkey "+std::to_string(chankey)+" in chankey_to_mrdpmtid map.",v_warning,verbosity);
@@ -308,10 +327,19 @@ bool TimeClustering::Execute(){
 		// ======================================================================================
 	}
 	
+	// SORT DIGITS BY TIME
+	// ===================
+	// sort (time, digit index) pairs once; the subevent search below is then a single pass
+	sortedtimeids.clear();
+	for(int thisdigit=0;thisdigit<numdigits;thisdigit++){
+		sortedtimeids.emplace_back(mrddigittimesthisevent[thisdigit],thisdigit);
+	}
+	std::sort(sortedtimeids.begin(),sortedtimeids.end());
+
 	// MEASURE TOTAL EVENT DURATION
 	// ============================
-	double eventendtime = *std::max_element(mrddigittimesthisevent.begin(),mrddigittimesthisevent.end());
-	double eventstarttime = *std::min_element(mrddigittimesthisevent.begin(),mrddigittimesthisevent.end());
+	double eventendtime = sortedtimeids.back().first;
+	double eventstarttime = sortedtimeids.front().first;
 	double eventduration = (eventendtime - eventstarttime);
 	Log("TimeClustering Tool: mrd event start: "+to_string(eventstarttime)
 			+", end : "+to_string(eventendtime)+", duration : "+to_string(eventduration),v_debug,verbosity);
@@ -342,22 +370,36 @@ bool TimeClustering::Execute(){
 		// COUNT SUBEVENTS
 		// ---------------
 		// this event has multiple subevents. We need to split hits into which subevent they belong to.
-		// first scan over the times and look for gaps where no digits lie, using these to delimit 'subevents'
-		std::vector<float> subeventhittimesv;   // a vector of the starting times of a given subevent
-		std::vector<float> subeventendtimesv;
-		std::vector<double> sorteddigittimes(mrddigittimesthisevent);
-		std::sort(sorteddigittimes.begin(), sorteddigittimes.end());
-		subeventhittimesv.push_back(sorteddigittimes.at(0));
-		for(unsigned int i=0;i<sorteddigittimes.size()-1;i++){
-			float timetonextdigit = sorteddigittimes.at(i+1)-sorteddigittimes.at(i);
+		// scan over the sorted times and look for gaps where no digits lie, using these to delimit 'subevents'.
+		subeventhittimesv.clear();   // the starting times of each subevent
+		subeventendtimesv.clear();
+		subeventhittimesv.push_back(sortedtimeids.front().first);
+		for(int i=1;i<numdigits;i++){
+			float timetonextdigit = sortedtimeids[i].first-sortedtimeids[i-1].first;
 			if(timetonextdigit>minimum_subevent_timeseparation){
-				subeventendtimesv.push_back(sorteddigittimes.at(i));
-				subeventhittimesv.push_back(sorteddigittimes.at(i+1));
+				subeventendtimesv.push_back(sortedtimeids[i-1].first);
+				subeventhittimesv.push_back(sortedtimeids[i].first);
 				Log("TimeClustering Tool: Setting subevent time threshold at "+to_string(subeventhittimesv.back()),v_debug,verbosity);
 			}
 		}
+		int numsubevents = subeventhittimesv.size();
 		Log("TimeClustering Tool: Found "+to_string(subeventhittimesv.size())+" subevents this event",v_debug,verbosity);
 		
+		// each digit belongs to the first subevent whose (float) end time it does not exceed. A digit time
+		// that is not exactly representable as a float can lie just past the end time of its own subevent,
+		// and then goes into the next one; past the last end time it is not in any subevent
+		subeventnumthisevent.assign(numdigits,-1);
+		int thissubevent=0;
+		for(auto&& atimeid : sortedtimeids){
+			while(thissubevent<numsubevents){
+				float endtime = (thissubevent<(numsubevents-1)) ? subeventendtimesv[thissubevent] : (eventendtime+1.);
+				if(atimeid.first<=endtime) break;
+				thissubevent++;
+			}
+			if(thissubevent==numsubevents) break;
+			subeventnumthisevent[atimeid.second] = thissubevent;
+		}
+		
 		//write subeventhittimesv to CStore for subsequent tools (e.g. FindMrdTracks)
 		m_data->CStore.Set("ClusterStartTimes",subeventhittimesv);
 
@@ -384,75 +426,44 @@ bool TimeClustering::Execute(){
 		
 		// SORT HITS INTO SUBEVENTS
 		// ------------------------
-		// now we need to sort the digits into the subevents they belong to:
-		// temporary storage vectors to hold the digits in the present subevent
-		std::vector<int> digitidsinasubevent;
-		std::vector<int> tubeidsinasubevent;
-		std::vector<double> digittimesinasubevent;
-		std::vector<double> digitchargesinasubevent;
-		// a vector to record the subevent number for each hit, to know if we've allocated it yet.
-		std::vector<int> subeventnumthisevent(numdigits,-1);
-		// LOOP OVER SUBEVENTS
-		// -------------------
-		for(unsigned int thissubevent=0; thissubevent<subeventhittimesv.size(); thissubevent++){
-			float endtime = (thissubevent<(subeventhittimesv.size()-1)) ?
-								//subeventhittimesv.at(thissubevent+1) : (eventendtime+1.);
-								subeventendtimesv.at(thissubevent) : (eventendtime+1.);
-			Log("TimeClustering Tool: Endtime for subevent "+to_string(thissubevent)+" is "+to_string(endtime), v_debug,verbosity);
-			// don't need to worry about search start time as we start from earliest hit and exclude already allocated hits
-			// times are not ordered, so scan through all digits for each subevent
-			// FIND HITS IN THIS SUBEVENT
-			// --------------------------
-			for(int thisdigit=0;thisdigit<numdigits;thisdigit++){
-				if(subeventnumthisevent.at(thisdigit)<0 && mrddigittimesthisevent.at(thisdigit)<= endtime ){
-					// thisdigit is in thissubevent
-					if(verbosity>5){
-						cout<<"adding digit id "<<thisdigit<<" and digit at "<<mrddigittimesthisevent.at(thisdigit)<<" to subevent "<<thissubevent<<endl;
-					}
-					digitidsinasubevent.push_back(thisdigit);
-					subeventnumthisevent.at(thisdigit)=thissubevent;
-					tubeidsinasubevent.push_back(mrddigitpmtsthisevent.at(thisdigit));
-					digittimesinasubevent.push_back(mrddigittimesthisevent.at(thisdigit));
-					digitchargesinasubevent.push_back(mrddigitchargesthisevent.at(thisdigit));
-					if (MakeMrdDigitTimePlot){
-						mrddigitts_file->cd();
-						if (MakeSingleEventPlots) mrddigitts_single->Fill(mrddigittimesthisevent.at(thisdigit));			
-					}			
-				}
+		// fill the digits into their subevents in digit order, so each cluster lists its digit indices ascending
+		if((int)subeventdigitids.size()<numsubevents) subeventdigitids.resize(numsubevents);
+		for(int i_sub=0;i_sub<numsubevents;i_sub++) subeventdigitids[i_sub].clear();
+		for(int thisdigit=0;thisdigit<numdigits;thisdigit++){
+			if(subeventnumthisevent[thisdigit]<0) continue;
+			if(verbosity>5){
+				cout<<"adding digit id "<<thisdigit<<" and digit at "<<mrddigittimesthisevent.at(thisdigit)<<" to subevent "<<subeventnumthisevent[thisdigit]<<endl;
+			}
+			subeventdigitids[subeventnumthisevent[thisdigit]].push_back(thisdigit);
+			if (MakeMrdDigitTimePlot && MakeSingleEventPlots){
+				mrddigitts_file->cd();
+				mrddigitts_single->Fill(mrddigittimesthisevent[thisdigit]);
 			}
-			
-			// CONSTRUCT THE SUBEVENT
-			// -----------------------
+		}
+
+		// CONSTRUCT THE SUBEVENTS
+		// -----------------------
+		for(int i_sub=0;i_sub<numsubevents;i_sub++){
+			float endtime = (i_sub<(numsubevents-1)) ? subeventendtimesv.at(i_sub) : (eventendtime+1.);
+			Log("TimeClustering Tool: Endtime for subevent "+to_string(i_sub)+" is "+to_string(endtime), v_debug,verbosity);
+			std::vector<int>& digitidsinasubevent = subeventdigitids[i_sub];
 			if(digitidsinasubevent.size()>=minimumdigits){  // must have enough for a subevent
 				Log("TimeClustering Tool: Constructing subevent "+to_string(mrdeventcounter)
 					+" with "+to_string(digitidsinasubevent.size())+" digits",v_debug,verbosity);
-				//MrdTimeClusters.Add(mrdeventcounter, digitidsinasubevent, tubeidsinasubevent, digittimesinasubevent);
 				MrdTimeClusters.push_back(digitidsinasubevent);
 				mrdeventcounter++;
 				if (MakeMrdDigitTimePlot){
-					for (unsigned int i_time = 0; i_time < digittimesinasubevent.size(); i_time++){
-						mrddigitts_file->cd();
-						mrddigitts_cluster->Fill(digittimesinasubevent.at(i_time));
-						if (MakeSingleEventPlots) mrddigitts_cluster_single->Fill(digittimesinasubevent.at(i_time));
-						if (MRDTriggertype == "Cosmic") mrddigitts_cosmic_cluster->Fill(digittimesinasubevent.at(i_time));
-                                		else if (MRDTriggertype == "Beam") mrddigitts_beam_cluster->Fill(digittimesinasubevent.at(i_time));
-                                		else if (MRDTriggertype == "No Loopback") mrddigitts_noloopback_cluster->Fill(digittimesinasubevent.at(i_time));						
+					mrddigitts_file->cd();
+					for (auto&& thisdigit : digitidsinasubevent){
+						double digittime = mrddigittimesthisevent[thisdigit];
+						mrddigitts_cluster->Fill(digittime);
+						if (MakeSingleEventPlots) mrddigitts_cluster_single->Fill(digittime);
+						if (MRDTriggertype == "Cosmic") mrddigitts_cosmic_cluster->Fill(digittime);
+						else if (MRDTriggertype == "Beam") mrddigitts_beam_cluster->Fill(digittime);
+						else if (MRDTriggertype == "No Loopback") mrddigitts_noloopback_cluster->Fill(digittime);
 					}
 				}
 			}
-			
-			// clear the vectors and loop to the next subevent
-			digitidsinasubevent.clear();
-			tubeidsinasubevent.clear();
-			digittimesinasubevent.clear();
-			digitchargesinasubevent.clear();
-		}
-		
-		// quick scan to check for any unallocated hits
-		for(unsigned int k=0;k<subeventnumthisevent.size();k++){
-			if(subeventnumthisevent.at(k)==-1){
-				Log("TimeClustering Tool: Found unbinned hit "+to_string(k)+" at "+to_string(mrddigittimesthisevent.at(k)),v_error,verbosity);
-			}
 		}
 		
 	}  // end multiple subevents case
@@ -3,6 +3,8 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
+#include <utility>
 
 #include "Tool.h"
 #include "TFile.h"
@@ -60,6 +62,16 @@ class TimeClustering: public Tool {
 	std::vector<std::vector<int>> MrdTimeClusters;
 	std::vector<std::vector<double>> MrdTimeClusters_Times;
 	std::vector<std::vector<double>> MrdTimeClusters_Charges;
+
+	// Per-event working buffers, kept as members so their capacity is reused across events
+	std::vector<std::pair<double,int>> sortedtimeids;   // (time, digit index), sorted by time
+	std::vector<int> subeventnumthisevent;               // subevent number of each digit
+	std::vector<float> subeventhittimesv;                // start time of each subevent
+	std::vector<float> subeventendtimesv;                // end time of each subevent
+	std::vector<std::vector<int>> subeventdigitids;      // digit indices of each subevent
+
+	// Paddle orientation (0: horizontal, 1: vertical, -1: unknown) indexed by channelkey
+	std::vector<int> paddleorientation;
 	
         // Histograms storing information about the MRD cluster times
 	TH1D* mrddigitts_cosmic_cluster = nullptr;
@@ -170,22 +170,10 @@ bool TrackCombiner::Execute(){
 		// what criteria do we want to use to choose our best match?
 		// closest in time seems sensible, but do we want to prefer longer MRD tracks than stubs?
 		for(int tracki=0; tracki<numtracksinev; tracki++){
-			BoostStore* thisTrackAsBoostStore = &(theMrdTracks->at(tracki));
-			// Get the track details from the BoostStore
-			double thistrackstarttime;
-			get_ok = thisTrackAsBoostStore->Get("StartTime",thistrackstarttime);
-			if(not get_ok){
-				Log("TrackCombiner Tool: Failed to get StartTime from reco MRD Track BoostStore!",
-					v_error,verbosity);
-				return false;
-			}
-			Position thistracksentrypoint;
-			get_ok = thisTrackAsBoostStore->Get("MrdEntryPoint",thistracksentrypoint);
-			if(not get_ok){
-				Log("TrackCombiner Tool: Failed to get MrdEntryPoint from reco MRD Track BoostStore!",
-					v_error,verbosity);
-				return false;
-			}
+			const MrdTrack& thisTrack = theMrdTracks->at(tracki);
+			// Get the track details
+			double thistrackstarttime = thisTrack.StartTime;
+			const Position& thistracksentrypoint = thisTrack.MrdEntryPoint;
 			// matching criteria
 			double timediff = abs(thistrackstarttime - recoEventStartTime);
 			double entrypointdisc = (recoEventMrdEntryPoint-thistracksentrypoint).Mag();
@@ -244,7 +232,7 @@ bool TrackCombiner::Execute(){
 	if(best_match_index>=0){
 		Log("TrackCombiner Tool: Matched MRD track "+to_string(best_match_index)
 			+" to the RecoVertex!",v_debug,verbosity);
-		BoostStore* primaryEventMrdTrack = &(theMrdTracks->at(best_match_index));
+		MrdTrack* primaryEventMrdTrack = &(theMrdTracks->at(best_match_index));
 		m_data->Stores.at("ANNIEEvent")->Set("PrimaryEventRecoMrdTrack",primaryEventMrdTrack);
 	} else {
 		Log("TrackCombiner Tool: Failed to match any MRD tracks to the RecoVertex, "
@@ -306,7 +294,7 @@ bool TrackCombiner::Execute(){
 	if((best_match_index<0) && (mrdhits.size()>0)){
 		
 		Log("TrackCombiner Tool: Starting short track search",v_debug,verbosity);
-		BoostStore* short_track = FindShortMrdTracks(mrdhits);
+		MrdTrack* short_track = FindShortMrdTracks(mrdhits);
 		
 		if(short_track){
 			// hey, we managed to reconstruct a short Mrd track!
@@ -368,7 +356,7 @@ bool TrackCombiner::Finalise(){
 ///////////////////////////////////////////////////////////////////////////////
 
 
-BoostStore* TrackCombiner::FindShortMrdTracks(std::map<unsigned long,vector<double>> mrdhits){
+MrdTrack* TrackCombiner::FindShortMrdTracks(std::map<unsigned long,vector<double>> mrdhits){
 	Log("TrackCombiner Tool: searching for short Mrd tracks in event",v_debug,verbosity);
 	// should we require hits in the front 2 layers, at least?
 	// or hits in N layers, at least?
@@ -717,7 +705,7 @@ BoostStore* TrackCombiner::FindShortMrdTracks(std::map<unsigned long,vector<doub
 			logmessage = "TrackCombiner Tool: ERROR! tank_reco_success false in FindShortMrdTracks, ";
 			logmessage += " but show_all_stubs is false? How did we get here?";
 			Log(logmessage,v_error,verbosity);
-			return false;
+			return nullptr;
 		}
 	}
 	
@@ -842,7 +830,7 @@ BoostStore* TrackCombiner::FindShortMrdTracks(std::map<unsigned long,vector<doub
 	}
 	
 	// Loop over stubs
-	BoostStore* matched_track_as_booststore=nullptr;
+	int matched_track_index=-1;  // index rather than pointer, as later stubs may resize theMrdTracks
 	for(int stub_i=0; stub_i<num_loops; ++stub_i){
 		// if drawing everything, get the index from the scan order
 		if(show_all_stubs){
@@ -947,10 +935,10 @@ BoostStore* TrackCombiner::FindShortMrdTracks(std::map<unsigned long,vector<doub
 			atrack->Print2();
 		}
 		
-		// Add To The Mrdtracks Booststore
-		// ===============================
+		// Add To The MrdTracks Vector
+		// ===========================
 		// so that other tools don't have to handle TClonesArrays, we also convert the
-		// TClonesArray of cMRDSubEvents containing cMRDTracks to a std::vector<BoostStore>
+		// TClonesArray of cMRDSubEvents containing cMRDTracks to a std::vector<MrdTrack>
 		// We need to also add our new tracks to this.
 		
 		// increment the track count to accommodate the new track
@@ -962,72 +950,64 @@ BoostStore* TrackCombiner::FindShortMrdTracks(std::map<unsigned long,vector<doub
 				+to_string(numtracksinev),v_debug,verbosity);
 			theMrdTracks->resize(numtracksinev);
 		}
-		// Get a pointer to the track entry
-		BoostStore* thisTrackAsBoostStore = &(theMrdTracks->at(numtracksinev-1));
+		// Get the track entry, resetting it so nothing is left over from previous events
+		MrdTrack& thisTrack = theMrdTracks->at(numtracksinev-1);
+		thisTrack = MrdTrack();
 		
 		// now set the new track properties from the cMRDTrack
-		// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-		// Since we don't remove and re-create the BoostStores each Execute, any members set here
-		// which are not updated by the FindMrdTracks tool will result in spurious track properties!
-		// !!!!!!!!!!!!! It is therefore crucial to keep these two Tools in sync! !!!!!!!!!!!!!!!
-		// XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX
-		// IF ADDING MEMBERS TO THE MRDTRACK BOOSTSTORE HERE, ADD THEM TO THE FINDMRDTRACKS TOO!
-		// XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX XXX
-		// !!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!
-		Log("TrackCombiner Tool: populating MrdTracks BoostStore entry",v_debug,verbosity);
+		// IF ADDING MEMBERS TO THE MRDTRACK HERE, FILL THEM IN THE FINDMRDTRACKS TOO!
+		Log("TrackCombiner Tool: populating MrdTracks entry",v_debug,verbosity);
 		
-		thisTrackAsBoostStore->Set("MrdTrackID",atrack->GetTrackID());
-		thisTrackAsBoostStore->Set("MrdSubEventID",atrack->GetMrdSubEventID());
-		thisTrackAsBoostStore->Set("InterceptsTank",atrack->GetInterceptsTank());
-		thisTrackAsBoostStore->Set("StartTime",atrack->GetStartTime());
+		thisTrack.MrdTrackID = atrack->GetTrackID();
+		thisTrack.MrdSubEventID = atrack->GetMrdSubEventID();
+		thisTrack.InterceptsTank = atrack->GetInterceptsTank();
+		thisTrack.StartTime = atrack->GetStartTime();
 		// convert start posn from TVector3 to ANNIEEVENT Position class
-		Position startpos(atrack->GetStartVertex().X() / 100.,
-						  atrack->GetStartVertex().Y() / 100.,
-						  atrack->GetStartVertex().Z() / 100.);
+		thisTrack.StartVertex = Position(atrack->GetStartVertex().X() / 100.,
+										 atrack->GetStartVertex().Y() / 100.,
+										 atrack->GetStartVertex().Z() / 100.);
 		// same for endpos
-		Position endpos(  atrack->GetStopVertex().X() / 100.,
-						  atrack->GetStopVertex().Y() / 100.,
-						  atrack->GetStopVertex().Z() / 100.);
-		thisTrackAsBoostStore->Set("StartVertex",startpos);
-		thisTrackAsBoostStore->Set("StopVertex",endpos);
-		thisTrackAsBoostStore->Set("TrackAngle",atrack->GetTrackAngle());
-		thisTrackAsBoostStore->Set("TrackAngleError",atrack->GetTrackAngleError()); // TODO!!!
-		thisTrackAsBoostStore->Set("LayersHit",atrack->GetLayersHit());
-		thisTrackAsBoostStore->Set("TrackLength",atrack->GetTrackLength() / 100.);
-		thisTrackAsBoostStore->Set("IsMrdPenetrating",atrack->GetIsPenetrating());
-		thisTrackAsBoostStore->Set("EnergyLoss",atrack->GetEnergyLoss());
-		thisTrackAsBoostStore->Set("EnergyLossError",atrack->GetEnergyLossError());
-		thisTrackAsBoostStore->Set("IsMrdStopped",atrack->GetIsStopped());
-		thisTrackAsBoostStore->Set("IsMrdSideExit",atrack->GetIsSideExit());
-		thisTrackAsBoostStore->Set("PenetrationDepth",atrack->GetPenetrationDepth() / 100.);
-		thisTrackAsBoostStore->Set("HtrackFitChi2",atrack->GetHtrackFitChi2());
-		thisTrackAsBoostStore->Set("HtrackFitCov",atrack->GetHtrackFitCov());
-		thisTrackAsBoostStore->Set("VtrackFitChi2",atrack->GetVtrackFitChi2());
-		thisTrackAsBoostStore->Set("VtrackFitCov",atrack->GetVtrackFitCov());
-		thisTrackAsBoostStore->Set("PMTsHit",atrack->GetPMTsHit());
+		thisTrack.StopVertex = Position( atrack->GetStopVertex().X() / 100.,
+										 atrack->GetStopVertex().Y() / 100.,
+										 atrack->GetStopVertex().Z() / 100.);
+		thisTrack.TrackAngle = atrack->GetTrackAngle();
+		thisTrack.TrackAngleError = atrack->GetTrackAngleError(); // TODO!!!
+		thisTrack.LayersHit = atrack->GetLayersHit();
+		thisTrack.TrackLength = atrack->GetTrackLength() / 100.;
+		thisTrack.IsMrdPenetrating = atrack->GetIsPenetrating();
+		thisTrack.EnergyLoss = atrack->GetEnergyLoss();
+		thisTrack.EnergyLossError = atrack->GetEnergyLossError();
+		thisTrack.IsMrdStopped = atrack->GetIsStopped();
+		thisTrack.IsMrdSideExit = atrack->GetIsSideExit();
+		thisTrack.PenetrationDepth = atrack->GetPenetrationDepth() / 100.;
+		thisTrack.HtrackFitChi2 = atrack->GetHtrackFitChi2();
+		thisTrack.HtrackFitCov = atrack->GetHtrackFitCov();
+		thisTrack.VtrackFitChi2 = atrack->GetVtrackFitChi2();
+		thisTrack.VtrackFitCov = atrack->GetVtrackFitCov();
+		thisTrack.PMTsHit = atrack->GetPMTsHit();
 		
-		thisTrackAsBoostStore->Set("HtrackOrigin",atrack->GetHtrackOrigin());
-		thisTrackAsBoostStore->Set("HtrackOriginError",atrack->GetHtrackOriginError());
-		thisTrackAsBoostStore->Set("HtrackGradient",atrack->GetHtrackGradient());
-		thisTrackAsBoostStore->Set("HtrackGradientError",atrack->GetHtrackGradientError());
-		thisTrackAsBoostStore->Set("VtrackOrigin",atrack->GetVtrackOrigin());
-		thisTrackAsBoostStore->Set("VtrackOriginError",atrack->GetVtrackOriginError());
-		thisTrackAsBoostStore->Set("VtrackGradient",atrack->GetVtrackGradient());
-		thisTrackAsBoostStore->Set("VtrackGradientError",atrack->GetVtrackGradientError());
+		thisTrack.HtrackOrigin = atrack->GetHtrackOrigin();
+		thisTrack.HtrackOriginError = atrack->GetHtrackOriginError();
+		thisTrack.HtrackGradient = atrack->GetHtrackGradient();
+		thisTrack.HtrackGradientError = atrack->GetHtrackGradientError();
+		thisTrack.VtrackOrigin = atrack->GetVtrackOrigin();
+		thisTrack.VtrackOriginError = atrack->GetVtrackOriginError();
+		thisTrack.VtrackGradient = atrack->GetVtrackGradient();
+		thisTrack.VtrackGradientError = atrack->GetVtrackGradientError();
 		
 		// convert back projections to Position class
-		Position TankExitPoint( atrack->GetTankExitPoint().X() / 100.,
-								atrack->GetTankExitPoint().Y() / 100.,
-								atrack->GetTankExitPoint().Z() / 100.);
-		Position MrdEntryPoint( atrack->GetMrdEntryPoint().X() / 100.,
-								atrack->GetMrdEntryPoint().Y() / 100.,
-								atrack->GetMrdEntryPoint().Z() / 100.);
-		thisTrackAsBoostStore->Set("TankExitPoint",TankExitPoint);
-		thisTrackAsBoostStore->Set("MrdEntryPoint",MrdEntryPoint);
+		thisTrack.TankExitPoint = Position( atrack->GetTankExitPoint().X() / 100.,
+											atrack->GetTankExitPoint().Y() / 100.,
+											atrack->GetTankExitPoint().Z() / 100.);
+		thisTrack.MrdEntryPoint = Position( atrack->GetMrdEntryPoint().X() / 100.,
+											atrack->GetMrdEntryPoint().Y() / 100.,
+											atrack->GetMrdEntryPoint().Z() / 100.);
+		// the new track was placed at this index in the sub-event's track vector
+		thisTrack.TrackIndex = numtracksinev-1;
 		
-		// if it's the first loop and we found a matching pair, grab the pointer to return
+		// if it's the first loop and we found a matching pair, note the track to return
 		if((stub_i==0)&&(found_matching_stub)){
-			matched_track_as_booststore = thisTrackAsBoostStore;
+			matched_track_index = numtracksinev-1;
 		}
 	}
 	
@@ -1036,6 +1016,6 @@ BoostStore* TrackCombiner::FindShortMrdTracks(std::map<unsigned long,vector<doub
 	m_data->Stores.at("MRDTracks")->Set("MRDTracks",theMrdTracks,false);
 	Log("TrackCombiner Tool: FindShortMrdTracks done",v_debug,verbosity);
 	
-	return matched_track_as_booststore;
+	return (matched_track_index>=0) ? &(theMrdTracks->at(matched_track_index)) : nullptr;
 }
 
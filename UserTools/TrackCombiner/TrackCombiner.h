@@ -27,7 +27,7 @@ class TrackCombiner: public Tool {
 	bool Execute(); ///< Execute function used to perform Tool purpose.
 	bool Finalise(); ///< Finalise funciton used to clean up resorces.
 	
-	BoostStore* FindShortMrdTracks(std::map<unsigned long,vector<double>> mrdhits);
+	MrdTrack* FindShortMrdTracks(std::map<unsigned long,vector<double>> mrdhits);
 	
 	private:
 	// from config file, requirements
@@ -47,7 +47,7 @@ class TrackCombiner: public Tool {
 	Geometry* anniegeom=nullptr;
 	TClonesArray* thesubeventarray = nullptr;
 	std::vector<MCParticle>* MCParticles=nullptr;
-	std::vector<BoostStore>* theMrdTracks=nullptr;
+	std::vector<MrdTrack>* theMrdTracks=nullptr;
 	std::map<unsigned long,int> channelkey_to_mrdpmtid;
 	std::vector<int> coincident_tubeids;      // wcsimtubeids in time, all get highlighted in paddleplot
 	std::vector<double> coincident_tubetimes; // used to colour the paddles, must be same size as # hit paddles
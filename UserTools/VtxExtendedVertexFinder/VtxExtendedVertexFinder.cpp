@@ -23,6 +23,14 @@ bool VtxExtendedVertexFinder::Initialise(std::string configfile, DataModel &data
   m_variables.Get("FitTimeWindowMin", fTmin);
   m_variables.Get("FitTimeWindowMax", fTmax);
   
+  // Skip fitting grid seeds that start far below the best one
+  fSeedPruneFOMMargin = -1.;
+  m_variables.Get("SeedPruneFOMMargin", fSeedPruneFOMMargin);
+  
+  // Give Minuit the analytic gradient of the FOM instead of its finite differences
+  fUseAnalyticGradient = false;
+  m_variables.Get("UseAnalyticGradient", fUseAnalyticGradient);
+  
   /// Create extended vertex
   /// Note that the objects created by "new" must be added to the "RecoEvent" store. 
   /// The last tool SaveRecoEvent will delete these pointers and free the memory.
@@ -144,15 +152,16 @@ RecoVertex* VtxExtendedVertexFinder::FitExtendedVertex(RecoVertex* myVertex) {
   //fit with Minuit
   MinuitOptimizer* myOptimizer = new MinuitOptimizer();
   myOptimizer->SetPrintLevel(-1);
+  myOptimizer->SetUseAnalyticGradient(fUseAnalyticGradient);
   myOptimizer->SetMeanTimeCalculatorType(1); //Type 1: most probable time
   myOptimizer->LoadVertexGeometry(myvtxgeo); //Load vertex geometry
   myOptimizer->LoadVertex(myVertex); //Load vertex seed
   myOptimizer->SetFitterTimeRange(fTmin, fTmax); //Set time range to fit over 
   myOptimizer->FitExtendedVertexWithMinuit(); //scan the point position in 4D space
-  // Fitted vertex must be copied to a new vertex pointer that is created in this class 
+  // Fitted vertex must be copied to the vertex owned by this class
   // Once the optimizer is deleted, the fitted vertex is lost. 
   // copy vertex to fExtendedVertex
-  RecoVertex* newVertex = new RecoVertex();
+  RecoVertex* newVertex = fExtendedVertex;
   newVertex->CloneVertex(myOptimizer->GetFittedVertex());
   //newVertex->SetFOM(myOptimizer->GetFittedVertex()->GetFOM(),1,1);
   // print vertex
@@ -168,45 +177,83 @@ RecoVertex* VtxExtendedVertexFinder::FitExtendedVertex(RecoVertex* myVertex) {
 }
 
 RecoVertex* VtxExtendedVertexFinder::FitGridSeeds(std::vector<RecoVertex>* vSeedVtxList) {
-  double vtxFOM = -9999.;
   double bestFOM = -1.0;
-  int vtxRecoStatus = -1;
   unsigned int nlast = vSeedVtxList->size();
   
-  RecoVertex* fSeedPos = 0;
-  RecoVertex* fSimpleVertex = new RecoVertex();
-  RecoVertex* bestGridVertex = new RecoVertex(); // FIXME: pointer must be deleted by the invoker
+  // The per-seed vertices are kept from event to event; they only grow when an
+  // event has more seeds than any before it.
+  if(fGridSeedVertices.size() < nlast) {
+    fGridSeedVertices.resize(nlast);
+    fGridFitVertices.resize(nlast);
+  }
+  fGridSeedFOM.assign(nlast, -9999.);
+  fGridFitFOM.assign(nlast, -9999.);
+  fGridFitStatus.assign(nlast, -1);
+  
+  // Seed each grid position with a simple direction
+  for( unsigned int n=0; n<nlast; n++ ){
+    this->FindSimpleDirection(&(vSeedVtxList->at(n)), &fGridSeedVertices.at(n));
+  }
+  
+  // Prune the seeds whose FOM before fitting is far below the best one. Minuit
+  // doesn't end a fit below the FOM it started from, so the best fitted FOM is
+  // at least the best seed FOM, and a seed that far below it is not worth fitting.
+  if(fSeedPruneFOMMargin >= 0) {
+    FoMCalculator seedFoMCalculator;
+    seedFoMCalculator.LoadVertexGeometry(myvtxgeo);
+    double coneAngle = Parameters::CherenkovAngle();
+    double bestSeedFOM = -9999.;
+    for( unsigned int n=0; n<nlast; n++ ){
+      RecoVertex& seed = fGridSeedVertices.at(n);
+      if( !seed.FoundVertex() || !seed.FoundDirection() ) continue;
+      seedFoMCalculator.ExtendedVertexChi2(seed.GetPosition().X(), seed.GetPosition().Y(), seed.GetPosition().Z(),
+                                           seed.GetDirection().X(), seed.GetDirection().Y(), seed.GetDirection().Z(),
+                                           coneAngle, seed.GetTime(), fGridSeedFOM.at(n));
+      if(fGridSeedFOM.at(n) > bestSeedFOM) bestSeedFOM = fGridSeedFOM.at(n);
+    }
+    fGridSeedPruneFOM = bestSeedFOM - fSeedPruneFOMMargin;
+  }
+  
+  // One optimizer fits all the seeds; each fit starts by clearing
+  // the Minuit parameters and setting them from the seed.
+  MinuitOptimizer* myOptimizer = new MinuitOptimizer();
+  myOptimizer->SetPrintLevel(0);
+  myOptimizer->SetUseAnalyticGradient(fUseAnalyticGradient);
+  myOptimizer->SetMeanTimeCalculatorType(1);
+  myOptimizer->LoadVertexGeometry(myvtxgeo); //Load vertex geometry
+  myOptimizer->SetFitterTimeRange(fTmin, fTmax); //Set time range to fit over 
   
   for( unsigned int n=0; n<nlast; n++ ){
+    if(fSeedPruneFOMMargin >= 0 && fGridSeedFOM.at(n) < fGridSeedPruneFOM) continue;
     //Find best time with Minuit
-    MinuitOptimizer* myOptimizer = new MinuitOptimizer();
-    myOptimizer->SetPrintLevel(0);
-    myOptimizer->SetMeanTimeCalculatorType(1);
-    myOptimizer->LoadVertexGeometry(myvtxgeo); //Load vertex geometry
-    myOptimizer->SetFitterTimeRange(fTmin, fTmax); //Set time range to fit over 
-    fSeedPos = &(vSeedVtxList->at(n));
-  	fSimpleVertex= this->FindSimpleDirection(fSeedPos);
-    myOptimizer->LoadVertex(fSimpleVertex); //Load vertex seed
+    myOptimizer->GetFittedVertex()->Reset();
+    myOptimizer->LoadVertex(&fGridSeedVertices.at(n)); //Load vertex seed
     myOptimizer->FitExtendedVertexWithMinuit(); //scan the point position in 4D space
-    vtxFOM = myOptimizer->GetFittedVertex()->GetFOM();
-    vtxRecoStatus = myOptimizer->GetFittedVertex()->GetStatus();
- 
-    if((vtxFOM>bestFOM) && (vtxRecoStatus==0)){
-      bestGridVertex->CloneVertex(myOptimizer->GetFittedVertex());
-      bestFOM = vtxFOM;
+    fGridFitFOM.at(n) = myOptimizer->GetFittedVertex()->GetFOM();
+    fGridFitStatus.at(n) = myOptimizer->GetFittedVertex()->GetStatus();
+    fGridFitVertices.at(n).CloneVertex(myOptimizer->GetFittedVertex());
+  }
+  delete myOptimizer; myOptimizer = 0;
+  
+  // pick the best fit; on equal FOMs the first seed wins
+  int best = -1;
+  for( unsigned int n=0; n<nlast; n++ ){
+    if((fGridFitFOM.at(n)>bestFOM) && (fGridFitStatus.at(n)==0)){
+      best = n;
+      bestFOM = fGridFitFOM.at(n);
     }
-    delete myOptimizer; myOptimizer = 0;
   }
+  if(best >= 0) fExtendedVertex->CloneVertex(&fGridFitVertices.at(best));
   if (verbosity>4){
     std::cout << "Best fit vertex information: " << std::endl;
     std::cout << "bestFOM: " << bestFOM << std::endl;
-    std::cout << "best fit reco status: " << bestGridVertex->GetStatus() << std::endl;
-    std::cout << "BestVertex info: " << bestGridVertex->Print() << std::endl;
+    std::cout << "best fit reco status: " << fExtendedVertex->GetStatus() << std::endl;
+    std::cout << "BestVertex info: " << fExtendedVertex->Print() << std::endl;
   }
-  return bestGridVertex;
+  return fExtendedVertex;
 }
 
-RecoVertex* VtxExtendedVertexFinder::FindSimpleDirection(RecoVertex* myVertex) {
+void VtxExtendedVertexFinder::FindSimpleDirection(RecoVertex* myVertex, RecoVertex* newVertex) {
 	
   /// get vertex position
   double vtxX = myVertex->GetPosition().X();
@@ -273,7 +320,7 @@ RecoVertex* VtxExtendedVertexFinder::FindSimpleDirection(RecoVertex* myVertex) {
 
   // set vertex and direction
   // ========================
-  RecoVertex* newVertex = new RecoVertex(); // Note: pointer must be deleted by the invoker
+  newVertex->Reset();
   
   if( pass ){
     newVertex->SetVertex(vtxX,vtxY,vtxZ,vtxTime);
@@ -285,10 +332,6 @@ RecoVertex* VtxExtendedVertexFinder::FindSimpleDirection(RecoVertex* myVertex) {
   // ==========
   if( !pass ) status |= RecoVertex::kFailSimpleDirection;
   newVertex->SetStatus(status);
-
-  // return vertex
-  // =============
-  return newVertex;
 }
 
 // Add extended vertex to RecoEvent store
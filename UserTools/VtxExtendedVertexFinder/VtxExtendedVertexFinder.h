@@ -3,6 +3,7 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
 
 #include "Tool.h"
 #include <VertexGeometry.h>
@@ -42,8 +43,9 @@ class VtxExtendedVertexFinder: public Tool {
   /// \brief Run ExtendedVertex with every grid seed
   RecoVertex* FitGridSeeds(std::vector<RecoVertex>* vSeedVtxList);
   
-  /// \brief Find a simple direction using weighted sum of digit charges 
-  RecoVertex* FindSimpleDirection(RecoVertex* myvertex);
+  /// \brief Find a simple direction using weighted sum of digit charges.
+  /// Sets newvertex to myvertex with that direction.
+  void FindSimpleDirection(RecoVertex* myvertex, RecoVertex* newvertex);
   
   /// \brief Reset everything
   void Reset();
@@ -63,6 +65,22 @@ class VtxExtendedVertexFinder: public Tool {
   /// Vertex Geometry shared by Fitter tools
   VertexGeometry* myvtxgeo;
   
+  /// \brief Grid seeds with a simple direction, and their FOM before fitting
+  std::vector<RecoVertex> fGridSeedVertices;
+  std::vector<double> fGridSeedFOM;
+  
+  /// \brief Seeds with a FOM more than this below the best seed's are not fitted (off if < 0)
+  double fSeedPruneFOMMargin;
+  double fGridSeedPruneFOM;
+  
+  /// \brief Fit with the analytic FOM gradient rather than Minuit's numerical one
+  bool fUseAnalyticGradient;
+  
+  /// \brief Fitted vertex, FOM and status of each grid seed, by seed index
+  std::vector<RecoVertex> fGridFitVertices;
+  std::vector<double> fGridFitFOM;
+  std::vector<int> fGridFitStatus;
+  
   /// verbosity levels: if 'verbosity' < this level, the message type will be logged.
   int verbosity=-1;
   int v_error=0;
@@ -13,9 +13,11 @@ bool VtxPointDirectionFinder::Initialise(std::string configfile, DataModel &data
   /////////////////////////////////////////////////////////////////
   
   fUseTrueVertexAsSeed = false;
+  fUseAnalyticGradient = false;
   
   /// Get the Tool configuration variables
 	m_variables.Get("UseTrueVertexAsSeed",fUseTrueVertexAsSeed);
+	m_variables.Get("UseAnalyticGradient",fUseAnalyticGradient);
 	m_variables.Get("verbosity", verbosity);
 	
 	/// The pointer has to be deleted after usage
@@ -197,6 +199,7 @@ RecoVertex* VtxPointDirectionFinder::FitPointDirection(RecoVertex* myVertex) {
   //fit with Minuit
   MinuitOptimizer* myOptimizer = new MinuitOptimizer();
   myOptimizer->SetPrintLevel(0);
+  myOptimizer->SetUseAnalyticGradient(fUseAnalyticGradient);
   myOptimizer->SetMeanTimeCalculatorType(1); //Type 1: most probable time
   VertexGeometry* myvtxgeo = VertexGeometry::Instance();
   myOptimizer->LoadVertexGeometry(myvtxgeo); //Load vertex geometry
@@ -45,6 +45,7 @@ class VtxPointDirectionFinder: public Tool {
  	void PushPointDirection(RecoVertex* vtx, bool savetodisk);
  	
  	bool fUseTrueVertexAsSeed;
+ 	bool fUseAnalyticGradient; ///< fit with the analytic FOM gradient rather than Minuit's numerical one
  	RecoVertex* fTrueVertex = 0;
  	std::vector<RecoDigit>* fDigitList = 0;
  	
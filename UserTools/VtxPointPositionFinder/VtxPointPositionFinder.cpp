@@ -13,10 +13,12 @@ bool VtxPointPositionFinder::Initialise(std::string configfile, DataModel &data)
   /////////////////////////////////////////////////////////////////
   
   fUseTrueVertexAsSeed = false;
+  fUseAnalyticGradient = false;
   fUseMinuit = true;
   
   /// Get the Tool configuration variables
 	m_variables.Get("UseTrueVertexAsSeed",fUseTrueVertexAsSeed);
+	m_variables.Get("UseAnalyticGradient",fUseAnalyticGradient);
 	m_variables.Get("UseMinuitForPos",fUseMinuit);
 	m_variables.Get("verbosity", verbosity);
 	
@@ -148,6 +150,7 @@ RecoVertex* VtxPointPositionFinder::FitPointPosition(RecoVertex* myVertex) {
   //fit with Minuit
   MinuitOptimizer* myOptimizer = new MinuitOptimizer();
   myOptimizer->SetPrintLevel(0);
+  myOptimizer->SetUseAnalyticGradient(fUseAnalyticGradient);
   myOptimizer->SetMeanTimeCalculatorType(1); //
   VertexGeometry* myvtxgeo = VertexGeometry::Instance();
   myOptimizer->LoadVertexGeometry(myvtxgeo); //Load vertex geometry
@@ -181,6 +184,7 @@ RecoVertex* VtxPointPositionFinder::FindSimplePosition(std::vector<RecoVertex>*
   //Find best time with Minuit
   MinuitOptimizer* myOptimizer = new MinuitOptimizer();
   myOptimizer->SetPrintLevel(0);
+  myOptimizer->SetUseAnalyticGradient(fUseAnalyticGradient);
   myOptimizer->SetMeanTimeCalculatorType(1);
   VertexGeometry* myvtxgeo = VertexGeometry::Instance();
   myOptimizer->LoadVertexGeometry(myvtxgeo); //Load vertex geometry
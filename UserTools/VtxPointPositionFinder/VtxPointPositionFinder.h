@@ -55,6 +55,7 @@ class VtxPointPositionFinder: public Tool {
  	void PushVertexSeedFOMList(bool savetodisk);
  	
  	bool fUseTrueVertexAsSeed;
+ 	bool fUseAnalyticGradient; ///< fit with the analytic FOM gradient rather than Minuit's numerical one
  	bool fUseMinuit; //If True, give the best GridSeed to the Minuit Optimizer
 
  	RecoVertex* fTrueVertex = 0;
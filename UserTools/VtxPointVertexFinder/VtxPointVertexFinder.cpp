@@ -12,9 +12,11 @@ bool VtxPointVertexFinder::Initialise(std::string configfile, DataModel &data){
   m_data= &data; //assigning transient data pointer
   /////////////////////////////////////////////////////////////////
 	fUseTrueVertexAsSeed = false;
+	fUseAnalyticGradient = false;
   
   /// Get the Tool configuration variables
 	m_variables.Get("UseTrueVertexAsSeed",fUseTrueVertexAsSeed);
+	m_variables.Get("UseAnalyticGradient",fUseAnalyticGradient);
 	m_variables.Get("verbosity", verbosity);
 	
 	/// The pointer has to be deleted after usage
@@ -107,6 +109,7 @@ RecoVertex* VtxPointVertexFinder::FitPointVertex(RecoVertex* myVertex) {
   //fit with Minuit
   MinuitOptimizer* myOptimizer = new MinuitOptimizer();
   myOptimizer->SetPrintLevel(0);
+  myOptimizer->SetUseAnalyticGradient(fUseAnalyticGradient);
   myOptimizer->SetMeanTimeCalculatorType(1); //Type 1: most probable time
   VertexGeometry* myvtxgeo = VertexGeometry::Instance();
   myOptimizer->LoadVertexGeometry(myvtxgeo); //Load vertex geometry
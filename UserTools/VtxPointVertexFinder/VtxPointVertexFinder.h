@@ -39,6 +39,7 @@ class VtxPointVertexFinder: public Tool {
  	void PushPointVertex(RecoVertex* vtx, bool savetodisk);
  	
  	bool fUseTrueVertexAsSeed;
+ 	bool fUseAnalyticGradient; ///< fit with the analytic FOM gradient rather than Minuit's numerical one
  	RecoVertex* fTrueVertex = 0;
  	std::vector<RecoDigit>* fDigitList = 0;
  	
@@ -121,19 +121,22 @@ bool VtxSeedGenerator::GenerateSeedGrid(int NSeeds) {
 
   // form list of golden digits used in class methods
   // Here, the digit type (PMT or LAPPD or all) is specified.
+  // Their positions and times are kept in fSeedDigitX/Y/Z/T for GetMedianSeedTime.
   Log("VtxSeedGenerator Tool: Getting clean RecoDigits for event", v_debug,verbosity);
   vSeedDigitList.clear();  
-  RecoDigit digit;
+  fSeedDigitX.clear();
+  fSeedDigitY.clear();
+  fSeedDigitZ.clear();
+  fSeedDigitT.clear();
   for( fThisDigit=0; fThisDigit<fDigitList->size(); fThisDigit++ ){
-  	digit = fDigitList->at(fThisDigit);
-    if( digit.GetFilterStatus() ){ 
-      if( digit.GetDigitType() == fSeedType){ 
-        vSeedDigitList.push_back(fThisDigit);
-      }
-      else if (fSeedType == 2){
-        //Use all digits available
-        vSeedDigitList.push_back(fThisDigit);
-      }
+    const RecoDigit& digit = fDigitList->at(fThisDigit);
+    if( digit.GetFilterStatus() && (digit.GetDigitType() == fSeedType || fSeedType == 2) ){ 
+      //fSeedType 2: Use all digits available
+      vSeedDigitList.push_back(fThisDigit);
+      fSeedDigitX.push_back(digit.GetPosition().X());
+      fSeedDigitY.push_back(digit.GetPosition().Y());
+      fSeedDigitZ.push_back(digit.GetPosition().Z());
+      fSeedDigitT.push_back(digit.GetCalTime());
     }
   }
   
@@ -143,11 +146,32 @@ bool VtxSeedGenerator::GenerateSeedGrid(int NSeeds) {
     return false;
   }
   	
-  //Now, we generate our grid of position/time guesses.  Position first.
+  // The grid positions only depend on the geometry and NSeeds
+  if( fGridNSeeds!=NSeeds ) this->MakeSeedGridPositions(NSeeds);
+
+  //Now, push a vertex for each grid position with its median time
+  vSeedVtxList->reserve(vSeedVtxList->size()+fGridX.size());
+  RecoVertex thisgridseed;
+  for (size_t k=0; k<fGridX.size(); k++) {
+    double mediantime = this->GetMedianSeedTime(fGridX[k],fGridY[k],fGridZ[k]);
+    thisgridseed.SetVertex(fGridX[k],fGridY[k],fGridZ[k],mediantime);
+    vSeedVtxList->push_back(thisgridseed);
+  }
+  Log("VtxSeedGenerator Tool: Grid of positions and median times calculated", v_debug,verbosity);
+  return true;
+}
+
+void VtxSeedGenerator::MakeSeedGridPositions(int NSeeds) {
+  //Now, we generate our grid of position guesses.
   //We will use Vogel's method to populate disks with equidistant points
   //inside the ANNIE tank.  The z separation for each disk will be approx. the
   //average separation of points on the disk.
   Log("VtxSeedGenerator Tool: Generating grid of positions", v_debug,verbosity);
+  fGridX.clear();
+  fGridY.clear();
+  fGridZ.clear();
+  fGridNSeeds = NSeeds;
+
   //Here, we need to get the radius and height of the ANNIE tank from the geo
   double pmtradius = ANNIEGeometry::Instance()->GetPMTRadius();	
   double pmtlength = ANNIEGeometry::Instance()->GetCylLength();
@@ -173,57 +197,47 @@ bool VtxSeedGenerator::GenerateSeedGrid(int NSeeds) {
     zpoints.push_back(z);
   }
 
-  //Now, push a vertex for each point in each disk layer
-  double diskind,layers,disk_height,mediantime;
+  //Now, a position for each point in each disk layer
+  double diskind,layers,disk_height;
   for (int j=0; j<numlayers; j++){
     for (int k=0; k<points_ondisk; k++) {
       diskind = (double) j;
       layers = (double) numlayers;
       disk_height = pmtlength*((diskind+0.5)/layers) - (pmtlength/2.0);
-      Position thisgridpos;
-      thisgridpos.SetX(xpoints[k]);
-      thisgridpos.SetZ(zpoints[k]);
-      thisgridpos.SetY(disk_height);
-      mediantime = this->GetMedianSeedTime(thisgridpos);
-      RecoVertex thisgridseed;
-      thisgridseed.SetVertex(thisgridpos,mediantime);
-      vSeedVtxList->push_back(thisgridseed);
+      fGridX.push_back(xpoints[k]);
+      fGridY.push_back(disk_height);
+      fGridZ.push_back(zpoints[k]);
     }
   }
-  Log("VtxSeedGenerator Tool: Grid of positions and median times calculated", v_debug,verbosity);
-  return true;
 }
 
-double VtxSeedGenerator::GetMedianSeedTime(Position pos){
-  double digitx, digity, digitz, digittime;
-  double dx,dy,dz,dr;
-  double fC, fN;
-  double seedtime;
-  std::vector<double> extraptimes;
-  for (int entry=0; entry<vSeedDigitList.size(); entry++){
-    fThisDigit = vSeedDigitList.at(entry);
-    digitx = fDigitList->at(fThisDigit).GetPosition().X();
-    digity = fDigitList->at(fThisDigit).GetPosition().Y();
-    digitz = fDigitList->at(fThisDigit).GetPosition().Z();
-    digittime = fDigitList->at(fThisDigit).GetCalTime();
+double VtxSeedGenerator::GetMedianSeedTime(double posX, double posY, double posZ){
+  //Back calculate to the vertex time using speed of light in H20
+  //Very rough estimate; ignores muon path before Cherenkov production
+  //TODO: add charge weighting?  Kinda like CalcSimpleVertex?
+  const double fC = Parameters::SpeedOfLight();
+  const double fN = Parameters::Index0();
+  const double fCn = fC/fN;
+
+  const size_t ndigits = fSeedDigitT.size();
+  fExtrapTimes.resize(ndigits);
+  const double* digitx = fSeedDigitX.data();
+  const double* digity = fSeedDigitY.data();
+  const double* digitz = fSeedDigitZ.data();
+  const double* digittime = fSeedDigitT.data();
+  double* extraptimes = fExtrapTimes.data();
+  for (size_t entry=0; entry<ndigits; entry++){
     //Now, find distance to seed position
-    dx = digitx - pos.X();
-    dy = digity - pos.Y();
-    dz = digitz - pos.Z();
-    dr = sqrt(pow(dx,2) + pow(dy,2) + pow(dz,2));
-
-    //Back calculate to the vertex time using speed of light in H20
-    //Very rough estimate; ignores muon path before Cherenkov production
-    //TODO: add charge weighting?  Kinda like CalcSimpleVertex?
-    fC = Parameters::SpeedOfLight();
-    fN = Parameters::Index0();
-    seedtime = digittime - (dr/(fC/fN));
-    extraptimes.push_back(seedtime);
+    double dx = digitx[entry] - posX;
+    double dy = digity[entry] - posY;
+    double dz = digitz[entry] - posZ;
+    double dr = sqrt(dx*dx + dy*dy + dz*dz);
+    extraptimes[entry] = digittime[entry] - dr/fCn;
   }
   //return the median of the extrapolated vertex times
-  size_t median_index = extraptimes.size() / 2;
-  std::nth_element(extraptimes.begin(), extraptimes.begin()+median_index, extraptimes.end());
-  return extraptimes[median_index];
+  size_t median_index = ndigits / 2;
+  std::nth_element(fExtrapTimes.begin(), fExtrapTimes.begin()+median_index, fExtrapTimes.end());
+  return fExtrapTimes[median_index];
 }  
 
 bool VtxSeedGenerator::GenerateVertexSeeds(int NSeeds) {
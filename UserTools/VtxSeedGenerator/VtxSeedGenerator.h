@@ -30,8 +30,11 @@ class VtxSeedGenerator: public Tool {
         /// \brief Grid Seed calculator
         ///
 	bool GenerateSeedGrid(int NSeeds);	
-	/// from the position to a digit
-	double GetMedianSeedTime(Position pos);	
+	/// \brief Fill fGridX/Y/Z with the grid positions for NSeeds seeds
+	void MakeSeedGridPositions(int NSeeds);
+	/// \brief Median of the vertex times extrapolated back
+	/// from the seed digits to the position
+	double GetMedianSeedTime(double posX, double posY, double posZ);	
  	
  	/// \brief Calculate seed candidate
  	///
@@ -87,6 +90,20 @@ class VtxSeedGenerator: public Tool {
   int UseSeedGrid=0;
   std::vector<RecoVertex>* SeedGridList = nullptr;
   
+  /// Grid positions, made once for fGridNSeeds seeds
+  int fGridNSeeds = -1;
+  std::vector<double> fGridX;
+  std::vector<double> fGridY;
+  std::vector<double> fGridZ;
+  
+  /// Positions and times of the digits in vSeedDigitList, and the
+  /// buffer GetMedianSeedTime selects the median from
+  std::vector<double> fSeedDigitX;
+  std::vector<double> fSeedDigitY;
+  std::vector<double> fSeedDigitZ;
+  std::vector<double> fSeedDigitT;
+  std::vector<double> fExtrapTimes;
+  
   /// verbosity levels: if 'verbosity' < this level, the message type will be logged.
   int verbosity=-1;
 	int v_error=0;
@@ -58,8 +58,8 @@ bool WaveformNNLS::Execute(){
 	string RawDataName;
 	m_variables.Get("rawdataname", RawDataName);
 
-	map<int,vector<Waveform<double>>> rawData;
-	m_data->Stores["ANNIEEvent"]->Get(RawDataName,rawData);
+	const map<int,vector<Waveform<double>>> noData;
+	const auto& rawData = ANNIEEventMember::Get(m_data->Stores["ANNIEEvent"],RawDataName,noData);
 
 	//This variable controls the sampling depth of the
 	//nnls algorithm and allows the template to have
@@ -148,7 +148,7 @@ bool WaveformNNLS::Execute(){
 	//default to avoid crashing
 	else
 	{
-		Waveform<double> example_waveform = rawData[0].front();
+		Waveform<double> example_waveform = rawData.at(0).front();
 		for(int i = 0; i < example_waveform.GetSamples()->size(); i++)
 		{
 			sampletimes.push_back(i);
@@ -171,7 +171,7 @@ bool WaveformNNLS::Execute(){
 	//is set to match the timesteps of the NEW template
 	//waveform and the signal waveform. Here, we get
 	//the signal waveform and expand it to that nrows sampling rate
-	map <int, vector<Waveform<double>>> :: iterator itr;
+	map <int, vector<Waveform<double>>> :: const_iterator itr;
     Waveform<double> signalwave; 
     size_t nrows = newsignaltimes.size();
     int flag; //error flag on nnls solver
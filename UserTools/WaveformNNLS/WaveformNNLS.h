@@ -9,6 +9,7 @@
 #include <TString.h>
 #include <TH1.h>
 #include "Tool.h"
+#include "ANNIEEventMember.h"
 #include "NnlsSolution.h"
 
 
@@ -0,0 +1,42 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+
+// Minimal helpers shared by the standalone checks. CHECK reports the failing
+// condition and counts it, so a check program keeps going and returns the
+// number of failures from main.
+
+static int check_failures = 0;
+
+#define CHECK(cond) \
+  do { if(!(cond)){ std::cout<<__FILE__<<":"<<__LINE__<<": CHECK failed: "<<#cond<<std::endl; \
+    check_failures++; } } while(0)
+
+// Copy the first max_bytes of a file (all of it if max_bytes<0), e.g. to
+// simulate a crash or a truncated transfer
+inline bool CopyFilePrefix(const std::string& from, const std::string& to, long max_bytes=-1){
+  std::ifstream in(from, std::ios::binary);
+  if(!in) return false;
+  std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+  if(max_bytes>=0 && (size_t)max_bytes<bytes.size()) bytes.resize(max_bytes);
+  std::ofstream out(to, std::ios::binary | std::ios::trunc);
+  out.write(bytes.data(), bytes.size());
+  return bool(out);
+}
+
+inline long FileSize(const std::string& filename){
+  std::ifstream in(filename, std::ios::binary | std::ios::ate);
+  return in ? long(in.tellg()) : -1;
+}
+
+inline int CheckResult(const std::string& name){
+  if(check_failures) std::cout<<name<<": "<<check_failures<<" checks failed"<<std::endl;
+  else std::cout<<name<<": OK"<<std::endl;
+  return check_failures;
+}
+
+#endif
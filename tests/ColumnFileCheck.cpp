@@ -0,0 +1,92 @@
+// Round trip of the ANNIEEventColumnFile format (ANNIEEventBuilder OutputFormat
+// ColumnFile, LoadANNIEEvent InputFormat ColumnFile): chunked writing, members
+// missing from some events, MCHit parents, and reading a file that was copied
+// while still being written or was cut short.
+#include "ANNIEEventColumnFile.h"
+#include "Check.h"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace ANNIEEventColumn;
+
+int main(){
+
+  const std::string filename = "ColumnFileCheck.col";
+  const std::string crashname = "ColumnFileCheck_crash.col";
+  const std::string truncname = "ColumnFileCheck_trunc.col";
+  const int num_events = 250;
+  const int events_per_chunk = 100;
+
+  {
+    ANNIEEventColumnWriter writer;
+    writer.SetEventsPerChunk(events_per_chunk);
+    CHECK(writer.Open(filename));
+    for(int event=0; event<num_events; event++){
+      writer.SetEventMember("EventNumber", event);
+      HitMap hits;
+      hits[event%7].push_back(Hit(event,1.5*event,2.0));
+      writer.SetEventMember("TDCData", hits);
+      MCHitMap mchits;
+      mchits[3].push_back(MCHit(1,2.0,3.0,std::vector<int>{event,event+1}));
+      mchits[5].push_back(MCHit(2,4.0,5.0,{}));
+      writer.SetEventMember("MCHits", mchits);
+      // a member that only appears part way through the file
+      if(event>=150) writer.SetEventMember("Late", std::string("x")+std::to_string(event));
+      CHECK(writer.WriteEvent());
+      // a copy taken now is what a crash would leave behind: only whole chunks
+      if(event==num_events-1) CHECK(CopyFilePrefix(filename, crashname));
+    }
+    CHECK(writer.Close());
+  }
+
+  ANNIEEventColumnReader reader;
+  CHECK(reader.Open(filename));
+  CHECK(reader.GetNumEvents()==(uint64_t)num_events);
+  int column = reader.FindColumn("TDCData");
+  CHECK(column>=0);
+  if(column>=0) CHECK(reader.GetColumnType(column)=="HitMap");
+  CHECK(reader.FindColumn("NotAMember")==-1);
+  for(int event=0; event<num_events; event++){
+    int event_number = -1;
+    CHECK(reader.Get("EventNumber",event,event_number) && event_number==event);
+    HitMap hits;
+    CHECK(reader.Get("TDCData",event,hits));
+    CHECK(hits.count(event%7) && hits.at(event%7).size()==1 && hits.at(event%7).at(0).GetTubeId()==event);
+    MCHitMap mchits;
+    CHECK(reader.Get("MCHits",event,mchits));
+    CHECK(mchits.count(3) && mchits.at(3).at(0).GetParents()->size()==2 && mchits.at(3).at(0).GetParents()->at(1)==event+1);
+    CHECK(mchits.count(5) && mchits.at(5).at(0).GetParents()->empty());
+    std::string late;
+    bool has_late = reader.Get("Late",event,late);
+    CHECK(has_late==(event>=150));
+    if(has_late) CHECK(late=="x"+std::to_string(event));
+  }
+  reader.Close();
+
+  // the copy taken before Close holds the full chunks written so far
+  ANNIEEventColumnReader crashed;
+  CHECK(crashed.Open(crashname));
+  CHECK(crashed.GetNumEvents()==(uint64_t)(num_events/events_per_chunk)*events_per_chunk);
+  int event_number = -1;
+  CHECK(crashed.Get("EventNumber",crashed.GetNumEvents()-1,event_number) && event_number==(int)crashed.GetNumEvents()-1);
+  crashed.Close();
+
+  // a file cut short mid-chunk still opens, with every event it reports readable
+  CHECK(CopyFilePrefix(crashname, truncname, FileSize(crashname)-FileSize(crashname)/10));
+  ANNIEEventColumnReader truncated;
+  CHECK(truncated.Open(truncname));
+  CHECK(truncated.GetNumEvents()<(uint64_t)num_events);
+  for(uint64_t event=0; event<truncated.GetNumEvents(); event++){
+    HitMap hits;
+    CHECK(truncated.Get("EventNumber",event,event_number) && event_number==(int)event);
+    CHECK(truncated.Get("TDCData",event,hits));
+  }
+  truncated.Close();
+
+  std::remove(filename.c_str());
+  std::remove(crashname.c_str());
+  std::remove(truncname.c_str());
+  return CheckResult("ColumnFileCheck");
+}
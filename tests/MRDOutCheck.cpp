@@ -0,0 +1,128 @@
+// Serialisation of MRDOut: version 1 (packed MRDHit words) round trips, and
+// version 0 archives (one vector per hit field) still load. Also checks the
+// MRDHit bit packing and the MRDEventMap serialisation used by the CStore.
+#include "MRDOut.h"
+#include "Check.h"
+
+#include <boost/archive/binary_oarchive.hpp>
+#include <boost/archive/binary_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/string.hpp>
+
+#include <sstream>
+
+// MRDOut as it was serialised before the hits were packed. It has the same
+// serialisation traits as MRDOut, so its archives match those of an MRDOut at
+// class version 0.
+class MRDOutV0 {
+
+  friend class boost::serialization::access;
+
+ public:
+
+  unsigned int OutN, Trigger;
+  std::vector<unsigned int> Value, Slot, Channel, Crate;
+  std::vector<std::string> Type;
+  long TimeStamp;
+
+ private:
+
+  template <class Archive> void serialize(Archive& ar, const unsigned int version){
+    ar & OutN;
+    ar & Trigger;
+    ar & Value;
+    ar & Slot;
+    ar & Channel;
+    ar & Crate;
+    ar & Type;
+    ar & TimeStamp;
+  }
+
+};
+
+template<class T> static std::string Save(const T& object){
+  std::stringstream stream;
+  {
+    boost::archive::binary_oarchive archive(stream);
+    archive << object;
+  }
+  return stream.str();
+}
+
+template<class T> static void Load(const std::string& bytes, T& object){
+  std::stringstream stream(bytes);
+  boost::archive::binary_iarchive archive(stream);
+  archive >> object;
+}
+
+int main(){
+
+  // bit packing, including the extremes of each field
+  MRDHit hit(255, 24, 31, 0xFFFFFFFFu, MRDHit::ADC);
+  CHECK(hit.Crate()==255 && hit.Slot()==24 && hit.Channel()==31);
+  CHECK(hit.Value()==0xFFFFFFFFu && hit.Type()==MRDHit::ADC);
+  MRDHit tdc_hit(7, 3, 0, 0);
+  CHECK(tdc_hit.Crate()==7 && tdc_hit.Slot()==3 && tdc_hit.Channel()==0 && tdc_hit.Value()==0);
+  CHECK(tdc_hit.Type()==MRDHit::TDC);
+  CHECK(MRDHit::TypeFromString("TDC")==MRDHit::TDC && MRDHit::TypeFromString("ADC")==MRDHit::ADC);
+  CHECK(MRDHit::TypeFromString("")==MRDHit::Unknown);
+
+  // version 1 round trip
+  MRDOut out;
+  out.OutN = 3;
+  out.Trigger = 11;
+  out.TimeStamp = 1546300800000L;
+  out.Hits.emplace_back(7, 3, 12, 845);
+  out.Hits.emplace_back(8, 15, 31, 0xFFFFFFFFu, MRDHit::ADC);
+  out.Hits.emplace_back(9, 0, 0, 0, MRDHit::Unknown);
+  MRDOut in;
+  Load(Save(out), in);
+  CHECK(in.OutN==3 && in.Trigger==11 && in.TimeStamp==1546300800000L);
+  CHECK(in.Hits.size()==3);
+  for(size_t i=0; i<in.Hits.size() && i<out.Hits.size(); i++) CHECK(in.Hits[i].Word==out.Hits[i].Word);
+
+  // version 0 archives load into the packed hits
+  MRDOutV0 old_out;
+  old_out.OutN = 2;
+  old_out.Trigger = 5;
+  old_out.TimeStamp = 1546300800123L;
+  old_out.Value = {845, 17, 4000};
+  old_out.Slot = {3, 15, 22};
+  old_out.Channel = {12, 31, 0};
+  old_out.Crate = {7, 8, 7};
+  old_out.Type = {"TDC", "ADC", "junk"};
+  MRDOut converted;
+  Load(Save(old_out), converted);
+  CHECK(converted.OutN==2 && converted.Trigger==5 && converted.TimeStamp==1546300800123L);
+  CHECK(converted.Hits.size()==3);
+  if(converted.Hits.size()==3){
+    for(size_t i=0; i<3; i++){
+      CHECK(converted.Hits[i].Value()==old_out.Value[i]);
+      CHECK(converted.Hits[i].Slot()==old_out.Slot[i]);
+      CHECK(converted.Hits[i].Channel()==old_out.Channel[i]);
+      CHECK(converted.Hits[i].Crate()==old_out.Crate[i]);
+    }
+    CHECK(converted.Hits[0].Type()==MRDHit::TDC);
+    CHECK(converted.Hits[1].Type()==MRDHit::ADC);
+    CHECK(converted.Hits[2].Type()==MRDHit::Unknown);
+  }
+  // version 0 files could hold fewer types than hits
+  old_out.Type.resize(1);
+  Load(Save(old_out), converted);
+  CHECK(converted.Hits.size()==3 && converted.Hits[0].Type()==MRDHit::TDC && converted.Hits[2].Type()==MRDHit::Unknown);
+
+  // MRDEventMap, as kept in the CStore by MRDDataDecoder
+  MRDEventMap events;
+  events[5].Hits = {{1,2},{3,4}};
+  events[5].TriggerType = "Beam";
+  events[5].BeamLoopbackTDC = 812;
+  events[7].CosmicLoopbackTDC = 9;
+  MRDEventMap loaded;
+  Load(Save(events), loaded);
+  CHECK(loaded.size()==2);
+  CHECK(loaded[5].Hits.size()==2 && loaded[5].Hits[1].first==3 && loaded[5].Hits[1].second==4);
+  CHECK(loaded[5].TriggerType=="Beam" && loaded[5].BeamLoopbackTDC==812 && loaded[5].CosmicLoopbackTDC==-1);
+  CHECK(loaded[7].TriggerType=="No Loopback" && loaded[7].CosmicLoopbackTDC==9);
+
+  return CheckResult("MRDOutCheck");
+}
@@ -0,0 +1,138 @@
+// Round trip of the ANNIEEventRecordFile format (ANNIEEventBuilder OutputFormat
+// RecordFile, LoadANNIEEvent InputFormat RecordFile): run constants, random
+// access, appending a second run, and rejecting truncated, corrupt or
+// malformed records instead of reading past their end.
+#include "ANNIEEventRecordFile.h"
+#include "Check.h"
+
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/zlib.hpp>
+
+#include <cstdio>
+#include <string>
+
+// Write a file holding a single event record with the given (uncompressed) payload
+static void WriteEventRecord(const std::string& filename, const std::string& payload){
+  std::string compressed;
+  {
+    boost::iostreams::filtering_ostream out;
+    out.push(boost::iostreams::zlib_compressor());
+    out.push(boost::iostreams::back_inserter(compressed));
+    out.write(payload.data(), payload.size());
+  }
+  std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+  file.write(ANNIEEventRecord::MAGIC, 8);
+  file.write(reinterpret_cast<const char*>(&ANNIEEventRecord::VERSION), 4);
+  uint32_t length = compressed.size();
+  uint8_t type = ANNIEEventRecord::EVENT_RECORD;
+  file.write(reinterpret_cast<const char*>(&length), 4);
+  file.write(reinterpret_cast<const char*>(&type), 1);
+  file.write(compressed.data(), length);
+}
+
+static std::string U32(uint32_t value){
+  return std::string(reinterpret_cast<const char*>(&value), 4);
+}
+
+int main(){
+
+  const std::string filename = "RecordFileCheck.rec";
+  std::remove(filename.c_str());
+
+  {
+    ANNIEEventRecordWriter writer;
+    writer.SetEventsPerFlush(7);
+    CHECK(writer.Open(filename));
+    writer.SetRunConstant("RunNumber", 42);
+    writer.SetRunConstant("RunStartTime", (uint64_t)1234);
+    for(int event=0; event<20; event++){
+      writer.SetEventMember("EventNumber", (uint32_t)event);
+      ANNIEEventColumn::WaveformMap waveforms;
+      waveforms[event].push_back(Waveform<uint16_t>());
+      writer.SetEventMember("RawADCData", waveforms);
+      writer.SetEventMember("MRDTriggerType", std::string(event%2 ? "Beam" : "Cosmic"));
+      CHECK(writer.WriteEvent());
+    }
+    writer.Close();
+    // reopening appends, here with the run constants of a new run
+    CHECK(writer.Open(filename));
+    writer.SetRunConstant("RunNumber", 43);
+    writer.SetEventMember("EventNumber", (uint32_t)20);
+    CHECK(writer.WriteEvent());
+    writer.Close();
+  }
+
+  ANNIEEventRecordReader reader;
+  CHECK(reader.Open(filename));
+  CHECK(reader.GetNumEvents()==21);
+  uint32_t event_number = 0;
+  int run_number = 0;
+  std::string trigger_type;
+  ANNIEEventColumn::WaveformMap waveforms;
+  CHECK(reader.ReadEvent(13));
+  CHECK(reader.Get("EventNumber", event_number) && event_number==13);
+  CHECK(reader.Get("RunNumber", run_number) && run_number==42);
+  CHECK(reader.Get("MRDTriggerType", trigger_type) && trigger_type=="Beam");
+  CHECK(reader.Get("RawADCData", waveforms) && waveforms.count(13));
+  CHECK(reader.GetEventMembers().at("RawADCData").Type=="WaveformMapUInt16");
+  CHECK(reader.GetRunConstants().at("RunStartTime").Type=="uint64");
+  CHECK(reader.ReadEvent(20));
+  CHECK(reader.Get("RunNumber", run_number) && run_number==43);
+  // going back to an earlier run reloads its run constants
+  CHECK(reader.ReadEvent(2));
+  CHECK(reader.Get("RunNumber", run_number) && run_number==42);
+  CHECK(reader.Get("EventNumber", event_number) && event_number==2);
+  CHECK(reader.ReadNextEvent());
+  CHECK(reader.Get("EventNumber", event_number) && event_number==3);
+  CHECK(!reader.ReadEvent(21));
+  reader.Close();
+
+  // a record cut short at the end of the file is dropped when indexing
+  const std::string truncname = "RecordFileCheck_trunc.rec";
+  CHECK(CopyFilePrefix(filename, truncname, FileSize(filename)-3));
+  CHECK(reader.Open(truncname));
+  CHECK(reader.GetNumEvents()==20);
+  CHECK(reader.ReadEvent(19));
+  reader.Close();
+
+  // corrupt the compressed payload of the first event, which follows the run constants record
+  {
+    std::fstream file(truncname, std::ios::in | std::ios::out | std::ios::binary);
+    uint32_t length = 0;
+    file.seekg(12);
+    file.read(reinterpret_cast<char*>(&length), 4);
+    file.seekp(12 + 4 + 1 + length + 4 + 1 + 2);
+    const char junk[8] = {1,2,3,4,5,6,7,8};
+    file.write(junk, 8);
+  }
+  CHECK(reader.Open(truncname));
+  CHECK(!reader.ReadEvent(0));
+  CHECK(reader.ReadEvent(1));
+  reader.Close();
+
+  // malformed payloads: lengths and counts running past the end of the record
+  const std::string badname = "RecordFileCheck_bad.rec";
+  const std::string bad_payloads[] = {
+    "",                                                            // no member count
+    U32(1000000),                                                  // more members than bytes
+    U32(1)+U32(100)+"ab",                                          // name longer than the record
+    U32(1)+U32(2)+"ab"+U32(3)+"int"+U32(1u<<31),                   // data longer than the record
+    U32(1)+U32(2)+"ab"+U32(3)+"int"+U32(4)+"abc",                  // data one byte short
+    U32(2)+U32(1)+"a"+U32(3)+"int"+U32(0)                          // second member missing
+  };
+  for(const std::string& payload : bad_payloads){
+    WriteEventRecord(badname, payload);
+    CHECK(reader.Open(badname) && reader.GetNumEvents()==1);
+    CHECK(!reader.ReadEvent(0));
+    reader.Close();
+  }
+  WriteEventRecord(badname, U32(1)+U32(1)+"a"+U32(3)+"int"+U32(0));
+  CHECK(reader.Open(badname));
+  CHECK(reader.ReadEvent(0) && reader.Has("a"));
+  reader.Close();
+
+  std::remove(filename.c_str());
+  std::remove(truncname.c_str());
+  std::remove(badname.c_str());
+  return CheckResult("RecordFileCheck");
+}
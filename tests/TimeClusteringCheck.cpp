@@ -0,0 +1,123 @@
+// Checks that the single sorted sweep used by TimeClustering::Execute to split MRD digits into
+// time clusters gives the same MrdTimeClusters and ClusterStartTimes as the previous algorithm,
+// which looped over all digits for every subevent.
+// Both are copied here from the tool (the multiple subevent branch only), as the tool itself
+// needs ROOT and ToolDAQ. Keep SweepClusters in step with TimeClustering.cpp.
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <iostream>
+
+struct Clusters {
+	std::vector<float> starttimes;
+	std::vector<std::vector<int>> digitids;
+};
+
+// previous TimeClustering: find the gaps in a sorted copy of the times, then scan all digits per subevent
+Clusters ReferenceClusters(const std::vector<double>& mrddigittimesthisevent, double minimum_subevent_timeseparation, unsigned int minimumdigits){
+	Clusters out;
+	int numdigits = mrddigittimesthisevent.size();
+	double eventendtime = *std::max_element(mrddigittimesthisevent.begin(),mrddigittimesthisevent.end());
+	std::vector<float> subeventendtimesv;
+	std::vector<double> sorteddigittimes(mrddigittimesthisevent);
+	std::sort(sorteddigittimes.begin(), sorteddigittimes.end());
+	out.starttimes.push_back(sorteddigittimes.at(0));
+	for(unsigned int i=0;i<sorteddigittimes.size()-1;i++){
+		float timetonextdigit = sorteddigittimes.at(i+1)-sorteddigittimes.at(i);
+		if(timetonextdigit>minimum_subevent_timeseparation){
+			subeventendtimesv.push_back(sorteddigittimes.at(i));
+			out.starttimes.push_back(sorteddigittimes.at(i+1));
+		}
+	}
+	std::vector<int> subeventnumthisevent(numdigits,-1);
+	for(unsigned int thissubevent=0; thissubevent<out.starttimes.size(); thissubevent++){
+		float endtime = (thissubevent<(out.starttimes.size()-1)) ? subeventendtimesv.at(thissubevent) : (eventendtime+1.);
+		std::vector<int> digitidsinasubevent;
+		for(int thisdigit=0;thisdigit<numdigits;thisdigit++){
+			if(subeventnumthisevent.at(thisdigit)<0 && mrddigittimesthisevent.at(thisdigit)<= endtime ){
+				digitidsinasubevent.push_back(thisdigit);
+				subeventnumthisevent.at(thisdigit)=thissubevent;
+			}
+		}
+		if(digitidsinasubevent.size()>=minimumdigits) out.digitids.push_back(digitidsinasubevent);
+	}
+	return out;
+}
+
+// current TimeClustering: one sort of (time, digit index) pairs, then a sweep over them
+Clusters SweepClusters(const std::vector<double>& mrddigittimesthisevent, double minimum_subevent_timeseparation, unsigned int minimumdigits){
+	Clusters out;
+	int numdigits = mrddigittimesthisevent.size();
+	std::vector<std::pair<double,int>> sortedtimeids;
+	for(int thisdigit=0;thisdigit<numdigits;thisdigit++){
+		sortedtimeids.emplace_back(mrddigittimesthisevent[thisdigit],thisdigit);
+	}
+	std::sort(sortedtimeids.begin(),sortedtimeids.end());
+	double eventendtime = sortedtimeids.back().first;
+
+	std::vector<float>& subeventhittimesv = out.starttimes;
+	std::vector<float> subeventendtimesv;
+	subeventhittimesv.push_back(sortedtimeids.front().first);
+	for(int i=1;i<numdigits;i++){
+		float timetonextdigit = sortedtimeids[i].first-sortedtimeids[i-1].first;
+		if(timetonextdigit>minimum_subevent_timeseparation){
+			subeventendtimesv.push_back(sortedtimeids[i-1].first);
+			subeventhittimesv.push_back(sortedtimeids[i].first);
+		}
+	}
+	int numsubevents = subeventhittimesv.size();
+
+	std::vector<int> subeventnumthisevent(numdigits,-1);
+	int thissubevent=0;
+	for(auto&& atimeid : sortedtimeids){
+		while(thissubevent<numsubevents){
+			float endtime = (thissubevent<(numsubevents-1)) ? subeventendtimesv[thissubevent] : (eventendtime+1.);
+			if(atimeid.first<=endtime) break;
+			thissubevent++;
+		}
+		if(thissubevent==numsubevents) break;
+		subeventnumthisevent[atimeid.second] = thissubevent;
+	}
+
+	std::vector<std::vector<int>> subeventdigitids(numsubevents);
+	for(int thisdigit=0;thisdigit<numdigits;thisdigit++){
+		if(subeventnumthisevent[thisdigit]<0) continue;
+		subeventdigitids[subeventnumthisevent[thisdigit]].push_back(thisdigit);
+	}
+	for(int i_sub=0;i_sub<numsubevents;i_sub++){
+		if(subeventdigitids[i_sub].size()>=minimumdigits) out.digitids.push_back(subeventdigitids[i_sub]);
+	}
+	return out;
+}
+
+int main(){
+	std::mt19937 rng(5);
+	const double minimum_subevent_timeseparation = 30.;
+	const unsigned int minimumdigits = 4;
+	// digit times on whole 4 ns TDC ticks (data), arbitrary doubles (simulation), and large offsets
+	// where float spacing is coarser than the time differences
+	const char* names[] = {"TDC ticks","arbitrary","large offset"};
+	int failures = 0;
+	for(int mode=0; mode<3; mode++){
+		for(int ev=0; ev<20000; ev++){
+			int numdigits = 1+rng()%200;
+			std::vector<double> times(numdigits);
+			for(auto&& t : times){
+				double cluster = (rng()%40)*37.;
+				if(mode==0) t = cluster + 4.*(rng()%10);
+				else if(mode==1) t = cluster + std::uniform_real_distribution<double>(0.,10.)(rng);
+				else t = 1.6e7 + cluster + std::uniform_real_distribution<double>(0.,10.)(rng);
+			}
+			Clusters a = ReferenceClusters(times,minimum_subevent_timeseparation,minimumdigits);
+			Clusters b = SweepClusters(times,minimum_subevent_timeseparation,minimumdigits);
+			if(a.starttimes!=b.starttimes || a.digitids!=b.digitids){
+				std::cout<<"TimeClusteringCheck: "<<names[mode]<<" event "<<ev<<" differs"<<std::endl;
+				failures++;
+				break;
+			}
+		}
+	}
+	if(failures) return 1;
+	std::cout<<"TimeClusteringCheck: OK"<<std::endl;
+	return 0;
+}